@@ -0,0 +1,284 @@
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "animation_clip.hpp"
+#include "animator.hpp"
+#include "model.hpp"
+#include "skeleton.hpp"
+#include "skinning.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+constexpr int JOINT_COUNT = 64;
+constexpr int VERTEX_COUNT = 4096;
+constexpr float FRAME_TIME = 1.0f / 60.0f;
+
+/**
+ * A humanoid sized rig: a chain of joints with a one second clip keyed at 30 Hz on every joint.
+ */
+struct Character
+{
+    std::shared_ptr<Skeleton> skeleton = std::make_shared<Skeleton>();
+    std::shared_ptr<const AnimationClip> clip;
+    std::shared_ptr<const AnimationClip> compressedClip;
+    std::vector<Vertex> vertices;
+
+    Character()
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<AnimationChannel> channels;
+        for (int j = 0; j < JOINT_COUNT; ++j)
+        {
+            JointPose bind;
+            bind.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+            skeleton->addJoint("joint" + std::to_string(j), j - 1, bind);
+
+            // Smooth motion like a mocap cycle, with a phase and axis per joint.
+            const glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+            const float phase = 3.0f * unit(random);
+            AnimationChannel channel;
+            channel.joint = j;
+            for (int k = 0; k <= 30; ++k)
+            {
+                const float time = k / 30.0f;
+                const float wave = std::sin(6.2831853f * time + phase);
+                channel.translations.push_back({time, glm::vec3(0.0f, 0.1f, 0.01f * wave)});
+                channel.rotations.push_back({time, glm::angleAxis(0.5f * wave, axis)});
+            }
+            channels.push_back(std::move(channel));
+        }
+        clip = std::make_shared<const AnimationClip>("bench", 1.0f, std::move(channels));
+        compressedClip = AnimationClip::compress(*clip);
+
+        vertices.assign(VERTEX_COUNT, Vertex{});
+        for (Vertex& vertex : vertices)
+        {
+            vertex.position = glm::vec3(unit(random), unit(random), unit(random));
+            vertex.normal = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.01f));
+            for (int k = 0; k < MAX_BONE_INFLUENCE; ++k)
+            {
+                vertex.m_BoneIDs[k] = static_cast<int>(random() % JOINT_COUNT);
+                vertex.m_Weights[k] = 1.0f / MAX_BONE_INFLUENCE;
+            }
+        }
+    }
+};
+
+const Character& character()
+{
+    static const Character instance;
+    return instance;
+}
+
+/**
+ * Per instance state, as an Animator holds it.
+ */
+struct Instance
+{
+    float time = 0.0f;
+    std::vector<JointPose> pose;
+    std::vector<glm::mat4> globals;
+    std::vector<glm::mat4> palette = std::vector<glm::mat4>(JOINT_COUNT);
+    std::vector<Vertex> skinned = character().vertices;
+};
+
+void samplePose(Instance& instance, float dt)
+{
+    const Character& shared = character();
+    instance.time = std::fmod(instance.time + dt, shared.clip->getDuration());
+    shared.skeleton->bindPose(instance.pose);
+    shared.clip->sample(instance.time, instance.pose);
+    shared.skeleton->computePalette(instance.pose, instance.globals, instance.palette.data());
+}
+
+void setCharacterCounters(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["vertices/s"] =
+        benchmark::Counter(static_cast<double>(state.iterations()) * state.range(0) * VERTEX_COUNT,
+                           benchmark::Counter::kIsRate);
+}
+
+/**
+ * Hidden window with a GL 4.6 core context, shared by the GPU benchmarks.
+ */
+class GLContext
+{
+public:
+    static GLContext& getInstance()
+    {
+        static GLContext instance;
+        return instance;
+    }
+
+    bool valid() const { return m_context != nullptr; }
+
+private:
+    GLContext()
+    {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0)
+            return;
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
+        m_window = SDL_CreateWindow("LambEngineBenchmarks", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+        if (!m_window)
+            return;
+        m_context = SDL_GL_CreateContext(m_window);
+        if (m_context && !gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress))
+        {
+            SDL_GL_DeleteContext(m_context);
+            m_context = nullptr;
+        }
+    }
+
+    SDL_Window* m_window = nullptr;
+    SDL_GLContext m_context = nullptr;
+};
+
+} // namespace
+
+static void BM_AnimationSampling(benchmark::State& state)
+{
+    std::vector<Instance> instances(state.range(0));
+    for (auto _ : state)
+    {
+        ThreadPool::getInstance().parallelFor(instances.size(),
+                                              [&](std::size_t i) { samplePose(instances[i], FRAME_TIME); });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AnimationSampling)->Arg(100)->Arg(500)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * Single threaded clip decompression, raw keys against CompressedClip.
+ */
+static void BM_ClipSampling(benchmark::State& state)
+{
+    const AnimationClip& clip = state.range(0) ? *character().compressedClip : *character().clip;
+    std::vector<JointPose> pose;
+    character().skeleton->bindPose(pose);
+
+    float time = 0.0f;
+    for (auto _ : state)
+    {
+        clip.sample(time, pose);
+        benchmark::DoNotOptimize(pose.data());
+        time = std::fmod(time + 0.0137f, clip.getDuration());
+    }
+    state.counters["bones/s"] =
+        benchmark::Counter(static_cast<double>(state.iterations()) * JOINT_COUNT, benchmark::Counter::kIsRate);
+    state.counters["bytes"] = static_cast<double>(clip.memoryUsage());
+    state.SetLabel(state.range(0) ? "compressed" : "raw");
+}
+BENCHMARK(BM_ClipSampling)->Arg(0)->Arg(1);
+
+static void BM_CpuSkinning(benchmark::State& state)
+{
+    std::vector<Instance> instances(state.range(0));
+    for (Instance& instance : instances)
+        samplePose(instance, FRAME_TIME);
+
+    const std::vector<Vertex>& bind = character().vertices;
+    for (auto _ : state)
+    {
+        ThreadPool::getInstance().parallelFor(instances.size(), [&](std::size_t i) {
+            skinVertices(bind.data(), bind.size(), instances[i].palette.data(), instances[i].skinned.data());
+        });
+        benchmark::ClobberMemory();
+    }
+    setCharacterCounters(state);
+}
+BENCHMARK(BM_CpuSkinning)->Arg(100)->Arg(500)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_CpuSkinningScalar(benchmark::State& state)
+{
+    std::vector<Instance> instances(state.range(0));
+    for (Instance& instance : instances)
+        samplePose(instance, FRAME_TIME);
+
+    const std::vector<Vertex>& bind = character().vertices;
+    for (auto _ : state)
+    {
+        ThreadPool::getInstance().parallelFor(instances.size(), [&](std::size_t i) {
+            skinVerticesScalar(bind.data(), bind.size(), instances[i].palette.data(), instances[i].skinned.data());
+        });
+        benchmark::ClobberMemory();
+    }
+    setCharacterCounters(state);
+}
+BENCHMARK(BM_CpuSkinningScalar)->Arg(100)->Arg(500)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * One full AnimationSystem frame for a crowd sharing one model: sampling, then either the
+ * palette upload (GPU mode) or CPU skinning and the vertex buffer refills (CPU mode).
+ */
+static void BM_SkinningFrame(benchmark::State& state)
+{
+    if (!GLContext::getInstance().valid())
+    {
+        state.SkipWithError("No OpenGL 4.6 context");
+        return;
+    }
+
+    const SkinningMode mode = state.range(1) ? SkinningMode::GPU : SkinningMode::CPU;
+    AnimationSystem& system = AnimationSystem::getInstance();
+    system.setSkinningMode(mode);
+
+    ModelData data;
+    data.skeleton = character().skeleton;
+    data.clips.push_back(character().clip);
+    ModelData::Submesh submesh;
+    submesh.vertices = character().vertices;
+    for (unsigned int i = 0; i < VERTEX_COUNT; ++i)
+        submesh.indices.push_back(i);
+    data.submeshes.push_back(std::move(submesh));
+    Model model(std::move(data));
+
+    std::vector<std::unique_ptr<Animator>> animators;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        animators.push_back(std::make_unique<Animator>(model));
+        animators.back()->play(character().clip);
+    }
+
+    Renderable& mesh = model.getMesh(0);
+    for (auto _ : state)
+    {
+        system.update(FRAME_TIME);
+        system.upload();
+        if (mode == SkinningMode::CPU)
+        {
+            for (const auto& animator : animators)
+            {
+                const std::vector<Vertex>& skinned = animator->getSkinnedVertices(0);
+                mesh.updateVertices(skinned.data(), skinned.size());
+            }
+        }
+        glFinish();
+    }
+    setCharacterCounters(state);
+    state.SetLabel(mode == SkinningMode::GPU ? "gpu" : "cpu");
+
+    animators.clear();
+    system.shutdown();
+}
+BENCHMARK(BM_SkinningFrame)
+    ->ArgsProduct({{100, 500}, {0, 1}})
+    ->ArgNames({"characters", "gpu"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,111 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "model.hpp"
+#include "mtl_parser.hpp"
+
+namespace
+{
+
+const std::filesystem::path ROOT = std::filesystem::temp_directory_path() / "lamb_io_benchmark";
+
+/**
+ * Writes a file under ROOT and returns its path.
+ */
+std::string writeFile(const std::string& name, const std::string& text)
+{
+    std::filesystem::create_directories(ROOT);
+    std::ofstream(ROOT / name, std::ios::trunc) << text;
+    return (ROOT / name).string();
+}
+
+/**
+ * The materials of res/materials.mtl, repeated count times as a long file would list them.
+ */
+std::string materialLibrary(int count)
+{
+    static const char* const MATERIALS[] = {"Gold", "Silver", "Copper"};
+    std::string text;
+    for (int i = 0; i < count; ++i)
+    {
+        text += "newmtl " + std::string(MATERIALS[i % 3]) + "\n";
+        text += "Ka 0.24725 0.1995 0.0745     # ambient color\n";
+        text += "Kd 0.75164 0.60648 0.22648   # diffuse color\n";
+        text += "Ks 0.628281 0.555802 0.366065\n";
+        text += "Ns 0.4\n";
+        text += "d 1.0\n\n";
+    }
+    return text;
+}
+
+/**
+ * A flat grid of size x size quads with normals and UVs, as an OBJ file.
+ */
+std::string gridObj(int size)
+{
+    std::string text;
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            const float u = static_cast<float>(x) / size;
+            const float v = static_cast<float>(y) / size;
+            text += "v " + std::to_string(u) + " 0 " + std::to_string(v) + "\n";
+            text += "vt " + std::to_string(u) + " " + std::to_string(v) + "\n";
+        }
+    }
+    text += "vn 0 1 0\n";
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const int a = y * (size + 1) + x + 1;
+            const int b = a + size + 1;
+            const auto corner = [](int i) { return std::to_string(i) + "/" + std::to_string(i) + "/1"; };
+            text += "f " + corner(a) + " " + corner(b) + " " + corner(b + 1) + " " + corner(a + 1) + "\n";
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+static void BM_ParseMTL(benchmark::State& state)
+{
+    const std::string path = writeFile("materials.mtl", materialLibrary(static_cast<int>(state.range(0))));
+    for (auto _ : state)
+    {
+        auto materials = IO::parseMTL(path);
+        benchmark::DoNotOptimize(materials);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_ParseMTL)->Arg(3)->Arg(300);
+
+/**
+ * Model::import() through Assimp and the ThreadPool conversion, without the GL upload.
+ * The grid has size^2 quads, triangulated on import.
+ */
+static void BM_ModelImport(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const std::string path = writeFile("grid" + std::to_string(size) + ".obj", gridObj(size));
+    for (auto _ : state)
+    {
+        ModelData data = Model::import(path);
+        if (!data.valid)
+        {
+            state.SkipWithError("Import failed");
+            break;
+        }
+        benchmark::DoNotOptimize(data);
+    }
+    state.counters["triangles/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * size * size * 2,
+                                                       benchmark::Counter::kIsRate);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_ModelImport)->Arg(16)->Arg(256)->UseRealTime()->Unit(benchmark::kMillisecond);
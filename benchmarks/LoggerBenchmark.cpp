@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "log.hpp"
+
+namespace
+{
+
+void runLoggerLog(benchmark::State& state, LogOverflowPolicy policy)
+{
+#ifndef DEBUG
+    state.SkipWithError("Logger::Log is compiled out without DEBUG");
+    return;
+#endif
+    // Threads wait for each other at the start and end of the loop, so the first one owns the worker.
+    const std::uint64_t droppedAtStart = Logger::GetDroppedCount();
+    if (state.thread_index() == 0)
+    {
+        Logger::SetOverflowPolicy(policy);
+        Logger::Init(false, false);
+    }
+
+    const std::string message = "Frame " + std::to_string(state.thread_index()) + " submitted";
+    for (auto _ : state)
+        Logger::Log(LogLevel::Info, message, "Renderer");
+    state.SetItemsProcessed(state.iterations());
+
+    // Drains the ring, so the next run starts empty.
+    if (state.thread_index() == 0)
+    {
+        Logger::Shutdown();
+        Logger::SetOverflowPolicy(LogOverflowPolicy::Count);
+        state.counters["dropped"] = static_cast<double>(Logger::GetDroppedCount() - droppedAtStart);
+    }
+}
+
+} // namespace
+
+/**
+ * Cost of Logger::Log on the calling thread, with range(0) threads logging at once.
+ * The console is off, so the worker only formats; the figure is what a hot path pays.
+ * Producers outrun the worker, so once the ring is full the default Count policy
+ * drops messages; the dropped counter says how many.
+ * Logger::Log compiles to nothing without DEBUG, as in Release builds.
+ */
+static void BM_LoggerLog(benchmark::State& state)
+{
+    runLoggerLog(state, LogOverflowPolicy::Count);
+}
+BENCHMARK(BM_LoggerLog)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * The same under LogOverflowPolicy::Block: nothing is dropped, so producers run
+ * at the pace of the worker and the figure is the sustained logging throughput.
+ */
+static void BM_LoggerLogBlocking(benchmark::State& state)
+{
+    runLoggerLog(state, LogOverflowPolicy::Block);
+}
+BENCHMARK(BM_LoggerLogBlocking)->ThreadRange(1, 8)->UseRealTime();
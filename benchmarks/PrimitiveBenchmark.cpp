@@ -0,0 +1,73 @@
+#include <glad/glad.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "null_gl.hpp"
+#include "primitive.hpp"
+
+namespace
+{
+
+/**
+ * Primitives upload their geometry when built. Without a context from another
+ * benchmark, NullGl stands in for the driver, since only the CPU side is timed.
+ */
+void ensureGlLoaded()
+{
+    if (!glGenBuffers)
+        gladLoadGLLoader((GLADloadproc)NullGl::getProcAddress);
+}
+
+/**
+ * The primitives with their geometry generation made public.
+ */
+struct BenchmarkCube : Cube
+{
+    using Cube::Cube;
+    using Cube::computeVertices;
+};
+
+struct BenchmarkSphere : Sphere
+{
+    using Sphere::computeVertices;
+    using Sphere::Sphere;
+};
+
+} // namespace
+
+static void BM_CubeVertices(benchmark::State& state)
+{
+    ensureGlLoaded();
+    BenchmarkCube cube;
+    for (auto _ : state)
+    {
+        std::vector<Vertex> vertices = cube.computeVertices();
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    cube.destroy();
+}
+BENCHMARK(BM_CubeVertices);
+
+/**
+ * A sphere of range(0) stacks by 2 * range(0) sectors, 16 being the default.
+ */
+static void BM_SphereVertices(benchmark::State& state)
+{
+    ensureGlLoaded();
+    const int stacks = static_cast<int>(state.range(0));
+    BenchmarkSphere sphere(stacks, 2 * stacks, 1.0f);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::vector<Vertex> vertices = sphere.computeVertices();
+        count = vertices.size();
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.counters["vertices/s"] =
+        benchmark::Counter(static_cast<double>(state.iterations()) * count, benchmark::Counter::kIsRate);
+    sphere.destroy();
+}
+BENCHMARK(BM_SphereVertices)->Arg(16)->Arg(128);
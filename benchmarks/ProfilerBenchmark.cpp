@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+
+#include "profiler.hpp"
+
+/**
+ * Cost of one zone while capturing: two timestamps and an append to the thread buffer.
+ */
+static void BM_ProfileZone(benchmark::State& state)
+{
+    Profiler& profiler = Profiler::getInstance();
+    profiler.start();
+    for (auto _ : state)
+    {
+        ProfileZone zone("Benchmark zone");
+        benchmark::ClobberMemory();
+    }
+    profiler.stop();
+}
+BENCHMARK(BM_ProfileZone)->ThreadRange(1, 4);
+
+/**
+ * Cost of one zone when no capture runs: a relaxed load.
+ */
+static void BM_ProfileZoneIdle(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        ProfileZone zone("Benchmark zone");
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ProfileZoneIdle);
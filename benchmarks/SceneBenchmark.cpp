@@ -0,0 +1,74 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "camera.hpp"
+#include "entity_manager.hpp"
+#include "input.hpp"
+
+/**
+ * EntityManager::getEntity() with range(0) entities registered, for random ids.
+ */
+static void BM_EntityLookup(benchmark::State& state)
+{
+    std::vector<Entity> entities(state.range(0));
+    for (Entity& entity : entities)
+        EntityManager::getInstance().addEntity(&entity);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::size_t> pick(0, entities.size() - 1);
+    std::vector<int> ids(1024);
+    for (int& id : ids)
+        id = entities[pick(random)].getId();
+
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(EntityManager::getInstance().getEntity(ids[next]));
+        next = (next + 1) % ids.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    for (Entity& entity : entities)
+        EntityManager::getInstance().removeEntity(&entity);
+}
+BENCHMARK(BM_EntityLookup)->Arg(100)->Arg(10000);
+
+/**
+ * The per frame camera work of MyGame: applying the actions, then the interpolated view and the projection.
+ */
+static void BM_CameraMatrices(benchmark::State& state)
+{
+    Camera camera;
+    const std::vector<Action> actions = {Action::Forward, Action::Left};
+    float alpha = 0.0f;
+    for (auto _ : state)
+    {
+        camera.computeActions(actions, 1.0f / 60.0f);
+        const glm::mat4 view = camera.getViewMatrix(alpha);
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        benchmark::DoNotOptimize(projection * view);
+        alpha = alpha < 1.0f ? alpha + 0.1f : 0.0f;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CameraMatrices);
+
+/**
+ * getActions() on a keyboard state with two movement keys down.
+ */
+static void BM_GetActions(benchmark::State& state)
+{
+    std::vector<Uint8> keystate(SDL_NUM_SCANCODES, 0);
+    keystate[SDL_SCANCODE_W] = 1;
+    keystate[SDL_SCANCODE_D] = 1;
+    for (auto _ : state)
+    {
+        std::vector<Action> actions = getActions(keystate.data());
+        benchmark::DoNotOptimize(actions.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetActions);
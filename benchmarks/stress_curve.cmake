@@ -0,0 +1,59 @@
+# Runs the stress scene headless for a series of object counts and collects the
+# frame time reports into one CSV, one row per count, to plot scaling curves.
+#
+#   cmake -DENGINE=<LambEngine> [-DOUTPUT_DIR=<dir>] [-DCOUNTS=1000;10000;...] [-DFRAMES=600]
+#         [-DARGS=--lights;16;--materials;32] -P stress_curve.cmake
+#
+# Run it from the directory holding shaders/ and res/. ARGS are passed to every
+# run, for instance --null-renderer to measure the CPU side alone.
+
+if (NOT ENGINE)
+    message(FATAL_ERROR "Set ENGINE to the LambEngine executable")
+endif()
+if (NOT OUTPUT_DIR)
+    set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/stress_curve")
+endif()
+if (NOT COUNTS)
+    set(COUNTS 1000 10000 100000 1000000)
+endif()
+if (NOT FRAMES)
+    set(FRAMES 600)
+endif()
+
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+set(CSV "objects,framesPerSecond,averageMs,p50Ms,p95Ms,p99Ms,")
+string(APPEND CSV "drawCalls,triangles,textureBytes,bufferBytes,peakResidentBytes\n")
+set(COUNTERS drawCalls triangles textureBytes bufferBytes peakResidentBytes)
+
+foreach(COUNT IN LISTS COUNTS)
+    set(REPORT "${OUTPUT_DIR}/stress_${COUNT}.json")
+    message(STATUS "Stress scene with ${COUNT} objects")
+    file(REMOVE "${REPORT}")
+    execute_process(
+        COMMAND "${ENGINE}" --scene stress --objects ${COUNT} --headless --frames ${FRAMES} --report "${REPORT}" ${ARGS}
+        RESULT_VARIABLE RESULT
+    )
+    if (NOT RESULT EQUAL 0 OR NOT EXISTS "${REPORT}")
+        message(WARNING "Run with ${COUNT} objects failed (${RESULT}), skipped")
+        continue()
+    endif()
+
+    file(READ "${REPORT}" JSON)
+    string(JSON FPS GET "${JSON}" framesPerSecond)
+    set(ROW "${COUNT},${FPS}")
+    foreach(STATISTIC average p50 p95 p99)
+        string(JSON VALUE GET "${JSON}" milliseconds ${STATISTIC})
+        string(APPEND ROW ",${VALUE}")
+    endforeach()
+    foreach(COUNTER IN LISTS COUNTERS)
+        string(JSON VALUE ERROR_VARIABLE MISSING GET "${JSON}" counters ${COUNTER})
+        if (MISSING)
+            set(VALUE "")
+        endif()
+        string(APPEND ROW ",${VALUE}")
+    endforeach()
+    string(APPEND CSV "${ROW}\n")
+endforeach()
+
+file(WRITE "${OUTPUT_DIR}/stress_curve.csv" "${CSV}")
+message(STATUS "Scaling curve written to ${OUTPUT_DIR}/stress_curve.csv")
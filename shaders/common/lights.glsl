@@ -0,0 +1,99 @@
+// Light types and Phong terms shared by the lighting shaders.
+// The including shader provides material.shininess, diffuseTexel() and specularTexel().
+
+struct DirectionalLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct Spotlight {
+    vec3 position;
+    vec3 direction;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float radius;
+    float outerRadius;
+};
+
+vec3 calculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
+    vec3 lightDir = normalize(-light.direction);
+
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+    vec3 ambient = light.ambient * diffuseTexel();
+    vec3 diffuse = light.diffuse * diff * diffuseTexel();
+    vec3 specular = light.specular * spec * specularTexel();
+
+    return (ambient + diffuse + specular);
+};
+
+vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
+    vec3 lightDir = normalize(light.position - fragPos);
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance +
+                            light.quadratic * (distance * distance));
+    vec3 ambient = light.ambient * diffuseTexel();
+    vec3 diffuse  = light.diffuse  * diff * diffuseTexel();
+    vec3 specular = light.specular * spec * specularTexel();
+    ambient  *= attenuation;
+    diffuse  *= attenuation;
+    specular *= attenuation;
+    return (ambient + diffuse + specular);
+};
+
+vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
+    vec3 lightDirToFrag = normalize(light.position - fragPos);
+
+    float diff = max(dot(normal, lightDirToFrag), 0.0);
+
+    vec3 reflectDir = reflect(-lightDirToFrag, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+    vec3 ambient = light.ambient * diffuseTexel();
+    vec3 diffuse  = light.diffuse  * diff * diffuseTexel();
+    vec3 specular = light.specular * spec * specularTexel();
+
+    float theta = dot(lightDirToFrag, normalize(-light.direction));
+    float epsilon = light.radius - light.outerRadius;
+    float outerRadiusIntensity = clamp((theta - light.outerRadius) / epsilon, 0.0, 1.0); // ratio
+    diffuse *= outerRadiusIntensity;
+    specular *= outerRadiusIntensity;
+
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance +
+                            light.quadratic * (distance * distance));
+    diffuse  *= attenuation;
+    specular *= attenuation;
+
+    return (ambient + diffuse + specular);
+}
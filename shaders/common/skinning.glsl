@@ -0,0 +1,19 @@
+// GPU skinning from the palettes packed by AnimationSystem::upload().
+// The including shader declares the bone ID and weight attributes.
+
+layout(std430, binding = 3) readonly buffer BonePalette {
+    mat4 bones[];
+};
+
+// First matrix of the drawn animator in bones.
+uniform int boneOffset;
+
+mat4 skinMatrix(ivec4 boneIds, vec4 weights) {
+    float total = weights.x + weights.y + weights.z + weights.w;
+    if (total == 0.0)
+        return mat4(1.0);
+    return bones[boneOffset + boneIds.x] * weights.x
+         + bones[boneOffset + boneIds.y] * weights.y
+         + bones[boneOffset + boneIds.z] * weights.z
+         + bones[boneOffset + boneIds.w] * weights.w;
+}
@@ -1,5 +1,14 @@
 #version 460 core
 
+// Permutation features, injected by ShaderVariants:
+//   TEXTURE_ARRAY    textures packed by LambTexturePacker
+//   SPOTLIGHT        camera spotlight
+//   NR_POINT_LIGHTS  number of point lights, 0 removes them
+
+#ifndef NR_POINT_LIGHTS
+#define NR_POINT_LIGHTS 4
+#endif
+
 out vec4 FragColor;
 
 in vec3 normal;
@@ -8,58 +17,62 @@ in vec3 fragPosition;
 
 uniform vec3 cameraPosition;
 
-// was object color
+#ifdef TEXTURE_ARRAY
+// One array per format and size, the material only selects a layer and the
+// UV rectangle inside it.
 struct Material {
-    sampler2D texture_diffuse1;
-    sampler2D texture_specular1;
+    sampler2DArray texture_diffuse1;
+    sampler2DArray texture_specular1;
+    int texture_diffuse1_layer;
+    int texture_specular1_layer;
+    vec4 texture_diffuse1_uv;  // offset (xy), scale (zw)
+    vec4 texture_specular1_uv;
     float shininess;
 };
 uniform Material material;
 
-struct DirectionalLight {
-    vec3 direction;
-  
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};  
-uniform DirectionalLight directionalLight;
-
-struct PointLight {
-    vec3 position;
+// Wraps inside the atlas rectangle; gradients come from the unwrapped
+// coordinates so the mip level does not jump at the seams.
+vec3 sampleLayer(sampler2DArray textureArray, int layer, vec4 uvTransform) {
+    vec2 uv = fract(TexCoords) * uvTransform.zw + uvTransform.xy;
+    vec2 dx = dFdx(TexCoords) * uvTransform.zw;
+    vec2 dy = dFdy(TexCoords) * uvTransform.zw;
+    return vec3(textureGrad(textureArray, vec3(uv, float(layer)), dx, dy));
+}
 
-    float constant;
-    float linear;
-    float quadratic;
+vec3 diffuseTexel() {
+    return sampleLayer(material.texture_diffuse1, material.texture_diffuse1_layer, material.texture_diffuse1_uv);
+}
 
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+vec3 specularTexel() {
+    return sampleLayer(material.texture_specular1, material.texture_specular1_layer, material.texture_specular1_uv);
+}
+#else
+struct Material {
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+    float shininess;
 };
+uniform Material material;
 
-#define NR_POINT_LIGHTS 4
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-
-struct Spotlight {
-    vec3 position;
-    vec3 direction;
+vec3 diffuseTexel() {
+    return vec3(texture(material.texture_diffuse1, TexCoords));
+}
 
-    float constant;
-    float linear;
-    float quadratic;
+vec3 specularTexel() {
+    return vec3(texture(material.texture_specular1, TexCoords));
+}
+#endif
 
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+#include "common/lights.glsl"
 
-    float radius;
-    float outerRadius;
-};
+uniform DirectionalLight directionalLight;
+#if NR_POINT_LIGHTS > 0
+uniform PointLight pointLights[NR_POINT_LIGHTS];
+#endif
+#ifdef SPOTLIGHT
 uniform Spotlight spotlight;
-
-vec3 calculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir);
-vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+#endif
 
 void main() {
     vec3 norm = normalize(normal);
@@ -67,71 +80,14 @@ void main() {
     vec3 result;
     result = calculateDirectionalLight(directionalLight, norm, viewDirection);
 
+#if NR_POINT_LIGHTS > 0
     for (int i = 0; i < NR_POINT_LIGHTS; i++)
         result += calculatePointLight(pointLights[i], norm, fragPosition, viewDirection);
+#endif
 
+#ifdef SPOTLIGHT
     result += calculateSpotlight(spotlight, norm, fragPosition, viewDirection);
+#endif
 
     FragColor = vec4(result, 1.0);
 };
-
-vec3 calculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
-    vec3 lightDir = normalize(-light.direction);
-
-    float diff = max(dot(normal, lightDir), 0.0);
-
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
-
-    return (ambient + diffuse + specular);
-};
-
-vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(normal, lightDir), 0.0);
-
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance +
-                            light.quadratic * (distance * distance));
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
-    ambient  *= attenuation;
-    diffuse  *= attenuation;
-    specular *= attenuation;
-    return (ambient + diffuse + specular);
-};
-
-vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDirToFrag = normalize(light.position - fragPos);
-
-    float diff = max(dot(normal, lightDirToFrag), 0.0);
-
-    vec3 reflectDir = reflect(-lightDirToFrag, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
-
-    float theta = dot(lightDirToFrag, normalize(-light.direction));
-    float epsilon = light.radius - light.outerRadius;
-    float outerRadiusIntensity = clamp((theta - light.outerRadius) / epsilon, 0.0, 1.0); // ratio
-    diffuse *= outerRadiusIntensity;
-    specular *= outerRadiusIntensity;
-
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance +
-                            light.quadratic * (distance * distance));
-    diffuse  *= attenuation;
-    specular *= attenuation;
-
-    return (ambient + diffuse + specular);
-}
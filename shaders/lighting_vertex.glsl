@@ -1,8 +1,17 @@
 #version 460 core
 
+// Permutation features, injected by ShaderVariants:
+//   SKINNING  skeletal animation from the bone palette buffer
+
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+#ifdef SKINNING
+layout (location = 5) in ivec4 aBoneIds;
+layout (location = 6) in vec4 aWeights;
+
+#include "common/skinning.glsl"
+#endif
 
 out vec3 normal;
 out vec3 fragPosition;
@@ -13,9 +22,17 @@ uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    normal = mat3(transpose(inverse(model))) * aNormal;;
+#ifdef SKINNING
+    mat4 skin = skinMatrix(aBoneIds, aWeights);
+    vec3 position = vec3(skin * vec4(aPos, 1.0));
+    vec3 localNormal = mat3(skin) * aNormal;
+#else
+    vec3 position = aPos;
+    vec3 localNormal = aNormal;
+#endif
+    gl_Position = projection * view * model * vec4(position, 1.0);
+    normal = mat3(transpose(inverse(model))) * localNormal;
     // normal = aNormal;
     TexCoords = aTexCoords;
-    fragPosition = vec3(model * vec4(aPos, 1.0));
+    fragPosition = vec3(model * vec4(position, 1.0));
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine.hpp"
+#include "render_command_list.hpp"
 
 class Engine;
 
@@ -9,6 +10,9 @@ class IGame
 public:
     virtual ~IGame() = default;
     virtual void OnInit(Engine& engine) {}
+    // Runs zero or more times per frame at EngineConfig::updateRate; dt is always the fixed step.
     virtual void OnUpdate(Engine& engine, float dt) {}
-    virtual void OnRender(Engine& engine) {}
+    // Records the frame; runs on the game thread, without the GL context when EngineConfig::renderThread is set.
+    // alpha in [0, 1) is how far the frame is between the last two updates, to interpolate what moves.
+    virtual void OnRender(Engine& engine, RenderCommandList& commands, float alpha) {}
 };
@@ -17,6 +17,7 @@
 #include "primitive.hpp"
 #include "shader.hpp"
 #include "shader_engine.hpp"
+#include "shader_variants.hpp"
 #include "time.hpp"
 
 // Pas de STB_IMAGE_IMPLEMENTATION ici !
@@ -30,27 +31,33 @@ void MyGame::OnInit(Engine& engine)
     // Aspect ratio (si tu peux le récupérer depuis Engine)
     // m_CurrentAspectRatio = engine.GetAspectRatio();
 
-    // Shaders pour la scène
-    m_LightingShader = new ShaderEngine();
-    m_LightShader = new ShaderEngine();
-
-    Shader lightingVertexShader = ShaderFactory::createShader(".\\shaders\\lighting_vertex.glsl", GL_VERTEX_SHADER);
-    m_LightingShader->addShader(lightingVertexShader);
+    // Shaders pour la scène : tout est soumis au driver d'un coup, les erreurs sont
+    // vérifiées au premier use() pendant que les modèles et textures se chargent.
+    ShaderBatch shaderBatch;
 
-    Shader lightingFragmentShader =
-        ShaderFactory::createShader(".\\shaders\\lighting_fragment.glsl", GL_FRAGMENT_SHADER);
-    m_LightingShader->addShader(lightingFragmentShader);
-    m_LightingShader->compile();
+    // Variantes du shader d'éclairage : chaque combinaison est compilée une seule fois.
+    m_LightingVariants = new ShaderVariants(".\\shaders\\lighting_vertex.glsl", ".\\shaders\\lighting_fragment.glsl",
+                                            {"SPOTLIGHT", "TEXTURE_ARRAY", "SKINNING"}, {{"NR_POINT_LIGHTS", "4"}});
+    const std::uint32_t litFeatures = m_LightingVariants->featureBit("SPOTLIGHT");
+    m_LightingVariants->prepare(litFeatures, shaderBatch);
 
+    m_LightShader = new ShaderEngine();
     Shader lightVertexShader = ShaderFactory::createShader(".\\shaders\\light_vertex.glsl", GL_VERTEX_SHADER);
     m_LightShader->addShader(lightVertexShader);
-
     Shader lightFragmentShader = ShaderFactory::createShader(".\\shaders\\light_fragment.glsl", GL_FRAGMENT_SHADER);
     m_LightShader->addShader(lightFragmentShader);
-    m_LightShader->compile();
+    shaderBatch.add(*m_LightShader);
 
-    m_BasicShader = new ShaderEngine(ShaderEngineFactory::createEngine(
-        ".\\shaders\\basic_vertex.glsl", ".\\shaders\\shader_single_color_fragment.glsl"));
+    m_BasicShader = new ShaderEngine();
+    Shader basicVertexShader = ShaderFactory::createShader(".\\shaders\\basic_vertex.glsl", GL_VERTEX_SHADER);
+    m_BasicShader->addShader(basicVertexShader);
+    Shader basicFragmentShader =
+        ShaderFactory::createShader(".\\shaders\\shader_single_color_fragment.glsl", GL_FRAGMENT_SHADER);
+    m_BasicShader->addShader(basicFragmentShader);
+    shaderBatch.add(*m_BasicShader);
+
+    shaderBatch.submit();
+    m_LightingShader = &m_LightingVariants->get(litFeatures);
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -63,14 +70,14 @@ void MyGame::OnInit(Engine& engine)
     m_Sphere = new Sphere(1.0f);
 
     m_LitCube = new Cube(1.0f);
-    m_LitCube->setShaderEngine(*m_LightingShader);
+    m_LitCube->setShaderVariants(*m_LightingVariants, litFeatures);
     m_LitCube->setTexture(".\\res\\box.bmp", TextureType::DIFFUSE);
     m_LitCube->setTexture(".\\res\\box_specular_map.png", TextureType::SPECULAR);
 
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
-    m_Teapot = new Model(".\\res\\teapot.fbx");
-    m_Teapot->setShaderEngine(*m_BasicShader);
+    // Importé en arrière-plan : le modèle n'est dessiné qu'une fois prêt.
+    m_Teapot = AssetManager::getInstance().loadModel(".\\res\\teapot.fbx");
 
     m_Camera = new Camera();
 
@@ -96,31 +103,29 @@ void MyGame::OnInit(Engine& engine)
 }
 
 // -----------------------------
-// OnUpdate : logique (input, mouvements)
+// OnUpdate : logique (input, mouvements), appelée à pas fixe
 // -----------------------------
 void MyGame::OnUpdate(Engine& engine, float dt)
 {
-    const Uint8* keystate = SDL_GetKeyboardState(nullptr);
+    const Uint8* keystate = InputSystem::getInstance()->getKeyboardState();
     std::vector<Action> actions = getActions(keystate);
 
-    m_Camera->computeActions(actions);
+    m_Camera->computeActions(actions, dt);
 
     // Ici tu peux mettre d'autres updates (animations, timers, etc.)
 }
 
 // -----------------------------
-// OnRender : tout le rendu OpenGL
+// OnRender : enregistre les commandes de rendu, exécutées par le thread de rendu
 // -----------------------------
-void MyGame::OnRender(Engine& engine)
+void MyGame::OnRender(Engine& engine, RenderCommandList& commands, float alpha)
 {
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
-    glStencilFunc(GL_ALWAYS, 1, 0xFF);
-    glStencilMask(0xFF);
+    commands.clear(glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
 
-    glm::mat4 view = m_Camera->getViewMatrix();
+    // Caméra interpolée entre les deux derniers pas de simulation
+    glm::mat4 view = m_Camera->getViewMatrix(alpha);
     glm::mat4 projection = glm::perspective(glm::radians(45.0f), m_CurrentAspectRatio, 0.1f, 100.0f);
+    commands.setCamera(view, projection);
 
     // ---- Light cubes ----
     // m_LightShader->use();
@@ -185,12 +190,21 @@ void MyGame::OnRender(Engine& engine)
     //     m_LitCube->draw();
     // }
 
-    // Teapot avec basic engine
-    m_BasicShader->use();
+    // Teapot avec basic engine, une fois chargé
+    Model* teapot = m_Teapot.get();
+    if (!teapot)
+        return;
+    if (!m_TeapotShaderSet)
+    {
+        // Recorded, so it runs where the draws run, after the frames that did not draw it yet.
+        commands.call([teapot, shader = m_BasicShader]() { teapot->setShaderEngine(*shader); });
+        m_TeapotShaderSet = true;
+    }
+
     glm::mat4 model(1.0f);
-    m_BasicShader->setMat4("model", model);
-    m_BasicShader->setMat4("view", view);
-    m_BasicShader->setMat4("projection", projection);
+    commands.setUniform(*m_BasicShader, "model", model);
+    commands.setUniform(*m_BasicShader, "view", view);
+    commands.setUniform(*m_BasicShader, "projection", projection);
 
-    m_Teapot->draw();
+    commands.draw(*teapot, model);
 }
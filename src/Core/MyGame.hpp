@@ -6,23 +6,25 @@
 #include <glm/glm.hpp>
 
 #include "IGame.hpp"
+#include "asset_manager.hpp"
 
 // Forward declarations pour éviter les includes lourds ici
 class ShaderEngine;
+class ShaderVariants;
 class Camera;
 class Cube;
 class Sphere;
-class Model;
 
 class MyGame : public IGame
 {
 public:
     void OnInit(Engine& engine) override;
     void OnUpdate(Engine& engine, float dt) override;
-    void OnRender(Engine& engine) override;
+    void OnRender(Engine& engine, RenderCommandList& commands, float alpha) override;
 
 private:
     // Shaders
+    ShaderVariants* m_LightingVariants = nullptr;
     ShaderEngine* m_LightingShader = nullptr;
     ShaderEngine* m_LightShader = nullptr;
     ShaderEngine* m_BasicShader = nullptr;
@@ -31,7 +33,8 @@ private:
     Cube* m_LightCube = nullptr;
     Cube* m_LitCube = nullptr;
     Sphere* m_Sphere = nullptr;
-    Model* m_Teapot = nullptr;
+    ModelHandle m_Teapot;
+    bool m_TeapotShaderSet = false;
 
     // Caméra
     Camera* m_Camera = nullptr;
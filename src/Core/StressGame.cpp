@@ -0,0 +1,236 @@
+// StressGame.cpp
+#include "StressGame.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "engine.hpp"
+#include "model.hpp"
+#include "primitive.hpp"
+#include "shader.hpp"
+#include "shader_engine.hpp"
+#include "shader_variants.hpp"
+
+namespace
+{
+
+constexpr float SPACING = 3.0f;        // between grid cells
+constexpr float BOB_HEIGHT = 1.0f;     // vertical travel of the moving objects
+constexpr float CAMERA_PERIOD = 60.0f; // seconds per orbit of the camera
+constexpr float LIGHT_PERIOD = 20.0f;  // seconds per orbit of the lights
+constexpr float TWO_PI = 6.28318530718f;
+
+} // namespace
+
+StressGame::StressGame(const StressSceneConfig& config) : m_Config(config)
+{
+    m_Config.materials = std::max(m_Config.materials, 1u);
+    m_Config.movingRatio = std::clamp(m_Config.movingRatio, 0.0f, 1.0f);
+}
+
+StressGame::~StressGame() = default;
+
+void StressGame::OnInit(Engine& engine)
+{
+    m_AspectRatio = engine.GetAspectRatio();
+    engine.SetReportInfo("scene", "stress");
+    engine.SetReportInfo("objects", std::to_string(m_Config.objects));
+    engine.SetReportInfo("lights", std::to_string(m_Config.lights));
+    engine.SetReportInfo("materials", std::to_string(m_Config.materials));
+    engine.SetReportInfo("movingRatio", std::to_string(m_Config.movingRatio));
+    engine.SetReportInfo("seed", std::to_string(m_Config.seed));
+
+    ShaderBatch shaderBatch;
+    m_LightingVariants = std::make_unique<ShaderVariants>(
+        ".\\shaders\\lighting_vertex.glsl", ".\\shaders\\lighting_fragment.glsl",
+        std::vector<std::string>{"SPOTLIGHT", "TEXTURE_ARRAY", "SKINNING"},
+        ShaderDefines{{"NR_POINT_LIGHTS", std::to_string(m_Config.lights)}});
+    m_LightingVariants->prepare(0, shaderBatch);
+
+    m_TeapotShader = std::make_unique<ShaderEngine>();
+    Shader teapotVertexShader = ShaderFactory::createShader(".\\shaders\\basic_vertex.glsl", GL_VERTEX_SHADER);
+    m_TeapotShader->addShader(teapotVertexShader);
+    Shader teapotFragmentShader =
+        ShaderFactory::createShader(".\\shaders\\shader_single_color_fragment.glsl", GL_FRAGMENT_SHADER);
+    m_TeapotShader->addShader(teapotFragmentShader);
+    shaderBatch.add(*m_TeapotShader);
+
+    shaderBatch.submit();
+    m_LightingShader = &m_LightingVariants->get(0);
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+
+    // Every material loads its own copy of the textures, so each has distinct texture objects to bind.
+    for (unsigned int i = 0; i < m_Config.materials; ++i)
+    {
+        auto cube = std::make_unique<Cube>(1.0f);
+        auto sphere = std::make_unique<Sphere>(0.6f);
+        for (Renderable* mesh : {static_cast<Renderable*>(cube.get()), static_cast<Renderable*>(sphere.get())})
+        {
+            mesh->setShaderVariants(*m_LightingVariants, 0);
+            mesh->setTexture(".\\res\\box.bmp", TextureType::DIFFUSE);
+            mesh->setTexture(".\\res\\box_specular_map.png", TextureType::SPECULAR);
+        }
+        m_Cubes.push_back(std::move(cube));
+        m_Spheres.push_back(std::move(sphere));
+        m_Shininess.push_back(8.0f * static_cast<float>(1u << (i % 5)));
+    }
+    m_Teapot = AssetManager::getInstance().loadModel(".\\res\\teapot.fbx");
+
+    for (unsigned int i = 0; i < m_Config.lights; ++i)
+        m_LightNames.push_back("pointLights[" + std::to_string(i) + "].");
+
+    createObjects();
+}
+
+void StressGame::createObjects()
+{
+    const auto side = static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(m_Config.objects))));
+    m_Extent = 0.5f * SPACING * static_cast<float>(std::max<std::size_t>(side, 1));
+
+    std::mt19937 random(m_Config.seed);
+    std::uniform_int_distribution<std::uint32_t> material(0, m_Config.materials - 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    struct Placed
+    {
+        Object object;
+        glm::vec3 position;
+        float phase;
+    };
+    std::vector<Placed> placed;
+    placed.reserve(m_Config.objects);
+    for (std::size_t i = 0; i < m_Config.objects; ++i)
+    {
+        const glm::vec3 cell(static_cast<float>(i % side), static_cast<float>(i / side % side),
+                             static_cast<float>(i / (side * side)));
+        Placed entry;
+        entry.object.shape = static_cast<Shape>(i % 3);
+        entry.object.material = material(random);
+        entry.object.moving = unit(random) < m_Config.movingRatio ? 0 : -1;
+        entry.position = cell * SPACING - glm::vec3(m_Extent);
+        entry.phase = TWO_PI * unit(random);
+        placed.push_back(entry);
+    }
+
+    // Consecutive draws then share their program and textures, as with a sorting renderer.
+    std::stable_sort(placed.begin(), placed.end(), [](const Placed& a, const Placed& b) {
+        if (a.object.shape != b.object.shape)
+            return a.object.shape < b.object.shape;
+        return a.object.material < b.object.material;
+    });
+
+    m_Objects.reserve(placed.size());
+    m_Transforms.reserve(placed.size());
+    for (Placed& entry : placed)
+    {
+        if (entry.object.moving >= 0)
+        {
+            entry.object.moving = static_cast<std::int32_t>(m_Origins.size());
+            m_Origins.push_back(entry.position);
+            m_Phases.push_back(entry.phase);
+        }
+        m_Objects.push_back(entry.object);
+        m_Transforms.push_back(glm::translate(glm::mat4(1.0f), entry.position));
+    }
+    m_Previous = m_Origins;
+    m_Current = m_Origins;
+}
+
+void StressGame::OnUpdate(Engine& engine, float dt)
+{
+    m_Time += dt;
+    m_Step = dt;
+    std::swap(m_Previous, m_Current);
+    const float time = static_cast<float>(m_Time);
+    for (std::size_t i = 0; i < m_Origins.size(); ++i)
+        m_Current[i] = m_Origins[i] + glm::vec3(0.0f, BOB_HEIGHT * std::sin(2.0f * time + m_Phases[i]), 0.0f);
+}
+
+glm::mat4 StressGame::movingTransform(std::size_t moving, float alpha, float time) const
+{
+    const glm::vec3 position = glm::mix(m_Previous[moving], m_Current[moving], alpha);
+    const float angle = m_Phases[moving] + time;
+    return glm::rotate(glm::translate(glm::mat4(1.0f), position), angle, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+void StressGame::OnRender(Engine& engine, RenderCommandList& commands, float alpha)
+{
+    commands.clear(glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+
+    // Time between the last two updates, like the moving objects
+    const float time = static_cast<float>(m_Time) - (1.0f - alpha) * m_Step;
+
+    const float cameraAngle = TWO_PI * time / CAMERA_PERIOD;
+    const float distance = 2.5f * m_Extent + 5.0f;
+    const glm::vec3 cameraPosition(distance * std::sin(cameraAngle), 0.6f * distance, distance * std::cos(cameraAngle));
+    const glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection =
+        glm::perspective(glm::radians(45.0f), m_AspectRatio, 0.1f, 2.0f * distance + 2.0f * m_Extent);
+    commands.setCamera(view, projection);
+
+    ShaderEngine& lighting = *m_LightingShader;
+    commands.setUniform(lighting, "view", view);
+    commands.setUniform(lighting, "projection", projection);
+    commands.setUniform(lighting, "cameraPosition", cameraPosition);
+    commands.setUniform(lighting, "directionalLight.direction", glm::vec3(-0.2f, -1.0f, -0.3f));
+    commands.setUniform(lighting, "directionalLight.ambient", glm::vec3(0.05f));
+    commands.setUniform(lighting, "directionalLight.diffuse", glm::vec3(0.4f));
+    commands.setUniform(lighting, "directionalLight.specular", glm::vec3(0.5f));
+    for (std::size_t i = 0; i < m_LightNames.size(); ++i)
+    {
+        const float angle = TWO_PI * (time / LIGHT_PERIOD + static_cast<float>(i) / m_LightNames.size());
+        const glm::vec3 position(m_Extent * std::sin(angle), m_Extent * 0.5f, m_Extent * std::cos(angle));
+        const std::string& name = m_LightNames[i];
+        commands.setUniform(lighting, name + "position", position);
+        commands.setUniform(lighting, name + "ambient", glm::vec3(0.05f));
+        commands.setUniform(lighting, name + "diffuse", glm::vec3(0.8f));
+        commands.setUniform(lighting, name + "specular", glm::vec3(1.0f));
+        commands.setUniform(lighting, name + "constant", 1.0f);
+        commands.setUniform(lighting, name + "linear", 0.09f);
+        commands.setUniform(lighting, name + "quadratic", 0.032f);
+    }
+
+    // Teapots are drawn once the model is imported.
+    Model* teapot = m_Teapot.get();
+    if (teapot)
+    {
+        if (!m_TeapotShaderSet)
+        {
+            // Recorded, so it runs where the draws run, after the frames that did not draw it yet.
+            commands.call([teapot, shader = m_TeapotShader.get()]() { teapot->setShaderEngine(*shader); });
+            m_TeapotShaderSet = true;
+        }
+        commands.setUniform(*m_TeapotShader, "view", view);
+        commands.setUniform(*m_TeapotShader, "projection", projection);
+    }
+
+    std::uint32_t currentMaterial = m_Config.materials;
+    for (std::size_t i = 0; i < m_Objects.size(); ++i)
+    {
+        const Object& object = m_Objects[i];
+        const glm::mat4 transform = object.moving >= 0 ? movingTransform(object.moving, alpha, time) : m_Transforms[i];
+        if (object.shape == Shape::Teapot)
+        {
+            if (!teapot)
+                continue;
+            commands.setUniform(*m_TeapotShader, "model", transform);
+            commands.draw(*teapot, transform);
+            continue;
+        }
+
+        if (object.material != currentMaterial)
+        {
+            currentMaterial = object.material;
+            commands.setUniform(lighting, "material.shininess", m_Shininess[currentMaterial]);
+        }
+        commands.setUniform(lighting, "model", transform);
+        Renderable& mesh = object.shape == Shape::Cube ? static_cast<Renderable&>(*m_Cubes[object.material])
+                                                       : static_cast<Renderable&>(*m_Spheres[object.material]);
+        commands.draw(mesh, transform);
+    }
+}
@@ -0,0 +1,84 @@
+// StressGame.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "IGame.hpp"
+#include "asset_manager.hpp"
+
+class Cube;
+class ShaderEngine;
+class ShaderVariants;
+class Sphere;
+
+struct StressSceneConfig
+{
+    std::size_t objects = 1000; // cubes, spheres and teapots in equal parts, on a grid
+    unsigned int lights = 4;    // point lights orbiting the grid, compiled into the lighting shader
+    unsigned int materials = 8; // materials, each with its own diffuse and specular texture objects
+    float movingRatio = 0.1f;   // share of the objects simulated every update, the rest never move
+    unsigned int seed = 1;      // picks the shape, material and motion of every object
+};
+
+// A procedural scene to measure how the engine scales with the object, light and material counts.
+// It runs through the same IGame path as any game; the camera orbits on its own, so runs repeat.
+class StressGame : public IGame
+{
+public:
+    explicit StressGame(const StressSceneConfig& config);
+    ~StressGame() override;
+
+    void OnInit(Engine& engine) override;
+    void OnUpdate(Engine& engine, float dt) override;
+    void OnRender(Engine& engine, RenderCommandList& commands, float alpha) override;
+
+private:
+    enum class Shape : std::uint8_t
+    {
+        Cube,
+        Sphere,
+        Teapot
+    };
+
+    struct Object
+    {
+        Shape shape;
+        std::uint32_t material;
+        std::int32_t moving; // index in m_Previous and m_Current, -1 when static
+    };
+
+    void createObjects();
+    glm::mat4 movingTransform(std::size_t moving, float alpha, float time) const;
+
+    StressSceneConfig m_Config;
+
+    std::unique_ptr<ShaderVariants> m_LightingVariants;
+    ShaderEngine* m_LightingShader = nullptr;
+    std::unique_ptr<ShaderEngine> m_TeapotShader;
+
+    // One mesh per shape and material, since textures belong to the renderable
+    std::vector<std::unique_ptr<Cube>> m_Cubes;
+    std::vector<std::unique_ptr<Sphere>> m_Spheres;
+    std::vector<float> m_Shininess;
+    ModelHandle m_Teapot;
+    bool m_TeapotShaderSet = false;
+
+    std::vector<Object> m_Objects;         // sorted by shape then material, as a renderer would submit them
+    std::vector<glm::mat4> m_Transforms;   // of every object; moving ones are rebuilt each frame
+    std::vector<glm::vec3> m_Origins;      // of the moving objects
+    std::vector<float> m_Phases;           // of the moving objects
+    std::vector<glm::vec3> m_Previous;     // positions of the moving objects at the previous update
+    std::vector<glm::vec3> m_Current;      // positions of the moving objects at the last update
+    std::vector<std::string> m_LightNames; // "pointLights[i]." prefixes, built once
+
+    float m_Extent = 1.0f;       // half the size of the grid
+    double m_Time = 0.0;         // simulated time at the last update
+    float m_Step = 1.0f / 60.0f; // the last update step, to interpolate the orbits
+    float m_AspectRatio = 16.0f / 9.0f;
+};
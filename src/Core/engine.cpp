@@ -1,15 +1,69 @@
 #include "engine.hpp"
 
+#include <functional>
+#include <memory>
+
 #include <glad/glad.h>
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl2.h>
 
 #include "IGame.hpp"
+#include "allocation_counter.hpp"
+#include "animator.hpp"
+#include "asset_manager.hpp"
+#include "fixed_timestep.hpp"
+#include "frame_time_report.hpp"
+#include "gpu_profiler.hpp"
 #include "input.hpp"
 #include "iostream"
 #include "log.hpp"
+#include "null_gl.hpp"
+#include "offscreen_target.hpp"
+#include "perf_overlay.hpp"
+#include "process_memory.hpp"
+#include "profiler.hpp"
+#include "program_binary_cache.hpp"
+#include "render_stats.hpp"
+#include "render_thread.hpp"
+#include "texture_binder.hpp"
+#include "texture_loader.hpp"
+#include "texture_streamer.hpp"
 #include "time.hpp"
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+/**
+ * A deep copy of the ImGui draw data, which ImGui reuses as soon as the next frame starts.
+ */
+class ImGuiDrawDataCopy
+{
+public:
+    explicit ImGuiDrawDataCopy(const ImDrawData& source) : m_data(source)
+    {
+        m_data.CmdLists.resize(0);
+        for (ImDrawList* list : source.CmdLists)
+            m_data.CmdLists.push_back(list->CloneOutput());
+    }
+
+    ~ImGuiDrawDataCopy()
+    {
+        for (ImDrawList* list : m_data.CmdLists)
+            IM_DELETE(list);
+    }
+
+    ImGuiDrawDataCopy(const ImGuiDrawDataCopy&) = delete;
+    ImGuiDrawDataCopy& operator=(const ImGuiDrawDataCopy&) = delete;
+
+    ImDrawData* get() { return &m_data; }
+
+private:
+    ImDrawData m_data;
+};
+
+} // namespace
 
 void GLAPIENTRY openglDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
                                     const GLchar* message, const void* userParam)
@@ -28,12 +82,27 @@ void Engine::initSDL(const EngineConfig& cfg)
 {
     Logger::Log(LogLevel::Info, "Initializing SDL...", "Engine");
 
+    // SDL's offscreen driver creates its contexts with EGL, on a GPU or on Mesa llvmpipe, without a display.
+    // The dummy driver has no GL at all, the null renderer needs nothing more than events.
+    if (cfg.nullRenderer)
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    else if (cfg.headless)
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
         Logger::Log(LogLevel::Error, std::string("Failed to initialize SDL: ") + SDL_GetError(), "Engine");
+        if (cfg.headless)
+            Logger::Log(LogLevel::Error, "Headless mode needs SDL 2.0.22 or later, built with EGL", "Engine");
         throw std::runtime_error("SDL_Init failed");
     }
 
+    if (cfg.nullRenderer)
+    {
+        initNullRenderer(cfg);
+        return;
+    }
+
 #ifdef DEBUG
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
 #endif
@@ -43,8 +112,10 @@ void Engine::initSDL(const EngineConfig& cfg)
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
 
+    const Uint32 windowFlags = cfg.headless ? SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN
+                                            : SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE;
     m_Window = SDL_CreateWindow(cfg.title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, cfg.width,
-                                cfg.height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+                                cfg.height, windowFlags);
     if (!m_Window)
     {
         Logger::Log(LogLevel::Error, std::string("Failed to create window: ") + SDL_GetError(), "Engine");
@@ -79,37 +150,72 @@ void Engine::initSDL(const EngineConfig& cfg)
         throw std::runtime_error("gladLoadGLLoader failed");
     }
 
+    if (cfg.headless)
+    {
+        // Nothing is presented, frames run as fast as they can.
+        SDL_GL_SetSwapInterval(0);
+        Logger::Log(LogLevel::Info, "Headless: VSYNC disabled", "Engine");
+    }
+    else
+    {
 #ifdef VSYNC
-    SDL_GL_SetSwapInterval(1);
-    Logger::Log(LogLevel::Info, "VSYNC enabled (SDL_GL_SetSwapInterval(1))", "Engine");
+        SDL_GL_SetSwapInterval(1);
+        Logger::Log(LogLevel::Info, "VSYNC enabled (SDL_GL_SetSwapInterval(1))", "Engine");
 #else
-    Logger::Log(LogLevel::Info, "VSYNC disabled", "Engine");
+        Logger::Log(LogLevel::Info, "VSYNC disabled", "Engine");
 #endif
+    }
 
     Logger::Log(LogLevel::Info, "SDL initialization successful.", "Engine");
 }
 
+void Engine::initNullRenderer(const EngineConfig& cfg)
+{
+    m_Window = SDL_CreateWindow(cfg.title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, cfg.width,
+                                cfg.height, SDL_WINDOW_HIDDEN);
+    if (!m_Window)
+    {
+        Logger::Log(LogLevel::Error, std::string("Failed to create window: ") + SDL_GetError(), "Engine");
+        SDL_Quit();
+        throw std::runtime_error("SDL_CreateWindow failed");
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)NullGl::getProcAddress))
+    {
+        Logger::Log(LogLevel::Error, "Failed to load the null renderer with gladLoadGLLoader", "Engine");
+        SDL_DestroyWindow(m_Window);
+        SDL_Quit();
+        throw std::runtime_error("gladLoadGLLoader failed");
+    }
+
+    Logger::Log(LogLevel::Info, "Null renderer: GL calls are counted and dropped", "Engine");
+}
+
 void Engine::initOpenGL()
 {
     Logger::Log(LogLevel::Info, "Initializing OpenGL state...", "Engine");
 
 #ifdef DEBUG
-    if (gladLoadGL())
+    // gladLoadGL() would replace the null renderer with the system's GL.
+    if (!m_Config.nullRenderer)
     {
-        GLint flags;
-        glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
-        if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+        if (gladLoadGL())
         {
-            Logger::Log(LogLevel::Info, "GL_CONTEXT::DEBUG::ACTIVATED", "Engine");
-            glEnable(GL_DEBUG_OUTPUT);
-            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-            glDebugMessageCallback(openglDebugCallback, nullptr);
-            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+            GLint flags;
+            glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+            if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+            {
+                Logger::Log(LogLevel::Info, "GL_CONTEXT::DEBUG::ACTIVATED", "Engine");
+                glEnable(GL_DEBUG_OUTPUT);
+                glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+                glDebugMessageCallback(openglDebugCallback, nullptr);
+                glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+            }
+        }
+        else
+        {
+            Logger::Log(LogLevel::Error, "Failed to initialize GLAD in initOpenGL()", "Engine");
         }
-    }
-    else
-    {
-        Logger::Log(LogLevel::Error, "Failed to initialize GLAD in initOpenGL()", "Engine");
     }
 #endif
 
@@ -146,19 +252,33 @@ void Engine::initImGui()
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+    // Platform windows switch contexts on the calling thread, which the render thread cannot share.
+    if (!m_Config.renderThread && !m_Config.headless && !m_Config.nullRenderer)
+        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
 
     ImGui::StyleColorsDark();
 
-    ImGui_ImplSDL2_InitForOpenGL(m_Window, m_Context);
-    ImGui_ImplOpenGL3_Init();
+    if (m_Config.nullRenderer)
+    {
+        // ImGui's OpenGL backend loads the system's GL itself. Without it, the font atlas is built here.
+        ImGui_ImplSDL2_InitForOther(m_Window);
+        unsigned char* pixels = nullptr;
+        int width = 0, height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+    else
+    {
+        ImGui_ImplSDL2_InitForOpenGL(m_Window, m_Context);
+        ImGui_ImplOpenGL3_Init();
+    }
 
     Logger::Log(LogLevel::Info, "ImGui initialization successful.", "Engine");
 }
 
 void Engine::shutdownImGui()
 {
-    ImGui_ImplOpenGL3_Shutdown();
+    if (!m_Config.nullRenderer)
+        ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
 }
@@ -176,9 +296,69 @@ Engine::Engine(const EngineConfig& cfg)
 {
     m_Config = cfg;
 
+    for (const std::string& pack : m_Config.packFiles)
+        IO::VirtualFileSystem::getInstance().mount(pack);
+
     initSDL(m_Config);
     initOpenGL();
     initImGui();
+
+    m_PerfOverlay = std::make_unique<PerfOverlay>();
+    if (m_Config.headless && !m_Config.nullRenderer)
+    {
+        m_Offscreen = std::make_unique<OffscreenTarget>();
+        m_Offscreen->create(static_cast<int>(m_Config.width), static_cast<int>(m_Config.height));
+    }
+}
+
+void Engine::startRenderThread()
+{
+    // The context can only be current on one thread at a time.
+    if (m_Context)
+        SDL_GL_MakeCurrent(m_Window, nullptr);
+    m_RenderThread = std::make_unique<RenderThread>(m_Window, m_Context);
+    Logger::Log(LogLevel::Info, "Render thread started", "Engine");
+}
+
+void Engine::stopRenderThread()
+{
+    if (!m_RenderThread)
+        return;
+    m_RenderThread.reset();
+    if (m_Context)
+        SDL_GL_MakeCurrent(m_Window, m_Context);
+    Logger::Log(LogLevel::Info, "Render thread stopped", "Engine");
+}
+
+void Engine::writeFrameTimeReport(FrameTimeReport& report, std::uint64_t allocationsPerFrame) const
+{
+    auto glString = [](GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    };
+
+    // The last complete frame; scenes benchmarked this way draw the same every frame.
+    const RenderStats::Frame stats = RenderStats::getInstance().getLastFrame();
+    report.setCounter("drawCalls", static_cast<double>(stats.drawCalls));
+    report.setCounter("triangles", static_cast<double>(stats.triangles));
+    report.setCounter("stateChanges", static_cast<double>(stats.stateChanges));
+    report.setCounter("uniformUploads", static_cast<double>(stats.uniformUploads));
+    report.setCounter("textureBytes", static_cast<double>(stats.textureBytes));
+    report.setCounter("bufferBytes", static_cast<double>(stats.bufferBytes));
+    report.setCounter("peakResidentBytes", static_cast<double>(ProcessMemory::getPeakResidentBytes()));
+    if (AllocationCounter::isEnabled())
+        report.setCounter("allocationsPerFrame", static_cast<double>(allocationsPerFrame));
+
+    std::map<std::string, std::string> info = m_ReportInfo;
+    info.insert({{"title", m_Config.title},
+                 {"width", std::to_string(m_Config.width)},
+                 {"height", std::to_string(m_Config.height)},
+                 {"headless", m_Config.headless ? "true" : "false"},
+                 {"nullRenderer", m_Config.nullRenderer ? "true" : "false"},
+                 {"renderThread", m_Config.renderThread ? "true" : "false"},
+                 {"glRenderer", glString(GL_RENDERER)},
+                 {"glVersion", glString(GL_VERSION)}});
+    report.write(m_Config.frameTimeReport, info);
 }
 
 void Engine::Run(IGame* game)
@@ -192,50 +372,177 @@ void Engine::Run(IGame* game)
     Logger::Log(LogLevel::Info, "Engine::Run() starting", "Engine");
     Logger::Log(LogLevel::Info, "Calling game->OnInit()", "Engine");
     game->OnInit(*this);
+    ProgramBinaryCache::getInstance().logStats();
+
+    // Creates the ImGui font texture while this thread still owns the context.
+    if (!m_Config.nullRenderer)
+        ImGui_ImplOpenGL3_NewFrame();
+    if (m_Config.renderThread)
+        startRenderThread();
+
+    PROFILE_THREAD("Main");
+    if (!m_Config.profilerTrace.empty())
+    {
+#ifdef LAMB_PROFILER
+        Profiler::getInstance().start();
+        GpuProfiler::getInstance().setEnabled(true);
+#else
+        Logger::Log(LogLevel::Warning, "profilerTrace is set but the profiler is compiled out (ENABLE_PROFILER)",
+                    "Engine");
+#endif
+    }
+    m_PerfOverlay->setVisible(m_Config.perfOverlay);
+    if (!m_Config.screenshot.empty() && !m_Offscreen)
+        Logger::Log(LogLevel::Warning, "screenshot is only written in headless mode", "Engine");
+
+    FrameTimeReport report;
+    report.reserve(m_Config.frameLimit);
+
+    InputSystem& input = *InputSystem::getInstance();
+    if (!m_Config.inputReplay.empty())
+    {
+        try
+        {
+            InputRecording recording = InputRecording::read(m_Config.inputReplay);
+            Logger::Log(LogLevel::Info,
+                        "Replaying " + std::to_string(recording.size()) + " frames of input from " +
+                            m_Config.inputReplay,
+                        "Engine");
+            input.startReplay(std::move(recording));
+        }
+        catch (const std::exception& e)
+        {
+            Logger::Log(LogLevel::Error, e.what(), "Engine");
+            throw;
+        }
+    }
+    if (!m_Config.inputRecording.empty())
+        input.startRecording();
+
+    // GL work on objects the game also reads. With a render thread, it runs there while the game waits.
+    const std::function<void()> synchronize = []() {
+        PROFILE_ZONE("Synchronize");
+        GPU_PROFILE_ZONE("Uploads");
+        AssetManager::getInstance().update();
+        TextureLoader::getInstance().update();
+        TextureStreamer::getInstance().update();
+        // Uploads above bound textures behind the binder's back.
+        TextureBinder::getInstance().reset();
+        AnimationSystem::getInstance().upload();
+    };
+
+    FixedTimestep timestep(m_Config.updateRate, m_Config.maxUpdateSteps);
+    const float step = static_cast<float>(timestep.getStep());
 
     bool running = true;
     int frameCount = 0;
+    const std::uint64_t allocationsAtStart = AllocationCounter::getCount();
 
     while (running)
     {
-        InputSystem::getInstance()->update(m_Window);
-        if (InputSystem::getInstance()->shouldStop())
+        PROFILE_FRAME();
+        PROFILE_ZONE("Frame");
+
+        Time::getInstance().computeDeltaTime();
+        input.update(m_Window, Time::getInstance().getFrameTime());
+        if (input.shouldStop())
         {
             Logger::Log(LogLevel::Info, "InputSystem requested stop, leaving main loop", "Engine");
             running = false;
             break;
         }
+        if (input.isReplayFinished())
+        {
+            Logger::Log(LogLevel::Info, "Input replay finished, leaving main loop", "Engine");
+            break;
+        }
 
-        Time::getInstance().computeDeltaTime();
-        float dt = Time::getInstance().getDeltaTime();
+        // The simulation advances by the replayed frame times when replaying, so it repeats exactly.
+        float dt = static_cast<float>(input.getFrameTime());
+        timestep.advance(input.getFrameTime());
+        m_PerfOverlay->record(Time::getInstance().getFrameTime());
+        // The first call measures nothing, later ones the previous frame.
+        if (frameCount > 0)
+            report.add(Time::getInstance().getFrameTime());
+
+        if (m_Config.frameLimit != 0 && frameCount == static_cast<int>(m_Config.frameLimit))
+        {
+            Logger::Log(LogLevel::Info, "Frame limit reached, leaving main loop", "Engine");
+            break;
+        }
 
         if ((frameCount++ % 300) == 0)
         {
             Logger::Log(LogLevel::Info, "Frame " + std::to_string(frameCount) + " dt=" + std::to_string(dt), "Engine");
         }
 
-        ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
+        if (ImGui::IsKeyPressed(ImGuiKey_F3, false))
+            m_PerfOverlay->toggle();
 
-        game->OnUpdate(*this, dt);
+        {
+            PROFILE_ZONE("OnUpdate");
+            while (timestep.step())
+                game->OnUpdate(*this, step);
+        }
+        // Animation is presentation: it advances by the real frame time, so poses stay smooth.
+        AnimationSystem::getInstance().update(dt);
+
+        RenderCommandList& commands = m_RenderThread ? m_RenderThread->commands() : m_Commands;
+        commands.call([offscreen = m_Offscreen.get()]() {
+            RenderStats::getInstance().beginFrame();
+            if (offscreen)
+                offscreen->bind();
+            GPU_PROFILE_FRAME();
+            GPU_PROFILE_BEGIN("Scene");
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+            glStencilFunc(GL_ALWAYS, 1, 0xFF);
+            glStencilMask(0xFF);
+            glBindVertexArray(0);
+        });
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        {
+            PROFILE_ZONE("OnRender");
+            game->OnRender(*this, commands, timestep.getAlpha());
+            commands.call([]() { GPU_PROFILE_END(); });
+        }
 
-        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-        glStencilFunc(GL_ALWAYS, 1, 0xFF);
-        glStencilMask(0xFF);
-        glBindVertexArray(0);
+        {
+            PROFILE_ZONE("ImGui");
+            m_PerfOverlay->draw();
+            ImGui::Render();
+            // The next NewFrame() reuses the draw lists, so the render thread gets its own copy.
+            auto drawData = std::make_shared<ImGuiDrawDataCopy>(*ImGui::GetDrawData());
+            commands.call([drawData, render = !m_Config.nullRenderer]() {
+                PROFILE_ZONE("ImGui render");
+                GPU_PROFILE_ZONE("ImGui");
+                if (!render)
+                    return;
+                ImGui_ImplOpenGL3_NewFrame();
+                ImGui_ImplOpenGL3_RenderDrawData(drawData->get());
+            });
+        }
 
-        game->OnRender(*this);
+        if (m_RenderThread)
+        {
+            PROFILE_ZONE("Submit");
+            m_RenderThread->submit(synchronize);
+            continue;
+        }
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        synchronize();
+        commands.execute();
+        commands.reset();
 
         ImGuiIO& io = ImGui::GetIO();
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
+            PROFILE_ZONE("Viewports");
+            GPU_PROFILE_ZONE("Viewports");
             SDL_Window* backup_current_window = SDL_GL_GetCurrentWindow();
             SDL_GLContext backup_current_context = SDL_GL_GetCurrentContext();
 
@@ -245,15 +552,64 @@ void Engine::Run(IGame* game)
             SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
         }
 
-        SDL_GL_SwapWindow(m_Window);
+        PROFILE_ZONE("Swap");
+        if (m_Context)
+            SDL_GL_SwapWindow(m_Window);
     }
 
+    stopRenderThread();
+    m_PerfOverlay->setVisible(false);
+    if (!m_Config.inputRecording.empty())
+    {
+        try
+        {
+            const InputRecording recording = input.stopRecording();
+            recording.write(m_Config.inputRecording);
+            Logger::Log(LogLevel::Info,
+                        "Recorded " + std::to_string(recording.size()) + " frames of input to " +
+                            m_Config.inputRecording,
+                        "Engine");
+        }
+        catch (const std::exception& e)
+        {
+            Logger::Log(LogLevel::Error, e.what(), "Engine");
+        }
+    }
+    if (!m_Config.frameTimeReport.empty())
+    {
+        const std::uint64_t allocations = AllocationCounter::getCount() - allocationsAtStart;
+        writeFrameTimeReport(report, frameCount > 0 ? allocations / frameCount : 0);
+    }
+    if (m_Offscreen && !m_Config.screenshot.empty())
+        m_Offscreen->writePng(m_Config.screenshot);
+    if (Profiler::getInstance().isCapturing())
+    {
+        Profiler::getInstance().stop();
+        Profiler::getInstance().writeChromeTrace(m_Config.profilerTrace);
+    }
+    if (timestep.getDroppedTime() > 0.0)
+        Logger::Log(LogLevel::Warning,
+                    "Simulation fell behind, dropped " + std::to_string(timestep.getDroppedTime()) + " s of frame time",
+                    "Engine");
+    AssetManager::getInstance().logStats();
+    IO::VirtualFileSystem::getInstance().logStats();
+    if (m_Config.nullRenderer)
+        Logger::Log(LogLevel::Info, "Null renderer dropped " + std::to_string(NullGl::getCallCount()) + " GL calls",
+                    "Engine");
     Logger::Log(LogLevel::Info, "Engine::Run() exiting main loop", "Engine");
 }
 
 Engine::~Engine()
 {
     Logger::Log(LogLevel::Info, "Engine destructor: shutting down subsystems.", "Engine");
+    stopRenderThread();
+    AssetManager::getInstance().shutdown();
+    TextureLoader::getInstance().shutdown();
+    TextureStreamer::getInstance().shutdown();
+    AnimationSystem::getInstance().shutdown();
+    GpuProfiler::getInstance().shutdown();
+    if (m_Offscreen)
+        m_Offscreen->destroy();
     shutdownImGui();
     shutdownSDL();
     Logger::Log(LogLevel::Info, "Engine shutdown complete.", "Engine");
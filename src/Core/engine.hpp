@@ -2,7 +2,13 @@
 
 #include <SDL2/SDL.h>
 
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "render_command_list.hpp"
 #include "string"
+#include "vector"
 
 struct EngineConfig
 {
@@ -12,9 +18,26 @@ struct EngineConfig
     bool vsync = true;
     bool enablePhysics = false;
     bool enableImGui = true;
+    bool renderThread = true; // executes OnRender's commands on a render thread, one frame behind the game
+    double updateRate = 60.0; // OnUpdate calls per simulated second
+    int maxUpdateSteps = 5;   // OnUpdate calls per frame at most; the game slows down past that
+    std::string profilerTrace; // when set, profiles the whole run and writes a Chrome trace there on exit
+    bool perfOverlay = false;  // shows the performance overlay from the start; F3 toggles it
+    bool headless = false;       // no window: renders offscreen on an EGL context with vsync off
+    unsigned int frameLimit = 0; // leaves the main loop after this many frames, 0 runs until quit
+    std::string frameTimeReport; // when set, writes frame time statistics there as JSON on exit
+    std::string screenshot;      // headless only: writes the last frame there as a PNG on exit
+    bool nullRenderer = false;   // no GPU at all: GL calls are counted and dropped, for CPU benchmarks
+    std::string inputRecording;  // when set, records the keyboard, mouse and frame times there on exit
+    std::string inputReplay;     // when set, replays that recording instead of live input, then exits
+    std::vector<std::string> packFiles; // mounted in order, later packs shadow earlier ones
 };
 
+class FrameTimeReport;
 class IGame;
+class OffscreenTarget;
+class PerfOverlay;
+class RenderThread;
 
 class Engine
 {
@@ -24,16 +47,29 @@ public:
 
     void Run(IGame* game);
 
+    float GetAspectRatio() const { return m_AspectRatio; }
+    // Stored under "info" in the frame time report, e.g. the parameters of a benchmark scene.
+    void SetReportInfo(const std::string& key, const std::string& value) { m_ReportInfo[key] = value; }
+
 private:
     void initSDL(const EngineConfig& cfg);
+    void initNullRenderer(const EngineConfig& cfg);
     void initOpenGL();
     void initImGui();
     void shutdownImGui();
     void shutdownSDL();
+    void startRenderThread();
+    void stopRenderThread();
+    void writeFrameTimeReport(FrameTimeReport& report, std::uint64_t allocationsPerFrame) const;
 
     EngineConfig m_Config;
 
     SDL_Window* m_Window = nullptr;
     SDL_GLContext m_Context = nullptr;
+    std::unique_ptr<RenderThread> m_RenderThread; // null when frames execute on the main thread
+    RenderCommandList m_Commands;                 // the frame, when there is no render thread
+    std::unique_ptr<PerfOverlay> m_PerfOverlay;   // frame times, render counters and zone timings, F3
+    std::unique_ptr<OffscreenTarget> m_Offscreen; // what frames render into when headless, null otherwise
     float m_AspectRatio = 16.0f / 9.0f;
+    std::map<std::string, std::string> m_ReportInfo; // set by the game with SetReportInfo
 };
@@ -0,0 +1,96 @@
+#include "animation_clip.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+/**
+ * Finds the keys around a time: the last key at or before it and the weight of the next one.
+ */
+template <typename T>
+std::size_t locate(const std::vector<AnimationKey<T>>& keys, float time, float& weight)
+{
+    weight = 0.0f;
+    if (time <= keys.front().time)
+        return 0;
+    if (time >= keys.back().time)
+        return keys.size() - 1;
+
+    auto next = std::upper_bound(keys.begin(), keys.end(), time,
+                                 [](float t, const AnimationKey<T>& key) { return t < key.time; });
+    const std::size_t index = static_cast<std::size_t>(next - keys.begin()) - 1;
+    const float span = keys[index + 1].time - keys[index].time;
+    weight = span > 0.0f ? (time - keys[index].time) / span : 0.0f;
+    return index;
+}
+
+glm::vec3 interpolate(const std::vector<AnimationKey<glm::vec3>>& keys, float time)
+{
+    float weight;
+    const std::size_t index = locate(keys, time, weight);
+    if (weight == 0.0f)
+        return keys[index].value;
+    return glm::mix(keys[index].value, keys[index + 1].value, weight);
+}
+
+glm::quat interpolate(const std::vector<AnimationKey<glm::quat>>& keys, float time)
+{
+    float weight;
+    const std::size_t index = locate(keys, time, weight);
+    if (weight == 0.0f)
+        return keys[index].value;
+    // glm::slerp takes the shortest path, flipping the second key if needed.
+    return glm::normalize(glm::slerp(keys[index].value, keys[index + 1].value, weight));
+}
+
+} // namespace
+
+AnimationClip::AnimationClip(std::string name, float duration, std::vector<AnimationChannel> channels)
+    : m_name(std::move(name)), m_duration(duration), m_channels(std::move(channels))
+{
+}
+
+std::shared_ptr<const AnimationClip> AnimationClip::compress(const AnimationClip& clip,
+                                                            const CompressionSettings& settings)
+{
+    auto compressed = std::make_shared<AnimationClip>(clip.m_name, clip.m_duration, std::vector<AnimationChannel>());
+    compressed->m_compressed = std::make_shared<const CompressedClip>(clip.m_channels, clip.m_duration, settings);
+    return compressed;
+}
+
+void AnimationClip::sample(float time, std::vector<JointPose>& pose) const
+{
+    if (m_compressed)
+    {
+        m_compressed->sample(time, pose);
+        return;
+    }
+
+    for (const AnimationChannel& channel : m_channels)
+    {
+        JointPose& joint = pose[channel.joint];
+        if (!channel.translations.empty())
+            joint.translation = interpolate(channel.translations, time);
+        if (!channel.rotations.empty())
+            joint.rotation = interpolate(channel.rotations, time);
+        if (!channel.scales.empty())
+            joint.scale = interpolate(channel.scales, time);
+    }
+}
+
+std::size_t AnimationClip::memoryUsage() const
+{
+    if (m_compressed)
+        return m_compressed->memoryUsage();
+
+    std::size_t bytes = m_channels.capacity() * sizeof(AnimationChannel);
+    for (const AnimationChannel& channel : m_channels)
+    {
+        bytes += channel.translations.capacity() * sizeof(AnimationKey<glm::vec3>);
+        bytes += channel.rotations.capacity() * sizeof(AnimationKey<glm::quat>);
+        bytes += channel.scales.capacity() * sizeof(AnimationKey<glm::vec3>);
+    }
+    return bytes;
+}
@@ -0,0 +1,123 @@
+#ifndef ANIMATION_CLIP_HPP_
+#define ANIMATION_CLIP_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "compressed_clip.hpp"
+#include "skeleton.hpp"
+
+/**
+ * @struct AnimationKey
+ * @brief A value of an animation curve at a point in time.
+ */
+template <typename T> struct AnimationKey
+{
+    float time = 0.0f; /**< Time of the key, in seconds. */
+    T value;           /**< Value at that time. */
+};
+
+/**
+ * @struct AnimationChannel
+ * @brief The curves animating one joint, each with keys sorted by time.
+ *
+ * An empty curve leaves that part of the joint at its bind pose.
+ */
+struct AnimationChannel
+{
+    int joint = -1;                                    /**< Index of the joint in the skeleton. */
+    std::vector<AnimationKey<glm::vec3>> translations; /**< Translation keys. */
+    std::vector<AnimationKey<glm::quat>> rotations;    /**< Rotation keys. */
+    std::vector<AnimationKey<glm::vec3>> scales;       /**< Scale keys. */
+};
+
+/**
+ * @class AnimationClip
+ * @brief A skeletal animation, sampled into joint poses.
+ *
+ * Immutable once built, so one clip can be sampled by any number of animators
+ * from any number of threads. A clip either keeps its channels as they were
+ * imported, or only their CompressedClip form once built by compress().
+ */
+class AnimationClip
+{
+public:
+    /**
+     * @brief Creates a clip.
+     *
+     * @param name The clip name.
+     * @param duration The length of the clip, in seconds.
+     * @param channels One channel per animated joint.
+     */
+    AnimationClip(std::string name, float duration, std::vector<AnimationChannel> channels);
+
+    /**
+     * @brief Builds the compressed version of a clip.
+     *
+     * @param clip The clip, with its channels.
+     * @param settings The tolerances and segment length.
+     * @return A clip holding only the compressed data.
+     */
+    static std::shared_ptr<const AnimationClip> compress(const AnimationClip& clip,
+                                                         const CompressionSettings& settings = CompressionSettings());
+
+    /**
+     * @brief Samples the clip.
+     *
+     * Joints without a channel keep the pose they have in pose. Keys are
+     * interpolated linearly, rotations with a shortest path slerp, and times
+     * outside the keys hold the first or last key.
+     *
+     * @param time The time, in seconds.
+     * @param pose The pose to update, one entry per skeleton joint.
+     */
+    void sample(float time, std::vector<JointPose>& pose) const;
+
+    /**
+     * @brief Gets the name of the clip.
+     *
+     * @return The name.
+     */
+    const std::string& getName() const { return m_name; }
+
+    /**
+     * @brief Gets the length of the clip.
+     *
+     * @return The duration, in seconds.
+     */
+    float getDuration() const { return m_duration; }
+
+    /**
+     * @brief Gets the channels of the clip.
+     *
+     * @return One channel per animated joint, empty for compressed clips.
+     */
+    const std::vector<AnimationChannel>& getChannels() const { return m_channels; }
+
+    /**
+     * @brief Tells whether the clip was built by compress().
+     *
+     * @return true if the clip holds compressed data instead of channels.
+     */
+    bool isCompressed() const { return m_compressed != nullptr; }
+
+    /**
+     * @brief Gets the memory held by the keys of the clip.
+     *
+     * @return The size, in bytes.
+     */
+    std::size_t memoryUsage() const;
+
+private:
+    std::string m_name;                                 /**< The clip name. */
+    float m_duration;                                   /**< The length, in seconds. */
+    std::vector<AnimationChannel> m_channels;           /**< The channels, empty once compressed. */
+    std::shared_ptr<const CompressedClip> m_compressed; /**< The compressed data, if any. */
+};
+
+#endif
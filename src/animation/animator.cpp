@@ -0,0 +1,152 @@
+#include "animator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "model.hpp"
+#include "profiler.hpp"
+#include "render_stats.hpp"
+#include "thread_pool.hpp"
+
+Animator::Animator(const Model& model) : m_model(model), m_skeleton(model.getSkeleton())
+{
+    if (!m_skeleton)
+        throw std::invalid_argument("Animator created for a model without skeleton");
+
+    m_skeleton->bindPose(m_pose);
+    m_palette.resize(m_skeleton->size());
+    m_skeleton->computePalette(m_pose, m_globals, m_palette.data());
+    m_skinned.resize(model.getMeshCount());
+    m_published.resize(model.getMeshCount());
+
+    AnimationSystem::getInstance().add(*this);
+}
+
+Animator::~Animator()
+{
+    AnimationSystem::getInstance().remove(*this);
+}
+
+void Animator::play(std::shared_ptr<const AnimationClip> clip, bool loop, float speed)
+{
+    m_clip = std::move(clip);
+    m_loop = loop;
+    m_speed = speed;
+    m_time = 0.0f;
+}
+
+void Animator::update(float dt)
+{
+    if (!m_clip)
+        return;
+
+    const float duration = m_clip->getDuration();
+    m_time += dt * m_speed;
+    if (m_loop && duration > 0.0f)
+    {
+        m_time = std::fmod(m_time, duration);
+        if (m_time < 0.0f)
+            m_time += duration;
+    }
+    else
+    {
+        m_time = std::clamp(m_time, 0.0f, duration);
+    }
+
+    m_skeleton->bindPose(m_pose);
+    m_clip->sample(m_time, m_pose);
+    m_skeleton->computePalette(m_pose, m_globals, m_palette.data());
+}
+
+void Animator::skin()
+{
+    for (std::size_t i = 0; i < m_skinned.size(); ++i)
+    {
+        const Renderable& mesh = m_model.getMesh(i);
+        if (!mesh.isSkinned())
+            continue;
+
+        const std::vector<Vertex>& bind = mesh.getVertexData();
+        std::vector<Vertex>& skinned = m_skinned[i];
+        // Copied once per buffer, later frames only rewrite positions and normals.
+        if (skinned.size() != bind.size())
+            skinned = bind;
+        skinVertices(bind.data(), bind.size(), m_palette.data(), skinned.data());
+    }
+}
+
+void AnimationSystem::add(Animator& animator)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_animators.push_back(&animator);
+}
+
+void AnimationSystem::remove(Animator& animator)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_animators.erase(std::remove(m_animators.begin(), m_animators.end(), &animator), m_animators.end());
+}
+
+void AnimationSystem::update(float dt)
+{
+    PROFILE_ZONE("AnimationSystem::update");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool cpu = m_mode == SkinningMode::CPU;
+    ThreadPool::getInstance().parallelFor(m_animators.size(), [&](std::size_t i) {
+        PROFILE_ZONE("Animator::update");
+        Animator& animator = *m_animators[i];
+        animator.update(dt);
+        if (cpu)
+            animator.skin();
+    });
+}
+
+void AnimationSystem::upload()
+{
+    PROFILE_ZONE("AnimationSystem::upload");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_mode == SkinningMode::CPU)
+    {
+        for (Animator* animator : m_animators)
+            std::swap(animator->m_skinned, animator->m_published);
+        return;
+    }
+    if (m_animators.empty())
+        return;
+
+    m_staging.clear();
+    for (Animator* animator : m_animators)
+    {
+        animator->m_paletteOffset = static_cast<int>(m_staging.size());
+        m_staging.insert(m_staging.end(), animator->m_palette.begin(), animator->m_palette.end());
+    }
+
+    if (m_buffer == 0)
+        glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    if (m_staging.size() > m_capacity)
+    {
+        const std::size_t capacity = m_staging.size() + m_staging.size() / 2;
+        const std::size_t added = (capacity - m_capacity) * sizeof(glm::mat4);
+        RenderStats::getInstance().addBufferMemory(static_cast<std::int64_t>(added));
+        m_capacity = capacity;
+    }
+    // Respecifying the storage orphans it, so the driver does not wait for draws still reading last frame's palettes.
+    glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_staging.size() * sizeof(glm::mat4), m_staging.data());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BONE_PALETTE_BINDING, m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void AnimationSystem::shutdown()
+{
+    if (m_buffer != 0)
+    {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    RenderStats::getInstance().addBufferMemory(-static_cast<std::int64_t>(m_capacity * sizeof(glm::mat4)));
+    m_capacity = 0;
+}
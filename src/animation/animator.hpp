@@ -0,0 +1,204 @@
+#ifndef ANIMATOR_HPP_
+#define ANIMATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "animation_clip.hpp"
+#include "renderable.hpp"
+#include "skeleton.hpp"
+#include "skinning.hpp"
+
+class Model;
+
+/**
+ * @class Animator
+ * @brief Plays clips on one instance of a skinned model.
+ *
+ * Every animator registers itself with the AnimationSystem, which advances,
+ * samples and skins all of them in parallel once per frame. Several animators
+ * can share one Model; draw it with Model::draw(const Animator&, const glm::mat4&).
+ */
+class Animator
+{
+public:
+    /**
+     * @brief Creates an animator in the bind pose.
+     *
+     * @param model The skinned model, which must outlive the animator.
+     *
+     * @throw std::invalid_argument If the model has no skeleton.
+     */
+    explicit Animator(const Model& model);
+    ~Animator();
+
+    Animator(const Animator&) = delete;
+    Animator& operator=(const Animator&) = delete;
+
+    /**
+     * @brief Starts a clip from its beginning.
+     *
+     * @param clip The clip, or nullptr for the bind pose.
+     * @param loop Whether the clip wraps around at its end instead of holding the last pose.
+     * @param speed Playback rate, 1 for real time.
+     */
+    void play(std::shared_ptr<const AnimationClip> clip, bool loop = true, float speed = 1.0f);
+
+    /**
+     * @brief Advances the clip and computes the pose and skinning matrices.
+     *
+     * Called by AnimationSystem::update(); thread safe against other animators.
+     *
+     * @param dt Elapsed time, in seconds.
+     */
+    void update(float dt);
+
+    /**
+     * @brief Skins every skinned mesh of the model with the current palette.
+     */
+    void skin();
+
+    /**
+     * @brief Gets the current playback time.
+     *
+     * @return The time in the clip, in seconds.
+     */
+    float getTime() const { return m_time; }
+
+    /**
+     * @brief Gets the skinning matrices of the current pose.
+     *
+     * @return One matrix per skeleton joint.
+     */
+    const std::vector<glm::mat4>& getPalette() const { return m_palette; }
+
+    /**
+     * @brief Gets where the palette starts in the bone palette buffer.
+     *
+     * @return The index of the first matrix, set by AnimationSystem::upload().
+     */
+    int getPaletteOffset() const { return m_paletteOffset; }
+
+    /**
+     * @brief Gets the vertices skinned on the CPU for a mesh of the model.
+     *
+     * Returns the vertices published by the last AnimationSystem::upload(), so
+     * a frame can draw them while update() skins the next one.
+     *
+     * @param mesh The mesh index in the model.
+     * @return The skinned vertices, empty for meshes without bone weights or in GPU mode.
+     */
+    const std::vector<Vertex>& getSkinnedVertices(std::size_t mesh) const { return m_published[mesh]; }
+
+private:
+    friend class AnimationSystem;
+
+    const Model& m_model;                         /**< The animated model. */
+    std::shared_ptr<const Skeleton> m_skeleton;   /**< The skeleton of the model. */
+    std::shared_ptr<const AnimationClip> m_clip;  /**< The clip playing, if any. */
+    float m_time = 0.0f;                          /**< Playback time, in seconds. */
+    float m_speed = 1.0f;                         /**< Playback rate. */
+    bool m_loop = true;                           /**< Whether the clip wraps around. */
+    std::vector<JointPose> m_pose;                /**< Local pose of every joint. */
+    std::vector<glm::mat4> m_globals;             /**< Scratch space for the global joint transforms. */
+    std::vector<glm::mat4> m_palette;             /**< Skinning matrices of the pose. */
+    std::vector<std::vector<Vertex>> m_skinned;   /**< CPU skinned vertices being written, per mesh. */
+    std::vector<std::vector<Vertex>> m_published; /**< CPU skinned vertices being drawn, per mesh. */
+    int m_paletteOffset = 0;                      /**< First matrix in the bone palette buffer. */
+};
+
+/**
+ * @class AnimationSystem
+ * @brief Updates every Animator once per frame and feeds the skinning paths.
+ *
+ * update() samples the pose of every animator in parallel on the ThreadPool,
+ * and in CPU mode skins its meshes in the same job. upload() then packs every
+ * palette into one shader storage buffer bound at BONE_PALETTE_BINDING for GPU
+ * skinning, so a whole crowd costs one buffer update per frame, or publishes
+ * the CPU skinned vertices to the draws.
+ */
+class AnimationSystem
+{
+public:
+    /**
+     * @brief Binding point of the bone palette shader storage buffer.
+     */
+    static constexpr GLuint BONE_PALETTE_BINDING = 3;
+
+    /**
+     * @brief Gets the singleton instance of AnimationSystem.
+     *
+     * @return The AnimationSystem instance.
+     */
+    static AnimationSystem& getInstance()
+    {
+        static AnimationSystem instance;
+        return instance;
+    }
+
+    AnimationSystem(const AnimationSystem&) = delete;
+    AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+    /**
+     * @brief Selects where skinned models are transformed.
+     *
+     * @param mode The skinning mode, GPU by default.
+     */
+    void setSkinningMode(SkinningMode mode) { m_mode = mode; }
+
+    /**
+     * @brief Gets where skinned models are transformed.
+     *
+     * @return The skinning mode.
+     */
+    SkinningMode getSkinningMode() const { return m_mode; }
+
+    /**
+     * @brief Advances, samples and, in CPU mode, skins every animator in parallel.
+     *
+     * @param dt Elapsed time, in seconds.
+     */
+    void update(float dt);
+
+    /**
+     * @brief Uploads every palette to the bone palette buffer in GPU mode, or publishes the CPU skinned
+     * vertices in CPU mode. Must run on the context thread, while update() is not running.
+     */
+    void upload();
+
+    /**
+     * @brief Releases the bone palette buffer. Must run on the context thread.
+     */
+    void shutdown();
+
+    /**
+     * @brief Gets the number of registered animators.
+     *
+     * @return The animator count.
+     */
+    std::size_t animatorCount() const { return m_animators.size(); }
+
+private:
+    friend class Animator;
+
+    AnimationSystem() = default;
+    ~AnimationSystem() = default;
+
+    void add(Animator& animator);
+    void remove(Animator& animator);
+
+    SkinningMode m_mode = SkinningMode::GPU; /**< Where skinned models are transformed. */
+    std::mutex m_mutex;                      /**< Guards m_animators. */
+    std::vector<Animator*> m_animators;      /**< Registered animators. */
+    std::vector<glm::mat4> m_staging;        /**< Every palette, in buffer order. */
+    GLuint m_buffer = 0;                     /**< The bone palette shader storage buffer. */
+    std::size_t m_capacity = 0;              /**< Size of m_buffer, in matrices. */
+};
+
+#endif
@@ -0,0 +1,367 @@
+#include "compressed_clip.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "animation_clip.hpp"
+
+namespace
+{
+
+constexpr float SQRT1_2 = 0.70710678f;
+constexpr float ROTATION_STEPS = 32767.0f;
+constexpr float RANGE_STEPS = 65535.0f;
+constexpr float TIME_STEPS = 65535.0f;
+
+/**
+ * A key of any track, with rotations as xyzw and vectors with a zero w.
+ */
+struct Key
+{
+    float time;
+    glm::vec4 value;
+};
+
+glm::quat toQuat(const glm::vec4& value)
+{
+    return glm::quat(value.w, value.x, value.y, value.z);
+}
+
+/**
+ * Linear interpolation, or for rotations the normalized lerp along the shortest path that sampling uses.
+ */
+glm::vec4 interpolate(const glm::vec4& a, glm::vec4 b, float weight, bool rotation)
+{
+    if (!rotation)
+        return glm::mix(a, b, weight);
+    if (glm::dot(a, b) < 0.0f)
+        b = -b;
+    return glm::normalize(glm::mix(a, b, weight));
+}
+
+/**
+ * Distance between two vectors, or the angle between two rotations.
+ */
+float distance(const glm::vec4& a, const glm::vec4& b, bool rotation)
+{
+    if (!rotation)
+        return glm::length(a - b);
+    // The chord between unit quaternions is 2 sin(angle / 4), which stays precise for small angles.
+    const float chord = std::min(glm::length(a - b), glm::length(a + b));
+    return 4.0f * std::asin(std::min(1.0f, chord * 0.5f));
+}
+
+glm::vec4 evaluate(const std::vector<Key>& keys, float time, bool rotation)
+{
+    if (time <= keys.front().time)
+        return keys.front().value;
+    if (time >= keys.back().time)
+        return keys.back().value;
+
+    auto next = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const Key& key) { return t < key.time; });
+    const Key& before = *(next - 1);
+    const float span = next->time - before.time;
+    return interpolate(before.value, next->value, span > 0.0f ? (time - before.time) / span : 0.0f, rotation);
+}
+
+std::vector<Key> gather(const std::vector<AnimationKey<glm::vec3>>& source)
+{
+    std::vector<Key> keys;
+    keys.reserve(source.size());
+    for (const auto& key : source)
+        keys.push_back({key.time, glm::vec4(key.value, 0.0f)});
+    return keys;
+}
+
+std::vector<Key> gather(const std::vector<AnimationKey<glm::quat>>& source)
+{
+    std::vector<Key> keys;
+    keys.reserve(source.size());
+    for (const auto& key : source)
+    {
+        const glm::quat rotation = glm::normalize(key.value);
+        glm::vec4 value(rotation.x, rotation.y, rotation.z, rotation.w);
+        // Keeps neighbours in the same hemisphere, so the error measured between them is the real one.
+        if (!keys.empty() && glm::dot(keys.back().value, value) < 0.0f)
+            value = -value;
+        keys.push_back({key.time, value});
+    }
+    return keys;
+}
+
+/**
+ * Removes the keys that interpolating their neighbours rebuilds within tolerance (Ramer-Douglas-Peucker).
+ */
+std::vector<Key> simplify(const std::vector<Key>& keys, float tolerance, bool rotation)
+{
+    std::vector<bool> keep(keys.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    std::vector<std::pair<std::size_t, std::size_t>> spans{{0, keys.size() - 1}};
+    while (!spans.empty())
+    {
+        const auto [first, last] = spans.back();
+        spans.pop_back();
+
+        const float span = keys[last].time - keys[first].time;
+        float worst = tolerance;
+        std::size_t split = 0;
+        for (std::size_t i = first + 1; i < last; ++i)
+        {
+            const float weight = span > 0.0f ? (keys[i].time - keys[first].time) / span : 0.0f;
+            const glm::vec4 rebuilt = interpolate(keys[first].value, keys[last].value, weight, rotation);
+            const float error = distance(rebuilt, keys[i].value, rotation);
+            if (error > worst)
+            {
+                worst = error;
+                split = i;
+            }
+        }
+
+        if (split != 0)
+        {
+            keep[split] = true;
+            spans.push_back({first, split});
+            spans.push_back({split, last});
+        }
+    }
+
+    std::vector<Key> kept;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        if (keep[i])
+            kept.push_back(keys[i]);
+    }
+    return kept;
+}
+
+std::uint16_t quantizeUnit(float value, float steps)
+{
+    return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * steps));
+}
+
+} // namespace
+
+void quantizeRotation(const glm::quat& rotation, std::uint16_t packed[3])
+{
+    const float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+        if (std::abs(components[i]) > std::abs(components[largest]))
+            largest = i;
+    }
+    // q and -q are the same rotation, so the dropped component is always made positive.
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    std::uint64_t bits = static_cast<std::uint64_t>(largest);
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        const float unit = (components[i] * sign / SQRT1_2 + 1.0f) * 0.5f;
+        bits = (bits << 15) | quantizeUnit(unit, ROTATION_STEPS);
+    }
+
+    packed[0] = static_cast<std::uint16_t>(bits >> 32);
+    packed[1] = static_cast<std::uint16_t>(bits >> 16);
+    packed[2] = static_cast<std::uint16_t>(bits);
+}
+
+glm::quat dequantizeRotation(const std::uint16_t packed[3])
+{
+    const std::uint64_t bits = (static_cast<std::uint64_t>(packed[0]) << 32) |
+                               (static_cast<std::uint64_t>(packed[1]) << 16) | packed[2];
+    const int largest = static_cast<int>((bits >> 45) & 3);
+
+    float components[4];
+    float sum = 0.0f;
+    int shift = 30;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        const float unit = static_cast<float>((bits >> shift) & 0x7FFF) / ROTATION_STEPS;
+        components[i] = (unit * 2.0f - 1.0f) * SQRT1_2;
+        sum += components[i] * components[i];
+        shift -= 15;
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+CompressedClip::CompressedClip(const std::vector<AnimationChannel>& channels, float duration,
+                               const CompressionSettings& settings)
+    : m_duration(std::max(duration, 0.0f))
+{
+    const std::size_t segments =
+        std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_duration / settings.segmentDuration - 1e-4f)));
+    m_segmentDuration = m_duration > 0.0f ? m_duration / static_cast<float>(segments) : 1.0f;
+
+    // Simplified keys of the tracks in m_tracks, in the same order.
+    std::vector<std::vector<Key>> curves;
+
+    const auto addTrack = [&](int joint, TrackType type, std::vector<Key> keys) {
+        if (keys.empty())
+            return;
+
+        const bool rotation = type == TrackType::Rotation;
+        const float tolerance = type == TrackType::Translation ? settings.translationTolerance
+                                : rotation                     ? settings.rotationTolerance
+                                                               : settings.scaleTolerance;
+
+        const bool constant = std::all_of(keys.begin(), keys.end(), [&](const Key& key) {
+            return distance(key.value, keys.front().value, rotation) <= tolerance;
+        });
+        if (constant)
+        {
+            m_constants.push_back({static_cast<std::uint16_t>(joint), type, keys.front().value});
+            return;
+        }
+
+        Track track{static_cast<std::uint16_t>(joint), type, glm::vec3(0.0f), glm::vec3(0.0f)};
+        float quantization = 4.0f * SQRT1_2 / ROTATION_STEPS;
+        if (!rotation)
+        {
+            glm::vec3 maximum = glm::vec3(keys.front().value);
+            track.minimum = maximum;
+            for (const Key& key : keys)
+            {
+                track.minimum = glm::min(track.minimum, glm::vec3(key.value));
+                maximum = glm::max(maximum, glm::vec3(key.value));
+            }
+            track.extent = maximum - track.minimum;
+            quantization = 0.5f * glm::length(track.extent) / RANGE_STEPS;
+        }
+
+        // The removed keys get what the quantization leaves of the tolerance.
+        const float budget = std::max(tolerance - quantization, 0.5f * tolerance);
+        m_tracks.push_back(track);
+        curves.push_back(simplify(keys, budget, rotation));
+    };
+
+    for (const AnimationChannel& channel : channels)
+    {
+        addTrack(channel.joint, TrackType::Translation, gather(channel.translations));
+        addTrack(channel.joint, TrackType::Rotation, gather(channel.rotations));
+        addTrack(channel.joint, TrackType::Scale, gather(channel.scales));
+    }
+
+    for (std::size_t s = 0; s < segments; ++s)
+    {
+        m_segmentOffsets.push_back(static_cast<std::uint32_t>(m_data.size()));
+        const float start = static_cast<float>(s) * m_segmentDuration;
+        const float end = s + 1 == segments ? m_duration : start + m_segmentDuration;
+
+        for (std::size_t t = 0; t < m_tracks.size(); ++t)
+        {
+            const Track& track = m_tracks[t];
+            const std::vector<Key>& curve = curves[t];
+            const bool rotation = track.type == TrackType::Rotation;
+
+            // Keys at both ends of the segment, so sampling never looks at a neighbour.
+            std::vector<Key> keys{{start, evaluate(curve, start, rotation)}};
+            for (const Key& key : curve)
+            {
+                if (key.time > start && key.time < end)
+                    keys.push_back(key);
+            }
+            keys.push_back({end, evaluate(curve, end, rotation)});
+
+            m_data.push_back(static_cast<std::uint16_t>(keys.size()));
+            const float span = end - start;
+            for (const Key& key : keys)
+                m_data.push_back(quantizeUnit(span > 0.0f ? (key.time - start) / span : 0.0f, TIME_STEPS));
+
+            for (const Key& key : keys)
+            {
+                std::uint16_t packed[3];
+                if (rotation)
+                {
+                    quantizeRotation(toQuat(key.value), packed);
+                }
+                else
+                {
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        const float extent = track.extent[axis];
+                        const float unit = extent > 0.0f ? (key.value[axis] - track.minimum[axis]) / extent : 0.0f;
+                        packed[axis] = quantizeUnit(unit, RANGE_STEPS);
+                    }
+                }
+                m_data.insert(m_data.end(), packed, packed + 3);
+            }
+        }
+    }
+    m_segmentOffsets.push_back(static_cast<std::uint32_t>(m_data.size()));
+}
+
+void CompressedClip::apply(JointPose& joint, TrackType type, const glm::vec4& value)
+{
+    switch (type)
+    {
+    case TrackType::Translation:
+        joint.translation = glm::vec3(value);
+        break;
+    case TrackType::Rotation:
+        joint.rotation = toQuat(value);
+        break;
+    case TrackType::Scale:
+        joint.scale = glm::vec3(value);
+        break;
+    }
+}
+
+void CompressedClip::sample(float time, std::vector<JointPose>& pose) const
+{
+    for (const ConstantTrack& constant : m_constants)
+        apply(pose[constant.joint], constant.type, constant.value);
+
+    const float clamped = std::clamp(time, 0.0f, m_duration);
+    const std::size_t segment =
+        std::min(static_cast<std::size_t>(clamped / m_segmentDuration), m_segmentOffsets.size() - 2);
+    const float local = (clamped - static_cast<float>(segment) * m_segmentDuration) / m_segmentDuration;
+    const float position = std::clamp(local, 0.0f, 1.0f) * TIME_STEPS;
+
+    const std::uint16_t* cursor = m_data.data() + m_segmentOffsets[segment];
+    for (const Track& track : m_tracks)
+    {
+        const std::size_t count = *cursor++;
+        const std::uint16_t* times = cursor;
+        const std::uint16_t* values = cursor + count;
+        cursor += count * 4;
+
+        std::size_t key = 0;
+        while (key + 2 < count && times[key + 1] <= position)
+            ++key;
+        const float span = static_cast<float>(times[key + 1] - times[key]);
+        const float weight = span > 0.0f ? std::clamp((position - times[key]) / span, 0.0f, 1.0f) : 0.0f;
+
+        const std::uint16_t* first = values + key * 3;
+        const std::uint16_t* second = first + 3;
+        glm::vec4 a, b;
+        if (track.type == TrackType::Rotation)
+        {
+            const glm::quat qa = dequantizeRotation(first);
+            const glm::quat qb = dequantizeRotation(second);
+            a = glm::vec4(qa.x, qa.y, qa.z, qa.w);
+            b = glm::vec4(qb.x, qb.y, qb.z, qb.w);
+        }
+        else
+        {
+            const glm::vec3 scale = track.extent / RANGE_STEPS;
+            a = glm::vec4(track.minimum + glm::vec3(first[0], first[1], first[2]) * scale, 0.0f);
+            b = glm::vec4(track.minimum + glm::vec3(second[0], second[1], second[2]) * scale, 0.0f);
+        }
+        apply(pose[track.joint], track.type, interpolate(a, b, weight, track.type == TrackType::Rotation));
+    }
+}
+
+std::size_t CompressedClip::memoryUsage() const
+{
+    return sizeof(*this) + m_constants.capacity() * sizeof(ConstantTrack) + m_tracks.capacity() * sizeof(Track) +
+           m_segmentOffsets.capacity() * sizeof(std::uint32_t) + m_data.capacity() * sizeof(std::uint16_t);
+}
@@ -0,0 +1,139 @@
+#ifndef COMPRESSED_CLIP_HPP_
+#define COMPRESSED_CLIP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "skeleton.hpp"
+
+struct AnimationChannel;
+
+/**
+ * @struct CompressionSettings
+ * @brief How far a compressed clip may drift from its source keys.
+ *
+ * Tolerances apply per joint, in the joint's parent space, and cover both the
+ * removed keys and the quantization.
+ */
+struct CompressionSettings
+{
+    float translationTolerance = 0.0005f; /**< Maximum translation error, in model units. */
+    float rotationTolerance = 0.001f;     /**< Maximum rotation error, in radians. */
+    float scaleTolerance = 0.0005f;       /**< Maximum scale error. */
+    float segmentDuration = 0.5f;         /**< Target length of a segment, in seconds. */
+};
+
+/**
+ * @brief Packs a unit quaternion into 48 bits with the smallest three encoding.
+ *
+ * The largest component is dropped, its index kept in 2 bits, and the other
+ * three are stored in 15 bits each over [-1/sqrt(2), 1/sqrt(2)].
+ *
+ * @param rotation The unit quaternion.
+ * @param packed Receives the 48 bits, most significant word first.
+ */
+void quantizeRotation(const glm::quat& rotation, std::uint16_t packed[3]);
+
+/**
+ * @brief Unpacks a quaternion packed by quantizeRotation().
+ *
+ * @param packed The 48 bits, most significant word first.
+ * @return The unit quaternion, or its opposite.
+ */
+glm::quat dequantizeRotation(const std::uint16_t packed[3]);
+
+/**
+ * @class CompressedClip
+ * @brief The curves of an AnimationClip, simplified and quantized.
+ *
+ * Keys that linear interpolation can rebuild within tolerance are removed, and
+ * tracks that never move are stored once. The rest is split into segments of
+ * equal length. Each segment holds, for every animated track, its keys inside
+ * the segment plus one at each end, as 16 bit times relative to the segment,
+ * 48 bit rotations and translations or scales quantized to 16 bits per axis
+ * over the range of the track. Sampling reads a single contiguous segment.
+ */
+class CompressedClip
+{
+public:
+    /**
+     * @brief Compresses the channels of a clip.
+     *
+     * @param channels One channel per animated joint.
+     * @param duration The length of the clip, in seconds.
+     * @param settings The tolerances and segment length.
+     */
+    CompressedClip(const std::vector<AnimationChannel>& channels, float duration, const CompressionSettings& settings);
+
+    /**
+     * @brief Samples the clip, with the same rules as AnimationClip::sample().
+     *
+     * @param time The time, in seconds.
+     * @param pose The pose to update, one entry per skeleton joint.
+     */
+    void sample(float time, std::vector<JointPose>& pose) const;
+
+    /**
+     * @brief Gets the number of segments.
+     *
+     * @return The segment count.
+     */
+    std::size_t segmentCount() const { return m_segmentOffsets.size() - 1; }
+
+    /**
+     * @brief Gets the memory held by the clip.
+     *
+     * @return The size, in bytes.
+     */
+    std::size_t memoryUsage() const;
+
+private:
+    /**
+     * @enum TrackType
+     * @brief The part of a joint pose a track animates.
+     */
+    enum class TrackType : std::uint8_t
+    {
+        Translation,
+        Rotation,
+        Scale
+    };
+
+    /**
+     * @struct Track
+     * @brief A track with keys in every segment.
+     */
+    struct Track
+    {
+        std::uint16_t joint; /**< Index of the joint in the skeleton. */
+        TrackType type;      /**< What the track animates. */
+        glm::vec3 minimum;   /**< Smallest value, for translations and scales. */
+        glm::vec3 extent;    /**< Largest minus smallest value, for translations and scales. */
+    };
+
+    /**
+     * @struct ConstantTrack
+     * @brief A track that holds one value for the whole clip.
+     */
+    struct ConstantTrack
+    {
+        std::uint16_t joint; /**< Index of the joint in the skeleton. */
+        TrackType type;      /**< What the track animates. */
+        glm::vec4 value;     /**< The value, xyzw for rotations. */
+    };
+
+    static void apply(JointPose& joint, TrackType type, const glm::vec4& value);
+
+    float m_duration;                            /**< The length, in seconds. */
+    float m_segmentDuration;                     /**< The length of a segment, in seconds. */
+    std::vector<ConstantTrack> m_constants;      /**< Tracks stored once. */
+    std::vector<Track> m_tracks;                 /**< Tracks stored in every segment, in segment order. */
+    std::vector<std::uint32_t> m_segmentOffsets; /**< Start of every segment in m_data, plus its end. */
+    std::vector<std::uint16_t> m_data;           /**< The segments, back to back. */
+};
+
+#endif
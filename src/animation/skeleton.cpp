@@ -0,0 +1,55 @@
+#include "skeleton.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+glm::mat4 JointPose::toMatrix() const
+{
+    glm::mat4 matrix = glm::mat4_cast(rotation);
+    matrix[0] *= scale.x;
+    matrix[1] *= scale.y;
+    matrix[2] *= scale.z;
+    matrix[3] = glm::vec4(translation, 1.0f);
+    return matrix;
+}
+
+int Skeleton::addJoint(const std::string& name, int parent, const JointPose& bindPose)
+{
+    const int index = static_cast<int>(m_joints.size());
+    if (parent >= index)
+        throw std::invalid_argument("Joint " + name + " added before its parent");
+
+    Joint joint;
+    joint.name = name;
+    joint.parent = parent;
+    joint.bindPose = bindPose;
+    m_joints.push_back(std::move(joint));
+    m_names.emplace(name, index);
+    return index;
+}
+
+int Skeleton::find(const std::string& name) const
+{
+    auto it = m_names.find(name);
+    return it == m_names.end() ? -1 : it->second;
+}
+
+void Skeleton::bindPose(std::vector<JointPose>& pose) const
+{
+    pose.resize(m_joints.size());
+    for (std::size_t i = 0; i < m_joints.size(); ++i)
+        pose[i] = m_joints[i].bindPose;
+}
+
+void Skeleton::computePalette(const std::vector<JointPose>& pose, std::vector<glm::mat4>& globals,
+                              glm::mat4* palette) const
+{
+    globals.resize(m_joints.size());
+    for (std::size_t i = 0; i < m_joints.size(); ++i)
+    {
+        const Joint& joint = m_joints[i];
+        const glm::mat4 local = pose[i].toMatrix();
+        globals[i] = joint.parent < 0 ? local : globals[joint.parent] * local;
+        palette[i] = m_globalInverse * globals[i] * joint.inverseBind;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef SKELETON_HPP_
+#define SKELETON_HPP_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/**
+ * @struct JointPose
+ * @brief Local transform of a joint, relative to its parent.
+ */
+struct JointPose
+{
+    glm::vec3 translation = glm::vec3(0.0f);                /**< Translation. */
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f); /**< Rotation. */
+    glm::vec3 scale = glm::vec3(1.0f);                      /**< Scale. */
+
+    /**
+     * @brief Builds the matrix of the transform.
+     *
+     * @return translate * rotate * scale.
+     */
+    glm::mat4 toMatrix() const;
+};
+
+/**
+ * @struct Joint
+ * @brief A node of a skeleton.
+ */
+struct Joint
+{
+    std::string name;                        /**< Node name, as animation channels refer to it. */
+    int parent = -1;                         /**< Index of the parent joint, -1 for a root. */
+    glm::mat4 inverseBind = glm::mat4(1.0f); /**< Mesh space to joint space in the bind pose. */
+    JointPose bindPose;                      /**< Local transform when no animation drives the joint. */
+};
+
+/**
+ * @class Skeleton
+ * @brief Joint hierarchy of a skinned model.
+ *
+ * Joints are stored parents first, so a single pass in index order computes
+ * every global transform.
+ */
+class Skeleton
+{
+public:
+    /**
+     * @brief Adds a joint.
+     *
+     * @param name The node name.
+     * @param parent Index of the parent, added before, or -1 for a root.
+     * @param bindPose The local transform of the node.
+     * @return The index of the joint.
+     *
+     * @throw std::invalid_argument If the parent was not added yet.
+     */
+    int addJoint(const std::string& name, int parent, const JointPose& bindPose);
+
+    /**
+     * @brief Sets the inverse bind matrix of a joint, the offset matrix of its bone.
+     *
+     * @param joint The joint index.
+     * @param inverseBind Mesh space to joint space.
+     */
+    void setInverseBind(int joint, const glm::mat4& inverseBind) { m_joints[joint].inverseBind = inverseBind; }
+
+    /**
+     * @brief Sets the transform applied after every joint, the inverse of the root node transform.
+     *
+     * @param globalInverse The transform.
+     */
+    void setGlobalInverse(const glm::mat4& globalInverse) { m_globalInverse = globalInverse; }
+
+    /**
+     * @brief Finds a joint by name.
+     *
+     * @param name The node name.
+     * @return The joint index, -1 if there is none.
+     */
+    int find(const std::string& name) const;
+
+    /**
+     * @brief Gets the number of joints.
+     *
+     * @return The joint count.
+     */
+    std::size_t size() const { return m_joints.size(); }
+
+    /**
+     * @brief Gets a joint.
+     *
+     * @param index The joint index.
+     * @return The joint.
+     */
+    const Joint& joint(std::size_t index) const { return m_joints[index]; }
+
+    /**
+     * @brief Fills a pose with the bind pose of every joint.
+     *
+     * @param pose Resized to size().
+     */
+    void bindPose(std::vector<JointPose>& pose) const;
+
+    /**
+     * @brief Computes the skinning matrices of a pose.
+     *
+     * @param pose One local transform per joint.
+     * @param globals Scratch space, resized to size().
+     * @param palette Receives size() matrices, mesh space in the bind pose to mesh space in the pose.
+     */
+    void computePalette(const std::vector<JointPose>& pose, std::vector<glm::mat4>& globals,
+                        glm::mat4* palette) const;
+
+private:
+    std::vector<Joint> m_joints;                  /**< Joints, parents first. */
+    std::unordered_map<std::string, int> m_names; /**< Joint index by name. */
+    glm::mat4 m_globalInverse = glm::mat4(1.0f);  /**< Applied after every joint transform. */
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "skinning.hpp"
+
+#include <cmath>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LAMB_SKINNING_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+
+glm::vec3 normalizeOrKeep(const glm::vec3& normal)
+{
+    const float length = glm::length(normal);
+    return length > 0.0f ? normal / length : normal;
+}
+
+} // namespace
+
+void skinVerticesScalar(const Vertex* source, std::size_t count, const glm::mat4* palette, Vertex* destination)
+{
+    for (std::size_t v = 0; v < count; ++v)
+    {
+        const Vertex& in = source[v];
+        Vertex& out = destination[v];
+
+        glm::mat4 skin(0.0f);
+        float total = 0.0f;
+        for (int k = 0; k < MAX_BONE_INFLUENCE; ++k)
+        {
+            const float weight = in.m_Weights[k];
+            if (weight == 0.0f)
+                continue;
+            skin += palette[in.m_BoneIDs[k]] * weight;
+            total += weight;
+        }
+
+        if (total == 0.0f)
+        {
+            out.position = in.position;
+            out.normal = in.normal;
+            continue;
+        }
+
+        out.position = glm::vec3(skin * glm::vec4(in.position, 1.0f));
+        out.normal = normalizeOrKeep(glm::vec3(skin * glm::vec4(in.normal, 0.0f)));
+    }
+}
+
+#if LAMB_SKINNING_SSE
+
+void skinVertices(const Vertex* source, std::size_t count, const glm::mat4* palette, Vertex* destination)
+{
+    for (std::size_t v = 0; v < count; ++v)
+    {
+        const Vertex& in = source[v];
+        Vertex& out = destination[v];
+
+        // Blend the bone matrices one column per register.
+        __m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+        float total = 0.0f;
+        for (int k = 0; k < MAX_BONE_INFLUENCE; ++k)
+        {
+            const float weight = in.m_Weights[k];
+            if (weight == 0.0f)
+                continue;
+            const float* bone = glm::value_ptr(palette[in.m_BoneIDs[k]]);
+            const __m128 w = _mm_set1_ps(weight);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(bone), w));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(bone + 4), w));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(bone + 8), w));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(bone + 12), w));
+            total += weight;
+        }
+
+        if (total == 0.0f)
+        {
+            out.position = in.position;
+            out.normal = in.normal;
+            continue;
+        }
+
+        const __m128 x = _mm_mul_ps(c0, _mm_set1_ps(in.position.x));
+        const __m128 y = _mm_mul_ps(c1, _mm_set1_ps(in.position.y));
+        const __m128 z = _mm_mul_ps(c2, _mm_set1_ps(in.position.z));
+        const __m128 position = _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, c3));
+
+        const __m128 nx = _mm_mul_ps(c0, _mm_set1_ps(in.normal.x));
+        const __m128 ny = _mm_mul_ps(c1, _mm_set1_ps(in.normal.y));
+        const __m128 nz = _mm_mul_ps(c2, _mm_set1_ps(in.normal.z));
+        const __m128 normal = _mm_add_ps(_mm_add_ps(nx, ny), nz);
+
+        alignas(16) float result[8];
+        _mm_store_ps(result, position);
+        _mm_store_ps(result + 4, normal);
+        out.position = glm::vec3(result[0], result[1], result[2]);
+        out.normal = normalizeOrKeep(glm::vec3(result[4], result[5], result[6]));
+    }
+}
+
+#else
+
+void skinVertices(const Vertex* source, std::size_t count, const glm::mat4* palette, Vertex* destination)
+{
+    skinVerticesScalar(source, count, palette, destination);
+}
+
+#endif
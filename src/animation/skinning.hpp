@@ -0,0 +1,45 @@
+#ifndef SKINNING_HPP_
+#define SKINNING_HPP_
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "renderable.hpp"
+
+/**
+ * @enum SkinningMode
+ * @brief Where skinned vertices are transformed.
+ */
+enum class SkinningMode
+{
+    CPU, /**< skinVertices() on the ThreadPool, then the vertex buffers are refilled. */
+    GPU  /**< In the vertex shader, from bone matrices in a shader storage buffer. */
+};
+
+/**
+ * @brief Skins vertices on the CPU, with SSE when the target has it.
+ *
+ * Each vertex blends the palette matrices of its bone IDs by its weights and
+ * transforms its position and normal; a vertex without weights is copied as
+ * is. Only position and normal are written, so destination must already hold
+ * the other attributes.
+ *
+ * @param source The bind pose vertices.
+ * @param count Number of vertices.
+ * @param palette Skinning matrices, indexed by Vertex::m_BoneIDs.
+ * @param destination Receives the skinned vertices, may not alias source.
+ */
+void skinVertices(const Vertex* source, std::size_t count, const glm::mat4* palette, Vertex* destination);
+
+/**
+ * @brief Reference implementation of skinVertices(), without SIMD.
+ *
+ * @param source The bind pose vertices.
+ * @param count Number of vertices.
+ * @param palette Skinning matrices, indexed by Vertex::m_BoneIDs.
+ * @param destination Receives the skinned vertices, may not alias source.
+ */
+void skinVerticesScalar(const Vertex* source, std::size_t count, const glm::mat4* palette, Vertex* destination);
+
+#endif
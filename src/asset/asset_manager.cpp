@@ -0,0 +1,273 @@
+#include "asset_manager.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "log.hpp"
+#include "profiler.hpp"
+#include "shader.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+std::string shaderKey(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines)
+{
+    std::string key = vertexPath + "|" + fragmentPath;
+    for (const auto& [name, value] : defines)
+        key += "|" + name + "=" + value;
+    return key;
+}
+
+} // namespace
+
+template <typename T> std::uint32_t AssetManager::Pool<T>::acquire(const std::string& key)
+{
+    std::uint32_t index;
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot<T>& slot = slots[index];
+    slot.key = key;
+    slot.references = 1;
+    slot.state = SlotState::LOADING;
+    slot.requested = Clock::now();
+    keys[key] = index;
+    return index;
+}
+
+ModelHandle AssetManager::loadModel(const std::string& path)
+{
+    auto it = m_models.keys.find(path);
+    if (it != m_models.keys.end())
+    {
+        Slot<Model>& slot = m_models.slots[it->second];
+        slot.references++;
+        m_coalesced++;
+        return ModelHandle(it->second, slot.generation);
+    }
+
+    const std::uint32_t index = m_models.acquire(path);
+    const std::uint32_t generation = m_models.slots[index].generation;
+
+    m_jobs.add();
+    ThreadPool::getInstance().submit([this, index, generation, path]() { importModel(index, generation, path); });
+
+    return ModelHandle(index, generation);
+}
+
+void AssetManager::importModel(std::uint32_t index, std::uint32_t generation, const std::string& path)
+{
+    PROFILE_ZONE("AssetManager::importModel");
+    ImportedModel imported;
+    imported.index = index;
+    imported.generation = generation;
+
+    try
+    {
+        imported.data = Model::import(path);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Log(LogLevel::Error, "Failed to import model " + path + ": " + e.what(), "Engine");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_imported.push_back(std::move(imported));
+    }
+    m_jobs.done();
+}
+
+ShaderHandle AssetManager::loadShader(const std::string& vertexPath, const std::string& fragmentPath,
+                                      const ShaderDefines& defines)
+{
+    const std::string key = shaderKey(vertexPath, fragmentPath, defines);
+    auto it = m_shaders.keys.find(key);
+    if (it != m_shaders.keys.end())
+    {
+        Slot<ShaderEngine>& slot = m_shaders.slots[it->second];
+        slot.references++;
+        m_coalesced++;
+        return ShaderHandle(it->second, slot.generation);
+    }
+
+    // Sources are read here, on the calling thread; the GL objects are created by update() on the context thread.
+    PendingShader pending;
+    pending.vertexSource = ShaderPreprocessor::getInstance().process(vertexPath, defines);
+    pending.fragmentSource = ShaderPreprocessor::getInstance().process(fragmentPath, defines);
+
+    const std::uint32_t index = m_shaders.acquire(key);
+    pending.index = index;
+    pending.generation = m_shaders.slots[index].generation;
+    m_pendingShaders.push_back(std::move(pending));
+
+    return ShaderHandle(index, m_shaders.slots[index].generation);
+}
+
+void AssetManager::createPendingShaders()
+{
+    for (PendingShader& pending : m_pendingShaders)
+    {
+        // The request may have been dropped before its first update().
+        Slot<ShaderEngine>* slot = m_shaders.find(pending.index, pending.generation);
+        if (!slot || slot->state != SlotState::LOADING)
+            continue;
+
+        slot->asset = std::make_unique<ShaderEngine>();
+        Shader vertexShader{std::move(pending.vertexSource), glCreateShader(GL_VERTEX_SHADER)};
+        slot->asset->addShader(vertexShader);
+        Shader fragmentShader{std::move(pending.fragmentSource), glCreateShader(GL_FRAGMENT_SHADER)};
+        slot->asset->addShader(fragmentShader);
+        m_shaderBatch.add(*slot->asset);
+    }
+    m_pendingShaders.clear();
+}
+
+void AssetManager::update()
+{
+    PROFILE_ZONE("AssetManager::update");
+    std::vector<ImportedModel> imported;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        imported.swap(m_imported);
+    }
+
+    for (ImportedModel& model : imported)
+    {
+        // The request may have been dropped, and its slot reused, while the import ran.
+        Slot<Model>* slot = m_models.find(model.index, model.generation);
+        if (!slot)
+            continue;
+
+        if (!model.data.valid)
+        {
+            slot->state = SlotState::FAILED;
+            continue;
+        }
+
+        slot->asset = std::make_unique<Model>(std::move(model.data));
+        slot->state = SlotState::READY;
+        recordLatency(slot->requested);
+    }
+
+    createPendingShaders();
+    m_shaderBatch.submit();
+    for (Slot<ShaderEngine>& slot : m_shaders.slots)
+    {
+        if (slot.state != SlotState::LOADING || !slot.asset || !slot.asset->isReady())
+            continue;
+
+        // Built, which is not the same as built successfully.
+        if (!slot.asset->checkLinked())
+        {
+            slot.state = SlotState::FAILED;
+            Logger::Log(LogLevel::Error, "Failed to build shader program " + slot.key, "Engine");
+            continue;
+        }
+        slot.state = SlotState::READY;
+        recordLatency(slot.requested);
+    }
+
+    collect(m_models);
+    collect(m_shaders);
+}
+
+template <typename T> void AssetManager::collect(Pool<T>& pool)
+{
+    std::vector<std::uint32_t> released;
+    released.swap(pool.released);
+
+    for (std::uint32_t index : released)
+    {
+        // A handle may have been copied from a live one after the count first reached zero.
+        if (pool.slots[index].state != SlotState::FREE && pool.slots[index].references == 0)
+            unload(pool, index);
+    }
+}
+
+template <typename T> void AssetManager::unload(Pool<T>& pool, std::uint32_t index)
+{
+    Slot<T>& slot = pool.slots[index];
+    if (slot.asset)
+        slot.asset->destroy();
+
+    pool.keys.erase(slot.key);
+    slot.asset.reset();
+    slot.key.clear();
+    slot.references = 0;
+    slot.state = SlotState::FREE;
+    slot.generation++;
+    pool.freeSlots.push_back(index);
+}
+
+void AssetManager::recordLatency(Clock::time_point requested)
+{
+    m_latencies[m_latencyCount % LATENCY_SAMPLES] =
+        std::chrono::duration<double, std::milli>(Clock::now() - requested).count();
+    m_latencyCount++;
+}
+
+AssetManager::LatencyStats AssetManager::getLatencyStats() const
+{
+    LatencyStats stats;
+    stats.samples = std::min(m_latencyCount, LATENCY_SAMPLES);
+    if (stats.samples == 0)
+        return stats;
+
+    std::vector<double> sorted(m_latencies.begin(), m_latencies.begin() + stats.samples);
+    std::sort(sorted.begin(), sorted.end());
+    stats.p50 = percentile(sorted, 0.50);
+    stats.p90 = percentile(sorted, 0.90);
+    stats.p99 = percentile(sorted, 0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+void AssetManager::logStats() const
+{
+    const LatencyStats stats = getLatencyStats();
+
+    std::ostringstream message;
+    message << "Assets: " << m_models.liveCount() << " models, " << m_shaders.liveCount() << " shaders, "
+            << m_coalesced << " coalesced requests; load latency over " << stats.samples << " loads: p50 "
+            << stats.p50 << " ms, p90 " << stats.p90 << " ms, p99 " << stats.p99 << " ms, max " << stats.max << " ms";
+    Logger::Log(LogLevel::Info, message.str(), "Engine");
+}
+
+void AssetManager::shutdown()
+{
+    m_jobs.wait();
+    m_imported.clear();
+    m_pendingShaders.clear();
+    m_shaderBatch.submit();
+
+    for (std::uint32_t index = 0; index < m_models.slots.size(); ++index)
+    {
+        if (m_models.slots[index].state != SlotState::FREE)
+            unload(m_models, index);
+    }
+    for (std::uint32_t index = 0; index < m_shaders.slots.size(); ++index)
+    {
+        if (m_shaders.slots[index].state != SlotState::FREE)
+            unload(m_shaders, index);
+    }
+    m_models.released.clear();
+    m_shaders.released.clear();
+}
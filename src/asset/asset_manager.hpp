@@ -0,0 +1,392 @@
+#ifndef ASSET_MANAGER_HPP_
+#define ASSET_MANAGER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "in_flight_counter.hpp"
+#include "model.hpp"
+#include "shader_engine.hpp"
+#include "shader_preprocessor.hpp"
+
+class AssetManager;
+
+/**
+ * @class AssetHandle
+ * @brief Reference counted, generational handle to an asset owned by the AssetManager.
+ *
+ * A handle is a slot index and the generation of the slot when it was handed out,
+ * so it stays cheap to copy and never dangles: once the asset is unloaded and its
+ * slot reused, get() returns nullptr instead of another asset. Copies add a
+ * reference, destruction removes one; the asset is unloaded by the next
+ * AssetManager::update() after the last reference is gone.
+ *
+ * Handles must be copied and destroyed where AssetManager methods may run: on
+ * the game thread, or on the render thread while the game thread waits for it.
+ *
+ * @tparam T Model or ShaderEngine.
+ */
+template <typename T> class AssetHandle
+{
+public:
+    AssetHandle() = default;
+    AssetHandle(const AssetHandle& other);
+    AssetHandle(AssetHandle&& other) noexcept;
+    AssetHandle& operator=(AssetHandle other) noexcept;
+    ~AssetHandle();
+
+    /**
+     * @brief Gets the asset.
+     *
+     * @return The asset, or nullptr while it is loading, if it failed to load or if the handle is empty.
+     */
+    T* get() const;
+
+    /**
+     * @brief Tells whether the asset can be used.
+     *
+     * @return true once get() returns the asset.
+     */
+    bool isReady() const { return get() != nullptr; }
+
+    /**
+     * @brief Tells whether the handle refers to an asset, loaded or not.
+     */
+    explicit operator bool() const { return m_generation != 0; }
+
+    T* operator->() const { return get(); }
+
+    /**
+     * @brief Gets the slot index of the asset.
+     *
+     * @return The index.
+     */
+    std::uint32_t index() const { return m_index; }
+
+    /**
+     * @brief Gets the generation of the slot the handle was created for.
+     *
+     * @return The generation, 0 for an empty handle.
+     */
+    std::uint32_t generation() const { return m_generation; }
+
+private:
+    friend class AssetManager;
+
+    AssetHandle(std::uint32_t index, std::uint32_t generation) : m_index(index), m_generation(generation) {}
+
+    std::uint32_t m_index = 0;      /**< Slot index in the manager. */
+    std::uint32_t m_generation = 0; /**< Slot generation, 0 for an empty handle. */
+};
+
+using ModelHandle = AssetHandle<Model>;
+using ShaderHandle = AssetHandle<ShaderEngine>;
+
+/**
+ * @class AssetManager
+ * @brief Loads models and shader programs in the background and shares them by handle.
+ *
+ * Requests are keyed by their source paths (and defines for shaders): asking
+ * again for an asset that is loaded or still loading hands out another
+ * reference to the same slot instead of starting a second load.
+ *
+ * Models are imported on the ThreadPool (Model::import(), Assimp or the mesh
+ * cache) and get their GL buffers in update(). Shader sources are read on the
+ * calling thread; update() creates their GL shaders and submits every program
+ * requested since the last update() in one ShaderBatch. Each is ready once the
+ * driver finished building it and it linked; a program that did not link, a
+ * missing source file included, is failed like a model that did not import.
+ *
+ * Load latency, from the request to the asset being usable, is recorded for
+ * the last LATENCY_SAMPLES loads.
+ *
+ * Only update() and shutdown() touch GL, so only they need the context. Every
+ * method, and every handle copy, get() or destruction, must run on the game
+ * thread, or on the render thread while the game thread is synchronized with
+ * it: Engine calls update() from the render thread's synchronize step, when
+ * the game thread is blocked in RenderThread::submit(). Without a render
+ * thread both are the main thread. An asset returned by get() must not be
+ * changed while a frame recorded earlier may still read it; commands that
+ * change it, such as Renderable::setShaderEngine(), are best recorded with
+ * RenderCommandList::call().
+ */
+class AssetManager
+{
+public:
+    /**
+     * @brief Number of load latencies kept for the percentiles.
+     */
+    static constexpr std::size_t LATENCY_SAMPLES = 256;
+
+    /**
+     * @struct LatencyStats
+     * @brief Load latency percentiles over the last LATENCY_SAMPLES loads, in milliseconds.
+     */
+    struct LatencyStats
+    {
+        std::size_t samples = 0; /**< Number of loads measured. */
+        double p50 = 0.0;        /**< Median latency. */
+        double p90 = 0.0;        /**< 90th percentile latency. */
+        double p99 = 0.0;        /**< 99th percentile latency. */
+        double max = 0.0;        /**< Worst latency. */
+    };
+
+    /**
+     * @brief Gets the singleton instance of AssetManager.
+     *
+     * @return The AssetManager instance.
+     */
+    static AssetManager& getInstance()
+    {
+        static AssetManager instance;
+        return instance;
+    }
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    /**
+     * @brief Requests a model, importing it on the ThreadPool unless it is already loaded or loading.
+     *
+     * @param path The file path to the model file.
+     * @return A handle to the model, not ready until a later update() created its GL buffers.
+     */
+    ModelHandle loadModel(const std::string& path);
+
+    /**
+     * @brief Requests a shader program, built in the background unless it is already loaded or loading.
+     *
+     * @param vertexPath The vertex shader source.
+     * @param fragmentPath The fragment shader source.
+     * @param defines Defines injected into both stages.
+     * @return A handle to the program, not ready until the driver finished building it.
+     */
+    ShaderHandle loadShader(const std::string& vertexPath, const std::string& fragmentPath,
+                            const ShaderDefines& defines = {});
+
+    /**
+     * @brief Finishes loads, submits new shader builds and unloads unreferenced assets, once per frame.
+     */
+    void update();
+
+    /**
+     * @brief Waits for pending imports and unloads every asset. Must run before the GL context is destroyed.
+     *
+     * Handles still alive afterwards return nullptr.
+     */
+    void shutdown();
+
+    /**
+     * @brief Gets the load latency percentiles of models and shaders together.
+     *
+     * @return The percentiles.
+     */
+    LatencyStats getLatencyStats() const;
+
+    /**
+     * @brief Logs the asset counts and load latency percentiles.
+     */
+    void logStats() const;
+
+    /**
+     * @brief Gets the number of assets requested and not unloaded yet.
+     *
+     * @return The number of live assets.
+     */
+    std::size_t liveCount() const { return m_models.liveCount() + m_shaders.liveCount(); }
+
+    /**
+     * @brief Gets the number of requests served by an asset already loaded or loading.
+     *
+     * @return The number of coalesced requests.
+     */
+    std::size_t coalescedCount() const { return m_coalesced; }
+
+private:
+    template <typename T> friend class AssetHandle;
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @enum SlotState
+     * @brief Lifecycle of a slot.
+     */
+    enum class SlotState
+    {
+        FREE,    /**< Unused, on the free list. */
+        LOADING, /**< Requested, the asset is not usable yet. */
+        READY,   /**< The asset is usable. */
+        FAILED   /**< The load failed; the slot lives until its last reference goes. */
+    };
+
+    /**
+     * @struct Slot
+     * @brief One asset and its bookkeeping.
+     */
+    template <typename T> struct Slot
+    {
+        std::unique_ptr<T> asset;          /**< The asset, set once loaded. */
+        std::string key;                   /**< The request key, for coalescing. */
+        std::uint32_t generation = 1;      /**< Incremented whenever the slot is freed. */
+        std::uint32_t references = 0;      /**< Number of live handles. */
+        SlotState state = SlotState::FREE; /**< Current state. */
+        Clock::time_point requested;       /**< When the load was requested. */
+    };
+
+    /**
+     * @struct Pool
+     * @brief Slots of one asset type, with the key index and free list.
+     */
+    template <typename T> struct Pool
+    {
+        std::vector<Slot<T>> slots;                          /**< Every slot, indices are stable. */
+        std::vector<std::uint32_t> freeSlots;                /**< Indices of FREE slots. */
+        std::unordered_map<std::string, std::uint32_t> keys; /**< Slot of every live request key. */
+        std::vector<std::uint32_t> released;                 /**< Slots whose reference count dropped to zero. */
+
+        std::uint32_t acquire(const std::string& key);
+        Slot<T>* find(std::uint32_t index, std::uint32_t generation);
+        std::size_t liveCount() const { return keys.size(); }
+    };
+
+    /**
+     * @struct ImportedModel
+     * @brief Output of a model import job, produced on a worker thread.
+     */
+    struct ImportedModel
+    {
+        std::uint32_t index = 0;      /**< Slot of the request. */
+        std::uint32_t generation = 0; /**< Generation of the slot when the import started. */
+        ModelData data;               /**< The imported model. */
+    };
+
+    AssetManager() = default;
+    ~AssetManager() = default;
+
+    template <typename T> Pool<T>& pool();
+    template <typename T> const Pool<T>& pool() const;
+
+    template <typename T> void retain(std::uint32_t index, std::uint32_t generation);
+    template <typename T> void release(std::uint32_t index, std::uint32_t generation);
+    template <typename T> T* find(std::uint32_t index, std::uint32_t generation);
+    template <typename T> void unload(Pool<T>& pool, std::uint32_t index);
+    template <typename T> void collect(Pool<T>& pool);
+
+    /**
+     * @struct PendingShader
+     * @brief Preprocessed sources of a program requested since the last update().
+     */
+    struct PendingShader
+    {
+        std::uint32_t index = 0;      /**< Slot of the request. */
+        std::uint32_t generation = 0; /**< Generation of the slot when it was requested. */
+        std::string vertexSource;     /**< Preprocessed vertex stage. */
+        std::string fragmentSource;   /**< Preprocessed fragment stage. */
+    };
+
+    void importModel(std::uint32_t index, std::uint32_t generation, const std::string& path);
+    void createPendingShaders();
+    void recordLatency(Clock::time_point requested);
+
+    Pool<Model> m_models;                        /**< Model slots. */
+    Pool<ShaderEngine> m_shaders;                /**< Shader program slots. */
+    std::vector<PendingShader> m_pendingShaders; /**< Programs requested since the last update(). */
+    ShaderBatch m_shaderBatch;                   /**< Programs created by update(), submitted together. */
+    std::size_t m_coalesced = 0;                 /**< Requests served by an existing slot. */
+
+    std::array<double, LATENCY_SAMPLES> m_latencies{}; /**< Ring of the last load latencies, in milliseconds. */
+    std::size_t m_latencyCount = 0;                    /**< Number of latencies ever recorded. */
+
+    std::mutex m_mutex;                    /**< Guards m_imported. */
+    std::vector<ImportedModel> m_imported; /**< Models imported by workers, waiting for the main thread. */
+    InFlightCounter m_jobs;                /**< Import jobs not yet finished. */
+};
+
+template <> inline AssetManager::Pool<Model>& AssetManager::pool<Model>()
+{
+    return m_models;
+}
+
+template <> inline AssetManager::Pool<ShaderEngine>& AssetManager::pool<ShaderEngine>()
+{
+    return m_shaders;
+}
+
+template <> inline const AssetManager::Pool<Model>& AssetManager::pool<Model>() const
+{
+    return m_models;
+}
+
+template <> inline const AssetManager::Pool<ShaderEngine>& AssetManager::pool<ShaderEngine>() const
+{
+    return m_shaders;
+}
+
+template <typename T> AssetManager::Slot<T>* AssetManager::Pool<T>::find(std::uint32_t index, std::uint32_t generation)
+{
+    if (index >= slots.size() || slots[index].generation != generation)
+        return nullptr;
+    return &slots[index];
+}
+
+template <typename T> void AssetManager::retain(std::uint32_t index, std::uint32_t generation)
+{
+    if (Slot<T>* slot = pool<T>().find(index, generation))
+        slot->references++;
+}
+
+template <typename T> void AssetManager::release(std::uint32_t index, std::uint32_t generation)
+{
+    Slot<T>* slot = pool<T>().find(index, generation);
+    if (slot && slot->references > 0 && --slot->references == 0)
+        pool<T>().released.push_back(index);
+}
+
+template <typename T> T* AssetManager::find(std::uint32_t index, std::uint32_t generation)
+{
+    Slot<T>* slot = pool<T>().find(index, generation);
+    return slot && slot->state == SlotState::READY ? slot->asset.get() : nullptr;
+}
+
+template <typename T> AssetHandle<T>::AssetHandle(const AssetHandle& other)
+    : m_index(other.m_index), m_generation(other.m_generation)
+{
+    if (m_generation != 0)
+        AssetManager::getInstance().retain<T>(m_index, m_generation);
+}
+
+template <typename T> AssetHandle<T>::AssetHandle(AssetHandle&& other) noexcept
+    : m_index(other.m_index), m_generation(other.m_generation)
+{
+    other.m_generation = 0;
+}
+
+template <typename T> AssetHandle<T>& AssetHandle<T>::operator=(AssetHandle other) noexcept
+{
+    std::swap(m_index, other.m_index);
+    std::swap(m_generation, other.m_generation);
+    return *this;
+}
+
+template <typename T> AssetHandle<T>::~AssetHandle()
+{
+    if (m_generation != 0)
+        AssetManager::getInstance().release<T>(m_index, m_generation);
+}
+
+template <typename T> T* AssetHandle<T>::get() const
+{
+    if (m_generation == 0)
+        return nullptr;
+    return AssetManager::getInstance().find<T>(m_index, m_generation);
+}
+
+#endif
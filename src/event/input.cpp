@@ -1,3 +1,5 @@
+#include <utility>
+
 #include <SDL2/SDL.h>
 #include <imgui_impl_sdl2.h>
 #include <input.hpp>
@@ -41,18 +43,84 @@ void InputSystem::handleEvents(SDL_Window* window)
     }
 };
 
-void InputHandler::processCursorMovement()
+void InputSystem::update(SDL_Window* window, double frameTime)
 {
-    if (m_onCursorMovement)
+    handleEvents(window);
+
+    int xrel = 0, yrel = 0;
+    if (m_replaying)
+    {
+        if (m_replayFrame == m_replay.size())
+        {
+            m_replayFinished = true;
+            return;
+        }
+        const InputRecording::Frame& frame = m_replay.getFrame(m_replayFrame++);
+        for (std::size_t key = 0; key < m_replayKeys.size(); ++key)
+            m_replayKeys[key] = frame.keys[key] ? 1 : 0;
+        xrel = frame.mouseX;
+        yrel = frame.mouseY;
+        m_frameTime = frame.frameTime;
+    }
+    else
     {
-        int xrel, yrel;
+        // Read once for every handler, since reading resets the motion.
         SDL_GetRelativeMouseState(&xrel, &yrel);
-        if (InputSystem::getInstance()->isMouseCaptureEnabled())
+        if (!m_isMouseCaptureEnabled)
+            xrel = yrel = 0;
+        m_frameTime = frameTime;
+
+        if (m_recording)
         {
-            if (xrel != 0 || yrel != 0)
-            {
-                m_onCursorMovement(xrel, yrel);
-            }
+            InputRecording::Frame frame;
+            frame.frameTime = frameTime;
+            frame.mouseX = xrel;
+            frame.mouseY = yrel;
+            int keyCount = 0;
+            const Uint8* keys = SDL_GetKeyboardState(&keyCount);
+            for (int key = 0; key < keyCount && key < static_cast<int>(InputRecording::KEY_COUNT); ++key)
+                frame.keys[key] = keys[key] != 0;
+            m_recorded.add(frame);
         }
     }
+
+    for (auto& handler : m_handlers)
+    {
+        handler.processInputs(xrel, yrel);
+    }
+}
+
+void InputSystem::startRecording()
+{
+    m_recorded = InputRecording();
+    m_recording = true;
+}
+
+InputRecording InputSystem::stopRecording()
+{
+    m_recording = false;
+    return std::move(m_recorded);
+}
+
+void InputSystem::startReplay(InputRecording recording)
+{
+    m_replay = std::move(recording);
+    m_replayFrame = 0;
+    m_replaying = true;
+    m_replayFinished = false;
+}
+
+void InputSystem::stopReplay()
+{
+    m_replay = InputRecording();
+    m_replaying = false;
+    m_replayFinished = false;
+}
+
+void InputHandler::processCursorMovement(int xrel, int yrel)
+{
+    if (m_onCursorMovement && (xrel != 0 || yrel != 0))
+    {
+        m_onCursorMovement(xrel, yrel);
+    }
 }
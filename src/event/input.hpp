@@ -1,6 +1,7 @@
 #ifndef INPUT_HPP_
 #define INPUT_HPP_
 
+#include <array>
 #include <functional>
 #include <iostream>
 #include <mutex>
@@ -9,6 +10,8 @@
 
 #include <SDL2/SDL.h>
 
+#include "input_recording.hpp"
+
 enum class Action
 {
     Up,
@@ -65,20 +68,26 @@ public:
     void setCursorMovementCallback(CursorMovementCallback callback) { m_onCursorMovement = callback; }
 
     /**
-     * @fn void processInputs()
+     * @fn void processInputs(int xrel, int yrel)
      * @brief Processes all input events.
      *
      * This function should be called to handle and dispatch input events.
+     *
+     * @param xrel The relative mouse motion of the frame, read by the InputSystem.
+     * @param yrel The relative mouse motion of the frame, read by the InputSystem.
      */
-    void processInputs() { processCursorMovement(); }
+    void processInputs(int xrel, int yrel) { processCursorMovement(xrel, yrel); }
 
     /**
-     * @fn void processCursorMovement()
+     * @fn void processCursorMovement(int xrel, int yrel)
      * @brief Processes cursor movement events.
      *
      * This function is called internally by processInputs() to handle cursor movement.
+     *
+     * @param xrel The relative mouse motion of the frame.
+     * @param yrel The relative mouse motion of the frame.
      */
-    void processCursorMovement();
+    void processCursorMovement(int xrel, int yrel);
 
 private:
     CursorMovementCallback m_onCursorMovement;
@@ -89,6 +98,12 @@ private:
  * @brief General input class that monitor input handlers and update the main
  * input pipeline. This class is a Singleton.
  *
+ * Each update() reads the keyboard and the mouse once for the frame. It can
+ * record them, with the frame time, into an InputRecording, or replay one
+ * instead of reading SDL, so a run can be repeated exactly: games read the
+ * keyboard with getKeyboardState() and the engine steps the simulation by
+ * getFrameTime(). Window events, such as quitting, are still read from SDL
+ * while replaying.
  */
 class InputSystem
 {
@@ -110,15 +125,54 @@ public:
      * @brief Update the main input pipeline.
      *
      * @param window
+     * @param frameTime The measured duration of the last frame in seconds, recorded when recording.
      */
-    void update(SDL_Window* window)
-    {
-        handleEvents(window);
-        for (auto& handler : m_handlers)
-        {
-            handler.processInputs();
-        }
-    }
+    void update(SDL_Window* window, double frameTime);
+
+    /**
+     * @brief Gets the keyboard state of the frame, to pass to getActions().
+     *
+     * @return SDL's keyboard state, or the replayed one, indexed by scancode.
+     */
+    const Uint8* getKeyboardState() const { return m_replaying ? m_replayKeys.data() : SDL_GetKeyboardState(nullptr); }
+
+    /**
+     * @brief Gets the duration of the last frame to simulate.
+     *
+     * @return The frameTime passed to update(), or the recorded one when replaying.
+     */
+    double getFrameTime() const { return m_frameTime; }
+
+    /**
+     * @brief Starts recording every following frame, dropping any previous recording.
+     */
+    void startRecording();
+
+    /**
+     * @brief Stops recording and hands over the frames recorded.
+     *
+     * @return The recording.
+     */
+    InputRecording stopRecording();
+
+    /**
+     * @brief Replays a recording from the next update() on, in place of the keyboard and the mouse.
+     *
+     * @param recording The frames to replay.
+     */
+    void startReplay(InputRecording recording);
+
+    /**
+     * @brief Goes back to live input, dropping the rest of the replay.
+     */
+    void stopReplay();
+
+    /**
+     * @brief Whether a replay ran out of frames.
+     *
+     * @return True once update() was called after the last replayed frame.
+     */
+    bool isReplayFinished() const { return m_replayFinished; }
 
     /**
      * @brief Add input handler to be updated by the input system.
@@ -152,6 +206,15 @@ private:
     bool m_running{true};
     std::vector<InputHandler> m_handlers;
 
+    double m_frameTime{};
+    bool m_recording{false};
+    bool m_replaying{false};
+    bool m_replayFinished{false};
+    InputRecording m_recorded;                                   // frames recorded so far
+    InputRecording m_replay;                                     // frames being replayed
+    std::size_t m_replayFrame{};                                 // next frame of m_replay
+    std::array<Uint8, InputRecording::KEY_COUNT> m_replayKeys{}; // the replayed frame, as SDL lays out its state
+
     InputSystem() = default;
 
     InputSystem(const InputSystem&) = delete;
@@ -0,0 +1,119 @@
+#include "input_recording.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr char INPUT_RECORDING_MAGIC[4] = {'L', 'I', 'N', 'P'};
+
+std::int16_t clampMotion(int value)
+{
+    return static_cast<std::int16_t>(std::clamp(value, -32768, 32767));
+}
+
+std::size_t keyBytes(std::size_t keyCount)
+{
+    return (keyCount + 7) / 8;
+}
+
+} // namespace
+
+void InputRecording::write(const std::string& path) const
+{
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Cannot write input recording " + path);
+
+    InputRecordingHeader header{};
+    std::memcpy(header.magic, INPUT_RECORDING_MAGIC, 4);
+    header.version = INPUT_RECORDING_VERSION;
+    header.keyCount = static_cast<std::uint32_t>(KEY_COUNT);
+    header.frameCount = static_cast<std::uint32_t>(m_frames.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<std::uint8_t> keys(keyBytes(KEY_COUNT));
+    for (std::size_t i = 0; i < m_frames.size(); ++i)
+    {
+        const Frame& frame = m_frames[i];
+        InputFrameRecord record{};
+        record.frameTime = frame.frameTime;
+        record.mouseX = clampMotion(frame.mouseX);
+        record.mouseY = clampMotion(frame.mouseY);
+        if (i == 0 || frame.keys != m_frames[i - 1].keys)
+            record.flags = InputFrameRecord::KEYS_CHANGED;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+        if (record.flags & InputFrameRecord::KEYS_CHANGED)
+        {
+            std::fill(keys.begin(), keys.end(), 0);
+            for (std::size_t key = 0; key < KEY_COUNT; ++key)
+            {
+                if (frame.keys[key])
+                    keys[key / 8] |= static_cast<std::uint8_t>(1u << (key % 8));
+            }
+            out.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size()));
+        }
+    }
+
+    if (!out)
+        throw std::runtime_error("Failed to write input recording " + path);
+}
+
+InputRecording InputRecording::read(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Cannot open input recording " + path);
+
+    InputRecordingHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, INPUT_RECORDING_MAGIC, 4) != 0)
+        throw std::runtime_error("Not an input recording: " + path);
+    if (header.version != INPUT_RECORDING_VERSION)
+        throw std::runtime_error("Unsupported input recording version in " + path);
+
+    // Every frame takes at least a record, so a count the file cannot hold is corrupt, not a reason to reserve.
+    const std::streamoff bodyStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto bodySize = static_cast<std::uint64_t>(in.tellg() - bodyStart);
+    in.seekg(bodyStart);
+    if (static_cast<std::uint64_t>(header.frameCount) * sizeof(InputFrameRecord) > bodySize)
+        throw std::runtime_error("Truncated input recording " + path);
+
+    // Scancodes this SDL does not know are dropped, missing ones stay released.
+    const std::size_t known = std::min<std::size_t>(header.keyCount, KEY_COUNT);
+    std::vector<std::uint8_t> keys(keyBytes(header.keyCount));
+
+    InputRecording recording;
+    recording.m_frames.reserve(header.frameCount);
+    Frame frame;
+    for (std::uint32_t i = 0; i < header.frameCount; ++i)
+    {
+        InputFrameRecord record{};
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+            throw std::runtime_error("Truncated input recording " + path);
+        frame.frameTime = record.frameTime;
+        frame.mouseX = record.mouseX;
+        frame.mouseY = record.mouseY;
+
+        if (record.flags & InputFrameRecord::KEYS_CHANGED)
+        {
+            if (!in.read(reinterpret_cast<char*>(keys.data()), static_cast<std::streamsize>(keys.size())))
+                throw std::runtime_error("Truncated input recording " + path);
+            frame.keys.reset();
+            for (std::size_t key = 0; key < known; ++key)
+                frame.keys[key] = (keys[key / 8] >> (key % 8)) & 1u;
+        }
+        recording.m_frames.push_back(frame);
+    }
+    return recording;
+}
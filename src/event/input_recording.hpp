@@ -0,0 +1,120 @@
+#ifndef INPUT_RECORDING_HPP_
+#define INPUT_RECORDING_HPP_
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+/**
+ * @brief Version of the input recording layout, bumped whenever it changes.
+ */
+constexpr std::uint32_t INPUT_RECORDING_VERSION = 1;
+
+/**
+ * @struct InputRecordingHeader
+ * @brief Fixed size header at the start of an input recording file.
+ */
+struct InputRecordingHeader
+{
+    char magic[4];            /**< "LINP". */
+    std::uint32_t version;    /**< INPUT_RECORDING_VERSION. */
+    std::uint32_t keyCount;   /**< Scancodes per keyboard state, SDL_NUM_SCANCODES when written. */
+    std::uint32_t frameCount; /**< Frame records that follow. */
+};
+
+/**
+ * @struct InputFrameRecord
+ * @brief One frame in an input recording file, followed by the keyboard when it changed.
+ *
+ * The keyboard follows as keyCount bits, rounded up to whole bytes, only when
+ * flags has KEYS_CHANGED; otherwise it is the same as in the previous frame.
+ */
+struct InputFrameRecord
+{
+    static constexpr std::uint8_t KEYS_CHANGED = 1; /**< The keyboard state follows the record. */
+
+    double frameTime;         /**< The frame duration in seconds. */
+    std::int16_t mouseX;      /**< Relative mouse motion, clamped to 16 bits. */
+    std::int16_t mouseY;      /**< Relative mouse motion, clamped to 16 bits. */
+    std::uint8_t flags;       /**< KEYS_CHANGED or 0. */
+    std::uint8_t reserved[3]; /**< Padding, zero. */
+};
+
+static_assert(sizeof(InputRecordingHeader) == 16, "Input recording header layout changed");
+static_assert(sizeof(InputFrameRecord) == 16, "Input frame record layout changed");
+
+/**
+ * @class InputRecording
+ * @brief The input of a run, frame by frame, to replay it exactly.
+ *
+ * Each frame holds what the InputSystem read from SDL at its start: the
+ * keyboard state, the relative mouse motion passed to the InputHandler
+ * callbacks, and the frame duration that drove the simulation. Files store
+ * the keyboard only when it changes, so a frame usually takes 16 bytes.
+ */
+class InputRecording
+{
+public:
+    static constexpr std::size_t KEY_COUNT = SDL_NUM_SCANCODES; /**< Scancodes per keyboard state. */
+
+    /**
+     * @brief The input of one frame.
+     */
+    struct Frame
+    {
+        double frameTime = 0.0;      /**< The frame duration in seconds. */
+        int mouseX = 0;              /**< Relative mouse motion dispatched to the handlers. */
+        int mouseY = 0;              /**< Relative mouse motion dispatched to the handlers. */
+        std::bitset<KEY_COUNT> keys; /**< The pressed scancodes. */
+    };
+
+    /**
+     * @brief Appends a frame.
+     *
+     * @param frame The input of the frame.
+     */
+    void add(const Frame& frame) { m_frames.push_back(frame); }
+
+    /**
+     * @brief Gets the number of frames.
+     *
+     * @return The frame count.
+     */
+    std::size_t size() const { return m_frames.size(); }
+
+    /**
+     * @brief Gets a frame.
+     *
+     * @param index The frame index, below size().
+     * @return The frame.
+     */
+    const Frame& getFrame(std::size_t index) const { return m_frames[index]; }
+
+    /**
+     * @brief Writes the recording.
+     *
+     * @param path The file to write.
+     *
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    void write(const std::string& path) const;
+
+    /**
+     * @brief Reads a recording written by write().
+     *
+     * @param path The file to read.
+     * @return The recording.
+     *
+     * @throw std::runtime_error If the file cannot be read or is not a valid recording.
+     */
+    static InputRecording read(const std::string& path);
+
+private:
+    std::vector<Frame> m_frames; /**< The frames, in order. */
+};
+
+#endif
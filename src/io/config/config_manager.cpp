@@ -1,17 +1,21 @@
 #include "config_manager.hpp"
 
+#include "virtual_file_system.hpp"
+
 ConfigurationManager* ConfigurationManager::instance = nullptr;
 
 json ConfigurationManager::parseJSON(const std::string& path)
 {
-    std::ifstream inputFile(path);
-    if (!inputFile.is_open())
+    IO::FileData file;
+    try
+    {
+        file = IO::VirtualFileSystem::getInstance().read(path);
+    }
+    catch (const std::exception&)
     {
         std::cerr << "Error opening file: " << path << std::endl;
         return nullptr;
     }
 
-    json buffer;
-    inputFile >> buffer;
-    return buffer;
+    return json::parse(file.text());
 }
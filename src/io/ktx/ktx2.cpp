@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <ktx2.hpp>
+
+namespace IO
+{
+
+namespace
+{
+
+constexpr std::uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr std::size_t HEADER_SIZE = 80;
+constexpr std::size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+constexpr char WRITER_KEY[] = "KTXwriter";
+constexpr char WRITER_VALUE[] = "LambEngine texture cooker";
+
+// Khronos data format descriptor color models for block compressed formats.
+constexpr std::uint8_t KHR_DF_MODEL_RGBSDA = 1;
+constexpr std::uint8_t KHR_DF_MODEL_BC1A = 128;
+constexpr std::uint8_t KHR_DF_MODEL_BC3 = 130;
+constexpr std::uint8_t KHR_DF_MODEL_BC5 = 132;
+constexpr std::uint8_t KHR_DF_MODEL_BC7 = 134;
+
+struct DfdSample
+{
+    std::uint16_t bitOffset;
+    std::uint8_t bitLength;
+    std::uint8_t channel;
+};
+
+void put32(std::vector<std::uint8_t>& out, std::size_t offset, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        out[offset + i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+void put64(std::vector<std::uint8_t>& out, std::size_t offset, std::uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        out[offset + i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+std::uint32_t get32(const std::uint8_t* bytes)
+{
+    return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) |
+           (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+std::uint64_t get64(const std::uint8_t* bytes)
+{
+    return static_cast<std::uint64_t>(get32(bytes)) | (static_cast<std::uint64_t>(get32(bytes + 4)) << 32);
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool isSrgb(Ktx2Format format)
+{
+    return format == Ktx2Format::R8G8B8A8_SRGB || format == Ktx2Format::BC1_RGB_SRGB ||
+           format == Ktx2Format::BC3_SRGB || format == Ktx2Format::BC7_SRGB;
+}
+
+struct FileLevel
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+/**
+ * Validates the header and returns the image description plus the file location
+ * of every level. Every level is checked to lie within the file and to have the
+ * size its format and dimensions imply; the payloads are left untouched.
+ */
+Ktx2Image parseHeader(const std::uint8_t* bytes, std::size_t size, std::vector<FileLevel>& fileLevels);
+
+std::vector<std::uint8_t> buildDataFormatDescriptor(Ktx2Format format)
+{
+    std::uint8_t colorModel = KHR_DF_MODEL_RGBSDA;
+    std::vector<DfdSample> samples;
+
+    switch (format)
+    {
+        case Ktx2Format::R8G8B8A8_UNORM:
+        case Ktx2Format::R8G8B8A8_SRGB:
+            samples = {{0, 7, 0}, {8, 7, 1}, {16, 7, 2}, {24, 7, 15}};
+            break;
+        case Ktx2Format::BC1_RGB_UNORM:
+        case Ktx2Format::BC1_RGB_SRGB:
+            colorModel = KHR_DF_MODEL_BC1A;
+            samples = {{0, 63, 0}};
+            break;
+        case Ktx2Format::BC3_UNORM:
+        case Ktx2Format::BC3_SRGB:
+            colorModel = KHR_DF_MODEL_BC3;
+            samples = {{0, 63, 15}, {64, 63, 0}};
+            break;
+        case Ktx2Format::BC5_UNORM:
+            colorModel = KHR_DF_MODEL_BC5;
+            samples = {{0, 63, 0}, {64, 63, 1}};
+            break;
+        case Ktx2Format::BC7_UNORM:
+        case Ktx2Format::BC7_SRGB:
+            colorModel = KHR_DF_MODEL_BC7;
+            samples = {{0, 127, 0}};
+            break;
+        default:
+            throw std::runtime_error("Unsupported KTX2 format: " + std::to_string(static_cast<std::uint32_t>(format)));
+    }
+
+    const std::size_t blockSize = 24 + 16 * samples.size();
+    std::vector<std::uint8_t> dfd(4 + blockSize, 0);
+
+    put32(dfd, 0, static_cast<std::uint32_t>(dfd.size()));
+    put32(dfd, 4, 0); // vendorId = Khronos, descriptorType = basic
+    put32(dfd, 8, 2u | (static_cast<std::uint32_t>(blockSize) << 16));
+    dfd[12] = colorModel;
+    dfd[13] = 1; // BT.709 primaries
+    dfd[14] = isSrgb(format) ? 2 : 1;
+    dfd[15] = 0; // straight alpha
+    if (isBlockCompressed(format))
+    {
+        dfd[16] = 3;
+        dfd[17] = 3;
+    }
+    dfd[20] = static_cast<std::uint8_t>(formatBlockBytes(format));
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        std::size_t base = 28 + 16 * i;
+        put32(dfd, base, samples[i].bitOffset | (static_cast<std::uint32_t>(samples[i].bitLength) << 16) |
+                             (static_cast<std::uint32_t>(samples[i].channel) << 24));
+        put32(dfd, base + 4, 0);
+        put32(dfd, base + 8, 0);
+        put32(dfd, base + 12, isBlockCompressed(format) ? 0xFFFFFFFFu : 0xFFu);
+    }
+
+    return dfd;
+}
+
+} // namespace
+
+bool isBlockCompressed(Ktx2Format format)
+{
+    switch (format)
+    {
+        case Ktx2Format::BC1_RGB_UNORM:
+        case Ktx2Format::BC1_RGB_SRGB:
+        case Ktx2Format::BC3_UNORM:
+        case Ktx2Format::BC3_SRGB:
+        case Ktx2Format::BC5_UNORM:
+        case Ktx2Format::BC7_UNORM:
+        case Ktx2Format::BC7_SRGB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::size_t formatBlockBytes(Ktx2Format format)
+{
+    switch (format)
+    {
+        case Ktx2Format::R8G8B8A8_UNORM:
+        case Ktx2Format::R8G8B8A8_SRGB:
+            return 4;
+        case Ktx2Format::BC1_RGB_UNORM:
+        case Ktx2Format::BC1_RGB_SRGB:
+            return 8;
+        case Ktx2Format::BC3_UNORM:
+        case Ktx2Format::BC3_SRGB:
+        case Ktx2Format::BC5_UNORM:
+        case Ktx2Format::BC7_UNORM:
+        case Ktx2Format::BC7_SRGB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+std::size_t levelByteSize(Ktx2Format format, std::uint32_t width, std::uint32_t height)
+{
+    if (isBlockCompressed(format))
+    {
+        std::size_t blocksX = std::max<std::uint32_t>(1, (width + 3) / 4);
+        std::size_t blocksY = std::max<std::uint32_t>(1, (height + 3) / 4);
+        return blocksX * blocksY * formatBlockBytes(format);
+    }
+    return static_cast<std::size_t>(width) * height * formatBlockBytes(format);
+}
+
+namespace
+{
+
+// Like mesh_cache's sectionFits: written so that offsets and sizes from the file cannot wrap.
+bool rangeFits(std::uint64_t offset, std::uint64_t length, std::size_t size)
+{
+    return offset <= size && length <= size - offset;
+}
+
+// levelByteSize(format, width, height) * layers == size, without overflowing on hostile dimensions.
+bool levelSizeMatches(Ktx2Format format, std::uint32_t width, std::uint32_t height, std::uint32_t layers,
+                      std::uint64_t size)
+{
+    std::uint64_t columns = width;
+    std::uint64_t rows = height;
+    if (isBlockCompressed(format))
+    {
+        columns = std::max<std::uint64_t>(1, (columns + 3) / 4);
+        rows = std::max<std::uint64_t>(1, (rows + 3) / 4);
+    }
+
+    // Each factor is at least 1, so a product above size is rejected before it can wrap.
+    if (rows > size / columns)
+        return false;
+    std::uint64_t layerSize = columns * rows;
+    const std::uint64_t unit = formatBlockBytes(format);
+    if (unit > size / layerSize)
+        return false;
+    layerSize *= unit;
+    return size % layerSize == 0 && size / layerSize == layers;
+}
+
+Ktx2Image parseHeader(const std::uint8_t* bytes, std::size_t size, std::vector<FileLevel>& fileLevels)
+{
+    if (size < HEADER_SIZE || std::memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        throw std::runtime_error("Not a KTX2 file");
+
+    Ktx2Image image;
+    image.format = static_cast<Ktx2Format>(get32(bytes + 12));
+    image.width = get32(bytes + 20);
+    image.height = get32(bytes + 24);
+    std::uint32_t depth = get32(bytes + 28);
+    image.layerCount = get32(bytes + 32);
+    std::uint32_t faceCount = get32(bytes + 36);
+    std::uint32_t levelCount = std::max<std::uint32_t>(1, get32(bytes + 40));
+    std::uint32_t supercompression = get32(bytes + 44);
+
+    if (formatBlockBytes(image.format) == 0)
+        throw std::runtime_error("Unsupported KTX2 format: " + std::to_string(get32(bytes + 12)));
+    if (depth > 1 || faceCount != 1)
+        throw std::runtime_error("Only 2D KTX2 textures and 2D arrays are supported");
+    if (supercompression != 0)
+        throw std::runtime_error("KTX2 supercompression is not supported");
+    if (image.width == 0 || image.height == 0)
+        throw std::runtime_error("Only 2D KTX2 textures and 2D arrays are supported");
+
+    // A full mip chain ends at 1x1, floor(log2(max(width, height))) + 1 levels.
+    std::uint32_t maxLevels = 1;
+    for (std::uint32_t side = std::max(image.width, image.height); side > 1; side >>= 1)
+        ++maxLevels;
+    if (levelCount > maxLevels)
+        throw std::runtime_error("KTX2 level count " + std::to_string(levelCount) + " exceeds the mip chain");
+    if (HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE > size)
+        throw std::runtime_error("Truncated KTX2 level index");
+
+    fileLevels.clear();
+    for (std::uint32_t level = 0; level < levelCount; ++level)
+    {
+        const std::uint8_t* entry = bytes + HEADER_SIZE + level * LEVEL_INDEX_ENTRY_SIZE;
+        const FileLevel fileLevel{get64(entry), get64(entry + 8)};
+        if (!rangeFits(fileLevel.offset, fileLevel.size, size))
+            throw std::runtime_error("Truncated KTX2 level data");
+
+        const std::uint32_t width = std::max<std::uint32_t>(1, image.width >> level);
+        const std::uint32_t height = std::max<std::uint32_t>(1, image.height >> level);
+        if (!levelSizeMatches(image.format, width, height, image.layers(), fileLevel.size))
+            throw std::runtime_error("KTX2 level " + std::to_string(level) + " has an unexpected size");
+
+        fileLevels.push_back(fileLevel);
+        image.levels.push_back(Ktx2Level{0, static_cast<std::size_t>(fileLevel.size)});
+    }
+
+    return image;
+}
+
+} // namespace
+
+Ktx2Image parseKTX2(const std::uint8_t* bytes, std::size_t size)
+{
+    std::vector<FileLevel> fileLevels;
+    Ktx2Image image = parseHeader(bytes, size, fileLevels);
+
+    std::size_t total = 0;
+    for (Ktx2Level& level : image.levels)
+    {
+        level.offset = total;
+        total += level.size;
+    }
+
+    // parseHeader() checked each level against the file and the mip chain, so total is below twice the file size.
+    image.data.resize(total);
+    for (std::size_t level = 0; level < image.levels.size(); ++level)
+    {
+        const Ktx2Level& target = image.levels[level];
+        std::memcpy(image.data.data() + target.offset, bytes + fileLevels[level].offset, target.size);
+    }
+
+    return image;
+}
+
+Ktx2Image readKTX2(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("File not found: " + path);
+
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return parseKTX2(bytes.data(), bytes.size());
+}
+
+Ktx2Image parseKTX2Tail(const std::uint8_t* bytes, std::size_t size, std::uint32_t maxDimension)
+{
+    std::vector<FileLevel> fileLevels;
+    Ktx2Image image = parseHeader(bytes, size, fileLevels);
+
+    const std::uint32_t levelCount = static_cast<std::uint32_t>(image.levels.size());
+    image.firstLevel = levelCount - 1;
+    while (image.firstLevel > 0 &&
+           std::max(image.width >> (image.firstLevel - 1), image.height >> (image.firstLevel - 1)) <= maxDimension)
+        image.firstLevel--;
+
+    std::size_t total = 0;
+    for (std::uint32_t level = image.firstLevel; level < levelCount; ++level)
+    {
+        image.levels[level].offset = total;
+        total += image.levels[level].size;
+    }
+
+    image.data.resize(total);
+    for (std::uint32_t level = image.firstLevel; level < levelCount; ++level)
+    {
+        const Ktx2Level& target = image.levels[level];
+        std::memcpy(image.data.data() + target.offset, bytes + fileLevels[level].offset, target.size);
+    }
+
+    return image;
+}
+
+std::vector<std::uint8_t> parseKTX2Level(const std::uint8_t* bytes, std::size_t size, std::uint32_t level)
+{
+    std::vector<FileLevel> fileLevels;
+    parseHeader(bytes, size, fileLevels);
+
+    if (level >= fileLevels.size())
+        throw std::runtime_error("KTX2 level " + std::to_string(level) + " does not exist");
+
+    const std::uint8_t* start = bytes + fileLevels[level].offset;
+    return std::vector<std::uint8_t>(start, start + fileLevels[level].size);
+}
+
+std::vector<std::uint8_t> encodeKTX2(const Ktx2Image& image)
+{
+    if (image.firstLevel != 0)
+        throw std::runtime_error("Cannot encode a partially loaded KTX2 image");
+
+    if (image.levels.empty())
+        throw std::runtime_error("KTX2 image has no level");
+
+    for (std::size_t level = 0; level < image.levels.size(); ++level)
+    {
+        std::uint32_t width = std::max<std::uint32_t>(1, image.width >> level);
+        std::uint32_t height = std::max<std::uint32_t>(1, image.height >> level);
+        if (image.levels[level].size != levelByteSize(image.format, width, height) * image.layers())
+            throw std::runtime_error("KTX2 level " + std::to_string(level) + " has an unexpected size");
+    }
+
+    const std::vector<std::uint8_t> dfd = buildDataFormatDescriptor(image.format);
+
+    const std::size_t kvdPayload = sizeof(WRITER_KEY) + sizeof(WRITER_VALUE);
+    const std::size_t kvdLength = alignUp(4 + kvdPayload, 4);
+
+    const std::size_t levelCount = image.levels.size();
+    const std::size_t dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE;
+    const std::size_t kvdOffset = dfdOffset + dfd.size();
+    const std::size_t levelAlignment = std::max<std::size_t>(4, formatBlockBytes(image.format));
+
+    // Levels go smallest first so a streaming reader can stop early.
+    std::vector<std::size_t> fileOffsets(levelCount);
+    std::size_t cursor = kvdOffset + kvdLength;
+    for (std::size_t level = levelCount; level-- > 0;)
+    {
+        cursor = alignUp(cursor, levelAlignment);
+        fileOffsets[level] = cursor;
+        cursor += image.levels[level].size;
+    }
+
+    std::vector<std::uint8_t> out(cursor, 0);
+    std::memcpy(out.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    put32(out, 12, static_cast<std::uint32_t>(image.format));
+    put32(out, 16, 1); // typeSize
+    put32(out, 20, image.width);
+    put32(out, 24, image.height);
+    put32(out, 28, 0); // pixelDepth
+    put32(out, 32, image.layerCount);
+    put32(out, 36, 1); // faceCount
+    put32(out, 40, static_cast<std::uint32_t>(levelCount));
+    put32(out, 44, 0); // supercompressionScheme
+
+    put32(out, 48, static_cast<std::uint32_t>(dfdOffset));
+    put32(out, 52, static_cast<std::uint32_t>(dfd.size()));
+    put32(out, 56, static_cast<std::uint32_t>(kvdOffset));
+    put32(out, 60, static_cast<std::uint32_t>(kvdLength));
+    put64(out, 64, 0);
+    put64(out, 72, 0);
+
+    for (std::size_t level = 0; level < levelCount; ++level)
+    {
+        std::size_t entry = HEADER_SIZE + level * LEVEL_INDEX_ENTRY_SIZE;
+        put64(out, entry, fileOffsets[level]);
+        put64(out, entry + 8, image.levels[level].size);
+        put64(out, entry + 16, image.levels[level].size);
+
+        std::memcpy(out.data() + fileOffsets[level], image.data.data() + image.levels[level].offset,
+                    image.levels[level].size);
+    }
+
+    std::memcpy(out.data() + dfdOffset, dfd.data(), dfd.size());
+
+    put32(out, kvdOffset, static_cast<std::uint32_t>(kvdPayload));
+    std::memcpy(out.data() + kvdOffset + 4, WRITER_KEY, sizeof(WRITER_KEY));
+    std::memcpy(out.data() + kvdOffset + 4 + sizeof(WRITER_KEY), WRITER_VALUE, sizeof(WRITER_VALUE));
+
+    return out;
+}
+
+void writeKTX2(const std::string& path, const Ktx2Image& image)
+{
+    std::vector<std::uint8_t> bytes = encodeKTX2(image);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open file for writing: " + path);
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+        throw std::runtime_error("Failed to write file: " + path);
+}
+
+} // namespace IO
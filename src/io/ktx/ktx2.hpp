@@ -0,0 +1,167 @@
+#ifndef KTX2_HPP_
+#define KTX2_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace IO
+{
+/**
+ * @enum Ktx2Format
+ * @brief Subset of Vulkan formats the engine reads and writes in KTX2 containers.
+ *
+ * Values are the VkFormat enumerants stored in the KTX2 header.
+ */
+enum class Ktx2Format : std::uint32_t
+{
+    UNDEFINED = 0,       /**< Unknown or unsupported format. */
+    R8G8B8A8_UNORM = 37, /**< Uncompressed 8-bit RGBA. */
+    R8G8B8A8_SRGB = 43,  /**< Uncompressed 8-bit RGBA, sRGB encoded. */
+    BC1_RGB_UNORM = 131, /**< BC1 (DXT1), opaque RGB, 8 bytes per block. */
+    BC1_RGB_SRGB = 132,  /**< BC1 (DXT1), opaque RGB, sRGB encoded. */
+    BC3_UNORM = 137,     /**< BC3 (DXT5), RGBA with interpolated alpha, 16 bytes per block. */
+    BC3_SRGB = 138,      /**< BC3 (DXT5), sRGB encoded. */
+    BC5_UNORM = 141,     /**< BC5 (RGTC2), two channels, 16 bytes per block. */
+    BC7_UNORM = 145,     /**< BC7 (BPTC), RGBA, 16 bytes per block. */
+    BC7_SRGB = 146       /**< BC7 (BPTC), sRGB encoded. */
+};
+
+/**
+ * @struct Ktx2Level
+ * @brief Location of one mip level inside Ktx2Image::data.
+ *
+ * A level holds every array layer of that mip, layer after layer.
+ */
+struct Ktx2Level
+{
+    std::size_t offset = 0; /**< Byte offset of the level in Ktx2Image::data. */
+    std::size_t size = 0;   /**< Size of the level in bytes, all layers included. */
+};
+
+/**
+ * @struct Ktx2Image
+ * @brief In-memory KTX2 texture: header fields plus the raw level payloads.
+ *
+ * Level 0 is the full resolution image. Supercompression is not supported.
+ * When only the tail of the mip chain was parsed (see parseKTX2Tail), levels below
+ * firstLevel keep their size but have no payload in data.
+ */
+struct Ktx2Image
+{
+    Ktx2Format format = Ktx2Format::UNDEFINED; /**< The pixel format of every level. */
+    std::uint32_t width = 0;                   /**< Width of level 0 in pixels. */
+    std::uint32_t height = 0;                  /**< Height of level 0 in pixels. */
+    std::uint32_t layerCount = 0;              /**< Number of array layers, 0 for a plain 2D texture. */
+    std::uint32_t firstLevel = 0;              /**< First level whose payload is present in data. */
+    std::vector<Ktx2Level> levels;             /**< The mip levels, largest first. */
+    std::vector<std::uint8_t> data;            /**< Concatenated level payloads. */
+
+    /**
+     * @brief Gets the number of layers stored per level.
+     *
+     * @return 1 for plain textures, layerCount for arrays.
+     */
+    std::uint32_t layers() const { return layerCount == 0 ? 1 : layerCount; }
+};
+
+/**
+ * @brief Tells whether a format is stored as 4x4 compressed blocks.
+ *
+ * @param format The format to query.
+ * @return true for BC formats.
+ */
+bool isBlockCompressed(Ktx2Format format);
+
+/**
+ * @brief Gets the size of one 4x4 block, or of one pixel for uncompressed formats.
+ *
+ * @param format The format to query.
+ * @return The size in bytes, 0 for unsupported formats.
+ */
+std::size_t formatBlockBytes(Ktx2Format format);
+
+/**
+ * @brief Computes the byte size of one layer of a mip level.
+ *
+ * @param format The pixel format.
+ * @param width Width of the level in pixels.
+ * @param height Height of the level in pixels.
+ * @return The size in bytes.
+ */
+std::size_t levelByteSize(Ktx2Format format, std::uint32_t width, std::uint32_t height);
+
+/**
+ * @brief Parses a KTX2 container held in memory.
+ *
+ * @param bytes Pointer to the file content.
+ * @param size Size of the file content in bytes.
+ * @return The parsed image.
+ *
+ * @throw std::runtime_error If the data is not a supported KTX2 file.
+ */
+Ktx2Image parseKTX2(const std::uint8_t* bytes, std::size_t size);
+
+/**
+ * @brief Reads and parses a KTX2 file.
+ *
+ * @param path The file path to the KTX2 file.
+ * @return The parsed image.
+ *
+ * @throw std::runtime_error If the file cannot be opened or is not a supported KTX2 file.
+ */
+Ktx2Image readKTX2(const std::string& path);
+
+/**
+ * @brief Parses only the small end of the mip chain of a KTX2 container held in memory.
+ *
+ * Levels whose largest side exceeds maxDimension are described but not copied,
+ * the last level is always copied.
+ *
+ * @param bytes Pointer to the file content.
+ * @param size Size of the file content in bytes.
+ * @param maxDimension Largest width or height of the levels to copy.
+ * @return The partially loaded image, firstLevel tells which levels are present.
+ *
+ * @throw std::runtime_error If the data is not a supported KTX2 file.
+ */
+Ktx2Image parseKTX2Tail(const std::uint8_t* bytes, std::size_t size, std::uint32_t maxDimension);
+
+/**
+ * @brief Copies the payload of a single level out of a KTX2 container held in memory.
+ *
+ * @param bytes Pointer to the file content.
+ * @param size Size of the file content in bytes.
+ * @param level The level to copy, 0 being the largest.
+ * @return The level payload, every layer included.
+ *
+ * @throw std::runtime_error If the data is not a supported KTX2 file or the level does not exist.
+ */
+std::vector<std::uint8_t> parseKTX2Level(const std::uint8_t* bytes, std::size_t size, std::uint32_t level);
+
+/**
+ * @brief Serializes an image into a KTX2 container.
+ *
+ * Writes the header, level index, a basic data format descriptor and a KTXwriter
+ * key/value entry, then the levels from smallest to largest as the spec requires.
+ *
+ * @param image The image to serialize.
+ * @return The file content.
+ *
+ * @throw std::runtime_error If the format is unsupported or level sizes do not match.
+ */
+std::vector<std::uint8_t> encodeKTX2(const Ktx2Image& image);
+
+/**
+ * @brief Serializes an image and writes it to disk.
+ *
+ * @param path The output file path.
+ * @param image The image to write.
+ *
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writeKTX2(const std::string& path, const Ktx2Image& image);
+}; // namespace IO
+
+#endif
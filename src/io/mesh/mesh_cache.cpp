@@ -0,0 +1,194 @@
+#include "mesh_cache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace IO
+{
+
+namespace
+{
+
+constexpr char MESH_CACHE_MAGIC[4] = {'L', 'M', 'S', 'H'};
+constexpr std::uint64_t SECTION_ALIGNMENT = 16;
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t alignSection(std::uint64_t offset)
+{
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+bool sectionFits(std::uint64_t offset, std::uint64_t size, std::size_t fileSize)
+{
+    return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+/**
+ * Copies a section at its offset, growing the buffer as needed.
+ */
+void putSection(std::vector<std::uint8_t>& file, std::uint64_t offset, const void* data, std::size_t size)
+{
+    if (file.size() < offset + size)
+        file.resize(offset + size, 0);
+    if (size > 0)
+        std::memcpy(file.data() + offset, data, size);
+}
+
+} // namespace
+
+MeshCacheFile::MeshCacheFile(const std::string& path, std::uint64_t sourceHash, std::uint32_t importFlags,
+                             std::uint32_t vertexStride)
+    : m_file(path)
+{
+    if (m_file.size() < sizeof(MeshCacheHeader))
+        throw std::runtime_error("Mesh cache file is truncated: " + path);
+
+    m_header = reinterpret_cast<const MeshCacheHeader*>(m_file.data());
+    const MeshCacheHeader& header = *m_header;
+    if (std::memcmp(header.magic, MESH_CACHE_MAGIC, 4) != 0 || header.version != MESH_CACHE_VERSION)
+        throw std::runtime_error("Not a mesh cache file of this version: " + path);
+    if (header.sourceHash != sourceHash || header.importFlags != importFlags || header.vertexStride != vertexStride)
+        throw std::runtime_error("Mesh cache file is stale: " + path);
+
+    const std::size_t size = m_file.size();
+    if (!sectionFits(header.submeshOffset, std::uint64_t(header.submeshCount) * sizeof(MeshCacheSubmesh), size) ||
+        !sectionFits(header.textureOffset, std::uint64_t(header.textureCount) * sizeof(MeshCacheTexture), size) ||
+        !sectionFits(header.stringOffset, header.stringBytes, size) ||
+        !sectionFits(header.vertexOffset, header.vertexBytes, size) ||
+        !sectionFits(header.indexOffset, header.indexBytes, size))
+        throw std::runtime_error("Mesh cache file is truncated: " + path);
+
+    m_submeshes = reinterpret_cast<const MeshCacheSubmesh*>(m_file.data() + header.submeshOffset);
+    m_textures = reinterpret_cast<const MeshCacheTexture*>(m_file.data() + header.textureOffset);
+
+    // Validate every range once so the accessors can stay unchecked.
+    const std::uint64_t vertexCount = header.vertexBytes / vertexStride;
+    const std::uint64_t indexCount = header.indexBytes / sizeof(std::uint32_t);
+    for (std::uint32_t i = 0; i < header.submeshCount; ++i)
+    {
+        const MeshCacheSubmesh& submesh = m_submeshes[i];
+        if (std::uint64_t(submesh.firstVertex) + submesh.vertexCount > vertexCount ||
+            std::uint64_t(submesh.firstIndex) + submesh.indexCount > indexCount ||
+            std::uint64_t(submesh.firstTexture) + submesh.textureCount > header.textureCount)
+            throw std::runtime_error("Mesh cache file has an invalid submesh: " + path);
+    }
+    for (std::uint32_t i = 0; i < header.textureCount; ++i)
+    {
+        if (std::uint64_t(m_textures[i].pathOffset) + m_textures[i].pathLength > header.stringBytes)
+            throw std::runtime_error("Mesh cache file has an invalid texture path: " + path);
+    }
+}
+
+std::string_view MeshCacheFile::texturePath(std::size_t index) const
+{
+    const MeshCacheTexture& texture = m_textures[index];
+    return std::string_view(reinterpret_cast<const char*>(m_file.data() + m_header->stringOffset) + texture.pathOffset,
+                            texture.pathLength);
+}
+
+const std::uint8_t* MeshCacheFile::vertices(const MeshCacheSubmesh& submesh) const
+{
+    return m_file.data() + m_header->vertexOffset + std::uint64_t(submesh.firstVertex) * m_header->vertexStride;
+}
+
+const std::uint32_t* MeshCacheFile::indices(const MeshCacheSubmesh& submesh) const
+{
+    return reinterpret_cast<const std::uint32_t*>(m_file.data() + m_header->indexOffset) + submesh.firstIndex;
+}
+
+std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size)
+{
+    std::uint64_t hash = FNV_OFFSET;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::uint64_t hashFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open " + path);
+
+    std::uint64_t hash = FNV_OFFSET;
+    char buffer[64 * 1024];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+        const std::streamsize count = file.gcount();
+        for (std::streamsize i = 0; i < count; ++i)
+        {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+void writeMeshCache(const std::string& path, const MeshCacheData& data)
+{
+    if (data.textureTypes.size() != data.texturePaths.size())
+        throw std::runtime_error("Mesh cache texture types and paths differ in count");
+
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+    header.version = MESH_CACHE_VERSION;
+    header.sourceHash = data.sourceHash;
+    header.importFlags = data.importFlags;
+    header.vertexStride = data.vertexStride;
+    header.submeshCount = static_cast<std::uint32_t>(data.submeshes.size());
+    header.textureCount = static_cast<std::uint32_t>(data.texturePaths.size());
+    std::memcpy(header.boundsMin, data.boundsMin, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, data.boundsMax, sizeof(header.boundsMax));
+
+    std::vector<MeshCacheTexture> textures(data.texturePaths.size());
+    std::string strings;
+    for (std::size_t i = 0; i < textures.size(); ++i)
+    {
+        textures[i].type = data.textureTypes[i];
+        textures[i].pathOffset = static_cast<std::uint32_t>(strings.size());
+        textures[i].pathLength = static_cast<std::uint32_t>(data.texturePaths[i].size());
+        strings += data.texturePaths[i];
+    }
+
+    header.submeshOffset = alignSection(sizeof(MeshCacheHeader));
+    header.textureOffset = alignSection(header.submeshOffset + data.submeshes.size() * sizeof(MeshCacheSubmesh));
+    header.stringOffset = alignSection(header.textureOffset + textures.size() * sizeof(MeshCacheTexture));
+    header.stringBytes = strings.size();
+    header.vertexOffset = alignSection(header.stringOffset + header.stringBytes);
+    header.vertexBytes = data.vertices.size();
+    header.indexOffset = alignSection(header.vertexOffset + header.vertexBytes);
+    header.indexBytes = data.indices.size() * sizeof(std::uint32_t);
+
+    std::vector<std::uint8_t> file;
+    putSection(file, 0, &header, sizeof(header));
+    putSection(file, header.submeshOffset, data.submeshes.data(), data.submeshes.size() * sizeof(MeshCacheSubmesh));
+    putSection(file, header.textureOffset, textures.data(), textures.size() * sizeof(MeshCacheTexture));
+    putSection(file, header.stringOffset, strings.data(), strings.size());
+    putSection(file, header.vertexOffset, data.vertices.data(), data.vertices.size());
+    putSection(file, header.indexOffset, data.indices.data(), header.indexBytes);
+
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path());
+
+    // Written next to the target then renamed, so a crash never leaves a truncated cache behind.
+    const std::filesystem::path temporary = target.string() + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Cannot write " + temporary.string());
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out)
+            throw std::runtime_error("Cannot write " + temporary.string());
+    }
+    std::filesystem::rename(temporary, target);
+}
+
+} // namespace IO
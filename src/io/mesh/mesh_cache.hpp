@@ -0,0 +1,201 @@
+#ifndef MESH_CACHE_HPP_
+#define MESH_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace IO
+{
+/**
+ * @brief Version of the mesh cache layout, bumped whenever it changes.
+ */
+constexpr std::uint32_t MESH_CACHE_VERSION = 1;
+
+/**
+ * @struct MeshCacheHeader
+ * @brief Fixed size header at the start of a mesh cache file.
+ *
+ * Every section offset is a multiple of 16 so blobs can be used in place.
+ */
+struct alignas(16) MeshCacheHeader
+{
+    char magic[4];               /**< "LMSH". */
+    std::uint32_t version;       /**< MESH_CACHE_VERSION. */
+    std::uint64_t sourceHash;    /**< Hash of the source file bytes. */
+    std::uint32_t importFlags;   /**< Import flags the source was processed with. */
+    std::uint32_t vertexStride;  /**< Size of one vertex in bytes. */
+    std::uint32_t submeshCount;  /**< Entries in the submesh table. */
+    std::uint32_t textureCount;  /**< Entries in the texture reference table. */
+    std::uint64_t submeshOffset; /**< Offset of the submesh table. */
+    std::uint64_t textureOffset; /**< Offset of the texture reference table. */
+    std::uint64_t stringOffset;  /**< Offset of the string blob. */
+    std::uint64_t stringBytes;   /**< Size of the string blob. */
+    std::uint64_t vertexOffset;  /**< Offset of the vertex blob. */
+    std::uint64_t vertexBytes;   /**< Size of the vertex blob. */
+    std::uint64_t indexOffset;   /**< Offset of the index blob. */
+    std::uint64_t indexBytes;    /**< Size of the index blob, 32-bit indices. */
+    float boundsMin[3];          /**< Minimum corner of the model bounding box. */
+    float boundsMax[3];          /**< Maximum corner of the model bounding box. */
+};
+
+/**
+ * @struct MeshCacheSubmesh
+ * @brief One mesh of the model: ranges in the shared blobs plus precomputed draw data.
+ */
+struct alignas(16) MeshCacheSubmesh
+{
+    std::uint32_t firstVertex = 0;  /**< First vertex in the vertex blob. */
+    std::uint32_t vertexCount = 0;  /**< Number of vertices. */
+    std::uint32_t firstIndex = 0;   /**< First index in the index blob; indices are relative to firstVertex. */
+    std::uint32_t indexCount = 0;   /**< Number of indices. */
+    std::uint32_t firstTexture = 0; /**< First entry in the texture reference table. */
+    std::uint32_t textureCount = 0; /**< Number of texture references. */
+    float boundsCenter[3] = {};     /**< Center of the bounding sphere. */
+    float boundsRadius = 0.0f;      /**< Radius of the bounding sphere. */
+    float uvDensity = 0.0f;         /**< UV area per model space area. */
+    std::uint32_t reserved = 0;     /**< Padding, zero. */
+};
+
+/**
+ * @struct MeshCacheTexture
+ * @brief A material texture referenced by a submesh.
+ */
+struct alignas(16) MeshCacheTexture
+{
+    std::uint32_t type = 0;       /**< Texture type, as the engine's TextureType value. */
+    std::uint32_t pathOffset = 0; /**< Offset of the path in the string blob. */
+    std::uint32_t pathLength = 0; /**< Length of the path. */
+    std::uint32_t reserved = 0;   /**< Padding, zero. */
+};
+
+static_assert(sizeof(MeshCacheHeader) == 128, "Mesh cache header layout changed");
+static_assert(sizeof(MeshCacheSubmesh) == 48, "Mesh cache submesh layout changed");
+static_assert(sizeof(MeshCacheTexture) == 16, "Mesh cache texture layout changed");
+
+/**
+ * @struct MeshCacheData
+ * @brief Everything written to a mesh cache file.
+ */
+struct MeshCacheData
+{
+    std::uint64_t sourceHash = 0;            /**< Hash of the source file bytes. */
+    std::uint32_t importFlags = 0;           /**< Import flags the source was processed with. */
+    std::uint32_t vertexStride = 0;          /**< Size of one vertex in bytes. */
+    std::vector<MeshCacheSubmesh> submeshes; /**< The submesh table. */
+    std::vector<std::uint32_t> textureTypes; /**< Type of every texture reference. */
+    std::vector<std::string> texturePaths;   /**< Path of every texture reference. */
+    std::vector<std::uint8_t> vertices;      /**< Every vertex of every submesh. */
+    std::vector<std::uint32_t> indices;      /**< Every index of every submesh. */
+    float boundsMin[3] = {};                 /**< Minimum corner of the model bounding box. */
+    float boundsMax[3] = {};                 /**< Maximum corner of the model bounding box. */
+};
+
+/**
+ * @class MeshCacheFile
+ * @brief A memory mapped mesh cache file, read in place without parsing.
+ */
+class MeshCacheFile
+{
+public:
+    /**
+     * @brief Maps a cache file and checks that it matches the expected source.
+     *
+     * @param path The cache file.
+     * @param sourceHash The hash of the current source file.
+     * @param importFlags The import flags the caller would use.
+     * @param vertexStride The size of the caller's vertex type.
+     *
+     * @throw std::runtime_error If the file is missing, truncated, of another version or stale.
+     */
+    MeshCacheFile(const std::string& path, std::uint64_t sourceHash, std::uint32_t importFlags,
+                  std::uint32_t vertexStride);
+
+    /**
+     * @brief Gets the file header.
+     *
+     * @return The header.
+     */
+    const MeshCacheHeader& header() const { return *m_header; }
+
+    /**
+     * @brief Gets the submesh table.
+     *
+     * @return The first entry, header().submeshCount entries in total.
+     */
+    const MeshCacheSubmesh* submeshes() const { return m_submeshes; }
+
+    /**
+     * @brief Gets the type of a texture reference.
+     *
+     * @param index Index in the texture reference table.
+     * @return The texture type.
+     */
+    std::uint32_t textureType(std::size_t index) const { return m_textures[index].type; }
+
+    /**
+     * @brief Gets the path of a texture reference.
+     *
+     * @param index Index in the texture reference table.
+     * @return A view into the mapped file.
+     */
+    std::string_view texturePath(std::size_t index) const;
+
+    /**
+     * @brief Gets the vertices of a submesh.
+     *
+     * @param submesh The submesh.
+     * @return A pointer into the mapped file, vertexCount * vertexStride bytes long.
+     */
+    const std::uint8_t* vertices(const MeshCacheSubmesh& submesh) const;
+
+    /**
+     * @brief Gets the indices of a submesh.
+     *
+     * @param submesh The submesh.
+     * @return A pointer into the mapped file, indexCount indices long.
+     */
+    const std::uint32_t* indices(const MeshCacheSubmesh& submesh) const;
+
+private:
+    MappedFile m_file;                             /**< The mapping, owning the bytes below. */
+    const MeshCacheHeader* m_header = nullptr;     /**< The header. */
+    const MeshCacheSubmesh* m_submeshes = nullptr; /**< The submesh table. */
+    const MeshCacheTexture* m_textures = nullptr;  /**< The texture reference table. */
+};
+
+/**
+ * @brief Hashes bytes with 64-bit FNV-1a, matching hashFile() for the same content.
+ *
+ * @param data The bytes to hash.
+ * @param size The number of bytes.
+ * @return The hash.
+ */
+std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size);
+
+/**
+ * @brief Hashes a file with 64-bit FNV-1a.
+ *
+ * @param path The file to hash.
+ * @return The hash.
+ *
+ * @throw std::runtime_error If the file cannot be read.
+ */
+std::uint64_t hashFile(const std::string& path);
+
+/**
+ * @brief Writes a mesh cache file, replacing it atomically.
+ *
+ * @param path The destination.
+ * @param data The content.
+ *
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writeMeshCache(const std::string& path, const MeshCacheData& data);
+}; // namespace IO
+
+#endif
@@ -1,19 +1,24 @@
-#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 
 #include <material.hpp>
 #include <mtl_parser.hpp>
+#include <virtual_file_system.hpp>
 
 namespace IO
 {
 
 std::unordered_map<MaterialType, Material> parseMTL(const std::string& path)
 {
-    std::ifstream file(path);
-    if (!file)
+    std::istringstream file;
+    try
+    {
+        file.str(std::string(VirtualFileSystem::getInstance().read(path).text()));
+    }
+    catch (const std::exception&)
     {
         std::cerr << "Error when opening MTL file: " << path << std::endl;
         throw std::runtime_error("File not found: " + path);
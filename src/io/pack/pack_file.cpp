@@ -0,0 +1,316 @@
+#include "pack_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <lz4.h>
+
+namespace IO
+{
+
+namespace
+{
+
+constexpr char PACK_MAGIC[4] = {'L', 'P', 'A', 'K'};
+constexpr std::uint64_t SECTION_ALIGNMENT = 16;
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t fnv1a(const void* data, std::size_t size)
+{
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    std::uint64_t hash = FNV_OFFSET;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::uint64_t alignSection(std::uint64_t offset)
+{
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+bool sectionFits(std::uint64_t offset, std::uint64_t size, std::size_t fileSize)
+{
+    return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+/**
+ * Copies a section at its offset, growing the buffer as needed.
+ */
+void putSection(std::vector<std::uint8_t>& file, std::uint64_t offset, const void* data, std::size_t size)
+{
+    if (file.size() < offset + size)
+        file.resize(offset + size, 0);
+    if (size > 0)
+        std::memcpy(file.data() + offset, data, size);
+}
+
+/**
+ * Compresses a blob, returning nothing when LZ4 does not save an eighth of it.
+ */
+std::vector<std::uint8_t> compressLZ4(const std::vector<std::uint8_t>& bytes)
+{
+    if (bytes.empty() || bytes.size() > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+        return {};
+
+    const int sourceSize = static_cast<int>(bytes.size());
+    std::vector<std::uint8_t> compressed(static_cast<std::size_t>(LZ4_compressBound(sourceSize)));
+    const int written = LZ4_compress_default(reinterpret_cast<const char*>(bytes.data()),
+                                             reinterpret_cast<char*>(compressed.data()), sourceSize,
+                                             static_cast<int>(compressed.size()));
+    if (written <= 0 || static_cast<std::size_t>(written) > bytes.size() - bytes.size() / 8)
+        return {};
+
+    compressed.resize(static_cast<std::size_t>(written));
+    return compressed;
+}
+
+} // namespace
+
+std::string normalizePackPath(std::string_view path)
+{
+    std::string slashes(path);
+    std::replace(slashes.begin(), slashes.end(), '\\', '/');
+
+    std::string normalized = std::filesystem::path(slashes).lexically_normal().generic_string();
+    if (normalized.rfind("./", 0) == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+std::uint64_t hashPackPath(std::string_view path)
+{
+    return fnv1a(path.data(), path.size());
+}
+
+PackStats writePack(const std::string& path, const std::vector<PackInput>& inputs, bool compress)
+{
+    PackStats stats;
+
+    struct PendingEntry
+    {
+        std::string path;
+        std::uint64_t hash = 0;
+        std::uint32_t blob = 0;
+    };
+
+    std::vector<PendingEntry> entries;
+    std::vector<PackBlob> blobs;
+    std::vector<std::vector<std::uint8_t>> storedBytes;
+    std::vector<std::size_t> blobInputs;
+    std::unordered_multimap<std::uint64_t, std::uint32_t> blobsByHash;
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        const PackInput& input = inputs[i];
+        const std::uint64_t contentHash = fnv1a(input.bytes.data(), input.bytes.size());
+        stats.inputBytes += input.bytes.size();
+
+        // Content addressed: a hash match is confirmed byte for byte before sharing the blob.
+        std::uint32_t blob = std::numeric_limits<std::uint32_t>::max();
+        auto [first, last] = blobsByHash.equal_range(contentHash);
+        for (auto it = first; it != last; ++it)
+        {
+            if (inputs[blobInputs[it->second]].bytes == input.bytes)
+            {
+                blob = it->second;
+                break;
+            }
+        }
+
+        if (blob == std::numeric_limits<std::uint32_t>::max())
+        {
+            blob = static_cast<std::uint32_t>(blobs.size());
+            blobsByHash.emplace(contentHash, blob);
+            blobInputs.push_back(i);
+
+            PackBlob packed;
+            packed.contentHash = contentHash;
+            packed.size = input.bytes.size();
+
+            std::vector<std::uint8_t> compressed = compress ? compressLZ4(input.bytes) : std::vector<std::uint8_t>();
+            if (!compressed.empty())
+            {
+                packed.compression = PackCompression::LZ4;
+                storedBytes.push_back(std::move(compressed));
+                stats.compressed++;
+            }
+            else
+            {
+                storedBytes.push_back(input.bytes);
+            }
+            packed.storedSize = storedBytes.back().size();
+            stats.storedBytes += packed.storedSize;
+            blobs.push_back(packed);
+        }
+
+        const std::string normalized = normalizePackPath(input.path);
+        entries.push_back(PendingEntry{normalized, hashPackPath(normalized), blob});
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const PendingEntry& a, const PendingEntry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.path < b.path;
+    });
+    for (std::size_t i = 1; i < entries.size(); ++i)
+    {
+        if (entries[i].path == entries[i - 1].path)
+            throw std::runtime_error("Pack input listed twice: " + entries[i].path);
+    }
+
+    std::string strings;
+    std::vector<PackEntry> table;
+    for (const PendingEntry& pending : entries)
+    {
+        PackEntry entry;
+        entry.pathHash = pending.hash;
+        entry.pathOffset = static_cast<std::uint32_t>(strings.size());
+        entry.pathLength = static_cast<std::uint32_t>(pending.path.size());
+        entry.blob = pending.blob;
+        strings += pending.path;
+        table.push_back(entry);
+    }
+
+    PackHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(table.size());
+    header.blobCount = static_cast<std::uint32_t>(blobs.size());
+    header.entryOffset = alignSection(sizeof(PackHeader));
+    header.blobOffset = alignSection(header.entryOffset + table.size() * sizeof(PackEntry));
+    header.stringOffset = alignSection(header.blobOffset + blobs.size() * sizeof(PackBlob));
+    header.stringBytes = strings.size();
+
+    std::uint64_t offset = alignSection(header.stringOffset + header.stringBytes);
+    for (PackBlob& blob : blobs)
+    {
+        blob.offset = offset;
+        offset = alignSection(offset + blob.storedSize);
+    }
+
+    std::vector<std::uint8_t> file;
+    putSection(file, 0, &header, sizeof(header));
+    putSection(file, header.entryOffset, table.data(), table.size() * sizeof(PackEntry));
+    putSection(file, header.blobOffset, blobs.data(), blobs.size() * sizeof(PackBlob));
+    putSection(file, header.stringOffset, strings.data(), strings.size());
+    for (std::size_t i = 0; i < blobs.size(); ++i)
+        putSection(file, blobs[i].offset, storedBytes[i].data(), storedBytes[i].size());
+
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path());
+
+    // Written next to the target then renamed, so a reader never maps a half written pack.
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size())))
+            throw std::runtime_error("Cannot write " + temporary);
+    }
+    std::filesystem::rename(temporary, target);
+
+    stats.entries = table.size();
+    stats.blobs = blobs.size();
+    return stats;
+}
+
+PackFile::PackFile(const std::string& path) : m_file(path)
+{
+    const std::size_t size = m_file.size();
+    if (size < sizeof(PackHeader))
+        throw std::runtime_error("Truncated pack header: " + path);
+
+    m_header = reinterpret_cast<const PackHeader*>(m_file.data());
+    if (std::memcmp(m_header->magic, PACK_MAGIC, 4) != 0)
+        throw std::runtime_error("Not a pack file: " + path);
+    if (m_header->version != PACK_VERSION)
+        throw std::runtime_error("Unsupported pack version in " + path);
+
+    if (!sectionFits(m_header->entryOffset, std::uint64_t(m_header->entryCount) * sizeof(PackEntry), size) ||
+        !sectionFits(m_header->blobOffset, std::uint64_t(m_header->blobCount) * sizeof(PackBlob), size) ||
+        !sectionFits(m_header->stringOffset, m_header->stringBytes, size))
+        throw std::runtime_error("Pack section out of bounds in " + path);
+
+    m_entries = reinterpret_cast<const PackEntry*>(m_file.data() + m_header->entryOffset);
+    m_blobs = reinterpret_cast<const PackBlob*>(m_file.data() + m_header->blobOffset);
+    m_strings = reinterpret_cast<const char*>(m_file.data() + m_header->stringOffset);
+
+    for (std::uint32_t i = 0; i < m_header->blobCount; ++i)
+    {
+        const PackBlob& blob = m_blobs[i];
+        if (!sectionFits(blob.offset, blob.storedSize, size))
+            throw std::runtime_error("Pack blob out of bounds in " + path);
+        if (blob.compression == PackCompression::NONE ? blob.storedSize != blob.size
+                                                      : blob.compression != PackCompression::LZ4)
+            throw std::runtime_error("Invalid pack blob in " + path);
+    }
+
+    for (std::uint32_t i = 0; i < m_header->entryCount; ++i)
+    {
+        const PackEntry& entry = m_entries[i];
+        if (entry.blob >= m_header->blobCount ||
+            std::uint64_t(entry.pathOffset) + entry.pathLength > m_header->stringBytes)
+            throw std::runtime_error("Invalid pack entry in " + path);
+        if (i > 0 && entry.pathHash < m_entries[i - 1].pathHash)
+            throw std::runtime_error("Unsorted pack path table in " + path);
+    }
+}
+
+const PackEntry* PackFile::find(std::string_view path) const
+{
+    const std::uint64_t hash = hashPackPath(path);
+    const PackEntry* end = m_entries + m_header->entryCount;
+    const PackEntry* it =
+        std::lower_bound(m_entries, end, hash, [](const PackEntry& entry, std::uint64_t value) {
+            return entry.pathHash < value;
+        });
+
+    for (; it != end && it->pathHash == hash; ++it)
+    {
+        if (this->path(*it) == path)
+            return it;
+    }
+    return nullptr;
+}
+
+std::span<const std::uint8_t> PackFile::stored(const PackEntry& entry) const
+{
+    const PackBlob& packed = blob(entry);
+    return std::span<const std::uint8_t>(m_file.data() + packed.offset, static_cast<std::size_t>(packed.storedSize));
+}
+
+std::vector<std::uint8_t> PackFile::decompress(const PackEntry& entry) const
+{
+    const PackBlob& packed = blob(entry);
+    const std::span<const std::uint8_t> source = stored(entry);
+    if (packed.compression == PackCompression::NONE)
+        return std::vector<std::uint8_t>(source.begin(), source.end());
+
+    if (packed.size > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+        packed.storedSize > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+        throw std::runtime_error("Pack blob too large to decompress");
+
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(packed.size));
+    const int read = LZ4_decompress_safe(reinterpret_cast<const char*>(source.data()),
+                                         reinterpret_cast<char*>(bytes.data()), static_cast<int>(source.size()),
+                                         static_cast<int>(bytes.size()));
+    if (read < 0 || static_cast<std::uint64_t>(read) != packed.size)
+        throw std::runtime_error("Corrupted LZ4 data in pack entry " + std::string(path(entry)));
+    return bytes;
+}
+
+std::string_view PackFile::path(const PackEntry& entry) const
+{
+    return std::string_view(m_strings + entry.pathOffset, entry.pathLength);
+}
+
+} // namespace IO
@@ -0,0 +1,225 @@
+#ifndef PACK_FILE_HPP_
+#define PACK_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace IO
+{
+/**
+ * @brief Version of the pack file layout, bumped whenever it changes.
+ */
+constexpr std::uint32_t PACK_VERSION = 1;
+
+/**
+ * @enum PackCompression
+ * @brief How a blob is stored in a pack file.
+ */
+enum class PackCompression : std::uint32_t
+{
+    NONE = 0, /**< Stored as is, served straight from the mapping. */
+    LZ4 = 1   /**< LZ4 block, decompressed on read. */
+};
+
+/**
+ * @struct PackHeader
+ * @brief Fixed size header at the start of a pack file.
+ *
+ * Every section and blob offset is a multiple of 16 so blobs can be used in place.
+ */
+struct alignas(16) PackHeader
+{
+    char magic[4];              /**< "LPAK". */
+    std::uint32_t version;      /**< PACK_VERSION. */
+    std::uint32_t entryCount;   /**< Entries in the path table. */
+    std::uint32_t blobCount;    /**< Entries in the blob table. */
+    std::uint64_t entryOffset;  /**< Offset of the path table. */
+    std::uint64_t blobOffset;   /**< Offset of the blob table. */
+    std::uint64_t stringOffset; /**< Offset of the path string blob. */
+    std::uint64_t stringBytes;  /**< Size of the path string blob. */
+    std::uint64_t reserved[2];  /**< Padding, zero. */
+};
+
+/**
+ * @struct PackEntry
+ * @brief A path in the pack, pointing at the blob holding its content.
+ *
+ * The path table is sorted by hash, then path, so lookups are a binary search.
+ */
+struct alignas(16) PackEntry
+{
+    std::uint64_t pathHash = 0;     /**< hashPackPath() of the normalized path. */
+    std::uint32_t pathOffset = 0;   /**< Offset of the path in the string blob. */
+    std::uint32_t pathLength = 0;   /**< Length of the path. */
+    std::uint32_t blob = 0;         /**< Index in the blob table. */
+    std::uint32_t reserved[3] = {}; /**< Padding, zero. */
+};
+
+/**
+ * @struct PackBlob
+ * @brief Content stored once, however many paths refer to it.
+ */
+struct alignas(16) PackBlob
+{
+    std::uint64_t contentHash = 0;                       /**< Hash of the uncompressed bytes. */
+    std::uint64_t offset = 0;                            /**< Offset of the stored bytes in the file. */
+    std::uint64_t storedSize = 0;                        /**< Size of the stored bytes. */
+    std::uint64_t size = 0;                              /**< Size once decompressed. */
+    PackCompression compression = PackCompression::NONE; /**< How the bytes are stored. */
+    std::uint32_t reserved[3] = {};                      /**< Padding, zero. */
+};
+
+static_assert(sizeof(PackHeader) == 64, "Pack header layout changed");
+static_assert(sizeof(PackEntry) == 32, "Pack entry layout changed");
+static_assert(sizeof(PackBlob) == 48, "Pack blob layout changed");
+
+/**
+ * @struct PackInput
+ * @brief A file to store in a pack.
+ */
+struct PackInput
+{
+    std::string path;                /**< Path the engine will ask for, normalized by writePack(). */
+    std::vector<std::uint8_t> bytes; /**< The file content. */
+};
+
+/**
+ * @struct PackStats
+ * @brief What writePack() produced.
+ */
+struct PackStats
+{
+    std::size_t entries = 0;       /**< Number of paths. */
+    std::size_t blobs = 0;         /**< Number of distinct contents. */
+    std::size_t compressed = 0;    /**< Number of blobs stored as LZ4. */
+    std::uint64_t inputBytes = 0;  /**< Total size of the inputs. */
+    std::uint64_t storedBytes = 0; /**< Total size of the stored blobs. */
+};
+
+/**
+ * @brief Normalizes a path the way pack files store them.
+ *
+ * Backslashes become slashes, "." and ".." components are folded and a leading
+ * "./" is dropped, so ".\\shaders\\a.glsl" and "shaders/a.glsl" are the same entry.
+ *
+ * @param path The path as the engine spells it.
+ * @return The normalized path.
+ */
+std::string normalizePackPath(std::string_view path);
+
+/**
+ * @brief Hashes a normalized path for the pack path table.
+ *
+ * @param path The normalized path.
+ * @return The 64-bit FNV-1a hash.
+ */
+std::uint64_t hashPackPath(std::string_view path);
+
+/**
+ * @brief Writes a pack file.
+ *
+ * Inputs with identical content share one blob. With compress set, a blob is
+ * stored as LZ4 when that saves at least an eighth of its size, and as is
+ * otherwise.
+ *
+ * @param path The pack file to write, replaced atomically.
+ * @param inputs The files to store.
+ * @param compress Whether to try LZ4 on every blob.
+ * @return Entry, blob and size counts.
+ *
+ * @throw std::runtime_error If two inputs have the same path or the file cannot be written.
+ */
+PackStats writePack(const std::string& path, const std::vector<PackInput>& inputs, bool compress);
+
+/**
+ * @class PackFile
+ * @brief A memory-mapped pack file.
+ *
+ * The whole layout is validated on open, so lookups and reads do not check
+ * bounds again. Safe to read from several threads at once.
+ */
+class PackFile
+{
+public:
+    /**
+     * @brief Maps and validates a pack file.
+     *
+     * @param path The pack file.
+     *
+     * @throw std::runtime_error If the file is missing, of another version or malformed.
+     */
+    explicit PackFile(const std::string& path);
+
+    /**
+     * @brief Finds a path.
+     *
+     * @param path The path, normalized with normalizePackPath().
+     * @return The entry, or nullptr if the pack does not hold the path.
+     */
+    const PackEntry* find(std::string_view path) const;
+
+    /**
+     * @brief Gets the blob an entry refers to.
+     *
+     * @param entry An entry of this pack.
+     * @return The blob.
+     */
+    const PackBlob& blob(const PackEntry& entry) const { return m_blobs[entry.blob]; }
+
+    /**
+     * @brief Gets the stored bytes of an entry, inside the mapping.
+     *
+     * @param entry An entry of this pack.
+     * @return The bytes, the file content itself unless the blob is compressed.
+     */
+    std::span<const std::uint8_t> stored(const PackEntry& entry) const;
+
+    /**
+     * @brief Decompresses an entry.
+     *
+     * @param entry An entry of this pack whose blob is compressed.
+     * @return The file content.
+     *
+     * @throw std::runtime_error If the LZ4 data is corrupted.
+     */
+    std::vector<std::uint8_t> decompress(const PackEntry& entry) const;
+
+    /**
+     * @brief Gets the number of paths in the pack.
+     *
+     * @return The entry count.
+     */
+    std::size_t entryCount() const { return m_header->entryCount; }
+
+    /**
+     * @brief Gets an entry by index, in path table order.
+     *
+     * @param index The index, below entryCount().
+     * @return The entry.
+     */
+    const PackEntry& entry(std::size_t index) const { return m_entries[index]; }
+
+    /**
+     * @brief Gets the path of an entry.
+     *
+     * @param entry An entry of this pack.
+     * @return The normalized path, pointing into the mapping.
+     */
+    std::string_view path(const PackEntry& entry) const;
+
+private:
+    MappedFile m_file;                    /**< The mapping, owning the bytes below. */
+    const PackHeader* m_header = nullptr; /**< The header. */
+    const PackEntry* m_entries = nullptr; /**< The sorted path table. */
+    const PackBlob* m_blobs = nullptr;    /**< The blob table. */
+    const char* m_strings = nullptr;      /**< The path string blob. */
+};
+}; // namespace IO
+
+#endif
@@ -0,0 +1,112 @@
+#include "virtual_file_system.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+#include "log.hpp"
+
+namespace IO
+{
+
+bool VirtualFileSystem::mount(const std::string& path)
+{
+    std::shared_ptr<const PackFile> pack;
+    try
+    {
+        pack = std::make_shared<const PackFile>(path);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Log(LogLevel::Error, std::string("Cannot mount pack: ") + e.what(), "Engine");
+        return false;
+    }
+
+    Logger::Log(LogLevel::Info, "Mounted " + path + " (" + std::to_string(pack->entryCount()) + " files)", "Engine");
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_packs.push_back(std::move(pack));
+    return true;
+}
+
+void VirtualFileSystem::unmountAll()
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_packs.clear();
+}
+
+bool VirtualFileSystem::exists(const std::string& path) const
+{
+    const std::string normalized = normalizePackPath(path);
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (auto it = m_packs.rbegin(); it != m_packs.rend(); ++it)
+        {
+            if ((*it)->find(normalized))
+                return true;
+        }
+    }
+
+    std::error_code error;
+    return std::filesystem::is_regular_file(normalized, error);
+}
+
+FileData VirtualFileSystem::read(const std::string& path) const
+{
+    const std::string normalized = normalizePackPath(path);
+
+    std::shared_ptr<const PackFile> pack;
+    const PackEntry* entry = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (auto it = m_packs.rbegin(); it != m_packs.rend() && !entry; ++it)
+        {
+            entry = (*it)->find(normalized);
+            if (entry)
+                pack = *it;
+        }
+    }
+
+    FileData file;
+    if (entry && pack->blob(*entry).compression == PackCompression::NONE)
+    {
+        file.m_bytes = pack->stored(*entry);
+        file.m_pack = std::move(pack);
+        m_mappedReads++;
+        return file;
+    }
+
+    if (entry)
+    {
+        file.m_owned = pack->decompress(*entry);
+        m_decompressedReads++;
+    }
+    else
+    {
+        std::ifstream stream(normalized, std::ios::binary);
+        if (!stream)
+            throw std::runtime_error("File not found: " + path);
+
+        stream.seekg(0, std::ios::end);
+        file.m_owned.resize(static_cast<std::size_t>(stream.tellg()));
+        stream.seekg(0, std::ios::beg);
+        if (!stream.read(reinterpret_cast<char*>(file.m_owned.data()),
+                         static_cast<std::streamsize>(file.m_owned.size())))
+            throw std::runtime_error("Cannot read " + path);
+        m_looseReads++;
+    }
+
+    file.m_bytes = std::span<const std::uint8_t>(file.m_owned.data(), file.m_owned.size());
+    return file;
+}
+
+void VirtualFileSystem::logStats() const
+{
+    Logger::Log(LogLevel::Info,
+                "Files read: " + std::to_string(m_mappedReads) + " mapped, " + std::to_string(m_decompressedReads) +
+                    " decompressed, " + std::to_string(m_looseReads) + " loose",
+                "Engine");
+}
+
+} // namespace IO
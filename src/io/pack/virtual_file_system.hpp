@@ -0,0 +1,153 @@
+#ifndef VIRTUAL_FILE_SYSTEM_HPP_
+#define VIRTUAL_FILE_SYSTEM_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pack_file.hpp"
+
+namespace IO
+{
+/**
+ * @class FileData
+ * @brief The content of a file read through the VirtualFileSystem.
+ *
+ * Uncompressed pack entries are a view into the pack mapping, kept alive by
+ * the FileData; compressed entries and loose files own their bytes.
+ */
+class FileData
+{
+public:
+    FileData() = default;
+    FileData(const FileData&) = delete;
+    FileData& operator=(const FileData&) = delete;
+    FileData(FileData&&) noexcept = default;
+    FileData& operator=(FileData&&) noexcept = default;
+
+    /**
+     * @brief Gets the bytes.
+     *
+     * @return The file content.
+     */
+    std::span<const std::uint8_t> bytes() const { return m_bytes; }
+
+    /**
+     * @brief Gets the first byte.
+     *
+     * @return Pointer to the content.
+     */
+    const std::uint8_t* data() const { return m_bytes.data(); }
+
+    /**
+     * @brief Gets the size of the file.
+     *
+     * @return The size in bytes.
+     */
+    std::size_t size() const { return m_bytes.size(); }
+
+    /**
+     * @brief Gets the content as text.
+     *
+     * @return The bytes as characters.
+     */
+    std::string_view text() const { return std::string_view(reinterpret_cast<const char*>(data()), size()); }
+
+    /**
+     * @brief Tells whether the bytes are served from a pack mapping without a copy.
+     *
+     * @return true for uncompressed pack entries.
+     */
+    bool isMapped() const { return m_pack != nullptr; }
+
+private:
+    friend class VirtualFileSystem;
+
+    std::span<const std::uint8_t> m_bytes;  /**< The content, in m_owned or in the mapping of m_pack. */
+    std::vector<std::uint8_t> m_owned;      /**< Decompressed or loose file bytes. */
+    std::shared_ptr<const PackFile> m_pack; /**< The pack m_bytes points into, if mapped. */
+};
+
+/**
+ * @class VirtualFileSystem
+ * @brief Serves engine assets from mounted pack files, falling back to loose files.
+ *
+ * Paths are normalized with normalizePackPath() and looked up in the packs
+ * mounted last first, then on disk, so a pack can shadow loose files and a
+ * later pack can patch an earlier one.
+ *
+ * read() and exists() are safe to call from any thread, including ThreadPool jobs.
+ */
+class VirtualFileSystem
+{
+public:
+    /**
+     * @brief Gets the singleton instance of VirtualFileSystem.
+     *
+     * @return The VirtualFileSystem instance.
+     */
+    static VirtualFileSystem& getInstance()
+    {
+        static VirtualFileSystem instance;
+        return instance;
+    }
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    /**
+     * @brief Mounts a pack file on top of the ones already mounted.
+     *
+     * @param path The pack file written by LambAssetPacker.
+     * @return false if the pack could not be opened; the error is logged.
+     */
+    bool mount(const std::string& path);
+
+    /**
+     * @brief Unmounts every pack. FileData already read stays valid.
+     */
+    void unmountAll();
+
+    /**
+     * @brief Tells whether a file exists in a pack or on disk.
+     *
+     * @param path The file path.
+     * @return true if read() would succeed.
+     */
+    bool exists(const std::string& path) const;
+
+    /**
+     * @brief Reads a file.
+     *
+     * @param path The file path.
+     * @return The content.
+     *
+     * @throw std::runtime_error If no pack holds the file and it cannot be read from disk.
+     */
+    FileData read(const std::string& path) const;
+
+    /**
+     * @brief Logs how many reads were mapped, decompressed or served from loose files.
+     */
+    void logStats() const;
+
+private:
+    VirtualFileSystem() = default;
+    ~VirtualFileSystem() = default;
+
+    mutable std::shared_mutex m_mutex;                    /**< Guards m_packs. */
+    std::vector<std::shared_ptr<const PackFile>> m_packs; /**< Mounted packs, in mount order. */
+
+    mutable std::atomic<std::size_t> m_mappedReads = 0;       /**< Reads served from a mapping. */
+    mutable std::atomic<std::size_t> m_decompressedReads = 0; /**< Reads that decompressed an entry. */
+    mutable std::atomic<std::size_t> m_looseReads = 0;        /**< Reads served from loose files. */
+};
+}; // namespace IO
+
+#endif
@@ -1,5 +1,8 @@
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -9,10 +12,139 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "Core/IGame.hpp"
 #include "Core/MyGame.hpp"
+#include "Core/StressGame.hpp"
 #include "Core/engine.hpp"
 #include "log.hpp"
 #include "stb_image.h"
 
+namespace
+{
+
+// The games main can run, picked with --scene. The stress options only apply to "stress".
+const std::map<std::string, std::function<std::unique_ptr<IGame>(const StressSceneConfig&)>> SCENES = {
+    {"default", [](const StressSceneConfig&) { return std::make_unique<MyGame>(); }},
+    {"stress", [](const StressSceneConfig& stress) { return std::make_unique<StressGame>(stress); }},
+};
+
+void printUsage()
+{
+    std::cout << "Usage: LambEngine [options]\n"
+                 "  --scene <name>        game to run:";
+    for (const auto& [name, factory] : SCENES)
+        std::cout << ' ' << name;
+    std::cout << "\n"
+                 "  --width <pixels>      framebuffer width\n"
+                 "  --height <pixels>     framebuffer height\n"
+                 "  --headless            render offscreen with EGL, no window, vsync off\n"
+                 "  --frames <count>      exit after this many frames\n"
+                 "  --report <path>       write frame time statistics as JSON on exit\n"
+                 "  --screenshot <path>   write the last frame as a PNG on exit (headless)\n"
+                 "  --no-render-thread    execute frames on the main thread\n"
+                 "  --null-renderer       drop every GL call, to benchmark the CPU side alone\n"
+                 "  --record-input <path> record the keyboard, mouse and frame times on exit\n"
+                 "  --replay-input <path> replay a recording instead of live input, then exit\n"
+                 "Stress scene:\n"
+                 "  --objects <count>     cubes, spheres and teapots to draw\n"
+                 "  --lights <count>      point lights\n"
+                 "  --materials <count>   materials, each with its own textures\n"
+                 "  --moving <ratio>      share of the objects that move, from 0 to 1\n"
+                 "  --seed <number>       placement and materials\n";
+}
+
+// Applies the command line to cfg. Returns false, after printing why, when it is invalid.
+bool parseArguments(int argc, char* argv[], EngineConfig& cfg, std::string& scene, StressSceneConfig& stress)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        auto number = [&](unsigned int& target) {
+            const char* text = value();
+            if (!text)
+                return false;
+            try
+            {
+                target = static_cast<unsigned int>(std::stoul(text));
+                return true;
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+        };
+        auto ratio = [&](float& target) {
+            const char* text = value();
+            if (!text)
+                return false;
+            try
+            {
+                target = std::stof(text);
+                return target >= 0.0f && target <= 1.0f;
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+        };
+        auto path = [&](std::string& target) {
+            const char* text = value();
+            if (text)
+                target = text;
+            return text != nullptr;
+        };
+
+        bool valid = true;
+        if (argument == "--headless")
+            cfg.headless = true;
+        else if (argument == "--no-render-thread")
+            cfg.renderThread = false;
+        else if (argument == "--null-renderer")
+            cfg.nullRenderer = true;
+        else if (argument == "--width")
+            valid = number(cfg.width) && cfg.width > 0;
+        else if (argument == "--height")
+            valid = number(cfg.height) && cfg.height > 0;
+        else if (argument == "--frames")
+            valid = number(cfg.frameLimit);
+        else if (argument == "--report")
+            valid = path(cfg.frameTimeReport);
+        else if (argument == "--screenshot")
+            valid = path(cfg.screenshot);
+        else if (argument == "--record-input")
+            valid = path(cfg.inputRecording);
+        else if (argument == "--replay-input")
+            valid = path(cfg.inputReplay);
+        else if (argument == "--scene")
+            valid = path(scene) && SCENES.count(scene) != 0;
+        else if (argument == "--objects")
+        {
+            unsigned int objects = 0;
+            valid = number(objects);
+            stress.objects = objects;
+        }
+        else if (argument == "--lights")
+            valid = number(stress.lights);
+        else if (argument == "--materials")
+            valid = number(stress.materials) && stress.materials > 0;
+        else if (argument == "--moving")
+            valid = ratio(stress.movingRatio);
+        else if (argument == "--seed")
+            valid = number(stress.seed);
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            std::cerr << "Invalid argument: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 int main(int argc, char* argv[])
 {
     Logger::Init(false, true, false);
@@ -22,10 +154,18 @@ int main(int argc, char* argv[])
     Logger::RegisterSubsystemFile("Renderer", "Logs/Renderer/Renderer.log");
     Logger::RegisterSubsystemFile("Physics", "Logs/Physics/Physics.log");
 
-    MyGame game;
     EngineConfig cfg;
+    std::string scene = "default";
+    StressSceneConfig stress;
+    if (!parseArguments(argc, argv, cfg, scene, stress))
+    {
+        Logger::Shutdown();
+        return 1;
+    }
+
+    std::unique_ptr<IGame> game = SCENES.at(scene)(stress);
     Engine engine{cfg};
-    engine.Run(&game);
+    engine.Run(game.get());
 
     Logger::Shutdown();
 
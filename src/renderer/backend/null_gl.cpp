@@ -0,0 +1,391 @@
+#include "null_gl.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace
+{
+
+std::atomic<std::uint64_t> s_calls{0};
+std::atomic<GLuint> s_nextName{1};
+GLint s_viewport[4] = {0, 0, 0, 0};
+GLint s_packAlignment = 4;
+GLuint s_pixelPackBuffer = 0;
+std::vector<std::uint8_t> s_mapping; // Buffer mappings are written and unmapped before the next one.
+
+void count()
+{
+    s_calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+// A pointer the callee writes through, as opposed to input arrays and callbacks.
+template <typename T>
+constexpr bool IS_OUTPUT = std::is_pointer_v<T> && !std::is_const_v<std::remove_pointer_t<T>> &&
+                           !std::is_function_v<std::remove_pointer_t<T>>;
+
+template <typename Pfn>
+struct Ignore;
+
+// A no-op with the exact signature and calling convention of the GL function, returning zero or null.
+template <typename R, typename... Args>
+struct Ignore<R(APIENTRY*)(Args...)>
+{
+    static_assert(!(IS_OUTPUT<Args> || ...), "GL functions with outputs need a stub that writes them");
+
+    static R APIENTRY call(Args...)
+    {
+        count();
+        if constexpr (!std::is_void_v<R>)
+            return R{};
+    }
+};
+
+void APIENTRY genNames(GLsizei n, GLuint* names)
+{
+    count();
+    for (GLsizei i = 0; i < n; ++i)
+        names[i] = s_nextName.fetch_add(1, std::memory_order_relaxed);
+}
+
+GLuint APIENTRY createName()
+{
+    count();
+    return s_nextName.fetch_add(1, std::memory_order_relaxed);
+}
+
+GLuint APIENTRY createShader(GLenum)
+{
+    return createName();
+}
+
+GLboolean APIENTRY isName(GLuint name)
+{
+    count();
+    return name != 0 ? GL_TRUE : GL_FALSE;
+}
+
+const GLubyte* APIENTRY getString(GLenum name)
+{
+    count();
+    switch (name)
+    {
+        case GL_VENDOR:
+            return reinterpret_cast<const GLubyte*>("LambEngine");
+        case GL_RENDERER:
+            return reinterpret_cast<const GLubyte*>("Null renderer");
+        case GL_VERSION:
+            return reinterpret_cast<const GLubyte*>("4.6.0 Null");
+        case GL_SHADING_LANGUAGE_VERSION:
+            return reinterpret_cast<const GLubyte*>("4.60 Null");
+        default:
+            return nullptr;
+    }
+}
+
+const GLubyte* APIENTRY getStringi(GLenum name, GLuint index)
+{
+    count();
+    return name == GL_EXTENSIONS && index == 0 ? reinterpret_cast<const GLubyte*>("GL_LAMB_null_renderer") : nullptr;
+}
+
+void APIENTRY getIntegerv(GLenum name, GLint* data)
+{
+    count();
+    switch (name)
+    {
+        case GL_MAJOR_VERSION:
+            *data = 4;
+            break;
+        case GL_MINOR_VERSION:
+            *data = 6;
+            break;
+        case GL_VIEWPORT:
+            std::memcpy(data, s_viewport, sizeof(s_viewport));
+            break;
+        case GL_NUM_EXTENSIONS:
+            // Glad fails to load with none, so there is one of our own.
+            *data = 1;
+            break;
+        default:
+            // No binary formats, no context flags.
+            *data = 0;
+            break;
+    }
+}
+
+void APIENTRY getInteger64v(GLenum name, GLint64* data)
+{
+    count();
+    *data = name == GL_TIMESTAMP ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now().time_since_epoch())
+                                       .count()
+                                 : 0;
+}
+
+void APIENTRY viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    count();
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+}
+
+void APIENTRY getObjectiv(GLuint, GLenum name, GLint* value)
+{
+    count();
+    switch (name)
+    {
+        case GL_COMPILE_STATUS:
+        case GL_LINK_STATUS:
+        case GL_COMPLETION_STATUS_KHR:
+        case GL_QUERY_RESULT_AVAILABLE:
+            *value = GL_TRUE;
+            break;
+        default:
+            // Empty info logs and program binaries, unknown shader types.
+            *value = 0;
+            break;
+    }
+}
+
+void APIENTRY getQueryObjectui64v(GLuint, GLenum, GLuint64* value)
+{
+    count();
+    *value = 0;
+}
+
+void APIENTRY getInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log)
+{
+    count();
+    if (length)
+        *length = 0;
+    if (log && size > 0)
+        log[0] = '\0';
+}
+
+void APIENTRY getProgramBinary(GLuint, GLsizei, GLsizei* length, GLenum* format, void*)
+{
+    count();
+    if (length)
+        *length = 0;
+    if (format)
+        *format = 0;
+}
+
+GLenum APIENTRY checkFramebufferStatus(GLenum)
+{
+    count();
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void* APIENTRY mapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield)
+{
+    count();
+    s_mapping.resize(static_cast<std::size_t>(length));
+    return s_mapping.data();
+}
+
+GLboolean APIENTRY unmapBuffer(GLenum)
+{
+    count();
+    return GL_TRUE;
+}
+
+void APIENTRY bindBuffer(GLenum target, GLuint buffer)
+{
+    count();
+    if (target == GL_PIXEL_PACK_BUFFER)
+        s_pixelPackBuffer = buffer;
+}
+
+void APIENTRY pixelStorei(GLenum name, GLint value)
+{
+    count();
+    if (name == GL_PACK_ALIGNMENT)
+        s_packAlignment = value;
+}
+
+std::size_t pixelComponents(GLenum format)
+{
+    switch (format)
+    {
+        case GL_RED:
+        case GL_DEPTH_COMPONENT:
+        case GL_STENCIL_INDEX:
+            return 1;
+        case GL_RG:
+            return 2;
+        case GL_RGB:
+        case GL_BGR:
+            return 3;
+        case GL_RGBA:
+        case GL_BGRA:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+std::size_t componentBytes(GLenum type)
+{
+    switch (type)
+    {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+// Reads back black. Like a driver, writes nothing for formats it rejects or into a bound pack buffer.
+void APIENTRY readPixels(GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+{
+    count();
+    const std::size_t pixelBytes = pixelComponents(format) * componentBytes(type);
+    if (s_pixelPackBuffer != 0 || !pixels || pixelBytes == 0 || width <= 0 || height <= 0)
+        return;
+
+    const auto alignment = static_cast<std::size_t>(s_packAlignment > 0 ? s_packAlignment : 1);
+    const std::size_t row = static_cast<std::size_t>(width) * pixelBytes;
+    const std::size_t stride = (row + alignment - 1) / alignment * alignment;
+    std::memset(pixels, 0, stride * static_cast<std::size_t>(height - 1) + row);
+}
+
+// The function pointer type glad stores the function in, so stubs must convert to it.
+template <typename F>
+using Pfn = std::add_pointer_t<std::remove_pointer_t<F>>;
+
+template <typename Function>
+void* address(Function function)
+{
+    return reinterpret_cast<void*>(function);
+}
+
+} // namespace
+
+// Maps a GL function to its stub, checked against the type glad loads it into.
+#define NULL_GL_STUB(name, stub) {#name, address(static_cast<Pfn<decltype(name)>>(stub))}
+#define NULL_GL_IGNORE(name) {#name, address(&Ignore<Pfn<decltype(name)>>::call)}
+
+void* NullGl::getProcAddress(const char* name)
+{
+    static const std::unordered_map<std::string_view, void*> functions = {
+        NULL_GL_STUB(glGetString, getString),
+        NULL_GL_STUB(glGetStringi, getStringi),
+        NULL_GL_STUB(glGetIntegerv, getIntegerv),
+        NULL_GL_STUB(glGetInteger64v, getInteger64v),
+        NULL_GL_STUB(glViewport, viewport),
+        NULL_GL_STUB(glGenBuffers, genNames),
+        NULL_GL_STUB(glGenTextures, genNames),
+        NULL_GL_STUB(glGenVertexArrays, genNames),
+        NULL_GL_STUB(glGenQueries, genNames),
+        NULL_GL_STUB(glGenFramebuffers, genNames),
+        NULL_GL_STUB(glGenRenderbuffers, genNames),
+        NULL_GL_STUB(glCreateProgram, createName),
+        NULL_GL_STUB(glCreateShader, createShader),
+        NULL_GL_STUB(glIsBuffer, isName),
+        NULL_GL_STUB(glIsVertexArray, isName),
+        NULL_GL_STUB(glIsTexture, isName),
+        NULL_GL_STUB(glIsProgram, isName),
+        NULL_GL_STUB(glGetShaderiv, getObjectiv),
+        NULL_GL_STUB(glGetProgramiv, getObjectiv),
+        NULL_GL_STUB(glGetQueryObjectiv, getObjectiv),
+        NULL_GL_STUB(glGetQueryObjectui64v, getQueryObjectui64v),
+        NULL_GL_STUB(glGetShaderInfoLog, getInfoLog),
+        NULL_GL_STUB(glGetProgramInfoLog, getInfoLog),
+        NULL_GL_STUB(glGetProgramBinary, getProgramBinary),
+        NULL_GL_STUB(glCheckFramebufferStatus, checkFramebufferStatus),
+        NULL_GL_STUB(glMapBufferRange, mapBufferRange),
+        NULL_GL_STUB(glUnmapBuffer, unmapBuffer),
+        NULL_GL_STUB(glBindBuffer, bindBuffer),
+        NULL_GL_STUB(glPixelStorei, pixelStorei),
+        NULL_GL_STUB(glReadPixels, readPixels),
+
+        // Functions without outputs, each with a no-op of its own type. Add the ones new code calls.
+        NULL_GL_IGNORE(glActiveTexture),
+        NULL_GL_IGNORE(glAttachShader),
+        NULL_GL_IGNORE(glBindBufferBase),
+        NULL_GL_IGNORE(glBindFramebuffer),
+        NULL_GL_IGNORE(glBindRenderbuffer),
+        NULL_GL_IGNORE(glBindTexture),
+        NULL_GL_IGNORE(glBindVertexArray),
+        NULL_GL_IGNORE(glBufferData),
+        NULL_GL_IGNORE(glBufferSubData),
+        NULL_GL_IGNORE(glClear),
+        NULL_GL_IGNORE(glClearColor),
+        NULL_GL_IGNORE(glCompileShader),
+        NULL_GL_IGNORE(glCompressedTexImage2D),
+        NULL_GL_IGNORE(glCompressedTexImage3D),
+        NULL_GL_IGNORE(glDebugMessageCallback),
+        NULL_GL_IGNORE(glDebugMessageControl),
+        NULL_GL_IGNORE(glDeleteBuffers),
+        NULL_GL_IGNORE(glDeleteFramebuffers),
+        NULL_GL_IGNORE(glDeleteProgram),
+        NULL_GL_IGNORE(glDeleteQueries),
+        NULL_GL_IGNORE(glDeleteRenderbuffers),
+        NULL_GL_IGNORE(glDeleteShader),
+        NULL_GL_IGNORE(glDeleteTextures),
+        NULL_GL_IGNORE(glDeleteVertexArrays),
+        NULL_GL_IGNORE(glDepthFunc),
+        NULL_GL_IGNORE(glDetachShader),
+        NULL_GL_IGNORE(glDisable),
+        NULL_GL_IGNORE(glDrawArrays),
+        NULL_GL_IGNORE(glDrawElements),
+        NULL_GL_IGNORE(glEnable),
+        NULL_GL_IGNORE(glEnableVertexAttribArray),
+        NULL_GL_IGNORE(glFinish),
+        NULL_GL_IGNORE(glFlush),
+        NULL_GL_IGNORE(glFramebufferRenderbuffer),
+        NULL_GL_IGNORE(glFramebufferTexture2D),
+        NULL_GL_IGNORE(glGenerateMipmap),
+        NULL_GL_IGNORE(glGetUniformLocation),
+        NULL_GL_IGNORE(glLinkProgram),
+        NULL_GL_IGNORE(glMaxShaderCompilerThreadsKHR),
+        NULL_GL_IGNORE(glProgramBinary),
+        NULL_GL_IGNORE(glProgramParameteri),
+        NULL_GL_IGNORE(glQueryCounter),
+        NULL_GL_IGNORE(glRenderbufferStorage),
+        NULL_GL_IGNORE(glShaderSource),
+        NULL_GL_IGNORE(glStencilFunc),
+        NULL_GL_IGNORE(glStencilMask),
+        NULL_GL_IGNORE(glStencilOp),
+        NULL_GL_IGNORE(glTexImage2D),
+        NULL_GL_IGNORE(glTexImage3D),
+        NULL_GL_IGNORE(glTexParameteri),
+        NULL_GL_IGNORE(glTexSubImage2D),
+        NULL_GL_IGNORE(glUniform1f),
+        NULL_GL_IGNORE(glUniform1i),
+        NULL_GL_IGNORE(glUniform3f),
+        NULL_GL_IGNORE(glUniform4f),
+        NULL_GL_IGNORE(glUniformMatrix4fv),
+        NULL_GL_IGNORE(glUseProgram),
+        NULL_GL_IGNORE(glVertexAttribIPointer),
+        NULL_GL_IGNORE(glVertexAttribPointer),
+    };
+
+    // Like a driver without the function: glad leaves it null.
+    const auto function = functions.find(name);
+    return function != functions.end() ? function->second : nullptr;
+}
+
+std::uint64_t NullGl::getCallCount()
+{
+    return s_calls.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#ifndef NULL_GL_HPP_
+#define NULL_GL_HPP_
+
+#include <cstdint>
+
+/**
+ * @class NullGl
+ * @brief An OpenGL loader whose functions do nothing, for benchmarking the CPU side of frames.
+ *
+ * Passing getProcAddress() to gladLoadGLLoader() points every GL function of
+ * the engine at a stub instead of a driver, so Renderable, ShaderEngine,
+ * texture uploads and the rest run unchanged without a context or a GPU.
+ * Calls are counted and dropped. RenderStats still counts draws, state changes
+ * and uniforms, since it does that where the calls are made.
+ *
+ * Functions with outputs return what a driver would on success:
+ * - fresh object names;
+ * - successful compile, link and framebuffer statuses;
+ * - scratch memory for buffer mappings;
+ * - the last viewport;
+ * - a GL_TIMESTAMP clock;
+ * - black pixels for glReadPixels.
+ * Functions without outputs get a no-op generated for their own glad function
+ * pointer type, which returns zero. A function with outputs fails to compile
+ * as a no-op, so each has a stub that writes them. Functions missing from the
+ * list stay null, as with a driver that lacks them: new GL calls must be added.
+ *
+ * ImGui's OpenGL backend has its own loader and must not run in this mode.
+ */
+class NullGl
+{
+public:
+    /**
+     * @brief Gets the stub for a GL function, with the signature of GLADloadproc.
+     *
+     * @param name The GL function name.
+     * @return The stub.
+     */
+    static void* getProcAddress(const char* name);
+
+    /**
+     * @brief Gets the number of GL calls made through the stubs.
+     *
+     * @return The call count since the program started.
+     */
+    static std::uint64_t getCallCount();
+};
+
+#endif
@@ -6,7 +6,6 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <input.hpp>
-#include <time.hpp>
 
 void Camera::computeCursorCameraMovements(int x, int y)
 {
@@ -22,9 +21,8 @@ void Camera::computeCursorCameraMovements(int x, int y)
     m_direction = glm::normalize(direction);
 }
 
-void Camera::computeAction(Action action)
+void Camera::computeAction(Action action, float deltaTime)
 {
-    float deltaTime = Time::getInstance().getDeltaTime();
     switch (action)
     {
         case Action::Up:
@@ -48,8 +46,9 @@ void Camera::computeAction(Action action)
     }
 }
 
-void Camera::computeActions(const std::vector<Action>& actions)
+void Camera::computeActions(const std::vector<Action>& actions, float deltaTime)
 {
+    m_previousPosition = m_position;
     for (auto action : actions)
-        computeAction(action);
+        computeAction(action, deltaTime);
 }
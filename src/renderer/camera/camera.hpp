@@ -25,8 +25,8 @@ public:
      */
     Camera(glm::vec3 position = glm::vec3(0.0f, 1.0f, 3.0f), glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f),
            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float mouseSensitivity = 0.1f, float cameraSpeed = 2.5f)
-        : m_position(position), m_direction(direction), m_up(up), m_mouseSensitivity(mouseSensitivity),
-          m_cameraSpeed(cameraSpeed) {};
+        : m_position(position), m_previousPosition(position), m_direction(direction), m_up(up),
+          m_mouseSensitivity(mouseSensitivity), m_cameraSpeed(cameraSpeed) {};
 
     /**
      * @brief Computes the camera movements based on cursor position changes.
@@ -39,9 +39,12 @@ public:
     /**
      * @brief Computes the camera actions based on a vector of actions.
      *
+     * The position before the actions is kept for getViewMatrix(float).
+     *
      * @param actions The vector of actions to be computed.
+     * @param deltaTime The simulated time the actions last, in seconds.
      */
-    void computeActions(const std::vector<Action>& actions);
+    void computeActions(const std::vector<Action>& actions, float deltaTime);
 
     /**
      * @brief Gets the view matrix of the camera.
@@ -50,6 +53,18 @@ public:
      */
     glm::mat4 getViewMatrix() const { return glm::lookAt(m_position, m_position + m_direction, m_up); };
 
+    /**
+     * @brief Gets the view matrix between the last two computeActions() calls.
+     *
+     * @param alpha The interpolation factor, 0 for the previous position and 1 for the current one.
+     * @return The interpolated view matrix of the camera.
+     */
+    glm::mat4 getViewMatrix(float alpha) const
+    {
+        const glm::vec3 position = glm::mix(m_previousPosition, m_position, alpha);
+        return glm::lookAt(position, position + m_direction, m_up);
+    }
+
     /**
      * @brief Gets the position of the camera.
      *
@@ -67,6 +82,8 @@ public:
 private:
     // Camera position
     glm::vec3 m_position;
+    // Camera position before the last computeActions() call
+    glm::vec3 m_previousPosition;
     // Camera direction
     glm::vec3 m_direction;
     // Up vector
@@ -84,8 +101,9 @@ private:
      * @brief Computes a single action for the camera.
      *
      * @param action The action to be computed.
+     * @param deltaTime The simulated time the action lasts, in seconds.
      */
-    void computeAction(Action action);
+    void computeAction(Action action, float deltaTime);
 };
 
 #endif
@@ -0,0 +1,102 @@
+#include "render_command_list.hpp"
+
+#include <type_traits>
+#include <utility>
+
+#include <glad/glad.h>
+
+#include "model.hpp"
+#include "profiler.hpp"
+#include "shader_engine.hpp"
+#include "texture_streamer.hpp"
+
+void RenderCommandList::clear(const glm::vec4& color)
+{
+    m_commands.emplace_back(Clear{color});
+}
+
+void RenderCommandList::setCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+    m_commands.emplace_back(SetCamera{view, projection});
+}
+
+void RenderCommandList::setUniform(ShaderEngine& shader, std::string name, UniformValue value)
+{
+    m_commands.emplace_back(SetUniform{&shader, std::move(name), value});
+}
+
+void RenderCommandList::draw(Renderable& renderable, const glm::mat4& transform)
+{
+    m_commands.emplace_back(DrawRenderable{&renderable, transform});
+}
+
+void RenderCommandList::draw(Model& model, const glm::mat4& transform)
+{
+    m_commands.emplace_back(DrawModel{&model, nullptr, transform});
+}
+
+void RenderCommandList::draw(Model& model, const Animator& animator, const glm::mat4& transform)
+{
+    m_commands.emplace_back(DrawModel{&model, &animator, transform});
+}
+
+void RenderCommandList::call(std::function<void()> function)
+{
+    m_commands.emplace_back(Call{std::move(function)});
+}
+
+void RenderCommandList::execute() const
+{
+    PROFILE_ZONE("RenderCommandList::execute");
+    for (const Command& command : m_commands)
+    {
+        std::visit(
+            [](const auto& c) {
+                using T = std::decay_t<decltype(c)>;
+                if constexpr (std::is_same_v<T, Clear>)
+                {
+                    glClearColor(c.color.x, c.color.y, c.color.z, c.color.w);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+                }
+                else if constexpr (std::is_same_v<T, SetCamera>)
+                {
+                    TextureStreamer::getInstance().setView(c.view, c.projection);
+                }
+                else if constexpr (std::is_same_v<T, SetUniform>)
+                {
+                    c.shader->use();
+                    std::visit(
+                        [&](const auto& value) {
+                            using V = std::decay_t<decltype(value)>;
+                            if constexpr (std::is_same_v<V, int>)
+                                c.shader->setInt(c.name, value);
+                            else if constexpr (std::is_same_v<V, float>)
+                                c.shader->setFloat(c.name, value);
+                            else if constexpr (std::is_same_v<V, glm::vec3>)
+                                c.shader->setVec3(c.name, value);
+                            else if constexpr (std::is_same_v<V, glm::vec4>)
+                                c.shader->setVec4(c.name, value);
+                            else
+                                c.shader->setMat4(c.name, value);
+                        },
+                        c.value);
+                }
+                else if constexpr (std::is_same_v<T, DrawRenderable>)
+                {
+                    c.renderable->draw(c.transform);
+                }
+                else if constexpr (std::is_same_v<T, DrawModel>)
+                {
+                    if (c.animator)
+                        c.model->draw(*c.animator, c.transform);
+                    else
+                        c.model->draw(c.transform);
+                }
+                else
+                {
+                    c.function();
+                }
+            },
+            command);
+    }
+}
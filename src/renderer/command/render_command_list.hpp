@@ -0,0 +1,156 @@
+#ifndef RENDER_COMMAND_LIST_HPP_
+#define RENDER_COMMAND_LIST_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Animator;
+class Model;
+class Renderable;
+class ShaderEngine;
+
+/**
+ * @class RenderCommandList
+ * @brief The draws of one frame, recorded by the game and executed later by the renderer.
+ *
+ * Recording copies every value it needs, such as matrices and uniforms, so
+ * the game can move on to the next frame while the list executes on the
+ * render thread. Objects are referenced and must stay alive until the frame
+ * has executed, which is the end of the next Engine frame. Use call() for work
+ * that has no command yet; it runs on the thread that owns the GL context.
+ */
+class RenderCommandList
+{
+public:
+    /**
+     * @brief A uniform value.
+     */
+    using UniformValue = std::variant<int, float, glm::vec3, glm::vec4, glm::mat4>;
+
+    /**
+     * @brief Clears the color, depth and stencil buffers.
+     *
+     * @param color The clear color.
+     */
+    void clear(const glm::vec4& color);
+
+    /**
+     * @brief Sets the camera the following draws are seen from, for texture streaming.
+     *
+     * @param view The view matrix.
+     * @param projection The projection matrix.
+     */
+    void setCamera(const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Binds a shader and sets one of its uniforms.
+     *
+     * @param shader The shader, which must outlive the frame.
+     * @param name The uniform name.
+     * @param value The value.
+     */
+    void setUniform(ShaderEngine& shader, std::string name, UniformValue value);
+
+    /**
+     * @brief Draws a renderable.
+     *
+     * @param renderable The renderable, which must outlive the frame.
+     * @param transform The model matrix set on its shader.
+     */
+    void draw(Renderable& renderable, const glm::mat4& transform);
+
+    /**
+     * @brief Draws a model.
+     *
+     * @param model The model, which must outlive the frame.
+     * @param transform The model matrix set on its shader.
+     */
+    void draw(Model& model, const glm::mat4& transform);
+
+    /**
+     * @brief Draws a model in the pose of an animator.
+     *
+     * @param model The model, which must outlive the frame.
+     * @param animator An animator of the model, which must outlive the frame.
+     * @param transform The model matrix set on its shader.
+     */
+    void draw(Model& model, const Animator& animator, const glm::mat4& transform);
+
+    /**
+     * @brief Runs a function when the list executes.
+     *
+     * @param function The function, called on the thread that owns the GL context.
+     */
+    void call(std::function<void()> function);
+
+    /**
+     * @brief Executes every command in recording order. Must run on the context thread.
+     */
+    void execute() const;
+
+    /**
+     * @brief Removes every command, keeping the memory for the next frame.
+     */
+    void reset() { m_commands.clear(); }
+
+    /**
+     * @brief Gets the number of recorded commands.
+     *
+     * @return The command count.
+     */
+    std::size_t size() const { return m_commands.size(); }
+
+private:
+    /** @brief Recorded by clear(). */
+    struct Clear
+    {
+        glm::vec4 color; /**< The clear color. */
+    };
+
+    /** @brief Recorded by setCamera(). */
+    struct SetCamera
+    {
+        glm::mat4 view;       /**< The view matrix. */
+        glm::mat4 projection; /**< The projection matrix. */
+    };
+
+    /** @brief Recorded by setUniform(). */
+    struct SetUniform
+    {
+        ShaderEngine* shader; /**< The shader to bind. */
+        std::string name;     /**< The uniform name. */
+        UniformValue value;   /**< The value. */
+    };
+
+    /** @brief Recorded by draw(Renderable&, const glm::mat4&). */
+    struct DrawRenderable
+    {
+        Renderable* renderable; /**< The renderable. */
+        glm::mat4 transform;    /**< The model matrix. */
+    };
+
+    /** @brief Recorded by the draw() overloads taking a Model. */
+    struct DrawModel
+    {
+        Model* model;             /**< The model. */
+        const Animator* animator; /**< The animator posing it, if any. */
+        glm::mat4 transform;      /**< The model matrix. */
+    };
+
+    /** @brief Recorded by call(). */
+    struct Call
+    {
+        std::function<void()> function; /**< The function. */
+    };
+
+    using Command = std::variant<Clear, SetCamera, SetUniform, DrawRenderable, DrawModel, Call>;
+
+    std::vector<Command> m_commands; /**< The commands, in recording order. */
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "render_thread.hpp"
+
+#include <exception>
+#include <string>
+
+#include "log.hpp"
+#include "profiler.hpp"
+
+RenderThread::RenderThread(SDL_Window* window, SDL_GLContext context) : m_window(window), m_context(context)
+{
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    finish();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void RenderThread::submit(const std::function<void()>& synchronize)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return !m_submitted && !m_busy; });
+
+    m_sync = &synchronize;
+    m_synchronized = false;
+    m_submitted = true;
+    m_recording ^= 1;
+    m_wake.notify_one();
+
+    // synchronize lives on the caller's stack and may touch game state, so wait for it.
+    m_done.wait(lock, [this]() { return m_synchronized; });
+    m_lists[m_recording].reset();
+}
+
+void RenderThread::finish()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return !m_submitted && !m_busy; });
+}
+
+void RenderThread::run()
+{
+    PROFILE_THREAD("Render");
+    if (m_context && SDL_GL_MakeCurrent(m_window, m_context) != 0)
+        Logger::Log(LogLevel::Error, std::string("Render thread SDL_GL_MakeCurrent error: ") + SDL_GetError(),
+                    "Engine");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wake.wait(lock, [this]() { return m_submitted || m_stopping; });
+        if (!m_submitted)
+            break;
+
+        m_submitted = false;
+        m_busy = true;
+        const RenderCommandList& list = m_lists[m_recording ^ 1];
+        lock.unlock();
+
+        try
+        {
+            (*m_sync)();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::Log(LogLevel::Error, std::string("Render thread synchronize failed: ") + e.what(), "Engine");
+        }
+
+        lock.lock();
+        m_synchronized = true;
+        m_done.notify_all();
+        lock.unlock();
+
+        try
+        {
+            list.execute();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::Log(LogLevel::Error, std::string("Render thread frame failed: ") + e.what(), "Engine");
+        }
+        {
+            PROFILE_ZONE("Swap");
+            if (m_context)
+                SDL_GL_SwapWindow(m_window);
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_done.notify_all();
+    }
+
+    // Hands the context back for the GL cleanup done on the main thread.
+    if (m_context)
+        SDL_GL_MakeCurrent(m_window, nullptr);
+}
@@ -0,0 +1,86 @@
+#ifndef RENDER_THREAD_HPP_
+#define RENDER_THREAD_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <SDL2/SDL.h>
+
+#include "render_command_list.hpp"
+
+/**
+ * @class RenderThread
+ * @brief Owns the GL context and executes command lists one frame behind the game.
+ *
+ * Two lists are double buffered: the game records frame N into one while the
+ * render thread executes and presents frame N - 1 from the other. submit()
+ * waits for frame N - 1 to finish, so the game never gets more than one
+ * frame ahead, and a frame costs about max(simulation, rendering).
+ */
+class RenderThread
+{
+public:
+    /**
+     * @brief Starts the thread and makes the context current on it.
+     *
+     * The calling thread must release the context first.
+     *
+     * @param window The window to present to.
+     * @param context The GL context of the window, null when GL goes through NullGl.
+     */
+    RenderThread(SDL_Window* window, SDL_GLContext context);
+
+    /**
+     * @brief Executes the last submitted frame, then stops the thread.
+     */
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Gets the list the game records the current frame into.
+     *
+     * @return The recording list, empty at the start of each frame.
+     */
+    RenderCommandList& commands() { return m_lists[m_recording]; }
+
+    /**
+     * @brief Hands the recorded frame over to the render thread.
+     *
+     * Waits for the previous frame to be presented, then runs synchronize on
+     * the render thread while the caller waits. That is the only time both
+     * threads are stopped, so synchronize can safely update GL objects that
+     * the game also reads, such as streamed assets. The frame then executes
+     * and presents while the caller moves on.
+     *
+     * @param synchronize Work that needs the context and exclusive access to game state.
+     */
+    void submit(const std::function<void()>& synchronize);
+
+    /**
+     * @brief Waits until every submitted frame has been presented.
+     */
+    void finish();
+
+private:
+    void run();
+
+    SDL_Window* m_window;                          /**< The window to present to. */
+    SDL_GLContext m_context;                       /**< The GL context, current on the render thread. */
+    RenderCommandList m_lists[2];                  /**< The double buffered command lists. */
+    int m_recording = 0;                           /**< Index of the list the game records into. */
+    const std::function<void()>* m_sync = nullptr; /**< The synchronize work of the submitted frame. */
+    bool m_submitted = false;                      /**< Whether a frame waits for the render thread. */
+    bool m_synchronized = false;                   /**< Whether its synchronize work has run. */
+    bool m_busy = false;                           /**< Whether a frame is executing. */
+    bool m_stopping = false;                       /**< Whether the thread must exit. */
+    std::mutex m_mutex;                            /**< Guards the flags above. */
+    std::condition_variable m_wake;                /**< Signals a submitted frame or the stop request. */
+    std::condition_variable m_done;                /**< Signals finished synchronize work or frames. */
+    std::thread m_thread;                          /**< The render thread. */
+};
+
+#endif
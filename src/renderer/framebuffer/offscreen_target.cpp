@@ -0,0 +1,107 @@
+#include "offscreen_target.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "log.hpp"
+
+void OffscreenTarget::create(int width, int height)
+{
+    destroy();
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthStencil);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        destroy();
+        Logger::Log(LogLevel::Error, "Offscreen framebuffer is incomplete: status " + std::to_string(status),
+                    "Renderer");
+        throw std::runtime_error("Offscreen framebuffer is incomplete");
+    }
+
+    Logger::Log(LogLevel::Info,
+                "Offscreen framebuffer created: " + std::to_string(width) + "x" + std::to_string(height), "Renderer");
+}
+
+void OffscreenTarget::destroy()
+{
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_color != 0)
+    {
+        glDeleteRenderbuffers(1, &m_color);
+        m_color = 0;
+    }
+    if (m_depthStencil != 0)
+    {
+        glDeleteRenderbuffers(1, &m_depthStencil);
+        m_depthStencil = 0;
+    }
+}
+
+void OffscreenTarget::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+std::vector<std::uint8_t> OffscreenTarget::readPixels() const
+{
+    const std::size_t rowSize = static_cast<std::size_t>(m_width) * 4;
+    std::vector<std::uint8_t> pixels(rowSize * static_cast<std::size_t>(m_height));
+    if (pixels.empty())
+        return pixels;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // OpenGL returns the bottom row first.
+    std::vector<std::uint8_t> row(rowSize);
+    for (int top = 0, bottom = m_height - 1; top < bottom; ++top, --bottom)
+    {
+        std::uint8_t* topRow = pixels.data() + static_cast<std::size_t>(top) * rowSize;
+        std::uint8_t* bottomRow = pixels.data() + static_cast<std::size_t>(bottom) * rowSize;
+        std::memcpy(row.data(), topRow, rowSize);
+        std::memcpy(topRow, bottomRow, rowSize);
+        std::memcpy(bottomRow, row.data(), rowSize);
+    }
+    return pixels;
+}
+
+bool OffscreenTarget::writePng(const std::string& path) const
+{
+    const std::vector<std::uint8_t> pixels = readPixels();
+    if (pixels.empty() || !stbi_write_png(path.c_str(), m_width, m_height, 4, pixels.data(), m_width * 4))
+    {
+        Logger::Log(LogLevel::Error, "Failed to write frame to " + path, "Renderer");
+        return false;
+    }
+    Logger::Log(LogLevel::Info, "Frame written to " + path, "Renderer");
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef OFFSCREEN_TARGET_HPP_
+#define OFFSCREEN_TARGET_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * @class OffscreenTarget
+ * @brief A framebuffer object to render into when there is no window to present to.
+ *
+ * Holds an RGBA8 color and a depth-stencil renderbuffer of a fixed size.
+ * Headless runs bind it at the start of every frame, so the result does not
+ * depend on the surface of the context, which may have none at all.
+ *
+ * Every method must run on the thread that owns the GL context.
+ */
+class OffscreenTarget
+{
+public:
+    OffscreenTarget() = default;
+    ~OffscreenTarget() = default;
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    /**
+     * @brief Creates the framebuffer and its attachments.
+     *
+     * @param width The width in pixels.
+     * @param height The height in pixels.
+     * @throws std::runtime_error If the framebuffer is incomplete.
+     */
+    void create(int width, int height);
+
+    /**
+     * @brief Deletes the framebuffer and its attachments.
+     */
+    void destroy();
+
+    /**
+     * @brief Binds the framebuffer for drawing and reading, and sets the viewport to cover it.
+     */
+    void bind() const;
+
+    /**
+     * @brief Reads the color attachment back, top row first.
+     *
+     * Stalls until the GPU has finished every pending draw.
+     *
+     * @return The pixels, 4 bytes each.
+     */
+    std::vector<std::uint8_t> readPixels() const;
+
+    /**
+     * @brief Writes the color attachment to a PNG file.
+     *
+     * @param path The file to write.
+     * @return Whether the file was written.
+     */
+    bool writePng(const std::string& path) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    GLuint m_framebuffer = 0;  /**< The framebuffer object, 0 before create(). */
+    GLuint m_color = 0;        /**< The RGBA8 color renderbuffer. */
+    GLuint m_depthStencil = 0; /**< The depth-stencil renderbuffer. */
+    int m_width = 0;           /**< The width in pixels. */
+    int m_height = 0;          /**< The height in pixels. */
+};
+
+#endif
@@ -0,0 +1,138 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+
+#include "log.hpp"
+
+std::size_t GpuProfiler::writeTimestamp(Frame& frame)
+{
+    if (frame.used == frame.queries.size())
+    {
+        // Grows the pool in blocks, so a new zone rarely costs a query allocation.
+        const std::size_t added = std::max<std::size_t>(16, frame.queries.size());
+        frame.queries.resize(frame.queries.size() + added);
+        glGenQueries(static_cast<GLsizei>(added), frame.queries.data() + frame.used);
+    }
+    const std::size_t index = frame.used++;
+    glQueryCounter(frame.queries[index], GL_TIMESTAMP);
+    return index;
+}
+
+void GpuProfiler::beginFrame()
+{
+    m_current = (m_current + 1) % FRAME_LATENCY;
+    Frame& frame = m_frames[m_current];
+    resolve(frame);
+    frame.used = 0;
+    frame.zones.clear();
+    // Zones left open by the previous frame are never closed.
+    m_open.clear();
+
+    m_active = m_supported && isEnabled();
+    if (!m_active)
+    {
+        // The clocks may have drifted apart while profiling was off.
+        m_calibrationAge = CALIBRATION_INTERVAL;
+        return;
+    }
+    if (!GLAD_GL_VERSION_3_3)
+    {
+        Logger::Log(LogLevel::Warning, "Timer queries need OpenGL 3.3, GPU profiling is disabled", "Renderer");
+        m_supported = false;
+        m_active = false;
+        return;
+    }
+
+    if (m_calibrationAge >= CALIBRATION_INTERVAL)
+        calibrate();
+    m_calibrationAge++;
+    frame.clockOffset = m_clockOffset;
+}
+
+void GpuProfiler::calibrate()
+{
+    // Stalls on the driver, hence only every CALIBRATION_INTERVAL frames.
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    m_clockOffset = Profiler::steadyNanoseconds() - static_cast<std::int64_t>(gpuTime);
+    m_calibrationAge = 0;
+}
+
+void GpuProfiler::begin(const char* name)
+{
+    if (!m_active)
+        return;
+    Frame& frame = m_frames[m_current];
+    m_open.push_back(frame.zones.size());
+    frame.zones.push_back(Zone{name, static_cast<int>(m_open.size()) - 1, writeTimestamp(frame), NO_QUERY});
+}
+
+void GpuProfiler::end()
+{
+    if (!m_active || m_open.empty())
+        return;
+    Frame& frame = m_frames[m_current];
+    frame.zones[m_open.back()].end = writeTimestamp(frame);
+    m_open.pop_back();
+}
+
+void GpuProfiler::resolve(Frame& frame)
+{
+    if (frame.used == 0)
+        return;
+
+    // Queries complete in order, so the last one tells whether the whole frame is ready.
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        m_lateFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_results.resize(frame.used);
+    for (std::size_t i = 0; i < frame.used; ++i)
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &m_results[i]);
+
+    Profiler& profiler = Profiler::getInstance();
+    const bool capturing = profiler.isCapturing();
+    if (capturing && !m_track)
+        m_track = profiler.addTrack("GPU");
+
+    std::vector<Timing> timings;
+    timings.reserve(frame.zones.size());
+    for (const Zone& zone : frame.zones)
+    {
+        if (zone.end == NO_QUERY)
+            continue;
+        const auto start = static_cast<std::int64_t>(m_results[zone.begin]);
+        const auto end = static_cast<std::int64_t>(m_results[zone.end]);
+        timings.push_back(Timing{zone.name, zone.depth, static_cast<double>(end - start) / 1e6});
+        if (capturing)
+        {
+            profiler.recordOnTrack(m_track, zone.name, start + frame.clockOffset, end + frame.clockOffset);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastFrame = std::move(timings);
+}
+
+std::vector<GpuProfiler::Timing> GpuProfiler::getLastFrame() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastFrame;
+}
+
+void GpuProfiler::shutdown()
+{
+    for (Frame& frame : m_frames)
+    {
+        if (!frame.queries.empty())
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        frame = Frame();
+    }
+    m_open.clear();
+    m_active = false;
+    m_calibrationAge = CALIBRATION_INTERVAL;
+}
@@ -0,0 +1,177 @@
+#ifndef GPU_PROFILER_HPP_
+#define GPU_PROFILER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "profiler.hpp"
+
+/**
+ * @class GpuProfiler
+ * @brief Times GPU passes with timer queries, read back a few frames later.
+ *
+ * Each zone writes a GL_TIMESTAMP query at its start and end. Queries of a
+ * frame come from a pool that is only read FRAME_LATENCY frames later, when
+ * the GPU has long finished them, so reading never stalls the pipeline. A
+ * frame whose results are still not available by then is dropped.
+ *
+ * Resolved frames are kept for getLastFrame() and, while the CPU Profiler
+ * captures, recorded on its "GPU" track, aligned to the CPU timeline with the
+ * offset between the GPU and CPU clocks. Reading the GPU clock is a synchronous
+ * round trip to the driver, so the offset is measured on the first profiled
+ * frame and then once every CALIBRATION_INTERVAL frames to follow drift.
+ *
+ * Every method except setEnabled() and getLastFrame() must run on the thread
+ * that owns the GL context. Use the GPU_PROFILE_* macros, which compile to
+ * nothing without LAMB_PROFILER.
+ */
+class GpuProfiler
+{
+public:
+    /**
+     * @brief The GPU time of one zone.
+     */
+    struct Timing
+    {
+        const char* name;    /**< The zone name. */
+        int depth;           /**< The nesting depth, 0 for top level zones. */
+        double milliseconds; /**< The GPU time between the start and the end of the zone. */
+    };
+
+    static constexpr std::size_t FRAME_LATENCY = 3;          /**< Frames between writing and reading a query. */
+    static constexpr std::size_t CALIBRATION_INTERVAL = 600; /**< Profiled frames between clock calibrations. */
+
+    static GpuProfiler& getInstance()
+    {
+        static GpuProfiler instance;
+        return instance;
+    }
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /**
+     * @brief Turns the queries on or off from the next frame. Any thread.
+     *
+     * @param enabled Whether zones write queries.
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether zones write queries.
+     *
+     * @return The value set with setEnabled().
+     */
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Starts a frame and resolves the one written FRAME_LATENCY frames ago.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Opens a zone.
+     *
+     * @param name The zone name, a string with static storage duration.
+     */
+    void begin(const char* name);
+
+    /**
+     * @brief Closes the innermost open zone.
+     */
+    void end();
+
+    /**
+     * @brief Gets the zones of the latest resolved frame. Any thread.
+     *
+     * @return The zones in the order they were opened.
+     */
+    std::vector<Timing> getLastFrame() const;
+
+    /**
+     * @brief Gets the number of frames dropped because their queries were not ready in time.
+     *
+     * @return The late frame count.
+     */
+    std::size_t lateFrameCount() const { return m_lateFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Deletes the queries. The context must be current.
+     */
+    void shutdown();
+
+private:
+    struct Zone
+    {
+        const char* name;  /**< The zone name. */
+        int depth;         /**< The nesting depth. */
+        std::size_t begin; /**< Index of the start query in the frame pool. */
+        std::size_t end;   /**< Index of the end query, NO_QUERY while the zone is open. */
+    };
+
+    struct Frame
+    {
+        std::vector<GLuint> queries;  /**< The query pool, grown on demand. */
+        std::size_t used = 0;         /**< The queries written this frame. */
+        std::vector<Zone> zones;      /**< The zones, in opening order. */
+        std::int64_t clockOffset = 0; /**< Steady clock minus GPU clock when the frame was written, in nanoseconds. */
+    };
+
+    static constexpr std::size_t NO_QUERY = static_cast<std::size_t>(-1);
+
+    GpuProfiler() = default;
+    ~GpuProfiler() = default;
+
+    std::size_t writeTimestamp(Frame& frame);
+    void calibrate();
+    void resolve(Frame& frame);
+
+    std::atomic<bool> m_enabled{false};                  /**< Whether the next frames write queries. */
+    bool m_active = false;                               /**< Whether the current frame writes queries. */
+    bool m_supported = true;                             /**< Whether the context has timer queries. */
+    std::array<Frame, FRAME_LATENCY> m_frames;           /**< The frames in flight, used round robin. */
+    std::size_t m_current = 0;                           /**< Index of the current frame. */
+    std::int64_t m_clockOffset = 0;                      /**< Steady clock minus GPU clock at the last calibration. */
+    std::size_t m_calibrationAge = CALIBRATION_INTERVAL; /**< Profiled frames since the last calibration. */
+    std::vector<std::size_t> m_open;                     /**< Indices of the open zones of the current frame. */
+    std::vector<GLuint64> m_results;                     /**< Scratch for the query results. */
+    Profiler::Track* m_track = nullptr;                  /**< The Profiler track, added on first capture. */
+    std::atomic<std::size_t> m_lateFrames{0};            /**< Frames dropped because they were not ready. */
+    mutable std::mutex m_mutex;                          /**< Guards m_lastFrame. */
+    std::vector<Timing> m_lastFrame;                     /**< The latest resolved frame. */
+};
+
+/**
+ * @class GpuProfileZone
+ * @brief Times the GPU work issued during its lifetime. Use GPU_PROFILE_ZONE.
+ */
+class GpuProfileZone
+{
+public:
+    explicit GpuProfileZone(const char* name) { GpuProfiler::getInstance().begin(name); }
+    ~GpuProfileZone() { GpuProfiler::getInstance().end(); }
+
+    GpuProfileZone(const GpuProfileZone&) = delete;
+    GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+};
+
+#ifdef LAMB_PROFILER
+// Must run on the context thread; name must be a string literal.
+#define GPU_PROFILE_FRAME() GpuProfiler::getInstance().beginFrame()
+#define GPU_PROFILE_BEGIN(name) GpuProfiler::getInstance().begin(name)
+#define GPU_PROFILE_END() GpuProfiler::getInstance().end()
+#define GPU_PROFILE_ZONE(name) GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#else
+#define GPU_PROFILE_FRAME() ((void)0)
+#define GPU_PROFILE_BEGIN(name) ((void)0)
+#define GPU_PROFILE_END() ((void)0)
+#define GPU_PROFILE_ZONE(name) ((void)0)
+#endif
+
+#endif
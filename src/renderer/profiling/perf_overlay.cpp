@@ -0,0 +1,233 @@
+#include "perf_overlay.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <imgui.h>
+
+#include "allocation_counter.hpp"
+#include "gpu_profiler.hpp"
+#include "profiler.hpp"
+#include "render_stats.hpp"
+
+namespace
+{
+
+// Weight of the newest value in the moving averages, about a third of a second at 60 Hz.
+constexpr double SMOOTHING = 0.05;
+
+constexpr double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+} // namespace
+
+PerfOverlay::~PerfOverlay()
+{
+    setVisible(false);
+}
+
+void PerfOverlay::setVisible(bool visible)
+{
+    if (visible == m_visible)
+        return;
+    m_visible = visible;
+    m_ownAllocations = 0;
+    m_ownAllocatedBytes = 0;
+    m_ownMilliseconds = 0.0;
+
+#ifdef LAMB_PROFILER
+    Profiler& profiler = Profiler::getInstance();
+    GpuProfiler& gpuProfiler = GpuProfiler::getInstance();
+    if (visible)
+    {
+        m_startedCapture = !profiler.isCapturing();
+        if (m_startedCapture)
+            profiler.start();
+        m_enabledGpu = !gpuProfiler.isEnabled();
+        if (m_enabledGpu)
+            gpuProfiler.setEnabled(true);
+
+        // Skips the events of earlier captures.
+        profiler.collectNew(m_cursors);
+        m_zones.clear();
+    }
+    else
+    {
+        if (m_startedCapture)
+            profiler.stop();
+        if (m_enabledGpu)
+            gpuProfiler.setEnabled(false);
+        m_startedCapture = false;
+        m_enabledGpu = false;
+    }
+#endif
+}
+
+void PerfOverlay::record(double frameTime)
+{
+    m_frameTimes[m_frameCount % HISTORY] = static_cast<float>(frameTime * 1000.0);
+    ++m_frameCount;
+
+    // The overlay's own allocations happened during the frame, in draw().
+    const std::uint64_t allocations = AllocationCounter::getCount();
+    const std::uint64_t allocatedBytes = AllocationCounter::getBytes();
+    m_frameAllocations = allocations - m_lastAllocations - m_ownAllocations;
+    m_frameAllocatedBytes = allocatedBytes - m_lastAllocatedBytes - m_ownAllocatedBytes;
+    m_lastAllocations = allocations;
+    m_lastAllocatedBytes = allocatedBytes;
+}
+
+void PerfOverlay::draw()
+{
+    if (!m_visible)
+        return;
+
+    PROFILE_ZONE("Perf overlay");
+    const std::int64_t start = Profiler::steadyNanoseconds();
+    const std::uint64_t allocations = AllocationCounter::getCount();
+    const std::uint64_t allocatedBytes = AllocationCounter::getBytes();
+
+    updateZones();
+
+    bool open = true;
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    if (ImGui::Begin("Performance", &open, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::Text("Overlay: %.3f ms, %llu allocations", m_ownMilliseconds,
+                    static_cast<unsigned long long>(m_ownAllocations));
+        drawFrameTimes();
+        drawRenderStats();
+        drawZones();
+    }
+    ImGui::End();
+
+    m_ownAllocations = AllocationCounter::getCount() - allocations;
+    m_ownAllocatedBytes = AllocationCounter::getBytes() - allocatedBytes;
+    const double milliseconds = static_cast<double>(Profiler::steadyNanoseconds() - start) / 1e6;
+    m_ownMilliseconds += (milliseconds - m_ownMilliseconds) * SMOOTHING;
+
+    if (!open)
+        setVisible(false);
+}
+
+void PerfOverlay::updateZones()
+{
+#ifdef LAMB_PROFILER
+    for (ZoneTiming& zone : m_zones)
+        zone.frame = 0.0;
+
+    for (const Profiler::ThreadEvents& thread : Profiler::getInstance().collectNew(m_cursors))
+    {
+        if (thread.id >= m_tracks.size())
+            m_tracks.resize(thread.id + 1);
+        if (m_tracks[thread.id] != thread.name)
+            m_tracks[thread.id] = thread.name;
+
+        for (const Profiler::Event& event : thread.events)
+        {
+            if (event.end == Profiler::INSTANT)
+                continue;
+            // Names are literals: usually the same pointer, but not across translation units.
+            auto zone = std::find_if(m_zones.begin(), m_zones.end(), [&](const ZoneTiming& timing) {
+                return timing.track == thread.id &&
+                       (timing.name == event.name || std::strcmp(timing.name, event.name) == 0);
+            });
+            if (zone == m_zones.end())
+                zone = m_zones.insert(m_zones.end(), ZoneTiming{thread.id, event.name});
+            zone->frame += static_cast<double>(event.end - event.start) / 1e6;
+        }
+    }
+
+    for (ZoneTiming& zone : m_zones)
+        zone.average += (zone.frame - zone.average) * SMOOTHING;
+    std::sort(m_zones.begin(), m_zones.end(), [](const ZoneTiming& a, const ZoneTiming& b) {
+        return a.track != b.track ? a.track < b.track : a.average > b.average;
+    });
+#endif
+}
+
+void PerfOverlay::drawFrameTimes()
+{
+    const std::size_t count = std::min(m_frameCount, HISTORY);
+    if (count == 0)
+        return;
+
+    std::copy_n(m_frameTimes.begin(), count, m_sorted.begin());
+    auto percentile = [&](double fraction) {
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(count - 1) + 0.5);
+        std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.begin() + count);
+        return m_sorted[index];
+    };
+    const float p50 = percentile(0.50);
+    const float p95 = percentile(0.95);
+    const float p99 = percentile(0.99);
+
+    float total = 0.0f;
+    for (std::size_t i = 0; i < count; ++i)
+        total += m_frameTimes[i];
+    const float average = total / static_cast<float>(count);
+
+    ImGui::Text("%.1f FPS, %.2f ms average over %zu frames", 1000.0f / average, average, count);
+    ImGui::Text("p50 %.2f ms  p95 %.2f ms  p99 %.2f ms", p50, p95, p99);
+
+    // Oldest frame first once the ring is full.
+    const int offset = m_frameCount > HISTORY ? static_cast<int>(m_frameCount % HISTORY) : 0;
+    ImGui::PlotLines("##Frame times", m_frameTimes.data(), static_cast<int>(count), offset, nullptr, 0.0f,
+                     std::max(p99 * 1.5f, 1000.0f / 60.0f), ImVec2(static_cast<float>(HISTORY), 60.0f));
+}
+
+void PerfOverlay::drawRenderStats()
+{
+    if (!ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    const RenderStats::Frame stats = RenderStats::getInstance().getLastFrame();
+    ImGui::Text("Draw calls: %zu  Triangles: %zu", stats.drawCalls, stats.triangles);
+    ImGui::Text("State changes: %zu  Uniform uploads: %zu", stats.stateChanges, stats.uniformUploads);
+    ImGui::Text("Textures: %.1f MB  Buffers: %.1f MB", static_cast<double>(stats.textureBytes) / BYTES_PER_MEGABYTE,
+                static_cast<double>(stats.bufferBytes) / BYTES_PER_MEGABYTE);
+
+    if (AllocationCounter::isEnabled())
+        ImGui::Text("Allocations: %llu per frame, %.1f KB", static_cast<unsigned long long>(m_frameAllocations),
+                    static_cast<double>(m_frameAllocatedBytes) / 1024.0);
+    else
+        ImGui::TextDisabled("Allocations are only counted with ENABLE_ALLOCATION_COUNTER");
+}
+
+void PerfOverlay::drawZones()
+{
+    if (!ImGui::CollapsingHeader("Zones", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+#ifdef LAMB_PROFILER
+    if (!ImGui::BeginTable("Zones", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+        return;
+
+    std::uint32_t track = static_cast<std::uint32_t>(-1);
+    for (const ZoneTiming& zone : m_zones)
+    {
+        // Zones that stopped running fade out of the list.
+        if (zone.average < 0.001)
+            continue;
+
+        if (zone.track != track)
+        {
+            track = zone.track;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (m_tracks[track].empty())
+                ImGui::TextDisabled("Thread %u", track);
+            else
+                ImGui::TextDisabled("%s", m_tracks[track].c_str());
+        }
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("  %s", zone.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f ms", zone.average);
+    }
+    ImGui::EndTable();
+#else
+    ImGui::TextDisabled("Zone timings need ENABLE_PROFILER");
+#endif
+}
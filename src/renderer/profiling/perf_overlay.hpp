@@ -0,0 +1,108 @@
+#ifndef PERF_OVERLAY_HPP_
+#define PERF_OVERLAY_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class PerfOverlay
+ * @brief An ImGui window showing frame times, render counters, memory and zone timings.
+ *
+ * The window shows:
+ * - the last HISTORY frame times as a graph, with their p50, p95 and p99;
+ * - the RenderStats of the last frame the GPU was given;
+ * - the allocations made through operator new per frame (AllocationCounter);
+ * - the time of every PROFILE_ZONE and GPU_PROFILE_ZONE, per thread, averaged over a few frames;
+ * - its own CPU time and allocations, which are left out of the other figures.
+ *
+ * Zone timings come from the Profiler and the GpuProfiler, which the overlay
+ * turns on while it is visible and back off when hidden, unless something
+ * else turned them on first. They need LAMB_PROFILER.
+ *
+ * record() must be called every frame, draw() between ImGui::NewFrame() and
+ * ImGui::Render(), both on the game thread.
+ */
+class PerfOverlay
+{
+public:
+    static constexpr std::size_t HISTORY = 240; /**< Frame times kept for the graph and percentiles. */
+
+    PerfOverlay() = default;
+    ~PerfOverlay();
+
+    PerfOverlay(const PerfOverlay&) = delete;
+    PerfOverlay& operator=(const PerfOverlay&) = delete;
+
+    /**
+     * @brief Shows or hides the window.
+     *
+     * @param visible Whether to show it.
+     */
+    void setVisible(bool visible);
+
+    /**
+     * @brief Shows the window if hidden, hides it otherwise.
+     */
+    void toggle() { setVisible(!m_visible); }
+
+    /**
+     * @brief Whether the window is shown.
+     *
+     * @return The value set with setVisible().
+     */
+    bool isVisible() const { return m_visible; }
+
+    /**
+     * @brief Records the duration of the last frame. Call every frame, even hidden.
+     *
+     * @param frameTime The frame duration in seconds.
+     */
+    void record(double frameTime);
+
+    /**
+     * @brief Draws the window, if visible.
+     */
+    void draw();
+
+private:
+    /**
+     * @brief The averaged time of a zone on one thread or track.
+     */
+    struct ZoneTiming
+    {
+        std::uint32_t track;  /**< The Profiler thread or track id. */
+        const char* name;     /**< The zone name. */
+        double frame = 0.0;   /**< The time spent in the zone since the last update, in ms. */
+        double average = 0.0; /**< The moving average of frame. */
+    };
+
+    void updateZones();
+    void drawFrameTimes();
+    void drawRenderStats();
+    void drawZones();
+
+    bool m_visible = false;        /**< Whether the window is shown. */
+    bool m_startedCapture = false; /**< Whether setVisible() started the Profiler capture. */
+    bool m_enabledGpu = false;     /**< Whether setVisible() enabled the GpuProfiler. */
+
+    std::array<float, HISTORY> m_frameTimes{}; /**< Ring of frame times, in ms. */
+    std::array<float, HISTORY> m_sorted{};     /**< Scratch copy for the percentiles. */
+    std::size_t m_frameCount = 0;              /**< Frames recorded, the ring is full past HISTORY. */
+
+    std::uint64_t m_lastAllocations = 0;     /**< AllocationCounter::getCount() at the last record(). */
+    std::uint64_t m_lastAllocatedBytes = 0;  /**< AllocationCounter::getBytes() at the last record(). */
+    std::uint64_t m_frameAllocations = 0;    /**< Allocations of the last frame, the overlay's excluded. */
+    std::uint64_t m_frameAllocatedBytes = 0; /**< Bytes allocated by the last frame, the overlay's excluded. */
+    std::uint64_t m_ownAllocations = 0;      /**< Allocations of the last draw(). */
+    std::uint64_t m_ownAllocatedBytes = 0;   /**< Bytes allocated by the last draw(). */
+
+    std::vector<std::size_t> m_cursors; /**< Read positions for Profiler::collectNew(). */
+    std::vector<std::string> m_tracks;  /**< Thread and track names by id. */
+    std::vector<ZoneTiming> m_zones;    /**< Every zone seen, sorted by track then time. */
+    double m_ownMilliseconds = 0.0;     /**< Moving average of the CPU time of draw(). */
+};
+
+#endif
@@ -0,0 +1,21 @@
+#include "render_stats.hpp"
+
+#include "texture_streamer.hpp"
+
+void RenderStats::beginFrame()
+{
+    const auto streamedBytes = static_cast<std::int64_t>(TextureStreamer::getInstance().getResidentBytes());
+    m_current.textureBytes = m_textureBytes + streamedBytes;
+    m_current.bufferBytes = m_bufferBytes;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_last = m_current;
+    }
+    m_current = Frame();
+}
+
+RenderStats::Frame RenderStats::getLastFrame() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_last;
+}
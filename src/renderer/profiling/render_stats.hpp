@@ -0,0 +1,103 @@
+#ifndef RENDER_STATS_HPP_
+#define RENDER_STATS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @class RenderStats
+ * @brief Counts the GL work of a frame: draws, state changes, uniforms and GPU memory.
+ *
+ * The counters are plain increments made where the engine issues the calls
+ * (Renderable, ShaderEngine, TextureBinder, uploads), so they cost about as
+ * much as the branch around them. Like the calls they count, they must only
+ * be updated on the thread that owns the GL context.
+ *
+ * beginFrame() closes the frame being counted and publishes it for
+ * getLastFrame(), which any thread can read.
+ */
+class RenderStats
+{
+public:
+    /**
+     * @brief The counters of one frame.
+     */
+    struct Frame
+    {
+        std::size_t drawCalls = 0;      /**< glDraw* calls. */
+        std::size_t triangles = 0;      /**< Triangles submitted by the draws. */
+        std::size_t stateChanges = 0;   /**< Program, vertex array and texture binds. */
+        std::size_t uniformUploads = 0; /**< glUniform* calls. */
+        std::int64_t textureBytes = 0;  /**< Estimated texture memory, streamed textures included. */
+        std::int64_t bufferBytes = 0;   /**< Vertex, index and storage buffer memory. */
+    };
+
+    static RenderStats& getInstance()
+    {
+        static RenderStats instance;
+        return instance;
+    }
+
+    RenderStats(const RenderStats&) = delete;
+    RenderStats& operator=(const RenderStats&) = delete;
+
+    /**
+     * @brief Publishes the frame counted so far and starts counting the next one.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Gets the last frame published by beginFrame(). Any thread.
+     *
+     * @return A copy of its counters.
+     */
+    Frame getLastFrame() const;
+
+    /**
+     * @brief Counts an indexed triangle draw.
+     *
+     * @param indexCount The number of indices drawn.
+     */
+    void countDraw(std::size_t indexCount)
+    {
+        ++m_current.drawCalls;
+        m_current.triangles += indexCount / 3;
+    }
+
+    /**
+     * @brief Counts a bind that changes the GL state.
+     */
+    void countStateChange() { ++m_current.stateChanges; }
+
+    /**
+     * @brief Counts a uniform upload.
+     */
+    void countUniformUpload() { ++m_current.uniformUploads; }
+
+    /**
+     * @brief Tracks texture memory allocated or, with a negative delta, freed.
+     *
+     * @param bytes The change in bytes.
+     */
+    void addTextureMemory(std::int64_t bytes) { m_textureBytes += bytes; }
+
+    /**
+     * @brief Tracks buffer memory allocated or, with a negative delta, freed.
+     *
+     * @param bytes The change in bytes.
+     */
+    void addBufferMemory(std::int64_t bytes) { m_bufferBytes += bytes; }
+
+private:
+    RenderStats() = default;
+    ~RenderStats() = default;
+
+    Frame m_current;                 /**< The frame being counted. */
+    std::int64_t m_textureBytes = 0; /**< Texture memory tracked outside the streamer. */
+    std::int64_t m_bufferBytes = 0;  /**< Buffer memory. */
+    mutable std::mutex m_mutex;      /**< Guards m_last. */
+    Frame m_last;                    /**< The last published frame. */
+};
+
+#endif
@@ -1,16 +1,203 @@
 #include "model.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <glm/glm.hpp>
-#include <stb_image.h>
+#include <glm/gtc/type_ptr.hpp>
 
+#include "animator.hpp"
+#include "log.hpp"
+#include "mesh_cache.hpp"
 #include "shader.hpp"
 #include "shader_engine.hpp"
 #include "texture.hpp"
+#include "texture_atlas.hpp"
+#include "texture_loader.hpp"
+#include "thread_pool.hpp"
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+/**
+ * Read-only Assimp stream over a file read through the VirtualFileSystem.
+ */
+class VfsIOStream : public Assimp::IOStream
+{
+public:
+    explicit VfsIOStream(IO::FileData file) : m_file(std::move(file)) {}
+
+    size_t Read(void* buffer, size_t size, size_t count) override
+    {
+        if (size == 0)
+            return 0;
+        const size_t available = (m_file.size() - m_position) / size;
+        const size_t read = std::min(count, available);
+        std::memcpy(buffer, m_file.data() + m_position, read * size);
+        m_position += read * size;
+        return read;
+    }
+
+    size_t Write(const void*, size_t, size_t) override { return 0; }
+
+    aiReturn Seek(size_t offset, aiOrigin origin) override
+    {
+        size_t target = offset;
+        if (origin == aiOrigin_CUR)
+            target = m_position + offset;
+        else if (origin == aiOrigin_END)
+            target = m_file.size() - std::min(offset, m_file.size());
+        if (target > m_file.size())
+            return aiReturn_FAILURE;
+        m_position = target;
+        return aiReturn_SUCCESS;
+    }
+
+    size_t Tell() const override { return m_position; }
+
+    size_t FileSize() const override { return m_file.size(); }
+
+    void Flush() override {}
+
+private:
+    IO::FileData m_file;
+    size_t m_position = 0;
+};
+
+/**
+ * Lets Assimp open the model and the files it references (.mtl, .bin) from packs.
+ */
+class VfsIOSystem : public Assimp::IOSystem
+{
+public:
+    bool Exists(const char* path) const override { return IO::VirtualFileSystem::getInstance().exists(path); }
+
+    char getOsSeparator() const override { return '/'; }
+
+    Assimp::IOStream* Open(const char* path, const char* mode) override
+    {
+        if (std::strchr(mode, 'w') || std::strchr(mode, 'a'))
+            return nullptr;
+        try
+        {
+            return new VfsIOStream(IO::VirtualFileSystem::getInstance().read(path));
+        }
+        catch (const std::exception&)
+        {
+            return nullptr;
+        }
+    }
+
+    void Close(Assimp::IOStream* stream) override { delete stream; }
+};
+
+void collectMaterialTextures(const aiMaterial* material, aiTextureType assimpTextureType, TextureType lambTextureType,
+                             std::vector<std::pair<std::string, TextureType>>& textures)
+{
+    for (unsigned int i = 0; i < material->GetTextureCount(assimpTextureType); i++)
+    {
+        aiString str;
+        material->GetTexture(assimpTextureType, i, &str);
+        textures.emplace_back(str.C_Str(), lambTextureType);
+    }
+}
+
+glm::mat4 toMat4(const aiMatrix4x4& matrix)
+{
+    // Assimp matrices are row major.
+    return glm::transpose(glm::make_mat4(&matrix.a1));
+}
+
+JointPose toJointPose(const aiMatrix4x4& matrix)
+{
+    aiVector3D scaling, position;
+    aiQuaternion rotation;
+    matrix.Decompose(scaling, rotation, position);
+
+    JointPose pose;
+    pose.translation = glm::vec3(position.x, position.y, position.z);
+    pose.rotation = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+    pose.scale = glm::vec3(scaling.x, scaling.y, scaling.z);
+    return pose;
+}
+
+void addJoints(const aiNode* node, int parent, Skeleton& skeleton)
+{
+    const int joint = skeleton.addJoint(node->mName.C_Str(), parent, toJointPose(node->mTransformation));
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+        addJoints(node->mChildren[i], joint, skeleton);
+}
+
+/**
+ * Keeps the MAX_BONE_INFLUENCE heaviest influences of a vertex.
+ */
+void addBoneInfluence(Vertex& vertex, int joint, float weight)
+{
+    int slot = 0;
+    for (int k = 1; k < MAX_BONE_INFLUENCE; ++k)
+    {
+        if (vertex.m_Weights[k] < vertex.m_Weights[slot])
+            slot = k;
+    }
+    if (weight <= vertex.m_Weights[slot])
+        return;
+    vertex.m_BoneIDs[slot] = joint;
+    vertex.m_Weights[slot] = weight;
+}
+
+std::shared_ptr<const AnimationClip> importClip(const aiAnimation* animation, const Skeleton& skeleton)
+{
+    const double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+    const auto seconds = [ticksPerSecond](double ticks) { return static_cast<float>(ticks / ticksPerSecond); };
+
+    std::vector<AnimationChannel> channels;
+    for (unsigned int c = 0; c < animation->mNumChannels; c++)
+    {
+        const aiNodeAnim* source = animation->mChannels[c];
+        AnimationChannel channel;
+        channel.joint = skeleton.find(source->mNodeName.C_Str());
+        if (channel.joint < 0)
+            continue;
+
+        for (unsigned int k = 0; k < source->mNumPositionKeys; k++)
+        {
+            const aiVectorKey& key = source->mPositionKeys[k];
+            channel.translations.push_back({seconds(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
+        }
+        for (unsigned int k = 0; k < source->mNumRotationKeys; k++)
+        {
+            const aiQuatKey& key = source->mRotationKeys[k];
+            channel.rotations.push_back(
+                {seconds(key.mTime), glm::quat(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z)});
+        }
+        for (unsigned int k = 0; k < source->mNumScalingKeys; k++)
+        {
+            const aiVectorKey& key = source->mScalingKeys[k];
+            channel.scales.push_back({seconds(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
+        }
+        channels.push_back(std::move(channel));
+    }
+
+    const AnimationClip clip(animation->mName.C_Str(), seconds(animation->mDuration), std::move(channels));
+    auto compressed = AnimationClip::compress(clip);
+    Logger::Log(LogLevel::Info,
+                "Compressed animation " + clip.getName() + ": " + std::to_string(clip.memoryUsage()) + " -> " +
+                    std::to_string(compressed->memoryUsage()) + " bytes",
+                "Renderer");
+    return compressed;
+}
+
+} // namespace
 
 Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, std::vector<Texture>& textures)
     : Renderable()
@@ -22,9 +209,51 @@ Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, st
     setup();
 };
 
-Model::Model(std::string const path)
+Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Texture>& textures)
+    : Renderable()
+{
+    m_vertices = std::move(vertices);
+    m_indices = std::move(indices);
+    m_textures = textures;
+
+    setup();
+}
+
+Mesh::Mesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+           std::vector<Texture>& textures, const glm::vec3& boundsCenter, float boundsRadius, float uvDensity)
+    : Renderable()
+{
+    m_textures = textures;
+
+    setup(vertices, vertexCount, indices, indexCount, boundsCenter, boundsRadius, uvDensity);
+}
+
+Model::Model(std::string const path) : Model(import(path))
 {
-    loadModel(path);
+}
+
+Model::Model(ModelData data) : m_directory(data.directory), m_skeleton(data.skeleton), m_clips(std::move(data.clips))
+{
+    m_meshes.reserve(data.submeshes.size());
+    for (ModelData::Submesh& submesh : data.submeshes)
+    {
+        std::vector<Texture> textures;
+        for (const auto& [texturePath, type] : submesh.textures)
+            textures.push_back(loadMaterialTexture(texturePath, type));
+
+        if (submesh.cached)
+        {
+            const IO::MeshCacheSubmesh& cached = *submesh.cached;
+            const glm::vec3 center(cached.boundsCenter[0], cached.boundsCenter[1], cached.boundsCenter[2]);
+            m_meshes.push_back(Mesh(reinterpret_cast<const Vertex*>(data.cache->vertices(cached)), cached.vertexCount,
+                                    data.cache->indices(cached), cached.indexCount, textures, center,
+                                    cached.boundsRadius, cached.uvDensity));
+        }
+        else
+        {
+            m_meshes.push_back(Mesh(std::move(submesh.vertices), std::move(submesh.indices), textures));
+        }
+    }
 }
 
 Model::Model(Primitive& primitive)
@@ -40,167 +269,370 @@ void Model::draw()
     }
 };
 
-void Model::setShaderEngine(ShaderEngine engine)
+void Model::draw(const glm::mat4& model)
+{
+    for (Renderable& mesh : m_meshes)
+        mesh.draw(model);
+}
+
+void Model::draw(const Animator& animator, const glm::mat4& model)
+{
+    const bool gpu = AnimationSystem::getInstance().getSkinningMode() == SkinningMode::GPU;
+    for (std::size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        Renderable& mesh = m_meshes[i];
+        if (mesh.isSkinned() && gpu)
+        {
+            mesh.setBoneOffset(animator.getPaletteOffset());
+        }
+        else if (mesh.isSkinned())
+        {
+            // Shared by every animator of the model, so refilled before each draw.
+            const std::vector<Vertex>& skinned = animator.getSkinnedVertices(i);
+            if (!skinned.empty())
+                mesh.updateVertices(skinned.data(), skinned.size());
+        }
+
+        mesh.draw(model);
+        mesh.setBoneOffset(-1);
+    }
+}
+
+std::shared_ptr<const AnimationClip> Model::findClip(const std::string& name) const
+{
+    for (const auto& clip : m_clips)
+    {
+        if (clip->getName() == name)
+            return clip;
+    }
+    return nullptr;
+}
+
+void Model::setShaderEngine(const ShaderEngine& engine)
 {
     for (auto& mesh : m_meshes)
         mesh.setShaderEngine(engine);
 }
 
-void Model::loadModel(std::string path)
+void Model::setShaderVariants(ShaderVariants& variants, std::uint32_t features)
 {
+    for (auto& mesh : m_meshes)
+        mesh.setShaderVariants(variants, features);
+}
+
+void Model::destroy()
+{
+    for (Renderable& mesh : m_meshes)
+        mesh.destroy();
+}
+
+ModelData Model::import(const std::string& path)
+{
+    ModelData data;
+    data.directory = path.substr(0, path.find_last_of('/'));
+
+    try
+    {
+        const IO::FileData source = IO::VirtualFileSystem::getInstance().read(path);
+        data.sourceHash = IO::hashBytes(source.data(), source.size());
+        char name[48];
+        std::snprintf(name, sizeof(name), "%016llx_%08x.lmesh", static_cast<unsigned long long>(data.sourceHash),
+                      IMPORT_FLAGS);
+        data.cachePath = (std::filesystem::path(MESH_CACHE_DIRECTORY) / name).string();
+    }
+    catch (const std::exception&)
+    {
+        // Let Assimp report the error.
+    }
+
+    if (!data.cachePath.empty() && readCache(data))
+        return data;
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    importer.SetIOHandler(new VfsIOSystem());
+    const aiScene* scene = importer.ReadFile(path, IMPORT_FLAGS);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
         std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
-        return;
+        return data;
     }
 
-    m_directory = path.substr(0, path.find_last_of('/'));
+    processScene(scene, data);
+    data.valid = true;
 
-    processNode(scene->mRootNode, scene);
+    // Written here, off the GL context thread; skinned models are imported from the source every time.
+    if (!data.cachePath.empty() && !data.skeleton)
+        writeCache(data);
+    return data;
 };
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+bool Model::readCache(ModelData& data)
 {
-    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    if (!std::filesystem::exists(data.cachePath))
+        return false;
+
+    try
+    {
+        data.cache = std::make_shared<IO::MeshCacheFile>(data.cachePath, data.sourceHash, IMPORT_FLAGS, sizeof(Vertex));
+    }
+    catch (const std::exception& e)
     {
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        m_meshes.push_back(std::move(processMesh(mesh, scene)));
+        Logger::Log(LogLevel::Warning, std::string("Ignoring mesh cache: ") + e.what(), "Renderer");
+        return false;
     }
 
-    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    const IO::MeshCacheFile& file = *data.cache;
+    for (std::uint32_t i = 0; i < file.header().submeshCount; ++i)
     {
-        processNode(node->mChildren[i], scene);
+        ModelData::Submesh submesh;
+        const IO::MeshCacheSubmesh& cached = file.submeshes()[i];
+        submesh.cached = &cached;
+        for (std::uint32_t t = cached.firstTexture; t < cached.firstTexture + cached.textureCount; ++t)
+            submesh.textures.emplace_back(file.texturePath(t), static_cast<TextureType>(file.textureType(t)));
+        data.submeshes.push_back(std::move(submesh));
     }
-};
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+    data.valid = true;
+    return true;
+}
+
+void Model::writeCache(const ModelData& model)
 {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    IO::MeshCacheData data;
+    data.sourceHash = model.sourceHash;
+    data.importFlags = IMPORT_FLAGS;
+    data.vertexStride = sizeof(Vertex);
 
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    bool empty = true;
+    for (const ModelData::Submesh& mesh : model.submeshes)
     {
-        Vertex vertex;
-        glm::vec3 vector;
-        vector.x = mesh->mVertices[i].x;
-        vector.y = mesh->mVertices[i].y;
-        vector.z = mesh->mVertices[i].z;
-        vertex.position = vector;
+        const std::vector<Vertex>& vertices = mesh.vertices;
+        const std::vector<unsigned int>& indices = mesh.indices;
 
-        if (mesh->HasNormals())
-        {
-            vector.x = mesh->mNormals[i].x;
-            vector.y = mesh->mNormals[i].y;
-            vector.z = mesh->mNormals[i].z;
-            vertex.normal = vector;
-        }
+        glm::vec3 boundsCenter;
+        float boundsRadius, uvDensity;
+        Renderable::computeStreamingBounds(vertices, indices, boundsCenter, boundsRadius, uvDensity);
 
-        if (mesh->mTextureCoords[0])
+        IO::MeshCacheSubmesh submesh;
+        submesh.firstVertex = static_cast<std::uint32_t>(data.vertices.size() / sizeof(Vertex));
+        submesh.vertexCount = static_cast<std::uint32_t>(vertices.size());
+        submesh.firstIndex = static_cast<std::uint32_t>(data.indices.size());
+        submesh.indexCount = static_cast<std::uint32_t>(indices.size());
+        submesh.firstTexture = static_cast<std::uint32_t>(data.texturePaths.size());
+        submesh.textureCount = static_cast<std::uint32_t>(mesh.textures.size());
+        submesh.boundsCenter[0] = boundsCenter.x;
+        submesh.boundsCenter[1] = boundsCenter.y;
+        submesh.boundsCenter[2] = boundsCenter.z;
+        submesh.boundsRadius = boundsRadius;
+        submesh.uvDensity = uvDensity;
+        data.submeshes.push_back(submesh);
+
+        for (const auto& [texturePath, type] : mesh.textures)
         {
-            glm::vec2 vec;
-            vec.x = mesh->mTextureCoords[0][i].x;
-            vec.y = mesh->mTextureCoords[0][i].y;
-            vertex.textureCoordinates = vec;
+            data.textureTypes.push_back(static_cast<std::uint32_t>(type));
+            data.texturePaths.push_back(texturePath);
         }
-        else
+
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(vertices.data());
+        data.vertices.insert(data.vertices.end(), bytes, bytes + vertices.size() * sizeof(Vertex));
+        data.indices.insert(data.indices.end(), indices.begin(), indices.end());
+
+        for (const Vertex& vertex : vertices)
         {
-            vertex.textureCoordinates = glm::vec2(0.0f, 0.0f);
+            boundsMin = empty ? vertex.position : glm::min(boundsMin, vertex.position);
+            boundsMax = empty ? vertex.position : glm::max(boundsMax, vertex.position);
+            empty = false;
         }
-        vertices.push_back(vertex);
     }
 
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        data.boundsMin[axis] = boundsMin[axis];
+        data.boundsMax[axis] = boundsMax[axis];
+    }
+
+    try
+    {
+        IO::writeMeshCache(model.cachePath, data);
+    }
+    catch (const std::exception& e)
     {
-        aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++)
-            indices.push_back(face.mIndices[j]);
+        Logger::Log(LogLevel::Warning, std::string("Failed to write mesh cache: ") + e.what(), "Renderer");
     }
+}
 
-    if (mesh->mMaterialIndex >= 0)
+void Model::processNode(aiNode* node, const aiScene* scene, std::vector<unsigned int>& meshOrder)
+{
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
     {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-        std::vector<Texture> diffuseMaps =
-            this->loadMaterialTextures(material, aiTextureType_DIFFUSE, TextureType::DIFFUSE);
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-        std::vector<Texture> specularMaps =
-            this->loadMaterialTextures(material, aiTextureType_SPECULAR, TextureType::SPECULAR);
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        meshOrder.push_back(node->mMeshes[i]);
     }
 
-    return Mesh(vertices, indices, textures);
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    {
+        processNode(node->mChildren[i], scene, meshOrder);
+    }
 };
 
-unsigned int textureFromFile(const char* path, const std::string& directory)
+void Model::processSkeleton(const aiScene* scene, ModelData& data)
 {
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
-
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+    auto skeleton = std::make_shared<Skeleton>();
+    addJoints(scene->mRootNode, -1, *skeleton);
+    skeleton->setGlobalInverse(glm::inverse(toMat4(scene->mRootNode->mTransformation)));
 
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
+    for (unsigned int m = 0; m < scene->mNumMeshes; m++)
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+        const aiMesh* mesh = scene->mMeshes[m];
+        for (unsigned int b = 0; b < mesh->mNumBones; b++)
+        {
+            const aiBone* bone = mesh->mBones[b];
+            const int joint = skeleton->find(bone->mName.C_Str());
+            if (joint >= 0)
+                skeleton->setInverseBind(joint, toMat4(bone->mOffsetMatrix));
+        }
+    }
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    for (unsigned int a = 0; a < scene->mNumAnimations; a++)
+        data.clips.push_back(importClip(scene->mAnimations[a], *skeleton));
+    data.skeleton = std::move(skeleton);
+}
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Model::processScene(const aiScene* scene, ModelData& data)
+{
+    std::vector<unsigned int> meshOrder;
+    processNode(scene->mRootNode, scene, meshOrder);
 
-        stbi_image_free(data);
+    for (unsigned int m = 0; m < scene->mNumMeshes && !data.skeleton; m++)
+    {
+        if (scene->mMeshes[m]->HasBones())
+            processSkeleton(scene, data);
     }
-    else
+
+    // Convert every referenced mesh once, in parallel; the geometry does not need the GL context.
+    std::vector<unsigned int> references(scene->mNumMeshes, 0);
+    std::vector<unsigned int> used;
+    for (unsigned int index : meshOrder)
     {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+        if (references[index]++ == 0)
+            used.push_back(index);
     }
 
-    return textureID;
-};
+    std::vector<MeshGeometry> geometry(scene->mNumMeshes);
+    ThreadPool::getInstance().parallelFor(used.size(), [&](std::size_t i) {
+        processMesh(scene->mMeshes[used[i]], data.skeleton.get(), geometry[used[i]]);
+    });
+
+    data.submeshes.reserve(meshOrder.size());
+    for (unsigned int index : meshOrder)
+    {
+        ModelData::Submesh submesh;
+
+        const aiMesh* mesh = scene->mMeshes[index];
+        if (mesh->mMaterialIndex < scene->mNumMaterials)
+        {
+            const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            collectMaterialTextures(material, aiTextureType_DIFFUSE, TextureType::DIFFUSE, submesh.textures);
+            collectMaterialTextures(material, aiTextureType_SPECULAR, TextureType::SPECULAR, submesh.textures);
+        }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType assimpTextureType,
-                                                 TextureType lambTextureType)
+        MeshGeometry& meshGeometry = geometry[index];
+        if (--references[index] == 0)
+        {
+            submesh.vertices = std::move(meshGeometry.vertices);
+            submesh.indices = std::move(meshGeometry.indices);
+        }
+        else
+        {
+            submesh.vertices = meshGeometry.vertices;
+            submesh.indices = meshGeometry.indices;
+        }
+        data.submeshes.push_back(std::move(submesh));
+    }
+}
+
+void Model::processMesh(const aiMesh* mesh, const Skeleton* skeleton, MeshGeometry& geometry)
 {
-    std::vector<Texture> textures;
-    for (unsigned int i = 0; i < mat->GetTextureCount(assimpTextureType); i++)
+    std::vector<Vertex>& vertices = geometry.vertices;
+    std::vector<unsigned int>& indices = geometry.indices;
+
+    // Zeroed so unused attributes are deterministic in the mesh cache.
+    vertices.assign(mesh->mNumVertices, Vertex{});
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
-        aiString str;
-        mat->GetTexture(assimpTextureType, i, &str);
-        bool skip = false;
-        for (unsigned int j = 0; j < m_texturesLoaded.size(); j++)
+        Vertex& vertex = vertices[i];
+        vertex.position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+
+        if (mesh->HasNormals())
+            vertex.normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+
+        if (mesh->mTextureCoords[0])
+            vertex.textureCoordinates = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+    }
+
+    if (skeleton && mesh->HasBones())
+    {
+        for (unsigned int b = 0; b < mesh->mNumBones; b++)
         {
-            if (std::strcmp(m_texturesLoaded[j].path.data(), str.C_Str()) == 0)
+            const aiBone* bone = mesh->mBones[b];
+            const int joint = skeleton->find(bone->mName.C_Str());
+            if (joint < 0)
+                continue;
+            for (unsigned int w = 0; w < bone->mNumWeights; w++)
             {
-                textures.push_back(m_texturesLoaded[j]);
-                skip = true;
-                break;
+                const aiVertexWeight& weight = bone->mWeights[w];
+                addBoneInfluence(vertices[weight.mVertexId], joint, weight.mWeight);
             }
         }
-        if (!skip)
+
+        for (Vertex& vertex : vertices)
         {
-            Texture texture;
-            texture.id = textureFromFile(str.C_Str(), m_directory);
-            texture.type = lambTextureType;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            m_texturesLoaded.push_back(texture); // add to loaded textures
+            float total = 0.0f;
+            for (float weight : vertex.m_Weights)
+                total += weight;
+            if (total <= 0.0f)
+                continue;
+            for (float& weight : vertex.m_Weights)
+                weight /= total;
         }
     }
-    return textures;
+
+    std::size_t indexCount = 0;
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+        indexCount += mesh->mFaces[i].mNumIndices;
+
+    indices.resize(indexCount);
+    std::size_t next = 0;
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        const aiFace& face = mesh->mFaces[i];
+        std::copy(face.mIndices, face.mIndices + face.mNumIndices, indices.begin() + next);
+        next += face.mNumIndices;
+    }
 };
+
+unsigned int textureFromFile(const char* path, const std::string& directory)
+{
+    std::string filename = std::string(path);
+    filename = directory + '/' + filename;
+
+    return TextureLoader::getInstance().load(filename);
+};
+
+Texture Model::loadMaterialTexture(const std::string& path, TextureType type)
+{
+    for (const Texture& loaded : m_texturesLoaded)
+    {
+        if (loaded.path == path)
+            return loaded;
+    }
+
+    Texture texture;
+    if (!TextureAtlas::getInstance().resolve(m_directory + '/' + path, texture))
+        texture.id = textureFromFile(path.c_str(), m_directory);
+    texture.type = type;
+    texture.path = path;
+    m_texturesLoaded.push_back(texture); // add to loaded textures
+    return texture;
+}
@@ -1,7 +1,11 @@
 #ifndef MODEL_H_
 #define MODEL_H_
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <assimp/Importer.hpp>
@@ -9,12 +13,17 @@
 #include <assimp/scene.h>
 #include <glm/glm.hpp>
 
+#include "animation_clip.hpp"
+#include "mesh_cache.hpp"
 #include "primitive.hpp"
 #include "renderable.hpp"
 #include "shader.hpp"
 #include "shader_engine.hpp"
+#include "skeleton.hpp"
 #include "texture.hpp"
 
+class Animator;
+
 /**
  * @class Mesh
  * @brief Represents a mesh that can be rendered.
@@ -35,6 +44,70 @@ public:
      * @param textures A vector of Texture objects representing the textures of the mesh.
      */
     Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, std::vector<Texture>& textures);
+
+    /**
+     * @brief Constructor for Mesh, taking over the geometry instead of copying it.
+     *
+     * @param vertices The vertices of the mesh, moved from.
+     * @param indices The indices of the mesh, moved from.
+     * @param textures A vector of Texture objects representing the textures of the mesh.
+     */
+    Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Texture>& textures);
+
+    /**
+     * @brief Constructor for Mesh, from geometry read from the mesh cache.
+     *
+     * The vertices and indices are uploaded as they are and not kept on the CPU.
+     *
+     * @param vertices The vertices, typically pointing into a mapped file.
+     * @param vertexCount The number of vertices.
+     * @param indices The indices.
+     * @param indexCount The number of indices.
+     * @param textures A vector of Texture objects representing the textures of the mesh.
+     * @param boundsCenter Center of the bounding sphere, in model space.
+     * @param boundsRadius Radius of the bounding sphere, in model space.
+     * @param uvDensity UV area per model space area.
+     */
+    Mesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+         std::vector<Texture>& textures, const glm::vec3& boundsCenter, float boundsRadius, float uvDensity);
+};
+
+/**
+ * @struct ModelData
+ * @brief A model imported on the CPU, waiting for the Model constructor to create its GL objects.
+ *
+ * Produced by Model::import(), which does not touch OpenGL and can run on any thread.
+ */
+struct ModelData
+{
+    /**
+     * @struct Submesh
+     * @brief One mesh to create, in draw order.
+     */
+    struct Submesh
+    {
+        std::vector<Vertex> vertices;                 /**< Converted vertices, empty when read from the cache. */
+        std::vector<unsigned int> indices;            /**< Converted indices, empty when read from the cache. */
+        const IO::MeshCacheSubmesh* cached = nullptr; /**< Mesh cache entry holding the geometry, if any. */
+
+        /**
+         * @brief Material textures as paths relative to the model directory, with their type.
+         */
+        std::vector<std::pair<std::string, TextureType>> textures;
+    };
+
+    std::string directory;                    /**< The directory containing the model files. */
+    std::uint64_t sourceHash = 0;             /**< Hash of the source file. */
+    std::string cachePath;                    /**< The mesh cache file, empty if the source could not be read. */
+    std::shared_ptr<IO::MeshCacheFile> cache; /**< The mapped mesh cache, if it was valid. */
+    std::vector<Submesh> submeshes;           /**< The meshes. */
+    std::shared_ptr<Skeleton> skeleton;       /**< The node hierarchy, if a mesh has bones. */
+    bool valid = false;                       /**< Whether the import succeeded. */
+
+    /**
+     * @brief The animations of the model, sampled against skeleton.
+     */
+    std::vector<std::shared_ptr<const AnimationClip>> clips;
 };
 
 /**
@@ -47,15 +120,37 @@ public:
 class Model
 {
 public:
+    /**
+     * @brief Import flags passed to Assimp, also recorded in mesh cache files.
+     */
+    static constexpr unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_LimitBoneWeights;
+
+    /**
+     * @brief Directory holding the binary mesh cache.
+     */
+    static constexpr const char* MESH_CACHE_DIRECTORY = "mesh_cache";
+
     /**
      * @brief Constructor for Model.
      *
-     * Loads a model from the specified file path.
+     * Loads a model from the specified file path. The first import goes through
+     * Assimp and writes a binary mesh cache keyed by the file content and import
+     * flags; later loads map that cache and upload it without parsing. Skinned
+     * models are not cached, since the cache holds no skeleton or animation.
      *
      * @param path The file path to the model file.
      */
     Model(std::string const path);
 
+    /**
+     * @brief Constructor for Model, from data imported by import().
+     *
+     * Creates the textures and GL buffers, so it must run on the context thread.
+     *
+     * @param data The imported model, moved from.
+     */
+    explicit Model(ModelData data);
+
     /**
      * @brief Constructor for Model.
      *
@@ -65,6 +160,23 @@ public:
      */
     Model(Primitive& primitive);
 
+    /**
+     * @brief Imports a model file without touching OpenGL.
+     *
+     * Maps the mesh cache when it matches the file, otherwise runs Assimp,
+     * converts the meshes on the ThreadPool and writes the mesh cache, so the
+     * file I/O stays on the importing thread.
+     *
+     * @param path The file path to the model file.
+     * @return The imported data; valid is false if the file could not be imported.
+     */
+    static ModelData import(const std::string& path);
+
+    /**
+     * @brief Releases the GL buffers of every mesh.
+     */
+    void destroy();
+
     /**
      * @brief Draws the model.
      *
@@ -72,12 +184,38 @@ public:
      */
     void draw();
 
+    /**
+     * @brief Draws the model and reports its texture usage to the TextureStreamer.
+     *
+     * @param model The model matrix set on the shader.
+     */
+    void draw(const glm::mat4& model);
+
+    /**
+     * @brief Draws the model in the pose of an animator.
+     *
+     * Skinned meshes are drawn with the animator palette on the GPU, or refilled
+     * with the vertices it skinned on the CPU, following the AnimationSystem mode.
+     *
+     * @param animator An animator of this model.
+     * @param model The model matrix set on the shader.
+     */
+    void draw(const Animator& animator, const glm::mat4& model);
+
     /**
      * @brief Sets the shader engine for the model.
      *
      * @param engine The shader engine to use for rendering.
      */
-    void setShaderEngine(ShaderEngine engine);
+    void setShaderEngine(const ShaderEngine& engine);
+
+    /**
+     * @brief Draws every mesh of the model with a permutation of a shader variant set.
+     *
+     * @param variants The variant set, which must outlive the model.
+     * @param features The features enabled for the model.
+     */
+    void setShaderVariants(ShaderVariants& variants, std::uint32_t features);
 
     /**
      * @brief Gets the meshes of the model.
@@ -86,45 +224,118 @@ public:
      */
     std::vector<Renderable> getMeshes() { return m_meshes; }
 
+    /**
+     * @brief Gets the number of meshes.
+     *
+     * @return The mesh count.
+     */
+    std::size_t getMeshCount() const { return m_meshes.size(); }
+
+    /**
+     * @brief Gets a mesh without copying it.
+     *
+     * @param index The mesh index, below getMeshCount().
+     * @return The mesh.
+     */
+    const Renderable& getMesh(std::size_t index) const { return m_meshes[index]; }
+    Renderable& getMesh(std::size_t index) { return m_meshes[index]; }
+
+    /**
+     * @brief Gets the skeleton of the model.
+     *
+     * @return The skeleton, nullptr if no mesh has bones.
+     */
+    std::shared_ptr<const Skeleton> getSkeleton() const { return m_skeleton; }
+
+    /**
+     * @brief Gets the animations of the model.
+     *
+     * @return The clips, in file order.
+     */
+    const std::vector<std::shared_ptr<const AnimationClip>>& getClips() const { return m_clips; }
+
+    /**
+     * @brief Finds an animation by name.
+     *
+     * @param name The clip name.
+     * @return The clip, nullptr if there is none.
+     */
+    std::shared_ptr<const AnimationClip> findClip(const std::string& name) const;
+
 private:
-    std::vector<Renderable> m_meshes;      /**< The meshes of the model. */
-    std::string m_directory;               /**< The directory containing the model files. */
-    std::vector<Texture> m_texturesLoaded; /**< The textures loaded for the model. */
+    std::vector<Renderable> m_meshes;                          /**< The meshes of the model. */
+    std::string m_directory;                                   /**< The directory containing the model files. */
+    std::vector<Texture> m_texturesLoaded;                     /**< The textures loaded for the model. */
+    std::shared_ptr<const Skeleton> m_skeleton;                /**< The skeleton, if the model is skinned. */
+    std::vector<std::shared_ptr<const AnimationClip>> m_clips; /**< The animations. */
 
     /**
-     * @brief Loads a model from the specified file path.
+     * @brief Fills the submeshes from the mesh cache.
      *
-     * @param path The file path to the model file.
+     * @param data The model being imported, with its cache path and source hash set.
+     * @return true if the cache was valid.
      */
-    void loadModel(std::string path);
+    static bool readCache(ModelData& data);
 
     /**
-     * @brief Processes a node in the model's scene.
+     * @brief Writes the meshes imported by Assimp to the mesh cache. Does not touch OpenGL.
+     *
+     * @param model The imported model, with its cache path and source hash set.
+     */
+    static void writeCache(const ModelData& model);
+
+    /**
+     * @struct MeshGeometry
+     * @brief Geometry of one Assimp mesh, converted off the GL context thread.
+     */
+    struct MeshGeometry
+    {
+        std::vector<Vertex> vertices;      /**< The vertices. */
+        std::vector<unsigned int> indices; /**< The indices. */
+    };
+
+    /**
+     * @brief Collects the meshes referenced by a node and its children, in draw order.
      *
      * @param node The node to process.
      * @param scene The scene containing the node.
+     * @param meshOrder Receives the scene mesh indices.
+     */
+    static void processNode(aiNode* node, const aiScene* scene, std::vector<unsigned int>& meshOrder);
+
+    /**
+     * @brief Converts the meshes of a scene on the ThreadPool and lists their material textures.
+     *
+     * @param scene The imported scene.
+     * @param data Receives one submesh per mesh reference.
+     */
+    static void processScene(const aiScene* scene, ModelData& data);
+
+    /**
+     * @brief Builds the skeleton of a scene with bones, one joint per node, and imports its animations.
+     *
+     * @param scene The imported scene.
+     * @param data Receives the skeleton and the clips.
      */
-    void processNode(aiNode* node, const aiScene* scene);
+    static void processSkeleton(const aiScene* scene, ModelData& data);
 
     /**
-     * @brief Processes a mesh in the model's scene.
+     * @brief Converts the geometry of a mesh. Thread safe, it does not touch OpenGL.
      *
      * @param mesh The mesh to process.
-     * @param scene The scene containing the mesh.
-     * @return A Mesh object representing the processed mesh.
+     * @param skeleton The skeleton bone IDs refer to, nullptr if the model has none.
+     * @param geometry Receives the vertices and indices, sized once up front.
      */
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+    static void processMesh(const aiMesh* mesh, const Skeleton* skeleton, MeshGeometry& geometry);
 
     /**
-     * @brief Loads material textures for a mesh.
+     * @brief Loads a material texture once per model.
      *
-     * @param mat The material to load textures for.
-     * @param assimpTextureType The type of texture to load using Assimp.
-     * @param lambTextureType The type of texture to load using the custom engine.
-     * @return A vector of Texture objects representing the loaded textures.
+     * @param path The texture path, relative to the model directory.
+     * @param type The type of the texture.
+     * @return The texture, shared with earlier meshes using the same path.
      */
-    std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType assimpTextureType,
-                                              TextureType lambTextureType);
+    Texture loadMaterialTexture(const std::string& path, TextureType type);
 };
 
 #endif
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include <glad/glad.h>
@@ -5,10 +7,72 @@
 #include <shader.hpp>
 #include <texture.hpp>
 
+#include "render_stats.hpp"
 #include "shader_engine.hpp"
-#include "stb_image.h"
+#include "shader_variants.hpp"
+#include "texture_atlas.hpp"
+#include "texture_binder.hpp"
+#include "texture_loader.hpp"
+#include "texture_streamer.hpp"
+
+void Renderable::computeStreamingBounds(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                        glm::vec3& center, float& radius, float& uvDensity)
+{
+    center = glm::vec3(0.0f);
+    radius = 0.0f;
+    uvDensity = 0.0f;
+    if (vertices.empty())
+        return;
+
+    glm::vec3 minimum = vertices[0].position, maximum = vertices[0].position;
+    for (const Vertex& vertex : vertices)
+    {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+    center = (minimum + maximum) * 0.5f;
+    for (const Vertex& vertex : vertices)
+        radius = std::max(radius, glm::length(vertex.position - center));
+
+    float surfaceArea = 0.0f, uvArea = 0.0f;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const Vertex& a = vertices[indices[i]];
+        const Vertex& b = vertices[indices[i + 1]];
+        const Vertex& c = vertices[indices[i + 2]];
+
+        surfaceArea += 0.5f * glm::length(glm::cross(b.position - a.position, c.position - a.position));
+
+        glm::vec2 ab = b.textureCoordinates - a.textureCoordinates;
+        glm::vec2 ac = c.textureCoordinates - a.textureCoordinates;
+        uvArea += 0.5f * std::abs(ab.x * ac.y - ab.y * ac.x);
+    }
+
+    if (surfaceArea > 0.0f)
+        uvDensity = uvArea / surfaceArea;
+}
 
 void Renderable::setup()
+{
+    computeStreamingBounds(m_vertices, m_indices, m_boundsCenter, m_boundsRadius, m_uvDensity);
+    m_skinned = std::any_of(m_vertices.begin(), m_vertices.end(), [](const Vertex& vertex) {
+        return std::any_of(std::begin(vertex.m_Weights), std::end(vertex.m_Weights),
+                           [](float weight) { return weight > 0.0f; });
+    });
+    upload(m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size());
+}
+
+void Renderable::setup(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices,
+                       std::size_t indexCount, const glm::vec3& boundsCenter, float boundsRadius, float uvDensity)
+{
+    m_boundsCenter = boundsCenter;
+    m_boundsRadius = boundsRadius;
+    m_uvDensity = uvDensity;
+    upload(vertices, vertexCount, indices, indexCount);
+}
+
+void Renderable::upload(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices,
+                        std::size_t indexCount)
 {
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
@@ -23,10 +87,14 @@ void Renderable::setup()
     glBindVertexArray(m_VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), &m_vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &m_indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+    m_indexCount = static_cast<GLsizei>(indexCount);
+    m_vertexBytes = vertexCount * sizeof(Vertex);
+    m_indexBytes = indexCount * sizeof(unsigned int);
+    RenderStats::getInstance().addBufferMemory(static_cast<std::int64_t>(m_vertexBytes + m_indexBytes));
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
@@ -37,12 +105,36 @@ void Renderable::setup()
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, textureCoordinates));
 
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, MAX_BONE_INFLUENCE, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
+
+    glEnableVertexAttribArray(6);
+    glVertexAttribPointer(6, MAX_BONE_INFLUENCE, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, m_Weights));
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+
+    for (Texture& texture : m_textures)
+        texture.uvDensity = m_uvDensity;
+}
+
+void Renderable::updateVertices(const Vertex* vertices, std::size_t count)
+{
+    // Respecified rather than overwritten, so the driver does not wait for the previous draw.
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), vertices, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats::getInstance().addBufferMemory(static_cast<std::int64_t>(count * sizeof(Vertex)) -
+                                               static_cast<std::int64_t>(m_vertexBytes));
+    m_vertexBytes = count * sizeof(Vertex);
 }
 
 void Renderable::destroy()
 {
+    RenderStats::getInstance().addBufferMemory(-static_cast<std::int64_t>(m_vertexBytes + m_indexBytes));
+    m_vertexBytes = 0;
+    m_indexBytes = 0;
     if (m_VBO != 0)
     {
         glDeleteBuffers(1, &m_VBO);
@@ -60,7 +152,24 @@ void Renderable::destroy()
     }
 }
 
+void Renderable::draw(const glm::mat4& model)
+{
+    for (const Texture& texture : m_textures)
+        TextureStreamer::getInstance().reportUsage(texture, model, m_boundsCenter, m_boundsRadius);
+
+    drawGeometry();
+}
+
 void Renderable::draw()
+{
+    // Without a transform the on-screen size is unknown, ask for full resolution.
+    for (const Texture& texture : m_textures)
+        TextureStreamer::getInstance().requestLevel(texture.id, 0);
+
+    drawGeometry();
+}
+
+void Renderable::drawGeometry()
 {
     if (!glIsVertexArray(m_VAO))
         std::cerr << "No VAO bound." << std::endl;
@@ -75,14 +184,15 @@ void Renderable::draw()
         // m_engine.addShader(Renderable::basicFragmentShader);
     }
 
-    m_engine.use();
-    glBindVertexArray(m_VAO);
+    ShaderEngine& engine = m_variants ? m_variants->get(variantFeatures()) : m_engine;
+    engine.use();
+    if (m_boneOffset >= 0)
+        engine.setInt("boneOffset", m_boneOffset);
     if (!m_textures.empty())
     {
         unsigned int diffuseNumber = 1, specularNumber = 1;
         for (int i = 0; i < m_textures.size(); i++)
         {
-            glActiveTexture(GL_TEXTURE0 + i);
             std::string number;
             TextureType type = m_textures[i].type;
             switch (type)
@@ -97,64 +207,57 @@ void Renderable::draw()
 
             std::string typeStr = toString(type);
             std::string textureUniformName = "material." + typeStr + number;
-            m_engine.setInt(textureUniformName.c_str(),
+            engine.setInt(textureUniformName.c_str(),
                             i); // c_str() need to be called directly, otherwise pointer will be lose.
-            glBindTexture(GL_TEXTURE_2D, m_textures[i].id);
+
+            // Packed textures share their array, only the layer and UV rectangle change per draw.
+            if (m_textures[i].target == GL_TEXTURE_2D_ARRAY)
+            {
+                engine.setInt(textureUniformName + "_layer", m_textures[i].layer);
+                engine.setVec4(textureUniformName + "_uv", m_textures[i].uvTransform);
+            }
+
+            TextureBinder::getInstance().bind(i, m_textures[i].target, m_textures[i].id);
         }
     }
-    glActiveTexture(GL_TEXTURE0);
+    TextureBinder::getInstance().activate(0);
 
     glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    RenderStats& stats = RenderStats::getInstance();
+    stats.countStateChange();
+    stats.countDraw(static_cast<std::size_t>(m_indexCount));
 }
 
-void Renderable::setTexture(const char* path, TextureType type)
+std::uint32_t Renderable::variantFeatures() const
 {
-    std::string filename(path);
+    std::uint32_t features = m_features;
+    for (const Texture& texture : m_textures)
+    {
+        if (texture.target == GL_TEXTURE_2D_ARRAY)
+            features |= m_variants->featureBit("TEXTURE_ARRAY");
+    }
+    if (m_boneOffset >= 0)
+        features |= m_variants->featureBit("SKINNING");
+    return features;
+}
 
+void Renderable::setTexture(const char* path, TextureType type)
+{
     Texture texture;
     texture.type = type;
     texture.path = std::string(path);
-    glGenTextures(1, &texture.id);
+    if (!TextureAtlas::getInstance().resolve(texture.path, texture))
+        texture.id = TextureLoader::getInstance().load(texture.path);
+    texture.uvDensity = m_uvDensity;
     if (texture.id == 0)
     {
         std::cerr << "Error: Failed to generate texture ID!" << std::endl;
         return;
     }
 
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, texture.id);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        stbi_image_free(data);
-
-        m_textures.push_back(texture);
-    }
-    else
-    {
-        std::cerr << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
+    m_textures.push_back(texture);
 }
 
 std::ostream& operator<<(std::ostream& os, const Renderable& renderable)
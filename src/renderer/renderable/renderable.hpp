@@ -1,6 +1,7 @@
 #ifndef RENDERABLE_H_
 #define RENDERABLE_H_
 
+#include <cstdint>
 #include <vector>
 
 #include <glad/glad.h>
@@ -9,6 +10,8 @@
 #include "shader_engine.hpp"
 #include "texture.hpp"
 
+class ShaderVariants;
+
 #define MAX_BONE_INFLUENCE 4
 
 /**
@@ -44,7 +47,11 @@ public:
      *
      * Initializes a Renderable object with default values for VAO, VBO, and EBO.
      */
-    Renderable() : m_VAO(0), m_VBO(0), m_EBO(0) {}
+    Renderable()
+        : m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(0), m_variants(nullptr), m_features(0), m_boundsCenter(0.0f),
+          m_boundsRadius(0.0f), m_uvDensity(0.0f), m_skinned(false), m_boneOffset(-1), m_vertexBytes(0), m_indexBytes(0)
+    {
+    }
 
     /**
      * @brief Destroys the Renderable object and cleans up OpenGL resources.
@@ -61,6 +68,14 @@ public:
      */
     void draw();
 
+    /**
+     * @brief Draws the Renderable object and reports its texture usage to the TextureStreamer.
+     *
+     * @param model The model matrix the caller set on the shader, used to estimate the
+     * on-screen texel density of each texture.
+     */
+    void draw(const glm::mat4& model);
+
     /**
      * @brief Sets up the Renderable object for rendering.
      *
@@ -68,6 +83,67 @@ public:
      */
     void setup();
 
+    /**
+     * @brief Sets up the Renderable object from geometry it does not keep a copy of.
+     *
+     * Used for meshes read from the mesh cache: the buffers are filled straight
+     * from the mapped file, and the bounds computed at import time are reused.
+     *
+     * @param vertices The vertices.
+     * @param vertexCount The number of vertices.
+     * @param indices The indices.
+     * @param indexCount The number of indices.
+     * @param boundsCenter Center of the bounding sphere, in model space.
+     * @param boundsRadius Radius of the bounding sphere, in model space.
+     * @param uvDensity UV area per model space area.
+     */
+    void setup(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+               const glm::vec3& boundsCenter, float boundsRadius, float uvDensity);
+
+    /**
+     * @brief Computes what setup() derives from the geometry, without touching OpenGL.
+     *
+     * The bounding sphere of the vertices, and the ratio between the area the
+     * triangles cover in UV space and in model space, which tells how many
+     * texels of a texture land on one unit of surface.
+     *
+     * @param vertices The vertices.
+     * @param indices The triangle indices.
+     * @param center Receives the center of the bounding sphere, in model space.
+     * @param radius Receives the radius of the bounding sphere.
+     * @param uvDensity Receives the UV area per model space area, 0 without triangles.
+     */
+    static void computeStreamingBounds(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                       glm::vec3& center, float& radius, float& uvDensity);
+
+    /**
+     * @brief Gets the bounding sphere center computed by setup().
+     *
+     * @return The center, in model space.
+     */
+    const glm::vec3& getBoundsCenter() const { return m_boundsCenter; }
+
+    /**
+     * @brief Gets the bounding sphere radius computed by setup().
+     *
+     * @return The radius, in model space.
+     */
+    float getBoundsRadius() const { return m_boundsRadius; }
+
+    /**
+     * @brief Gets the UV density computed by setup().
+     *
+     * @return The UV area per model space area.
+     */
+    float getUvDensity() const { return m_uvDensity; }
+
+    /**
+     * @brief Gets the textures of the Renderable object.
+     *
+     * @return The textures.
+     */
+    const std::vector<Texture>& getTextures() const { return m_textures; }
+
     /**
      * @brief Gets the vertices of the Renderable object.
      *
@@ -75,6 +151,38 @@ public:
      */
     std::vector<Vertex> getVertices() { return m_vertices; }
 
+    /**
+     * @brief Gets the vertices kept on the CPU without copying them.
+     *
+     * @return The vertices, empty for meshes read from the mesh cache.
+     */
+    const std::vector<Vertex>& getVertexData() const { return m_vertices; }
+
+    /**
+     * @brief Tells whether any vertex has bone weights.
+     *
+     * @return true for meshes deformed by a skeleton.
+     */
+    bool isSkinned() const { return m_skinned; }
+
+    /**
+     * @brief Replaces the content of the vertex buffer, for vertices skinned on the CPU.
+     *
+     * @param vertices The vertices, as many as the buffer was created with.
+     * @param count The number of vertices.
+     */
+    void updateVertices(const Vertex* vertices, std::size_t count);
+
+    /**
+     * @brief Sets the palette the next draws are skinned with on the GPU.
+     *
+     * The shader reads the matrices from the AnimationSystem bone palette buffer,
+     * starting at the offset, and ShaderVariants get the SKINNING feature.
+     *
+     * @param offset Index of the first matrix of the palette, -1 to draw without GPU skinning.
+     */
+    void setBoneOffset(int offset) { m_boneOffset = offset; }
+
     /**
      * @brief Gets the indices of the Renderable object.
      *
@@ -95,7 +203,22 @@ public:
      *
      * @param engine The shader engine to use for rendering.
      */
-    void setShaderEngine(ShaderEngine engine) { m_engine = engine; }
+    void setShaderEngine(const ShaderEngine& engine) { m_engine = engine; }
+
+    /**
+     * @brief Draws the Renderable object with a permutation of a shader variant set.
+     *
+     * The permutation is picked at every draw from the given features, plus the
+     * TEXTURE_ARRAY feature when the textures are packed arrays and the set has it.
+     *
+     * @param variants The variant set, which must outlive the Renderable.
+     * @param features The features enabled for this object.
+     */
+    void setShaderVariants(ShaderVariants& variants, std::uint32_t features)
+    {
+        m_variants = &variants;
+        m_features = features;
+    }
 
     /**
      * @brief Output stream operator for printing Renderable objects.
@@ -107,13 +230,40 @@ public:
     friend std::ostream& operator<<(std::ostream& os, const Renderable& renderable);
 
 protected:
+    /**
+     * @brief Binds the textures and issues the draw call.
+     */
+    void drawGeometry();
+
+    /**
+     * @brief Creates the VAO and fills the vertex and index buffers.
+     */
+    void upload(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount);
+
+    /**
+     * @brief Gets the features of the permutation of m_variants to draw with.
+     *
+     * @return m_features, plus TEXTURE_ARRAY when a texture is an array.
+     */
+    std::uint32_t variantFeatures() const;
+
     GLuint m_VAO;                        /**< The Vertex Array Object (VAO) for the Renderable object. */
     GLuint m_VBO;                        /**< The Vertex Buffer Object (VBO) for the Renderable object. */
     GLuint m_EBO;                        /**< The Element Buffer Object (EBO) for the Renderable object. */
+    GLsizei m_indexCount;                /**< The number of indices in the EBO. */
     ShaderEngine m_engine;               /**< The shader engine used for rendering. */
+    ShaderVariants* m_variants;          /**< The variant set overriding m_engine, if any. */
+    std::uint32_t m_features;            /**< The features requested from m_variants. */
     std::vector<Vertex> m_vertices;      /**< The vertices of the Renderable object. */
     std::vector<unsigned int> m_indices; /**< The indices of the Renderable object. */
     std::vector<Texture> m_textures;     /**< The textures of the Renderable object. */
+    glm::vec3 m_boundsCenter;            /**< Center of the bounding sphere, in model space. */
+    float m_boundsRadius;                /**< Radius of the bounding sphere, in model space. */
+    float m_uvDensity;                   /**< UV area per model space area, computed in setup(). */
+    bool m_skinned;                      /**< Whether a vertex has bone weights, computed in setup(). */
+    int m_boneOffset;                    /**< First bone palette matrix for GPU skinning, -1 if none. */
+    std::size_t m_vertexBytes;           /**< The size of the VBO storage, for RenderStats. */
+    std::size_t m_indexBytes;            /**< The size of the EBO storage, for RenderStats. */
 };
 
 #endif
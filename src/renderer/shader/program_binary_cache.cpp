@@ -0,0 +1,203 @@
+#include "program_binary_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "log.hpp"
+
+namespace
+{
+
+constexpr char CACHE_MAGIC[4] = {'L', 'P', 'B', 'C'};
+constexpr std::uint32_t CACHE_VERSION = 1;
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * Header written in front of every binary blob.
+ */
+struct CacheHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t binaryFormat;
+    std::uint32_t length;
+    double buildMilliseconds;
+};
+
+void hashBytes(std::uint64_t& hash, const char* bytes, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= FNV_PRIME;
+    }
+}
+
+std::string glString(GLenum name)
+{
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+} // namespace
+
+bool ProgramBinaryCache::isAvailable()
+{
+    if (!m_enabled)
+        return false;
+
+    if (m_formatCount < 0)
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_formatCount = formats;
+        if (formats == 0)
+            Logger::Log(LogLevel::Info, "Driver exposes no program binary format, shader cache disabled", "Renderer");
+    }
+    return m_formatCount > 0;
+}
+
+std::uint64_t ProgramBinaryCache::makeKey(const std::vector<std::string>& sources)
+{
+    if (m_driver.empty())
+        m_driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+    std::uint64_t hash = FNV_OFFSET;
+    hashBytes(hash, m_driver.data(), m_driver.size());
+    for (const std::string& source : sources)
+    {
+        // Separator so that moving text between stages changes the key.
+        hashBytes(hash, "\0", 1);
+        hashBytes(hash, source.data(), source.size());
+    }
+    return hash;
+}
+
+std::string ProgramBinaryCache::pathFor(std::uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+bool ProgramBinaryCache::load(std::uint64_t key, GLuint program)
+{
+    if (!isAvailable())
+        return false;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::string path = pathFor(key);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        m_misses++;
+        return false;
+    }
+
+    CacheHeader header{};
+    std::vector<char> binary;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        std::equal(header.magic, header.magic + 4, CACHE_MAGIC) && header.version == CACHE_VERSION)
+    {
+        binary.resize(header.length);
+        if (!file.read(binary.data(), header.length))
+            binary.clear();
+    }
+    file.close();
+
+    GLint linked = GL_FALSE;
+    if (!binary.empty())
+    {
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
+
+    if (linked != GL_TRUE)
+    {
+        // Stale or foreign binary: drop it, the caller compiles from source and stores a fresh one.
+        Logger::Log(LogLevel::Warning, "Rejected cached program binary " + path + ", recompiling", "Renderer");
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        m_misses++;
+        return false;
+    }
+
+    const double loadMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_hits++;
+    m_savedMilliseconds += header.buildMilliseconds - loadMilliseconds;
+    return true;
+}
+
+void ProgramBinaryCache::store(std::uint64_t key, GLuint program, double buildMilliseconds)
+{
+    if (!isAvailable())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    CacheHeader header{};
+    std::copy(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic);
+    header.version = CACHE_VERSION;
+    header.buildMilliseconds = buildMilliseconds;
+
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    header.binaryFormat = format;
+    header.length = static_cast<std::uint32_t>(written);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    // Written next to the target then renamed, so a crash or a full disk never leaves a truncated binary behind.
+    const std::string path = pathFor(key);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (file)
+        {
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+        }
+        if (!file)
+        {
+            Logger::Log(LogLevel::Warning, "Cannot write program binary cache file " + temporary, "Renderer");
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        Logger::Log(LogLevel::Warning, "Cannot replace program binary cache file " + path + ": " + error.message(),
+                    "Renderer");
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+void ProgramBinaryCache::logStats() const
+{
+    if (m_hits == 0 && m_misses == 0)
+        return;
+
+    Logger::Log(LogLevel::Info,
+                "Shader cache: " + std::to_string(m_hits) + " programs loaded from binaries, " +
+                    std::to_string(m_misses) + " compiled, " + std::to_string(m_savedMilliseconds) +
+                    " ms of startup saved",
+                "Renderer");
+}
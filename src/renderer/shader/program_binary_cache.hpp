@@ -0,0 +1,109 @@
+#ifndef PROGRAM_BINARY_CACHE_HPP_
+#define PROGRAM_BINARY_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * @class ProgramBinaryCache
+ * @brief Disk cache of linked program binaries, to skip GLSL compilation on later launches.
+ *
+ * Entries are keyed by a hash of every stage source (defines included, they are
+ * part of the source text) and of the GL vendor, renderer and version strings,
+ * so a driver update simply misses. A binary the driver refuses anyway (format
+ * mismatch) is deleted and the program is compiled from source as usual.
+ *
+ * Each entry remembers how long compiling and linking took, which lets the
+ * cache report the startup time it saved.
+ */
+class ProgramBinaryCache
+{
+public:
+    /**
+     * @brief Gets the singleton instance of ProgramBinaryCache.
+     *
+     * @return The ProgramBinaryCache instance.
+     */
+    static ProgramBinaryCache& getInstance()
+    {
+        static ProgramBinaryCache instance;
+        return instance;
+    }
+
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+    /**
+     * @brief Sets the directory holding the cache files.
+     *
+     * @param directory The cache directory, created on first store.
+     */
+    void setDirectory(const std::string& directory) { m_directory = directory; }
+
+    /**
+     * @brief Enables or disables the cache.
+     *
+     * @param enabled false to always compile from source.
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    /**
+     * @brief Tells whether the cache can be used with the current context.
+     *
+     * @return true if enabled and the driver exposes at least one binary format.
+     */
+    bool isAvailable();
+
+    /**
+     * @brief Computes the cache key of a program.
+     *
+     * @param sources The source of every stage, in attach order.
+     * @return The 64-bit FNV-1a hash of the sources and the driver strings.
+     */
+    std::uint64_t makeKey(const std::vector<std::string>& sources);
+
+    /**
+     * @brief Loads a cached binary into a program.
+     *
+     * @param key The program key.
+     * @param program A program object without any attached shader.
+     * @return true if the program is linked from the cached binary.
+     */
+    bool load(std::uint64_t key, GLuint program);
+
+    /**
+     * @brief Stores the binary of a linked program.
+     *
+     * The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+     *
+     * @param key The program key.
+     * @param program The linked program.
+     * @param buildMilliseconds How long compiling and linking took.
+     */
+    void store(std::uint64_t key, GLuint program, double buildMilliseconds);
+
+    /**
+     * @brief Logs hits, misses and the startup time saved since launch.
+     */
+    void logStats() const;
+
+private:
+    ProgramBinaryCache() = default;
+    ~ProgramBinaryCache() = default;
+
+    std::string pathFor(std::uint64_t key) const;
+
+    std::string m_directory = "shader_cache"; /**< Directory holding the cache files. */
+    bool m_enabled = true;                    /**< Whether the cache is used at all. */
+    int m_formatCount = -1;                   /**< GL_NUM_PROGRAM_BINARY_FORMATS, -1 until queried. */
+    std::string m_driver;                     /**< Vendor, renderer and version strings, hashed into keys. */
+    std::size_t m_hits = 0;                   /**< Programs loaded from the cache. */
+    std::size_t m_misses = 0;                 /**< Programs compiled from source. */
+    double m_savedMilliseconds = 0.0;         /**< Build time avoided by hits, minus their load time. */
+};
+
+#endif
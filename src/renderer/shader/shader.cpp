@@ -1,28 +1,16 @@
 #include "shader.hpp"
 
-#include <fstream>
-#include <iostream>
-#include <sstream>
 #include <string>
 
 #include <glad/glad.h>
 
-Shader ShaderFactory::createShader(const std::string& filePath, unsigned int shaderType)
+Shader ShaderFactory::createShader(const std::string& filePath, unsigned int shaderType, const ShaderDefines& defines)
 {
     Shader shader;
     shader.id = glCreateShader(shaderType);
 
-    // Read the shader file
-    std::ifstream fileStream(filePath);
-    if (!fileStream.is_open())
-    {
-        std::cerr << "Failed to open shader file: " << filePath << std::endl;
-        return shader;
-    }
-
-    std::stringstream shaderStream;
-    shaderStream << fileStream.rdbuf();
-    shader.source = shaderStream.str();
+    // Read the shader file, its includes and the permutation defines
+    shader.source = ShaderPreprocessor::getInstance().process(filePath, defines);
 
     return shader;
 }
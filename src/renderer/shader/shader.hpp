@@ -8,6 +8,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "shader_preprocessor.hpp"
+
 /**
  * @struct Shader
  * @brief Represents a shader with its source code and ID.
@@ -35,16 +37,19 @@ public:
      * @brief Creates a shader from a file.
      *
      * This method loads the shader source code from the specified file path,
-     * compiles it, and returns a Shader object containing the source code
-     * and the shader ID.
+     * expands its includes and injects the given defines through the
+     * ShaderPreprocessor, and returns a Shader object containing the source code
+     * and the shader ID. Compilation happens in ShaderEngine::compile().
      *
      * @param filePath The file path to the shader source code.
      * @param shaderType The type of shader to create (e.g., vertex, fragment).
+     * @param defines The defines of the permutation to build.
      * @return A Shader object containing the source code and ID of the created shader.
      *
      * @throw std::runtime_error If the shader cannot be created or compiled.
      */
-    static Shader createShader(const std::string& filePath, unsigned int shaderType);
+    static Shader createShader(const std::string& filePath, unsigned int shaderType,
+                               const ShaderDefines& defines = {});
 };
 
 #endif
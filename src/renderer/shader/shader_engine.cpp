@@ -1,56 +1,216 @@
+#include <chrono>
 #include <iostream>
 
+#include <program_binary_cache.hpp>
 #include <shader_engine.hpp>
 
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+/**
+ * Link submitted by submitLink() whose status was not read yet.
+ */
+struct ShaderEngine::PendingLink
+{
+    std::vector<GLuint> shaders;   /**< Shaders attached to the program, deleted once it is checked. */
+    std::uint64_t cacheKey = 0;    /**< ProgramBinaryCache key. */
+    bool fromSource = false;       /**< Whether the program is compiled from source, not loaded from the cache. */
+    bool linkSubmitted = false;    /**< Whether submitLink() was called. */
+    double submitMilliseconds = 0; /**< Time spent submitting the compilation and link. */
+};
+
+bool ShaderBatch::enableParallelCompile()
+{
+#ifdef GL_KHR_parallel_shader_compile
+    static const bool available = [] {
+        if (!GLAD_GL_KHR_parallel_shader_compile)
+            return false;
+        // Let the driver pick its thread count.
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        return true;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+void ShaderBatch::submit()
+{
+    ShaderBatch::enableParallelCompile();
+
+    for (ShaderEngine* engine : m_engines)
+        engine->submitCompile();
+    for (ShaderEngine* engine : m_engines)
+        engine->submitLink();
+
+    m_engines.clear();
+}
+
 void ShaderEngine::addShader(Shader& shader)
 {
-    const char* sourceCstr = shader.source.c_str();
-    glShaderSource(shader.id, 1, &sourceCstr, NULL);
-    glCompileShader(shader.id);
+    // Compilation is deferred to compile(), which skips it when the program binary is cached.
+    m_shaders.push_back(shader);
+}
 
-    int success;
-    char infoLog[512];
-    glGetShaderiv(shader.id, GL_COMPILE_STATUS, &success);
-    if (!success)
+void ShaderEngine::compile()
+{
+    submitCompile();
+    submitLink();
+}
+
+void ShaderEngine::submitCompile()
+{
+    const auto start = Clock::now();
+    ProgramBinaryCache& cache = ProgramBinaryCache::getInstance();
+    m_shaderProgramID = glCreateProgram();
+    m_pending = std::make_shared<PendingLink>();
+
+    std::vector<std::string> sources;
+    for (const Shader& shader : m_shaders)
     {
-        glGetShaderInfoLog(shader.id, 512, NULL, infoLog);
-        std::cerr << "Failed to compile vertex shader: " << infoLog << std::endl;
+        GLint type = 0;
+        glGetShaderiv(shader.id, GL_SHADER_TYPE, &type);
+        sources.push_back(std::to_string(type) + "\n" + shader.source);
+    }
+
+    const bool cacheAvailable = cache.isAvailable();
+    m_pending->cacheKey = cacheAvailable ? cache.makeKey(sources) : 0;
+
+    if (cacheAvailable && cache.load(m_pending->cacheKey, m_shaderProgramID))
+    {
+        for (const Shader& shader : m_shaders)
+            glDeleteShader(shader.id);
     }
     else
     {
-        m_shaders.push_back(shader);
+        m_pending->fromSource = true;
+        for (const Shader& shader : m_shaders)
+        {
+            const char* sourceCstr = shader.source.c_str();
+            glShaderSource(shader.id, 1, &sourceCstr, NULL);
+            glCompileShader(shader.id);
+            glAttachShader(m_shaderProgramID, shader.id);
+            m_pending->shaders.push_back(shader.id);
+        }
+        if (cacheAvailable)
+            glProgramParameteri(m_shaderProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     }
+
+    m_shaders.clear();
+    m_pending->submitMilliseconds = elapsedMilliseconds(start);
 }
 
-void ShaderEngine::compile()
+void ShaderEngine::submitLink()
 {
-    m_shaderProgramID = glCreateProgram();
+    if (!m_pending || !m_pending->fromSource || m_pending->linkSubmitted)
+        return;
+
+    const auto start = Clock::now();
+    glLinkProgram(m_shaderProgramID);
+    m_pending->linkSubmitted = true;
+    m_pending->submitMilliseconds += elapsedMilliseconds(start);
+}
 
-    for (Shader shader : m_shaders)
+bool ShaderEngine::isReady() const
+{
+    if (!m_pending || !m_pending->fromSource)
+        return true;
+
+#ifdef GL_KHR_parallel_shader_compile
+    if (ShaderBatch::enableParallelCompile())
     {
-        glAttachShader(m_shaderProgramID, shader.id);
+        GLint completed = GL_FALSE;
+        glGetProgramiv(m_shaderProgramID, GL_COMPLETION_STATUS_KHR, &completed);
+        return completed == GL_TRUE;
     }
+#endif
+    return true;
+}
 
-    glLinkProgram(m_shaderProgramID);
+bool ShaderEngine::checkLinked()
+{
+    if (m_pending)
+        resolve();
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
 
+void ShaderEngine::resolve()
+{
+    // Copies of this engine share the pending state, the first use checks it for all of them.
+    std::shared_ptr<PendingLink> pending = std::move(m_pending);
+    if (!pending->fromSource || pending->shaders.empty())
+        return;
+
+    if (!pending->linkSubmitted)
+        glLinkProgram(m_shaderProgramID);
+
+    // Waits for the driver; this stall, plus the submission, is what the binary cache saves.
+    const auto start = Clock::now();
     int success;
     char infoLog[512];
     glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &success);
+    const double buildMilliseconds = pending->submitMilliseconds + elapsedMilliseconds(start);
+
     if (!success)
     {
+        for (GLuint shader : pending->shaders)
+        {
+            int compiled;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+            if (!compiled)
+            {
+                glGetShaderInfoLog(shader, 512, NULL, infoLog);
+                std::cerr << "Failed to compile shader: " << infoLog << std::endl;
+            }
+        }
         glGetProgramInfoLog(m_shaderProgramID, 512, NULL, infoLog);
         std::cerr << "Failed to link shader program: " << infoLog << std::endl;
     }
-
-    for (Shader shader : m_shaders)
+    else if (ProgramBinaryCache::getInstance().isAvailable())
     {
-        glDeleteShader(shader.id);
+        ProgramBinaryCache::getInstance().store(pending->cacheKey, m_shaderProgramID, buildMilliseconds);
     }
 
-    m_shaders.clear();
+    for (GLuint shader : pending->shaders)
+    {
+        glDetachShader(m_shaderProgramID, shader);
+        glDeleteShader(shader);
+    }
+    pending->shaders.clear();
 }
 
 void ShaderEngine::use()
 {
+    if (m_pending)
+        resolve();
+
     glUseProgram(m_shaderProgramID);
+    RenderStats::getInstance().countStateChange();
+}
+
+void ShaderEngine::destroy()
+{
+    if (m_pending)
+    {
+        for (GLuint shader : m_pending->shaders)
+            glDeleteShader(shader);
+        m_pending->shaders.clear();
+        m_pending.reset();
+    }
+
+    glDeleteProgram(m_shaderProgramID);
+    m_shaderProgramID = 0;
 }
@@ -1,27 +1,43 @@
 #ifndef SHADER_ENGINE_HPP_
 #define SHADER_ENGINE_HPP_
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <shader.hpp>
 
+#include "render_stats.hpp"
+
 /**
  * @class ShaderEngine
  * @brief Manages shaders and their compilation into a shader program.
  *
  * This class handles the addition of shaders, compilation into a shader program,
  * and provides methods to set uniform variables in the shader program.
+ *
+ * Compilation and linking are only submitted to the driver: statuses are
+ * checked the first time the program is used, so drivers exposing
+ * KHR_parallel_shader_compile build programs in the background meanwhile.
  */
 class ShaderEngine
 {
 private:
-    std::vector<Shader> m_shaders;  /**< The list of shaders in the engine. */
-    unsigned int m_shaderProgramID; /**< The ID of the compiled shader program. */
+    struct PendingLink;
+
+    std::vector<Shader> m_shaders;          /**< The list of shaders in the engine. */
+    unsigned int m_shaderProgramID = 0;     /**< The ID of the compiled shader program. */
+    std::shared_ptr<PendingLink> m_pending; /**< Link not checked yet, shared by copies of the engine. */
+
+    void resolve();
 
 public:
     /**
      * @brief Adds a shader to the engine.
      *
+     * The shader is compiled by compile(), unless the linked program is found in the
+     * ProgramBinaryCache.
+     *
      * @param shader The shader to add.
      */
     void addShader(Shader& shader);
@@ -29,10 +45,39 @@ public:
     /**
      * @brief Compiles the shaders into a shader program.
      *
-     * This method links all added shaders into a single shader program.
+     * This method links all added shaders into a single shader program. The program
+     * binary is loaded from the ProgramBinaryCache when the same sources were linked
+     * by the same driver before, and stored there otherwise. Same as submitCompile()
+     * followed by submitLink().
      */
     void compile();
 
+    /**
+     * @brief Creates the program and starts compiling its shaders, without waiting for them.
+     *
+     * Nothing is compiled when the program binary is cached.
+     */
+    void submitCompile();
+
+    /**
+     * @brief Starts linking the program compiled by submitCompile(), without waiting for it.
+     */
+    void submitLink();
+
+    /**
+     * @brief Tells whether the driver finished building the program, without blocking.
+     *
+     * @return true once the program is built, or always without KHR_parallel_shader_compile.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Checks the build, logging the compile and link errors, and waits for the driver if it is not done.
+     *
+     * @return true if the program linked.
+     */
+    bool checkLinked();
+
     /**
      * @brief Gets the ID of the shader program.
      *
@@ -44,9 +89,17 @@ public:
      * @brief Activates the shader program for use.
      *
      * This method sets the shader program as the current program in the OpenGL context.
+     * The first call waits for the link to finish and reports errors.
      */
     void use();
 
+    /**
+     * @brief Deletes the shader program, and the shaders of a link that was never checked.
+     *
+     * Copies of the engine refer to the same program and must not be used afterwards.
+     */
+    void destroy();
+
     /**
      * @brief Sets an integer uniform in the shader program.
      *
@@ -55,6 +108,7 @@ public:
      */
     void setInt(const std::string& name, int value)
     {
+        RenderStats::getInstance().countUniformUpload();
         glUniform1i(glGetUniformLocation(m_shaderProgramID, name.c_str()), value);
     }
 
@@ -68,6 +122,7 @@ public:
      */
     void setVec3(const std::string& name, float x, float y, float z)
     {
+        RenderStats::getInstance().countUniformUpload();
         glUniform3f(glGetUniformLocation(m_shaderProgramID, name.c_str()), x, y, z);
     }
 
@@ -79,6 +134,18 @@ public:
      */
     void setVec3(const std::string& name, glm::vec3 value) { ShaderEngine::setVec3(name, value.x, value.y, value.z); }
 
+    /**
+     * @brief Sets a 4D vector uniform in the shader program.
+     *
+     * @param name The name of the uniform variable.
+     * @param value The glm::vec4 value to set.
+     */
+    void setVec4(const std::string& name, glm::vec4 value)
+    {
+        RenderStats::getInstance().countUniformUpload();
+        glUniform4f(glGetUniformLocation(m_shaderProgramID, name.c_str()), value.x, value.y, value.z, value.w);
+    }
+
     /**
      * @brief Sets a 4x4 matrix uniform in the shader program.
      *
@@ -87,6 +154,7 @@ public:
      */
     void setMat4(const std::string& name, glm::mat4 mat)
     {
+        RenderStats::getInstance().countUniformUpload();
         glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
@@ -98,6 +166,7 @@ public:
      */
     void setFloat(const std::string& name, float value)
     {
+        RenderStats::getInstance().countUniformUpload();
         glUniform1f(glGetUniformLocation(m_shaderProgramID, name.c_str()), value);
     }
 
@@ -109,6 +178,42 @@ public:
     int size() { return m_shaders.size(); }
 };
 
+/**
+ * @class ShaderBatch
+ * @brief Submits the compilation of several programs at once.
+ *
+ * Every shader of every program is compiled before the first link is
+ * submitted, so the driver compiler threads get the whole workload up front
+ * while the caller goes on loading meshes and textures.
+ */
+class ShaderBatch
+{
+public:
+    /**
+     * @brief Adds a program to the batch.
+     *
+     * @param engine An engine with its shaders added, which must outlive submit().
+     */
+    void add(ShaderEngine& engine) { m_engines.push_back(&engine); }
+
+    /**
+     * @brief Submits every compilation, then every link, and empties the batch.
+     */
+    void submit();
+
+    /**
+     * @brief Enables driver side parallel compilation when KHR_parallel_shader_compile is exposed.
+     *
+     * Called by submit(); returns whether the extension is available.
+     *
+     * @return true if programs are built in the background.
+     */
+    static bool enableParallelCompile();
+
+private:
+    std::vector<ShaderEngine*> m_engines; /**< Programs waiting for submit(). */
+};
+
 /**
  * @class ShaderEngineFactory
  * @brief Factory class for creating ShaderEngine instances.
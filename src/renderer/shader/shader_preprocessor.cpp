@@ -0,0 +1,147 @@
+#include "shader_preprocessor.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+/**
+ * Extracts the file name of an `#include "file"` line, or returns an empty string.
+ */
+std::string includeTarget(const std::string& line)
+{
+    std::size_t pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line[pos] != '#')
+        return "";
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+        return "";
+
+    const std::size_t open = line.find('"', pos + 7);
+    const std::size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+    if (close == std::string::npos)
+        return "";
+    return line.substr(open + 1, close - open - 1);
+}
+
+} // namespace
+
+const ShaderPreprocessor::ParsedFile& ShaderPreprocessor::parse(const std::string& path)
+{
+    auto it = m_files.find(path);
+    if (it != m_files.end())
+        return it->second;
+
+    ParsedFile& parsed = m_files[path];
+    std::istringstream fileStream;
+    try
+    {
+        fileStream.str(std::string(IO::VirtualFileSystem::getInstance().read(path).text()));
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Failed to open shader file: " << path << std::endl;
+        return parsed;
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    std::string chunk;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(fileStream, line))
+    {
+        lineNumber++;
+        const std::string target = includeTarget(line);
+        if (target.empty())
+        {
+            chunk += line;
+            chunk += '\n';
+            continue;
+        }
+
+        parsed.chunks.push_back(std::move(chunk));
+        chunk.clear();
+        parsed.includes.push_back(IO::normalizePackPath((directory / IO::normalizePackPath(target)).string()));
+        parsed.resumeLines.push_back(lineNumber + 1);
+    }
+    parsed.chunks.push_back(std::move(chunk));
+    parsed.valid = true;
+    return parsed;
+}
+
+void ShaderPreprocessor::expand(const std::string& path, std::unordered_set<std::string>& included,
+                                std::vector<std::string>& stack, std::string& output)
+{
+    if (std::find(stack.begin(), stack.end(), path) != stack.end())
+    {
+        std::cerr << "Shader include cycle through " << path << std::endl;
+        return;
+    }
+    if (!included.insert(path).second)
+        return;
+
+    const ParsedFile& parsed = parse(path);
+    if (!parsed.valid)
+        return;
+
+    stack.push_back(path);
+    output += parsed.chunks[0];
+    for (std::size_t i = 0; i < parsed.includes.size(); ++i)
+    {
+        output += "#line 1\n";
+        expand(parsed.includes[i], included, stack, output);
+        output += "#line " + std::to_string(parsed.resumeLines[i]) + "\n";
+        output += parsed.chunks[i + 1];
+    }
+    stack.pop_back();
+}
+
+void ShaderPreprocessor::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.clear();
+}
+
+std::string ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines)
+{
+    const std::string root = IO::normalizePackPath(path);
+    std::string source;
+    {
+        // Held for the whole expansion: it reads m_files and adds the files it has not parsed yet.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!parse(root).valid)
+            return "";
+
+        std::unordered_set<std::string> included;
+        std::vector<std::string> stack;
+        expand(root, included, stack, source);
+    }
+
+    if (defines.empty())
+        return source;
+
+    std::string injected;
+    for (const auto& [name, value] : defines)
+        injected += "#define " + name + (value.empty() ? "" : " " + value) + "\n";
+
+    // #version must stay first: defines go right after it, followed by a #line to keep numbering.
+    std::size_t insertAt = 0;
+    int resumeLine = 1;
+    const std::size_t version = source.find("#version");
+    if (version != std::string::npos)
+    {
+        const std::size_t end = source.find('\n', version);
+        insertAt = end == std::string::npos ? source.size() : end + 1;
+        resumeLine = static_cast<int>(std::count(source.begin(), source.begin() + insertAt, '\n')) + 1;
+        if (end == std::string::npos)
+            injected.insert(0, "\n");
+    }
+    injected += "#line " + std::to_string(resumeLine) + "\n";
+    source.insert(insertAt, injected);
+    return source;
+}
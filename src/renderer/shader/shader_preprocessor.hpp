@@ -0,0 +1,93 @@
+#ifndef SHADER_PREPROCESSOR_HPP_
+#define SHADER_PREPROCESSOR_HPP_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Preprocessor defines injected into a shader, as name and value pairs.
+ *
+ * An empty value defines the name alone.
+ */
+using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @class ShaderPreprocessor
+ * @brief Expands `#include "file"` directives and injects defines into GLSL sources.
+ *
+ * Every file is read and split around its include directives once; the parsed
+ * files form a graph that is reused by every shader and every permutation
+ * including them. Include paths are relative to the including file. A file is
+ * inserted at most once per expanded source, so shared headers need no guards,
+ * and include cycles are reported instead of expanded.
+ *
+ * Safe from any thread: AssetManager::loadShader() runs on the game thread and
+ * ShaderVariants builds permutations on the render thread, so the parsed files
+ * are guarded by a mutex.
+ */
+class ShaderPreprocessor
+{
+public:
+    /**
+     * @brief Gets the singleton instance of ShaderPreprocessor.
+     *
+     * @return The ShaderPreprocessor instance.
+     */
+    static ShaderPreprocessor& getInstance()
+    {
+        static ShaderPreprocessor instance;
+        return instance;
+    }
+
+    ShaderPreprocessor(const ShaderPreprocessor&) = delete;
+    ShaderPreprocessor& operator=(const ShaderPreprocessor&) = delete;
+
+    /**
+     * @brief Builds the final source of a shader.
+     *
+     * The defines are inserted right after the `#version` line, then includes are
+     * expanded in place. `#line` directives keep compiler messages pointing at the
+     * right line of each file.
+     *
+     * @param path The shader file.
+     * @param defines The defines of the permutation.
+     * @return The expanded source, empty if the file cannot be read.
+     */
+    std::string process(const std::string& path, const ShaderDefines& defines = {});
+
+    /**
+     * @brief Forgets every parsed file, so edited sources are read again.
+     */
+    void clear();
+
+private:
+    /**
+     * @struct ParsedFile
+     * @brief A source file split around its include directives.
+     *
+     * The expanded file is chunks[0], includes[0], chunks[1], ... chunks[n].
+     */
+    struct ParsedFile
+    {
+        bool valid = false;                /**< Whether the file could be read. */
+        std::vector<std::string> chunks;   /**< Source text between include directives. */
+        std::vector<std::string> includes; /**< Normalized paths of the included files. */
+        std::vector<int> resumeLines;      /**< Line following each include directive. */
+    };
+
+    ShaderPreprocessor() = default;
+    ~ShaderPreprocessor() = default;
+
+    const ParsedFile& parse(const std::string& path);
+    void expand(const std::string& path, std::unordered_set<std::string>& included, std::vector<std::string>& stack,
+                std::string& output);
+
+    std::mutex m_mutex;                                  /**< Guards m_files. */
+    std::unordered_map<std::string, ParsedFile> m_files; /**< Parsed files by normalized path. */
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "shader_variants.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+ShaderVariants::ShaderVariants(const std::string& vertex, const std::string& fragment,
+                               const std::vector<std::string>& features, const ShaderDefines& defines)
+    : m_vertex(vertex), m_fragment(fragment), m_features(features), m_defines(defines)
+{
+    if (features.size() > MAX_FEATURES)
+        throw std::invalid_argument("A shader variant set supports at most 32 features");
+
+    m_validBits = features.size() == MAX_FEATURES ? ~0u : (1u << features.size()) - 1u;
+}
+
+ShaderEngine& ShaderVariants::get(std::uint32_t mask)
+{
+    mask &= m_validBits;
+
+    auto it = m_programs.find(mask);
+    if (it != m_programs.end())
+        return it->second;
+
+    ShaderEngine& engine = create(mask);
+    engine.compile();
+    return engine;
+}
+
+void ShaderVariants::prepare(std::uint32_t mask, ShaderBatch& batch)
+{
+    mask &= m_validBits;
+    if (m_programs.find(mask) == m_programs.end())
+        batch.add(create(mask));
+}
+
+ShaderEngine& ShaderVariants::create(std::uint32_t mask)
+{
+    ShaderDefines defines = m_defines;
+    for (std::size_t bit = 0; bit < m_features.size(); ++bit)
+    {
+        if (mask & (1u << bit))
+            defines.emplace_back(m_features[bit], "");
+    }
+
+    ShaderEngine engine;
+    Shader vertexShader = ShaderFactory::createShader(m_vertex, GL_VERTEX_SHADER, defines);
+    Shader fragmentShader = ShaderFactory::createShader(m_fragment, GL_FRAGMENT_SHADER, defines);
+    engine.addShader(vertexShader);
+    engine.addShader(fragmentShader);
+
+    return m_programs.emplace(mask, engine).first->second;
+}
+
+std::uint32_t ShaderVariants::featureBit(const std::string& feature) const
+{
+    auto it = std::find(m_features.begin(), m_features.end(), feature);
+    if (it == m_features.end())
+        return 0;
+    return 1u << static_cast<std::uint32_t>(it - m_features.begin());
+}
@@ -0,0 +1,87 @@
+#ifndef SHADER_VARIANTS_HPP_
+#define SHADER_VARIANTS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shader_engine.hpp"
+
+/**
+ * @class ShaderVariants
+ * @brief The permutations of one vertex and fragment shader pair, selected by a feature bitmask.
+ *
+ * Bit i of a mask defines features[i] in both stages. Each permutation is
+ * compiled the first time it is requested and reused afterwards, so features a
+ * draw does not use cost nothing in its shaders instead of a runtime branch.
+ */
+class ShaderVariants
+{
+public:
+    /**
+     * @brief Maximum number of features of a variant set.
+     */
+    static constexpr std::size_t MAX_FEATURES = 32;
+
+    /**
+     * @brief Describes the permutations of a shader pair.
+     *
+     * @param vertex The file path to the vertex shader.
+     * @param fragment The file path to the fragment shader.
+     * @param features The define enabled by each bit of the mask, at most MAX_FEATURES.
+     * @param defines Defines shared by every permutation.
+     *
+     * @throw std::invalid_argument If there are more than MAX_FEATURES features.
+     */
+    ShaderVariants(const std::string& vertex, const std::string& fragment, const std::vector<std::string>& features,
+                   const ShaderDefines& defines = {});
+
+    /**
+     * @brief Gets the program of a permutation, compiling it on first use.
+     *
+     * Bits without a feature are ignored, so masks differing only there share a program.
+     *
+     * @param mask The enabled features.
+     * @return The shader engine of the permutation, valid as long as this object.
+     */
+    ShaderEngine& get(std::uint32_t mask);
+
+    /**
+     * @brief Adds a permutation to a batch, so it compiles alongside other programs.
+     *
+     * Does nothing if the permutation already exists.
+     *
+     * @param mask The enabled features.
+     * @param batch The batch to add the program to, submitted by the caller.
+     */
+    void prepare(std::uint32_t mask, ShaderBatch& batch);
+
+    /**
+     * @brief Gets the mask bit enabling a feature.
+     *
+     * @param feature The feature define.
+     * @return The bit, 0 if the set has no such feature.
+     */
+    std::uint32_t featureBit(const std::string& feature) const;
+
+    /**
+     * @brief Gets the number of permutations compiled so far.
+     *
+     * @return The number of programs.
+     */
+    std::size_t compiledCount() const { return m_programs.size(); }
+
+private:
+    ShaderEngine& create(std::uint32_t mask);
+
+    std::string m_vertex;                                       /**< The vertex shader file. */
+    std::string m_fragment;                                     /**< The fragment shader file. */
+    std::vector<std::string> m_features;                        /**< The define of each mask bit. */
+    ShaderDefines m_defines;                                    /**< Defines shared by every permutation. */
+    std::uint32_t m_validBits;                                  /**< Bits that map to a feature. */
+    std::unordered_map<std::uint32_t, ShaderEngine> m_programs; /**< Compiled permutations by mask. */
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <string>
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 /**
  * @enum TextureType
@@ -47,13 +48,23 @@ TextureType fromString(const std::string& str);
  * @brief Represents a texture with an ID, type, and file path.
  *
  * This struct defines a texture used in rendering, including its OpenGL ID,
- * type, and the file path from which it was loaded.
+ * type, and the file path from which it was loaded. A Texture is a binding of
+ * an image to a mesh, so it also carries how densely that mesh samples it,
+ * which the TextureStreamer uses to pick the mip levels to keep resident.
+ *
+ * Images packed by the texture packer live in a layer of a GL_TEXTURE_2D_ARRAY,
+ * possibly in a sub-rectangle of an atlas page: id is then the array, shared by
+ * every image of the same format and size.
  */
 struct Texture
 {
-    GLuint id;        /**< The OpenGL ID of the texture. */
-    TextureType type; /**< The type of the texture. */
-    std::string path; /**< The file path to the texture image. */
+    GLuint id = 0;                                 /**< The OpenGL ID of the texture. */
+    TextureType type = NOT_TEXTURE;                /**< The type of the texture. */
+    std::string path;                              /**< The file path to the texture image. */
+    float uvDensity = 0.0f;                        /**< UV area per model space area of the mesh. */
+    GLenum target = GL_TEXTURE_2D;                 /**< GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY if packed. */
+    int layer = 0;                                 /**< Array layer holding the image. */
+    glm::vec4 uvTransform{0.0f, 0.0f, 1.0f, 1.0f}; /**< UV offset (xy) and scale (zw) in the layer. */
 };
 
 #endif
@@ -0,0 +1,88 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "log.hpp"
+#include "texture_loader.hpp"
+#include "virtual_file_system.hpp"
+
+using json = nlohmann::json;
+
+bool TextureAtlas::addManifest(const std::string& path)
+{
+    IO::FileData file;
+    try
+    {
+        file = IO::VirtualFileSystem::getInstance().read(path);
+    }
+    catch (const std::exception&)
+    {
+        Logger::Log(LogLevel::Error, "Texture atlas manifest not found: " + path, "Renderer");
+        return false;
+    }
+
+    json manifest;
+    try
+    {
+        manifest = json::parse(file.text());
+    }
+    catch (const json::exception& e)
+    {
+        Logger::Log(LogLevel::Error, "Invalid texture atlas manifest " + path + ": " + e.what(), "Renderer");
+        return false;
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+    std::vector<GLuint> containers;
+    for (const auto& container : manifest["containers"])
+    {
+        std::filesystem::path containerPath = directory / container.get<std::string>();
+        containers.push_back(TextureLoader::getInstance().loadArray(containerPath.string()));
+    }
+
+    for (const auto& [source, entry] : manifest["entries"].items())
+    {
+        std::size_t container = entry["container"].get<std::size_t>();
+        if (container >= containers.size() || containers[container] == 0)
+            continue;
+
+        Entry packed;
+        packed.id = containers[container];
+        packed.layer = entry["layer"].get<int>();
+        packed.uvTransform = glm::vec4(entry["uvOffset"][0].get<float>(), entry["uvOffset"][1].get<float>(),
+                                       entry["uvScale"][0].get<float>(), entry["uvScale"][1].get<float>());
+        m_entries[normalize(source)] = packed;
+    }
+
+    Logger::Log(LogLevel::Info,
+                "Texture atlas " + path + ": " + std::to_string(manifest["entries"].size()) + " images in " +
+                    std::to_string(containers.size()) + " arrays",
+                "Renderer");
+    return true;
+}
+
+bool TextureAtlas::resolve(const std::string& path, Texture& texture) const
+{
+    auto it = m_entries.find(normalize(path));
+    if (it == m_entries.end())
+        return false;
+
+    texture.id = it->second.id;
+    texture.target = GL_TEXTURE_2D_ARRAY;
+    texture.layer = it->second.layer;
+    texture.uvTransform = it->second.uvTransform;
+    return true;
+}
+
+std::string TextureAtlas::normalize(const std::string& path)
+{
+    // Assets are referenced with both separators (".\\res\\box.bmp" and "res/box.bmp").
+    std::string generic = path;
+    std::replace(generic.begin(), generic.end(), '\\', '/');
+    return std::filesystem::path(generic).lexically_normal().generic_string();
+}
@@ -0,0 +1,86 @@
+#ifndef TEXTURE_ATLAS_HPP_
+#define TEXTURE_ATLAS_HPP_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "texture.hpp"
+
+/**
+ * @class TextureAtlas
+ * @brief Redirects image paths to the texture arrays built by the texture packer tool.
+ *
+ * A manifest lists the packed KTX2 containers and, for every source image, the
+ * container, layer and UV transform replacing it. Once a manifest is added,
+ * Renderable::setTexture and model loading resolve packed paths to the shared
+ * array instead of loading the image, so materials differing only by texture
+ * keep the same binding and just pass another layer index.
+ */
+class TextureAtlas
+{
+public:
+    /**
+     * @brief Gets the singleton instance of TextureAtlas.
+     *
+     * @return The TextureAtlas instance.
+     */
+    static TextureAtlas& getInstance()
+    {
+        static TextureAtlas instance;
+        return instance;
+    }
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /**
+     * @brief Reads a manifest and requests its containers from the TextureLoader.
+     *
+     * Containers are looked up next to the manifest.
+     *
+     * @param path The file path to the .atlas.json manifest.
+     * @return true if the manifest was read.
+     */
+    bool addManifest(const std::string& path);
+
+    /**
+     * @brief Points a texture at the packed copy of an image.
+     *
+     * @param path The image path, as given to the packer.
+     * @param texture The texture whose id, target, layer and uvTransform are filled in.
+     * @return true if the image is packed, false to load it on its own.
+     */
+    bool resolve(const std::string& path, Texture& texture) const;
+
+    /**
+     * @brief Gets the number of packed images known.
+     *
+     * @return The number of entries.
+     */
+    std::size_t entryCount() const { return m_entries.size(); }
+
+private:
+    /**
+     * @struct Entry
+     * @brief Location of a packed image.
+     */
+    struct Entry
+    {
+        GLuint id = 0;                                 /**< The texture array. */
+        int layer = 0;                                 /**< Layer holding the image. */
+        glm::vec4 uvTransform{0.0f, 0.0f, 1.0f, 1.0f}; /**< UV offset (xy) and scale (zw) in the layer. */
+    };
+
+    TextureAtlas() = default;
+    ~TextureAtlas() = default;
+
+    static std::string normalize(const std::string& path);
+
+    std::unordered_map<std::string, Entry> m_entries; /**< Packed images by normalized path. */
+};
+
+#endif
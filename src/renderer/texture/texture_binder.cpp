@@ -0,0 +1,37 @@
+#include "texture_binder.hpp"
+
+#include "render_stats.hpp"
+
+void TextureBinder::bind(GLuint unit, GLenum target, GLuint id)
+{
+    if (unit < MAX_UNITS && m_slots[unit].target == target && m_slots[unit].id == id)
+    {
+        m_skippedCount++;
+        return;
+    }
+
+    activate(unit);
+    glBindTexture(target, id);
+    m_bindCount++;
+    RenderStats::getInstance().countStateChange();
+
+    if (unit < MAX_UNITS)
+        m_slots[unit] = Slot{target, id};
+}
+
+void TextureBinder::activate(GLuint unit)
+{
+    if (m_activeUnit == unit && unit < MAX_UNITS)
+        return;
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    m_activeUnit = unit < MAX_UNITS ? unit : MAX_UNITS;
+}
+
+void TextureBinder::reset()
+{
+    m_slots.fill(Slot{});
+    m_activeUnit = MAX_UNITS;
+    m_bindCount = 0;
+    m_skippedCount = 0;
+}
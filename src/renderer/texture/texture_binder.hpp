@@ -0,0 +1,95 @@
+#ifndef TEXTURE_BINDER_HPP_
+#define TEXTURE_BINDER_HPP_
+
+#include <array>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+/**
+ * @class TextureBinder
+ * @brief Shadows the texture unit bindings to skip redundant glBindTexture calls.
+ *
+ * Packed textures share one array per format and size, so consecutive draws
+ * mostly bind what is already bound. Code binding textures behind the binder's
+ * back (loaders, ImGui) must be followed by reset(); the engine does it once per
+ * frame before rendering.
+ */
+class TextureBinder
+{
+public:
+    /**
+     * @brief Number of texture units tracked, higher units are always bound.
+     */
+    static constexpr GLuint MAX_UNITS = 32;
+
+    /**
+     * @brief Gets the singleton instance of TextureBinder.
+     *
+     * @return The TextureBinder instance.
+     */
+    static TextureBinder& getInstance()
+    {
+        static TextureBinder instance;
+        return instance;
+    }
+
+    TextureBinder(const TextureBinder&) = delete;
+    TextureBinder& operator=(const TextureBinder&) = delete;
+
+    /**
+     * @brief Binds a texture to a unit unless it is bound there already.
+     *
+     * @param unit The texture unit, 0 for GL_TEXTURE0.
+     * @param target GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY.
+     * @param id The texture name.
+     */
+    void bind(GLuint unit, GLenum target, GLuint id);
+
+    /**
+     * @brief Makes a unit active unless it is already.
+     *
+     * @param unit The texture unit, 0 for GL_TEXTURE0.
+     */
+    void activate(GLuint unit);
+
+    /**
+     * @brief Forgets the cached bindings, the next bind() of every unit reaches OpenGL.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the number of glBindTexture calls issued since the last reset().
+     *
+     * @return The number of binds.
+     */
+    std::size_t getBindCount() const { return m_bindCount; }
+
+    /**
+     * @brief Gets the number of binds skipped since the last reset().
+     *
+     * @return The number of redundant binds.
+     */
+    std::size_t getSkippedCount() const { return m_skippedCount; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief What a texture unit holds.
+     */
+    struct Slot
+    {
+        GLenum target = 0; /**< The target last bound. */
+        GLuint id = 0;     /**< The texture last bound. */
+    };
+
+    TextureBinder() = default;
+    ~TextureBinder() = default;
+
+    std::array<Slot, MAX_UNITS> m_slots{}; /**< Cached binding of every unit. */
+    GLuint m_activeUnit = MAX_UNITS;       /**< Cached active unit, MAX_UNITS when unknown. */
+    std::size_t m_bindCount = 0;           /**< Binds issued since reset(). */
+    std::size_t m_skippedCount = 0;        /**< Binds skipped since reset(). */
+};
+
+#endif
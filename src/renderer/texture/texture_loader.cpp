@@ -0,0 +1,375 @@
+#include "texture_loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#include <stb_image.h>
+
+#include "log.hpp"
+#include "profiler.hpp"
+#include "render_stats.hpp"
+#include "texture_streamer.hpp"
+#include "thread_pool.hpp"
+#include "virtual_file_system.hpp"
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+    #define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace
+{
+
+// Updates in a row a staging buffer may fail to map before its upload is abandoned.
+constexpr int MAX_MAP_ATTEMPTS = 3;
+
+GLenum glFormatFromKtx2(IO::Ktx2Format format)
+{
+    switch (format)
+    {
+        case IO::Ktx2Format::R8G8B8A8_UNORM:
+            return GL_RGBA8;
+        case IO::Ktx2Format::R8G8B8A8_SRGB:
+            return GL_SRGB8_ALPHA8;
+        case IO::Ktx2Format::BC1_RGB_UNORM:
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case IO::Ktx2Format::BC1_RGB_SRGB:
+            return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+        case IO::Ktx2Format::BC3_UNORM:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case IO::Ktx2Format::BC3_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+        case IO::Ktx2Format::BC5_UNORM:
+            return GL_COMPRESSED_RG_RGTC2;
+        case IO::Ktx2Format::BC7_UNORM:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case IO::Ktx2Format::BC7_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+        default:
+            return 0;
+    }
+}
+
+bool isKtx2Path(const std::string& path)
+{
+    return std::filesystem::path(path).extension() == ".ktx2";
+}
+
+GLenum formatFromChannels(int channels)
+{
+    switch (channels)
+    {
+        case 1:
+            return GL_RED;
+        case 4:
+            return GL_RGBA;
+        default:
+            return GL_RGB;
+    }
+}
+
+} // namespace
+
+GLuint TextureLoader::load(const std::string& path)
+{
+    return request(path, GL_TEXTURE_2D);
+}
+
+GLuint TextureLoader::loadArray(const std::string& path)
+{
+    return request(path, GL_TEXTURE_2D_ARRAY);
+}
+
+GLuint TextureLoader::request(const std::string& path, GLenum target)
+{
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if (id == 0)
+    {
+        Logger::Log(LogLevel::Error, "Failed to generate texture ID for " + path, "Renderer");
+        return 0;
+    }
+
+    // Neutral grey until the real image is resident.
+    static const unsigned char placeholder[4] = {128, 128, 128, 255};
+    glBindTexture(target, id);
+    if (target == GL_TEXTURE_2D_ARRAY)
+        glTexImage3D(target, 0, GL_RGBA, 1, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    else
+        glTexImage2D(target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target, 0);
+
+    m_jobs.add();
+    ThreadPool::getInstance().submit([this, id, target, path]() { decode(id, target, path); });
+
+    return id;
+}
+
+void TextureLoader::decode(GLuint id, GLenum target, const std::string& path)
+{
+    PROFILE_ZONE("TextureLoader::decode");
+    DecodedImage image;
+    image.id = id;
+    image.target = target;
+    image.path = path;
+
+    try
+    {
+        // Packed textures are parsed straight from the pack mapping.
+        const IO::FileData file = IO::VirtualFileSystem::getInstance().read(path);
+
+        if (target == GL_TEXTURE_2D_ARRAY)
+        {
+            image.ktx = IO::parseKTX2(file.data(), file.size());
+            image.width = static_cast<int>(image.ktx.width);
+            image.height = static_cast<int>(image.ktx.height);
+            image.valid = glFormatFromKtx2(image.ktx.format) != 0;
+        }
+        else if (isKtx2Path(path))
+        {
+            // When streaming, only the small levels are read now, the streamer brings the others in on demand.
+            if (TextureStreamer::getInstance().isEnabled())
+                image.ktx = IO::parseKTX2Tail(file.data(), file.size(), TextureStreamer::RESIDENT_TAIL_SIZE);
+            else
+                image.ktx = IO::parseKTX2(file.data(), file.size());
+            image.width = static_cast<int>(image.ktx.width);
+            image.height = static_cast<int>(image.ktx.height);
+            image.valid = image.ktx.layers() == 1 && glFormatFromKtx2(image.ktx.format) != 0;
+        }
+        else
+        {
+            image.pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &image.width,
+                                                 &image.height, &image.channels, 0);
+            image.valid = image.pixels != nullptr;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Log(LogLevel::Warning, std::string("Failed to read texture: ") + e.what(), "Renderer");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decoded.push_back(std::move(image));
+    }
+    m_jobs.done();
+}
+
+void TextureLoader::update(std::size_t byteBudget)
+{
+    PROFILE_ZONE("TextureLoader::update");
+    std::vector<DecodedImage> decoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    for (DecodedImage& image : decoded)
+    {
+        if (!image.valid)
+        {
+            freeImage(image);
+            Logger::Log(LogLevel::Warning, "Texture failed to load at path: " + image.path, "Renderer");
+            continue;
+        }
+
+        PendingUpload upload;
+        upload.size = image.pixels ? static_cast<std::size_t>(image.width) * image.height * image.channels
+                                   : image.ktx.data.size();
+        upload.image = std::move(image);
+
+        glGenBuffers(1, &upload.pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, upload.size, nullptr, GL_STREAM_DRAW);
+
+        m_uploads.push_back(std::move(upload));
+    }
+
+    while (!m_uploads.empty() && byteBudget > 0)
+    {
+        PendingUpload& upload = m_uploads.front();
+
+        std::size_t slice = std::min(byteBudget, upload.size - upload.uploaded);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+        void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, upload.uploaded, slice,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!staging)
+        {
+            // Nothing was staged, so the slice is retried by the next update() rather than uploaded unwritten.
+            if (++upload.mapFailures < MAX_MAP_ATTEMPTS)
+            {
+                Logger::Log(LogLevel::Warning, "Failed to map staging buffer for " + upload.image.path, "Renderer");
+                break;
+            }
+
+            // The texture keeps its placeholder.
+            Logger::Log(LogLevel::Error, "Abandoning upload of " + upload.image.path + ", staging buffer never mapped",
+                        "Renderer");
+            glDeleteBuffers(1, &upload.pbo);
+            freeImage(upload.image);
+            m_uploads.pop_front();
+            continue;
+        }
+
+        std::memcpy(staging, upload.image.payload() + upload.uploaded, slice);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        upload.mapFailures = 0;
+
+        upload.uploaded += slice;
+        byteBudget -= slice;
+
+        if (upload.uploaded < upload.size)
+            break;
+
+        finalize(upload);
+        m_uploads.pop_front();
+    }
+
+    // A PBO left bound would turn every later client-memory glTexImage2D into an offset.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureLoader::finalize(PendingUpload& upload)
+{
+    const DecodedImage& image = upload.image;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+    glBindTexture(image.target, image.id);
+
+    if (image.pixels)
+    {
+        GLenum format = formatFromChannels(image.channels);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        // The mip chain adds a third to the base level.
+        const auto baseBytes = static_cast<std::int64_t>(image.width) * image.height * image.channels;
+        RenderStats::getInstance().addTextureMemory(baseBytes + baseBytes / 3);
+    }
+    else
+    {
+        finalizeKtx2(image);
+    }
+
+    // Atlas pages are addressed through a UV transform, wrapping is done in the shader.
+    const GLint wrap = image.target == GL_TEXTURE_2D_ARRAY ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(image.target, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(image.target, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(image.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(image.target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(image.target, 0);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &upload.pbo);
+    upload.pbo = 0;
+
+    freeImage(upload.image);
+}
+
+void TextureLoader::finalizeKtx2(const DecodedImage& image)
+{
+    const IO::Ktx2Image& ktx = image.ktx;
+    const GLenum internalFormat = glFormatFromKtx2(ktx.format);
+    const GLint levelCount = static_cast<GLint>(ktx.levels.size());
+    const GLint firstLevel = static_cast<GLint>(ktx.firstLevel);
+
+    // Offsets are relative to the bound PIXEL_UNPACK_BUFFER, which holds ktx.data.
+    for (GLint level = firstLevel; level < levelCount; ++level)
+    {
+        GLsizei width = std::max(1, image.width >> level);
+        GLsizei height = std::max(1, image.height >> level);
+        const void* offset = reinterpret_cast<const void*>(ktx.levels[level].offset);
+
+        if (image.target == GL_TEXTURE_2D_ARRAY)
+        {
+            const GLsizei layers = static_cast<GLsizei>(ktx.layers());
+            if (IO::isBlockCompressed(ktx.format))
+                glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, layers, 0,
+                                       static_cast<GLsizei>(ktx.levels[level].size), offset);
+            else
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, layers, 0, GL_RGBA,
+                             GL_UNSIGNED_BYTE, offset);
+        }
+        else if (IO::isBlockCompressed(ktx.format))
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0,
+                                   static_cast<GLsizei>(ktx.levels[level].size), offset);
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, offset);
+        }
+    }
+
+    glTexParameteri(image.target, GL_TEXTURE_BASE_LEVEL, firstLevel);
+    glTexParameteri(image.target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    if (firstLevel > 0 && image.target == GL_TEXTURE_2D)
+    {
+        // The streamer accounts for the levels it manages.
+        TextureStreamer::getInstance().registerTexture(image.id, image.path, ktx, internalFormat);
+        return;
+    }
+
+    std::int64_t bytes = 0;
+    for (GLint level = firstLevel; level < levelCount; ++level)
+        bytes += static_cast<std::int64_t>(ktx.levels[level].size);
+    RenderStats::getInstance().addTextureMemory(bytes);
+}
+
+void TextureLoader::flush()
+{
+    // Once no decode is running, unlimited updates stage everything; only a failing map takes more than one.
+    m_jobs.wait();
+    while (pendingCount() > 0)
+        update(static_cast<std::size_t>(-1));
+}
+
+void TextureLoader::shutdown()
+{
+    m_jobs.wait();
+
+    for (DecodedImage& image : m_decoded)
+        freeImage(image);
+    m_decoded.clear();
+
+    for (PendingUpload& upload : m_uploads)
+    {
+        if (upload.pbo != 0)
+            glDeleteBuffers(1, &upload.pbo);
+        freeImage(upload.image);
+    }
+    m_uploads.clear();
+}
+
+std::size_t TextureLoader::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.count() + m_decoded.size() + m_uploads.size();
+}
+
+void TextureLoader::freeImage(DecodedImage& image)
+{
+    if (image.pixels)
+    {
+        stbi_image_free(image.pixels);
+        image.pixels = nullptr;
+    }
+    image.ktx = IO::Ktx2Image();
+}
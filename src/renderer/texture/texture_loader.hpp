@@ -0,0 +1,151 @@
+#ifndef TEXTURE_LOADER_HPP_
+#define TEXTURE_LOADER_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <ktx2.hpp>
+
+#include "in_flight_counter.hpp"
+
+/**
+ * @class TextureLoader
+ * @brief Streams image files into OpenGL textures without blocking the main thread.
+ *
+ * load() hands back a texture name immediately, bound to a 1x1 placeholder texel.
+ * Decoding runs on the ThreadPool; update() then copies the decoded pixels into a
+ * pixel buffer object, a bounded number of bytes per frame, and re-specifies the
+ * texture from that PBO once the whole image is staged. The texture name never
+ * changes, so Texture structs copied around by value stay valid.
+ *
+ * Files ending in .ktx2 (see the texture cooker tool) are read as-is and their
+ * precomputed mip levels are uploaded with glCompressedTexImage2D: no CPU decode
+ * and no glGenerateMipmap. While the TextureStreamer is enabled only the tail of
+ * their mip chain is loaded, the streamer then owns the larger levels. Layered
+ * KTX2 files go through loadArray() and become GL_TEXTURE_2D_ARRAY textures.
+ *
+ * Every method except the decoding jobs must be called from the GL context thread.
+ */
+class TextureLoader
+{
+public:
+    /**
+     * @brief Default amount of pixel data copied into staging buffers per update() call.
+     */
+    static constexpr std::size_t DEFAULT_UPLOAD_BUDGET = 4ull * 1024ull * 1024ull; // 4 MB
+
+    /**
+     * @brief Gets the singleton instance of TextureLoader.
+     *
+     * @return The TextureLoader instance.
+     */
+    static TextureLoader& getInstance()
+    {
+        static TextureLoader instance;
+        return instance;
+    }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    /**
+     * @brief Requests an image to be loaded asynchronously.
+     *
+     * @param path The file path to the image.
+     * @return The OpenGL name of the texture, showing the placeholder until resident, 0 on failure.
+     */
+    GLuint load(const std::string& path);
+
+    /**
+     * @brief Requests a layered KTX2 file (see the texture packer tool) to be loaded asynchronously.
+     *
+     * @param path The file path to the KTX2 file.
+     * @return The OpenGL name of the GL_TEXTURE_2D_ARRAY, showing the placeholder until resident, 0 on failure.
+     */
+    GLuint loadArray(const std::string& path);
+
+    /**
+     * @brief Advances pending uploads, to be called once per frame.
+     *
+     * @param byteBudget Maximum number of bytes copied into staging buffers during this call.
+     */
+    void update(std::size_t byteBudget = DEFAULT_UPLOAD_BUDGET);
+
+    /**
+     * @brief Blocks until every requested texture is resident.
+     *
+     * Meant for tools and tests that need deterministic content, not for the frame loop.
+     */
+    void flush();
+
+    /**
+     * @brief Releases staging buffers and pending images. Must run before the GL context is destroyed.
+     */
+    void shutdown();
+
+    /**
+     * @brief Gets the number of textures still decoding or uploading.
+     *
+     * @return The number of non-resident textures.
+     */
+    std::size_t pendingCount() const;
+
+private:
+    /**
+     * @struct DecodedImage
+     * @brief Output of a decoding job, produced on a worker thread.
+     */
+    struct DecodedImage
+    {
+        GLuint id = 0;                   /**< The texture name handed out by load(). */
+        GLenum target = GL_TEXTURE_2D;   /**< GL_TEXTURE_2D, or GL_TEXTURE_2D_ARRAY for loadArray(). */
+        std::string path;                /**< The source file, for diagnostics. */
+        int width = 0;                   /**< Width in pixels. */
+        int height = 0;                  /**< Height in pixels. */
+        int channels = 0;                /**< Number of 8-bit channels. */
+        unsigned char* pixels = nullptr; /**< stb_image owned pixels, null on failure. */
+        IO::Ktx2Image ktx;               /**< Cooked texture, used instead of pixels for .ktx2 files. */
+        bool valid = false;              /**< Whether decoding succeeded. */
+
+        /**
+         * @brief Gets the bytes to stage, pixels or the concatenated KTX2 levels.
+         *
+         * @return Pointer to the upload payload.
+         */
+        const unsigned char* payload() const { return pixels ? pixels : ktx.data.data(); }
+    };
+
+    /**
+     * @struct PendingUpload
+     * @brief A decoded image being copied into its pixel buffer object.
+     */
+    struct PendingUpload
+    {
+        DecodedImage image;       /**< The decoded image. */
+        GLuint pbo = 0;           /**< The staging pixel buffer object. */
+        std::size_t size = 0;     /**< Total number of bytes to stage. */
+        std::size_t uploaded = 0; /**< Number of bytes already staged. */
+        int mapFailures = 0;      /**< Updates in a row the staging buffer failed to map. */
+    };
+
+    TextureLoader() = default;
+    ~TextureLoader() = default;
+
+    GLuint request(const std::string& path, GLenum target);
+    void decode(GLuint id, GLenum target, const std::string& path);
+    void finalize(PendingUpload& upload);
+    void finalizeKtx2(const DecodedImage& image);
+    static void freeImage(DecodedImage& image);
+
+    mutable std::mutex m_mutex;          /**< Guards m_decoded. */
+    std::vector<DecodedImage> m_decoded; /**< Images decoded by workers, waiting for the main thread. */
+    InFlightCounter m_jobs;              /**< Decoding jobs not yet finished. */
+
+    std::deque<PendingUpload> m_uploads; /**< Images being staged, main thread only. */
+};
+
+#endif
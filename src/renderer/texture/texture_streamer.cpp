@@ -0,0 +1,301 @@
+#include "texture_streamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "log.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+constexpr std::uint32_t NO_REQUEST = std::numeric_limits<std::uint32_t>::max();
+constexpr float MIN_DISTANCE = 0.01f;
+
+std::uint32_t levelExtent(std::uint32_t size, std::uint32_t level)
+{
+    return std::max<std::uint32_t>(1, size >> level);
+}
+
+} // namespace
+
+void TextureStreamer::registerTexture(GLuint id, const std::string& path, const IO::Ktx2Image& image,
+                                      GLenum internalFormat)
+{
+    StreamedTexture texture;
+    texture.path = path;
+    texture.format = image.format;
+    texture.internalFormat = internalFormat;
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.tailLevel = image.firstLevel;
+    texture.residentLevel = image.firstLevel;
+    texture.wantedLevel = image.firstLevel;
+    texture.frameLevel = NO_REQUEST;
+    texture.lastUsedFrame = m_frame;
+
+    for (const IO::Ktx2Level& level : image.levels)
+        texture.levelSizes.push_back(level.size);
+    for (std::size_t level = image.firstLevel; level < image.levels.size(); ++level)
+        m_residentBytes += image.levels[level].size;
+
+    m_textures[id] = std::move(texture);
+}
+
+void TextureStreamer::setView(const glm::mat4& view, const glm::mat4& projection)
+{
+    m_view = view;
+    m_projection = projection;
+    m_hasView = m_viewportHeight > 0.0f;
+}
+
+void TextureStreamer::reportUsage(const Texture& texture, const glm::mat4& model, const glm::vec3& center,
+                                  float radius)
+{
+    auto it = m_textures.find(texture.id);
+    if (it == m_textures.end())
+        return;
+
+    StreamedTexture& streamed = it->second;
+    const std::uint32_t coarsest = static_cast<std::uint32_t>(streamed.levelSizes.size()) - 1;
+
+    if (!m_hasView || texture.uvDensity <= 0.0f)
+    {
+        requestLevel(texture.id, 0);
+        return;
+    }
+
+    const float scale = std::sqrt(std::max({glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                            glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                            glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))}));
+    const float worldRadius = radius * scale;
+    const glm::vec4 viewCenter = m_view * model * glm::vec4(center, 1.0f);
+
+    // Behind the camera or outside the side planes: the draw does not need any texel.
+    if (viewCenter.z > worldRadius)
+        return;
+    const glm::vec4 clipCenter = m_projection * viewCenter;
+    const float slack = std::abs(clipCenter.w) + worldRadius * std::max(m_projection[0][0], m_projection[1][1]);
+    if (std::abs(clipCenter.x) > slack + worldRadius || std::abs(clipCenter.y) > slack + worldRadius)
+        return;
+
+    const float distance = std::max(glm::length(glm::vec3(viewCenter)) - worldRadius, MIN_DISTANCE);
+    const float pixelsPerUnit = m_projection[1][1] * 0.5f * m_viewportHeight / distance;
+
+    // Less than a pixel on screen: the coarsest level is plenty.
+    if (worldRadius * pixelsPerUnit < 1.0f)
+    {
+        requestLevel(texture.id, coarsest);
+        return;
+    }
+
+    // Texels covering one world unit at level 0, uvDensity being UV area per model space area.
+    const float texelsPerUnit =
+        std::sqrt(texture.uvDensity * static_cast<float>(streamed.width) * static_cast<float>(streamed.height)) /
+        std::max(scale, std::numeric_limits<float>::epsilon());
+    const float texelsPerPixel = texelsPerUnit / pixelsPerUnit;
+
+    std::uint32_t level = 0;
+    if (texelsPerPixel > 1.0f)
+        level = static_cast<std::uint32_t>(std::floor(std::log2(texelsPerPixel)));
+
+    requestLevel(texture.id, std::min(level, coarsest));
+}
+
+void TextureStreamer::requestLevel(GLuint id, std::uint32_t level)
+{
+    auto it = m_textures.find(id);
+    if (it == m_textures.end())
+        return;
+
+    it->second.frameLevel = std::min(it->second.frameLevel, level);
+    it->second.lastUsedFrame = m_frame;
+}
+
+void TextureStreamer::readLevel(GLuint id, const std::string& path, std::uint32_t level)
+{
+    LoadedLevel loaded;
+    loaded.id = id;
+    loaded.level = level;
+
+    try
+    {
+        const IO::FileData file = IO::VirtualFileSystem::getInstance().read(path);
+        loaded.data = IO::parseKTX2Level(file.data(), file.size(), level);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Log(LogLevel::Warning, std::string("Failed to stream texture level: ") + e.what(), "Renderer");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loaded.push_back(std::move(loaded));
+    }
+    m_jobs.done();
+}
+
+void TextureStreamer::update()
+{
+    PROFILE_ZONE("TextureStreamer::update");
+    GLint viewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_viewportHeight = static_cast<float>(viewport[3]);
+    m_hasView = false;
+
+    std::vector<LoadedLevel> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        loaded.swap(m_loaded);
+    }
+
+    for (const LoadedLevel& level : loaded)
+    {
+        auto it = m_textures.find(level.id);
+        if (it == m_textures.end())
+            continue;
+
+        StreamedTexture& texture = it->second;
+        texture.loading = false;
+
+        if (level.data.size() != texture.levelSizes[level.level])
+        {
+            // Release the reservation made when the read was scheduled.
+            m_residentBytes -= texture.levelSizes[level.level];
+            continue;
+        }
+
+        uploadLevel(level.id, texture, level);
+    }
+
+    // Fold this frame's reports in, then serve the most recently used, most blurry textures first.
+    std::vector<std::pair<GLuint, StreamedTexture*>> candidates;
+    for (auto& [id, texture] : m_textures)
+    {
+        if (texture.frameLevel != NO_REQUEST)
+            texture.wantedLevel = texture.frameLevel;
+        texture.frameLevel = NO_REQUEST;
+
+        if (!texture.loading && texture.wantedLevel < texture.residentLevel)
+            candidates.emplace_back(id, &texture);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        if (a.second->lastUsedFrame != b.second->lastUsedFrame)
+            return a.second->lastUsedFrame > b.second->lastUsedFrame;
+        return a.second->residentLevel - a.second->wantedLevel > b.second->residentLevel - b.second->wantedLevel;
+    });
+
+    std::size_t requests = 0;
+    for (auto& [id, texture] : candidates)
+    {
+        if (requests == MAX_LEVEL_REQUESTS_PER_FRAME)
+            break;
+
+        const std::uint32_t level = texture->residentLevel - 1;
+        const std::size_t size = texture->levelSizes[level];
+        if (!makeRoom(size, id))
+            break;
+
+        m_residentBytes += size;
+        texture->loading = true;
+        requests++;
+
+        m_jobs.add();
+        ThreadPool::getInstance().submit(
+            [this, id = id, path = texture->path, level]() { readLevel(id, path, level); });
+    }
+
+    m_frame++;
+}
+
+void TextureStreamer::uploadLevel(GLuint id, StreamedTexture& texture, const LoadedLevel& loaded)
+{
+    const GLsizei width = static_cast<GLsizei>(levelExtent(texture.width, loaded.level));
+    const GLsizei height = static_cast<GLsizei>(levelExtent(texture.height, loaded.level));
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    if (IO::isBlockCompressed(texture.format))
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, loaded.level, texture.internalFormat, width, height, 0,
+                               static_cast<GLsizei>(loaded.data.size()), loaded.data.data());
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, loaded.level, texture.internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     loaded.data.data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, loaded.level);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    texture.residentLevel = loaded.level;
+}
+
+void TextureStreamer::evictTopLevel(GLuint id, StreamedTexture& texture)
+{
+    const std::uint32_t level = texture.residentLevel;
+
+    // Move the base level first so the texture stays complete, then shrink the dropped level to nothing.
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    if (IO::isBlockCompressed(texture.format))
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, texture.internalFormat, 0, 0, 0, 0, nullptr);
+    else
+        glTexImage2D(GL_TEXTURE_2D, level, texture.internalFormat, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    texture.residentLevel = level + 1;
+    m_residentBytes -= texture.levelSizes[level];
+}
+
+bool TextureStreamer::makeRoom(std::size_t bytes, GLuint requester)
+{
+    while (m_residentBytes + bytes > m_budget)
+    {
+        GLuint victimId = 0;
+        StreamedTexture* victim = nullptr;
+
+        for (auto& [id, texture] : m_textures)
+        {
+            if (id == requester || texture.loading || texture.residentLevel >= texture.tailLevel)
+                continue;
+
+            if (!victim)
+            {
+                victimId = id;
+                victim = &texture;
+                continue;
+            }
+
+            // Textures sharper than needed go first, then the least recently used.
+            const bool surplus = texture.residentLevel < texture.wantedLevel;
+            const bool victimSurplus = victim->residentLevel < victim->wantedLevel;
+            if (surplus != victimSurplus ? surplus : texture.lastUsedFrame < victim->lastUsedFrame)
+            {
+                victimId = id;
+                victim = &texture;
+            }
+        }
+
+        // Never blur something drawn this frame to sharpen something else.
+        if (!victim || (victim->lastUsedFrame == m_frame && victim->residentLevel >= victim->wantedLevel))
+            return false;
+
+        evictTopLevel(victimId, *victim);
+    }
+
+    return true;
+}
+
+void TextureStreamer::shutdown()
+{
+    m_jobs.wait();
+
+    m_loaded.clear();
+    m_textures.clear();
+    m_residentBytes = 0;
+}
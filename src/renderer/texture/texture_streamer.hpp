@@ -0,0 +1,215 @@
+#ifndef TEXTURE_STREAMER_HPP_
+#define TEXTURE_STREAMER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <ktx2.hpp>
+
+#include "in_flight_counter.hpp"
+#include "texture.hpp"
+
+/**
+ * @class TextureStreamer
+ * @brief Keeps only the mip levels that are actually visible resident in VRAM.
+ *
+ * Cooked KTX2 textures start with the tail of their mip chain only (levels no
+ * larger than RESIDENT_TAIL_SIZE). While rendering, each draw reports how many
+ * texels per screen pixel it samples, derived from the mesh UV density and its
+ * distance and projected size. update() turns those reports into requests for
+ * larger levels, read from disk on the ThreadPool and uploaded one level at a
+ * time by lowering GL_TEXTURE_BASE_LEVEL.
+ *
+ * Memory is bounded by a global budget: when a level does not fit, the top mip
+ * of the least recently used texture is dropped, textures holding more detail
+ * than they currently need going first.
+ *
+ * Every method except the level reading jobs must be called from the GL context thread.
+ */
+class TextureStreamer
+{
+public:
+    /**
+     * @brief Default amount of VRAM streamed textures may use.
+     */
+    static constexpr std::size_t DEFAULT_BUDGET = 256ull * 1024ull * 1024ull; // 256 MB
+
+    /**
+     * @brief Largest side of the levels loaded up front and never evicted.
+     */
+    static constexpr std::uint32_t RESIDENT_TAIL_SIZE = 64;
+
+    /**
+     * @brief Maximum number of level reads started per update() call.
+     */
+    static constexpr std::size_t MAX_LEVEL_REQUESTS_PER_FRAME = 4;
+
+    /**
+     * @brief Gets the singleton instance of TextureStreamer.
+     *
+     * @return The TextureStreamer instance.
+     */
+    static TextureStreamer& getInstance()
+    {
+        static TextureStreamer instance;
+        return instance;
+    }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Enables or disables streaming for textures loaded from now on.
+     *
+     * @param enabled false to upload every level of cooked textures at load time.
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    /**
+     * @brief Tells whether newly loaded textures are streamed.
+     *
+     * @return true if streaming is enabled.
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Sets the VRAM budget shared by every streamed texture.
+     *
+     * @param bytes The budget in bytes.
+     */
+    void setBudget(std::size_t bytes) { m_budget = bytes; }
+
+    /**
+     * @brief Gets the VRAM budget shared by every streamed texture.
+     *
+     * @return The budget in bytes.
+     */
+    std::size_t getBudget() const { return m_budget; }
+
+    /**
+     * @brief Gets the VRAM used by streamed textures, levels being read included.
+     *
+     * @return The resident size in bytes.
+     */
+    std::size_t getResidentBytes() const { return m_residentBytes; }
+
+    /**
+     * @brief Gets the number of textures managed by the streamer.
+     *
+     * @return The number of streamed textures.
+     */
+    std::size_t streamedCount() const { return m_textures.size(); }
+
+    /**
+     * @brief Hands a texture whose tail levels were just uploaded over to the streamer.
+     *
+     * @param id The texture name.
+     * @param path The KTX2 file the missing levels are read from.
+     * @param image The partially loaded image, image.firstLevel being the resident level.
+     * @param internalFormat The OpenGL internal format the levels were uploaded with.
+     */
+    void registerTexture(GLuint id, const std::string& path, const IO::Ktx2Image& image, GLenum internalFormat);
+
+    /**
+     * @brief Sets the camera used to evaluate the draws reported until the next update().
+     *
+     * @param view The view matrix.
+     * @param projection The perspective projection matrix.
+     */
+    void setView(const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Reports a draw sampling a texture.
+     *
+     * Off-screen draws are ignored, others request the level whose texel size best
+     * matches a screen pixel.
+     *
+     * @param texture The sampled texture, with the UV density of the mesh.
+     * @param model The model matrix of the draw.
+     * @param center Center of the mesh bounding sphere, in model space.
+     * @param radius Radius of the mesh bounding sphere, in model space.
+     */
+    void reportUsage(const Texture& texture, const glm::mat4& model, const glm::vec3& center, float radius);
+
+    /**
+     * @brief Requests a level explicitly, for draws whose transform is unknown.
+     *
+     * @param id The texture name.
+     * @param level The level needed, 0 for full resolution.
+     */
+    void requestLevel(GLuint id, std::uint32_t level);
+
+    /**
+     * @brief Uploads the levels read since the last call and schedules new reads, once per frame.
+     */
+    void update();
+
+    /**
+     * @brief Waits for pending reads and forgets every texture. Must run before the GL context is destroyed.
+     */
+    void shutdown();
+
+private:
+    /**
+     * @struct StreamedTexture
+     * @brief Residency state of one streamed texture.
+     */
+    struct StreamedTexture
+    {
+        std::string path;                                  /**< The KTX2 file levels are read from. */
+        IO::Ktx2Format format = IO::Ktx2Format::UNDEFINED; /**< The pixel format of every level. */
+        GLenum internalFormat = 0;                         /**< The OpenGL internal format. */
+        std::uint32_t width = 0;                           /**< Width of level 0 in pixels. */
+        std::uint32_t height = 0;                          /**< Height of level 0 in pixels. */
+        std::vector<std::size_t> levelSizes;               /**< Byte size of every level. */
+        std::uint32_t tailLevel = 0;                       /**< Largest level loaded up front, never evicted. */
+        std::uint32_t residentLevel = 0;                   /**< Current GL_TEXTURE_BASE_LEVEL. */
+        std::uint32_t wantedLevel = 0;                     /**< Level requested by the last frame using the texture. */
+        std::uint32_t frameLevel = 0;                      /**< Finest level requested during the current frame. */
+        std::uint64_t lastUsedFrame = 0;                   /**< Last frame the texture was drawn. */
+        bool loading = false;                              /**< Whether residentLevel - 1 is being read. */
+    };
+
+    /**
+     * @struct LoadedLevel
+     * @brief Output of a level reading job, produced on a worker thread.
+     */
+    struct LoadedLevel
+    {
+        GLuint id = 0;                  /**< The texture name. */
+        std::uint32_t level = 0;        /**< The level read. */
+        std::vector<std::uint8_t> data; /**< The level payload, empty on failure. */
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer() = default;
+
+    void readLevel(GLuint id, const std::string& path, std::uint32_t level);
+    void uploadLevel(GLuint id, StreamedTexture& texture, const LoadedLevel& loaded);
+    void evictTopLevel(GLuint id, StreamedTexture& texture);
+    bool makeRoom(std::size_t bytes, GLuint requester);
+
+    std::atomic<bool> m_enabled = true;                     /**< Whether newly loaded textures are streamed. */
+    std::size_t m_budget = DEFAULT_BUDGET;                  /**< The VRAM budget in bytes. */
+    std::size_t m_residentBytes = 0;                        /**< Resident and reserved bytes. */
+    std::uint64_t m_frame = 1;                              /**< Current frame number. */
+    std::unordered_map<GLuint, StreamedTexture> m_textures; /**< Streamed textures by name, main thread only. */
+
+    glm::mat4 m_view = glm::mat4(1.0f);       /**< View matrix for the current frame. */
+    glm::mat4 m_projection = glm::mat4(1.0f); /**< Projection matrix for the current frame. */
+    float m_viewportHeight = 0.0f;            /**< Viewport height in pixels. */
+    bool m_hasView = false;                   /**< Whether setView() was called this frame. */
+
+    std::mutex m_mutex;                /**< Guards m_loaded. */
+    std::vector<LoadedLevel> m_loaded; /**< Levels read by workers, waiting for the main thread. */
+    InFlightCounter m_jobs;            /**< Reading jobs not yet finished. */
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+
+std::atomic<std::uint64_t> s_count{0};
+std::atomic<std::uint64_t> s_bytes{0};
+
+} // namespace
+
+#ifdef LAMB_ALLOCATION_COUNTER
+
+namespace
+{
+
+// Like the standard operator new: retries through the new handler until it gives up.
+// An alignment of 0 is plain malloc, anything else pairs with freeAligned().
+void* allocate(std::size_t size, std::size_t alignment)
+{
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+
+    while (true)
+    {
+        void* memory = nullptr;
+        if (alignment == 0)
+            memory = std::malloc(size);
+        else
+#ifdef _WIN32
+            memory = _aligned_malloc(size, alignment);
+#else
+            // aligned_alloc wants a multiple of the alignment.
+            memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        if (memory)
+            return memory;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void freeAligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+} // namespace
+
+// The array and nothrow forms of the standard library end up in these.
+void* operator new(std::size_t size)
+{
+    return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    freeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(memory);
+}
+
+bool AllocationCounter::isEnabled()
+{
+    return true;
+}
+
+#else
+
+bool AllocationCounter::isEnabled()
+{
+    return false;
+}
+
+#endif
+
+std::uint64_t AllocationCounter::getCount()
+{
+    return s_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AllocationCounter::getBytes()
+{
+    return s_bytes.load(std::memory_order_relaxed);
+}
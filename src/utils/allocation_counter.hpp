@@ -0,0 +1,43 @@
+#ifndef ALLOCATION_COUNTER_HPP_
+#define ALLOCATION_COUNTER_HPP_
+
+#include <cstdint>
+
+/**
+ * @class AllocationCounter
+ * @brief Counts the heap allocations made through operator new.
+ *
+ * With LAMB_ALLOCATION_COUNTER (the ENABLE_ALLOCATION_COUNTER CMake option,
+ * off by default), the engine replaces the global operator new and delete,
+ * aligned forms included, with versions that forward to malloc and free and
+ * bump two relaxed atomic counters. That costs every allocation of the
+ * program, so only turn it on to hunt allocations. The totals only grow:
+ * sample them at two points in time and compare, for instance once per frame.
+ * Without LAMB_ALLOCATION_COUNTER nothing is replaced and isEnabled() is false.
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * @brief Whether allocations are counted in this build.
+     *
+     * @return True when compiled with LAMB_ALLOCATION_COUNTER.
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Gets the number of allocations since the program started.
+     *
+     * @return The allocation count.
+     */
+    static std::uint64_t getCount();
+
+    /**
+     * @brief Gets the number of bytes allocated since the program started, frees not deducted.
+     *
+     * @return The allocated bytes.
+     */
+    static std::uint64_t getBytes();
+};
+
+#endif
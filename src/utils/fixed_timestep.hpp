@@ -0,0 +1,111 @@
+#ifndef FIXED_TIMESTEP_HPP_
+#define FIXED_TIMESTEP_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @class FixedTimestep
+ * @brief Splits variable frame times into fixed simulation steps.
+ *
+ * Frame time is accumulated in double precision and consumed in steps of
+ * 1 / rate seconds, so the simulation behaves the same at any refresh rate.
+ * The time left over is exposed as an interpolation factor for rendering.
+ *
+ * A frame runs at most maxSteps steps. When the simulation cannot keep up,
+ * the backlog beyond that is dropped instead of growing every frame, and the
+ * game slows down rather than stalling.
+ *
+ * @code
+ * timestep.advance(frameTime);
+ * while (timestep.step())
+ *     update(timestep.getStep());
+ * render(timestep.getAlpha());
+ * @endcode
+ */
+class FixedTimestep
+{
+public:
+    /**
+     * @brief Creates a timestep.
+     *
+     * @param rate The number of steps per simulated second.
+     * @param maxSteps The maximum number of steps per frame.
+     */
+    explicit FixedTimestep(double rate = 60.0, int maxSteps = 5) : m_step(1.0 / rate), m_maxSteps(maxSteps)
+    {
+        if (!(rate > 0.0) || maxSteps < 1)
+            throw std::invalid_argument("FixedTimestep needs a positive rate and at least one step per frame");
+    }
+
+    /**
+     * @brief Adds the duration of a frame to the time to simulate.
+     *
+     * @param frameTime The frame duration in seconds.
+     */
+    void advance(double frameTime)
+    {
+        m_accumulator += std::max(frameTime, 0.0);
+        m_steps = 0;
+    }
+
+    /**
+     * @brief Consumes one step of accumulated time.
+     *
+     * @return Whether a step must be simulated; call until it returns false.
+     */
+    bool step()
+    {
+        if (m_accumulator < m_step)
+            return false;
+        if (m_steps == m_maxSteps)
+        {
+            // Keeps the fraction of a step so getAlpha() stays continuous.
+            const double kept = std::fmod(m_accumulator, m_step);
+            m_droppedTime += m_accumulator - kept;
+            m_accumulator = kept;
+            return false;
+        }
+        m_accumulator -= m_step;
+        ++m_steps;
+        return true;
+    }
+
+    /**
+     * @brief Gets the duration of one step.
+     *
+     * @return The step duration in seconds.
+     */
+    double getStep() const { return m_step; }
+
+    /**
+     * @brief Gets how far the frame is between the last two simulated states.
+     *
+     * @return The interpolation factor, in [0, 1).
+     */
+    float getAlpha() const { return static_cast<float>(m_accumulator / m_step); }
+
+    /**
+     * @brief Gets the number of steps simulated since the last advance().
+     *
+     * @return The step count.
+     */
+    int getStepCount() const { return m_steps; }
+
+    /**
+     * @brief Gets the frame time dropped because a frame reached the step limit.
+     *
+     * @return The dropped time in seconds, since creation.
+     */
+    double getDroppedTime() const { return m_droppedTime; }
+
+private:
+    double m_step;              /**< The step duration in seconds. */
+    int m_maxSteps;             /**< The maximum number of steps per frame. */
+    double m_accumulator = 0.0; /**< The time not simulated yet. */
+    int m_steps = 0;            /**< The steps simulated since the last advance(). */
+    double m_droppedTime = 0.0; /**< The total time dropped by the step limit. */
+};
+
+#endif
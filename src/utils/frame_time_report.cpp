@@ -0,0 +1,73 @@
+#include "frame_time_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "log.hpp"
+
+FrameTimeReport::Summary FrameTimeReport::summarize() const
+{
+    Summary summary;
+    if (m_frameTimes.empty())
+        return summary;
+
+    std::vector<double> sorted = m_frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double fraction) {
+        const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return sorted[std::max<std::size_t>(rank, 1) - 1];
+    };
+
+    double total = 0.0;
+    for (double frameTime : sorted)
+        total += frameTime;
+
+    summary.frames = sorted.size();
+    summary.totalSeconds = total / 1000.0;
+    summary.framesPerSecond = total > 0.0 ? static_cast<double>(summary.frames) / summary.totalSeconds : 0.0;
+    summary.average = total / static_cast<double>(summary.frames);
+    summary.minimum = sorted.front();
+    summary.maximum = sorted.back();
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    return summary;
+}
+
+bool FrameTimeReport::write(const std::string& path, const std::map<std::string, std::string>& info) const
+{
+    using json = nlohmann::json;
+
+    const Summary summary = summarize();
+    json root;
+    root["info"] = info;
+    root["frames"] = summary.frames;
+    root["totalSeconds"] = summary.totalSeconds;
+    root["framesPerSecond"] = summary.framesPerSecond;
+    root["milliseconds"] = {{"average", summary.average}, {"min", summary.minimum}, {"max", summary.maximum},
+                            {"p50", summary.p50},         {"p95", summary.p95},     {"p99", summary.p99}};
+    root["counters"] = m_counters;
+    root["frameTimes"] = m_frameTimes;
+
+    const std::filesystem::path target(path);
+    std::error_code error;
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path(), error);
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file || !(file << root.dump(1) << '\n'))
+    {
+        Logger::Log(LogLevel::Error, "Failed to write frame time report " + path, "Engine");
+        return false;
+    }
+
+    Logger::Log(LogLevel::Info,
+                "Frame time report written to " + path + ": " + std::to_string(summary.frames) + " frames, p50 " +
+                    std::to_string(summary.p50) + " ms, p99 " + std::to_string(summary.p99) + " ms",
+                "Engine");
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef FRAME_TIME_REPORT_HPP_
+#define FRAME_TIME_REPORT_HPP_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @class FrameTimeReport
+ * @brief Collects the frame times of a run and summarizes them for automated comparisons.
+ *
+ * Percentiles use the nearest rank: p99 is the smallest frame time that at
+ * least 99% of the frames do not exceed.
+ */
+class FrameTimeReport
+{
+public:
+    /**
+     * @brief Statistics of the frames added so far, in milliseconds unless stated otherwise.
+     */
+    struct Summary
+    {
+        std::size_t frames = 0;       /**< The number of frames. */
+        double totalSeconds = 0.0;    /**< The sum of the frame times, in seconds. */
+        double framesPerSecond = 0.0; /**< frames / totalSeconds. */
+        double average = 0.0;         /**< The mean frame time. */
+        double minimum = 0.0;         /**< The fastest frame. */
+        double maximum = 0.0;         /**< The slowest frame. */
+        double p50 = 0.0;             /**< The median frame time. */
+        double p95 = 0.0;             /**< The 95th percentile. */
+        double p99 = 0.0;             /**< The 99th percentile. */
+    };
+
+    /**
+     * @brief Reserves room for a number of frames, so add() does not allocate during the run.
+     *
+     * @param frames The expected number of frames.
+     */
+    void reserve(std::size_t frames) { m_frameTimes.reserve(frames); }
+
+    /**
+     * @brief Adds the duration of a frame.
+     *
+     * @param frameTime The frame duration in seconds.
+     */
+    void add(double frameTime) { m_frameTimes.push_back(frameTime * 1000.0); }
+
+    /**
+     * @brief Gets the number of frames added.
+     *
+     * @return The frame count.
+     */
+    std::size_t size() const { return m_frameTimes.size(); }
+
+    /**
+     * @brief Computes the statistics of the frames added so far.
+     *
+     * @return The summary, all zeros without frames.
+     */
+    Summary summarize() const;
+
+    /**
+     * @brief Sets a figure of the run to write under "counters", such as the draw calls per frame.
+     *
+     * @param name The counter name, replacing any previous value.
+     * @param value The value.
+     */
+    void setCounter(const std::string& name, double value) { m_counters[name] = value; }
+
+    /**
+     * @brief Writes the summary, the counters and every frame time as JSON.
+     *
+     * @param path The file to write.
+     * @param info Settings of the run to store alongside, such as the scene and resolution.
+     * @return Whether the file was written.
+     */
+    bool write(const std::string& path, const std::map<std::string, std::string>& info) const;
+
+private:
+    std::vector<double> m_frameTimes;         /**< The frame times in milliseconds, in order. */
+    std::map<std::string, double> m_counters; /**< Figures set with setCounter(). */
+};
+
+#endif
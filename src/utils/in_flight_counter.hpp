@@ -0,0 +1,65 @@
+#ifndef IN_FLIGHT_COUNTER_HPP_
+#define IN_FLIGHT_COUNTER_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * @class InFlightCounter
+ * @brief Counts background jobs that have not finished yet, and lets a thread sleep until there are none.
+ *
+ * A job is added before it is submitted and marked done as its very last step,
+ * after its result is handed back, so once wait() returns every result is
+ * visible to the waiting thread.
+ */
+class InFlightCounter
+{
+public:
+    /**
+     * @brief Counts a job about to be submitted.
+     */
+    void add()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_count++;
+    }
+
+    /**
+     * @brief Marks a job finished, waking the waiters when it was the last one.
+     */
+    void done()
+    {
+        // Notified under the lock, so a waiter returning cannot see the counter go away before this ends.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_count == 0)
+            m_idle.notify_all();
+    }
+
+    /**
+     * @brief Gets the number of jobs not finished yet.
+     *
+     * @return The count.
+     */
+    std::size_t count() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    /**
+     * @brief Blocks until every job added so far is done.
+     */
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_count == 0; });
+    }
+
+private:
+    mutable std::mutex m_mutex;             /**< Guards m_count. */
+    mutable std::condition_variable m_idle; /**< Notified when m_count drops to zero. */
+    std::size_t m_count = 0;                /**< Jobs added and not done yet. */
+};
+
+#endif
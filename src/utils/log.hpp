@@ -1,18 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <unordered_map>
 
+#include "mpsc_ring.hpp"
+
 enum class LogLevel
 {
     Info,
@@ -20,6 +27,14 @@ enum class LogLevel
     Error
 };
 
+// What Logger::Log does when the ring is full, that is when the worker falls behind.
+enum class LogOverflowPolicy
+{
+    Drop,  // discard the message
+    Count, // discard it, count it, and have the worker report how many were lost
+    Block  // wait for the worker to free a slot
+};
+
 class Logger
 {
 public:
@@ -39,6 +54,17 @@ public:
         }
     }
 
+    static void SetOverflowPolicy(LogOverflowPolicy policy)
+    {
+        Get().m_OverflowPolicy.store(policy, std::memory_order_relaxed);
+    }
+
+    // Messages lost to a full ring since the start, except under LogOverflowPolicy::Drop.
+    static std::uint64_t GetDroppedCount()
+    {
+        return Get().m_Dropped.load(std::memory_order_relaxed);
+    }
+
     static void RegisterSubsystemFile(const std::string& subsystem, const std::string& filePath, bool append = true)
     {
         Logger& inst = Get();
@@ -75,8 +101,9 @@ public:
         }
         inst.m_Cv.notify_all();
 
-        if (inst.m_WorkerStarted && inst.m_WorkerThread.joinable())
+        if (inst.m_WorkerThread.joinable())
             inst.m_WorkerThread.join();
+        inst.m_WorkerStarted = false;
 
         std::lock_guard<std::mutex> lock(inst.m_Mutex);
         for (auto& [subsystem, info] : inst.m_FileStreams)
@@ -92,12 +119,76 @@ public:
 #ifdef DEBUG
         Logger& inst = Get();
 
+        // Allocates before claiming a slot: a slot must be published once claimed.
+        std::unique_ptr<std::string> longMessage;
+        if (msg.size() > MESSAGE_CAPACITY)
+            longMessage = std::make_unique<std::string>(msg);
+        std::unique_ptr<std::string> longSubsystem;
+        if (subsystem.size() > SUBSYSTEM_CAPACITY)
+            longSubsystem = std::make_unique<std::string>(subsystem);
+
+        const auto time = std::chrono::system_clock::now();
+        const auto thread = std::this_thread::get_id();
+        auto fill = [&](LogRecord& record) {
+            record.level = level;
+            record.time = time;
+            record.thread = thread;
+            if (longSubsystem)
+            {
+                record.subsystemLength = 0;
+                record.longSubsystem = std::move(longSubsystem);
+            }
+            else
+            {
+                record.subsystemLength = static_cast<std::uint8_t>(subsystem.size());
+                std::memcpy(record.subsystem, subsystem.data(), subsystem.size());
+            }
+            if (longMessage)
+            {
+                record.messageLength = 0;
+                record.longMessage = std::move(longMessage);
+            }
+            else
+            {
+                record.messageLength = static_cast<std::uint16_t>(msg.size());
+                std::memcpy(record.message, msg.data(), msg.size());
+            }
+        };
+
+        if (!inst.m_Ring.tryPush(fill))
         {
-            std::lock_guard<std::mutex> lock(inst.m_Mutex);
-            inst.m_Queue.push_back(LogMessage{level, msg, subsystem});
+            switch (inst.m_OverflowPolicy.load(std::memory_order_relaxed))
+            {
+                case LogOverflowPolicy::Drop:
+                    return;
+                case LogOverflowPolicy::Count:
+                    inst.m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case LogOverflowPolicy::Block:
+                    // Without a worker nothing would free a slot, so the message counts as dropped.
+                    while (!inst.m_Ring.tryPush(fill))
+                    {
+                        if (!inst.m_WorkerStarted.load(std::memory_order_relaxed))
+                        {
+                            inst.m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                            return;
+                        }
+                        inst.m_Cv.notify_one();
+                        std::this_thread::yield();
+                    }
+                    break;
+            }
         }
 
-        inst.m_Cv.notify_one();
+        // The worker polls while busy, so only an idle one needs waking. The fence pairs with the one in
+        // WorkerLoop(): either the worker sees the record before sleeping, or this sees the flag set.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (inst.m_WorkerWaiting.load(std::memory_order_seq_cst))
+        {
+            // The worker sets the flag under the mutex, so once it is ours the worker is inside wait_for().
+            std::lock_guard<std::mutex> lock(inst.m_Mutex);
+            inst.m_Cv.notify_one();
+        }
 #else
         (void)level;
         (void)msg;
@@ -109,11 +200,24 @@ private:
     Logger() = default;
     ~Logger() = default;
 
-    struct LogMessage
+    static constexpr std::size_t RING_CAPACITY = 8192;    // records, about 2 MB
+    static constexpr std::size_t BATCH_SIZE = 256;        // records written per lock and flush
+    static constexpr std::size_t SUBSYSTEM_CAPACITY = 23; // longer subsystem names go to the heap
+    static constexpr std::size_t MESSAGE_CAPACITY = 176;  // longer messages go to the heap
+    static constexpr auto IDLE_WAIT = std::chrono::milliseconds(10);
+
+    // Fixed size, so producers copy into a slot of the ring instead of allocating.
+    struct LogRecord
     {
-        LogLevel level;
-        std::string message;
-        std::string subsystem;
+        LogLevel level = LogLevel::Info;
+        std::uint8_t subsystemLength = 0;
+        std::uint16_t messageLength = 0;
+        std::chrono::system_clock::time_point time;
+        std::thread::id thread;
+        char subsystem[SUBSYSTEM_CAPACITY];
+        char message[MESSAGE_CAPACITY];
+        std::unique_ptr<std::string> longSubsystem; // set instead of subsystem when it does not fit
+        std::unique_ptr<std::string> longMessage;   // set instead of message when it does not fit
     };
 
     struct FileInfo
@@ -121,6 +225,7 @@ private:
         std::ofstream stream;
         std::filesystem::path basePath;
         std::size_t rotationIndex = 0;
+        bool pendingFlush = false;
     };
 
     static Logger& Get()
@@ -133,49 +238,108 @@ private:
     {
         while (true)
         {
-            LogMessage entry;
-
-            {
-                std::unique_lock<std::mutex> lock(m_Mutex);
-                m_Cv.wait(lock, [&] { return m_Exit || !m_Queue.empty(); });
+            // Read before draining: whatever was logged before Shutdown() is written.
+            const bool exit = m_Exit;
+            if (DrainBatch() > 0)
+                continue;
+            if (exit)
+                break;
+
+            // The fence orders the flag before the emptiness check, against the one in Log().
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkerWaiting.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_Cv.wait_for(lock, IDLE_WAIT, [&] { return m_Exit || !m_Ring.empty(); });
+            m_WorkerWaiting.store(false, std::memory_order_seq_cst);
+        }
+    }
 
-                if (m_Exit && m_Queue.empty())
-                    break;
+    std::size_t DrainBatch()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
 
-                entry = std::move(m_Queue.front());
-                m_Queue.pop_front();
-            }
+        auto consume = [this](LogRecord& record) {
+            ProcessRecord(record);
+            record.longSubsystem.reset();
+            record.longMessage.reset();
+        };
+        std::size_t count = 0;
+        while (count < BATCH_SIZE && m_Ring.tryPop(consume))
+            ++count;
+
+        ReportDropped();
+        FlushBatch();
+        return count;
+    }
 
-            ProcessEntry(entry);
-        }
+    void ProcessRecord(const LogRecord& record)
+    {
+        const std::string subsystem =
+            record.longSubsystem ? *record.longSubsystem : std::string(record.subsystem, record.subsystemLength);
+        if (record.longMessage)
+            ProcessEntry(record.level, *record.longMessage, subsystem, record.time, record.thread);
+        else
+            ProcessEntry(record.level, std::string(record.message, record.messageLength), subsystem, record.time,
+                         record.thread);
     }
 
-    void ProcessEntry(const LogMessage& entry)
+    void ReportDropped()
     {
-        std::lock_guard<std::mutex> lock(m_Mutex);
+        const std::uint64_t dropped = m_Dropped.load(std::memory_order_relaxed);
+        if (dropped == m_DroppedReported)
+            return;
+
+        const std::string message = std::to_string(dropped - m_DroppedReported) +
+                                    " messages dropped, the log ring was full";
+        m_DroppedReported = dropped;
+        ProcessEntry(LogLevel::Warning, message, "Global", std::chrono::system_clock::now(),
+                     std::this_thread::get_id());
+    }
 
-        std::string line = m_JsonMode ? FormatJsonLine(entry.level, entry.message, entry.subsystem)
-                                      : FormatTextLine(entry.level, entry.message, entry.subsystem);
+    // Lines are buffered for the whole batch, then written with one flush per output.
+    void ProcessEntry(LogLevel level, const std::string& message, const std::string& subsystem,
+                      std::chrono::system_clock::time_point time, std::thread::id thread)
+    {
+        std::string line = m_JsonMode ? FormatJsonLine(level, message, subsystem, time, thread)
+                                      : FormatTextLine(level, message, subsystem, time, thread);
 
         if (m_EnableConsole)
         {
             if (m_UseColors && !m_JsonMode)
             {
-                const char* color = ColorForLevel(entry.level);
-                std::cout << color << line << "\033[0m" << std::endl;
+                const char* color = ColorForLevel(level);
+                m_ConsoleBuffer.append(color).append(line).append("\033[0m\n");
             }
             else
             {
-                std::cout << line << std::endl;
+                m_ConsoleBuffer.append(line).append("\n");
             }
         }
 
-        WriteToSubsystemFile(entry.subsystem, line);
+        WriteToSubsystemFile(subsystem, line);
 
-        if (entry.subsystem != "Global")
+        if (subsystem != "Global")
             WriteToSubsystemFile("Global", line);
     }
 
+    void FlushBatch()
+    {
+        if (!m_ConsoleBuffer.empty())
+        {
+            std::cout << m_ConsoleBuffer << std::flush;
+            m_ConsoleBuffer.clear();
+        }
+
+        for (auto& [subsystem, info] : m_FileStreams)
+        {
+            if (info.pendingFlush)
+            {
+                info.stream.flush();
+                info.pendingFlush = false;
+            }
+        }
+    }
+
     void WriteToSubsystemFile(const std::string& subsystem, const std::string& line)
     {
         auto it = m_FileStreams.find(subsystem);
@@ -204,7 +368,8 @@ private:
         {
         }
 
-        info.stream << line << std::endl;
+        info.stream << line << '\n';
+        info.pendingFlush = true;
     }
 
     void RotateFile(FileInfo& info)
@@ -232,22 +397,24 @@ private:
         }
     }
 
-    std::string FormatTextLine(LogLevel level, const std::string& msg, const std::string& subsystem)
+    std::string FormatTextLine(LogLevel level, const std::string& msg, const std::string& subsystem,
+                               std::chrono::system_clock::time_point time, std::thread::id thread)
     {
         std::ostringstream oss;
-        oss << "[" << MakeTimestamp() << "]"
-            << " [T:" << ThreadIdString() << "]"
+        oss << "[" << MakeTimestamp(time) << "]"
+            << " [T:" << ThreadIdString(thread) << "]"
             << " [" << subsystem << "]"
             << " [" << LevelToString(level) << "] " << msg;
         return oss.str();
     }
 
-    std::string FormatJsonLine(LogLevel level, const std::string& msg, const std::string& subsystem)
+    std::string FormatJsonLine(LogLevel level, const std::string& msg, const std::string& subsystem,
+                               std::chrono::system_clock::time_point time, std::thread::id thread)
     {
         std::ostringstream oss;
         oss << "{"
-            << "\"timestamp\":\"" << EscapeJson(MakeTimestamp()) << "\","
-            << "\"thread\":\"" << EscapeJson(ThreadIdString()) << "\","
+            << "\"timestamp\":\"" << EscapeJson(MakeTimestamp(time)) << "\","
+            << "\"thread\":\"" << EscapeJson(ThreadIdString(thread)) << "\","
             << "\"subsystem\":\"" << EscapeJson(subsystem) << "\","
             << "\"level\":\"" << EscapeJson(LevelToString(level)) << "\","
             << "\"message\":\"" << EscapeJson(msg) << "\""
@@ -255,30 +422,48 @@ private:
         return oss.str();
     }
 
-    static std::string MakeTimestamp()
+    // Worker only: the date and time are formatted once per second, a batch usually shares them.
+    std::string MakeTimestamp(std::chrono::system_clock::time_point now)
     {
         using namespace std::chrono;
-        auto now = system_clock::now();
         auto t = system_clock::to_time_t(now);
         auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
 
-        std::tm tm{};
+        if (t != m_TimestampSecond || m_TimestampPrefix.empty())
+        {
+            std::tm tm{};
 #ifdef _WIN32
-        localtime_s(&tm, &t);
+            localtime_s(&tm, &t);
 #else
-        localtime_r(&t, &tm);
+            localtime_r(&t, &tm);
 #endif
 
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.' << std::setw(3) << std::setfill('0') << ms.count();
-        return oss.str();
+            std::ostringstream oss;
+            oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.';
+            m_TimestampPrefix = oss.str();
+            m_TimestampSecond = t;
+        }
+
+        const auto millis = static_cast<int>(ms.count());
+        std::string timestamp = m_TimestampPrefix;
+        timestamp += static_cast<char>('0' + millis / 100);
+        timestamp += static_cast<char>('0' + millis / 10 % 10);
+        timestamp += static_cast<char>('0' + millis % 10);
+        return timestamp;
     }
 
-    static std::string ThreadIdString()
+    // Worker only: the id is formatted again only when the thread changes, runs of records usually share it.
+    // Only the last one is kept, so threads that come and go do not grow a cache.
+    const std::string& ThreadIdString(std::thread::id thread)
     {
-        std::ostringstream oss;
-        oss << std::this_thread::get_id();
-        return oss.str();
+        if (thread != m_FormattedThread || m_FormattedThreadId.empty())
+        {
+            std::ostringstream oss;
+            oss << thread;
+            m_FormattedThreadId = oss.str();
+            m_FormattedThread = thread;
+        }
+        return m_FormattedThreadId;
     }
 
     static std::string EscapeJson(const std::string& s)
@@ -366,10 +551,21 @@ private:
 
     std::unordered_map<std::string, FileInfo> m_FileStreams;
 
-    std::deque<LogMessage> m_Queue;
+    MpscRing<LogRecord> m_Ring{RING_CAPACITY};
+    std::atomic<LogOverflowPolicy> m_OverflowPolicy{LogOverflowPolicy::Count};
+    std::atomic<std::uint64_t> m_Dropped{0};
+    std::uint64_t m_DroppedReported = 0; // worker only
+    std::string m_ConsoleBuffer;         // lines of the current batch, worker only
+    std::time_t m_TimestampSecond = 0;   // second of m_TimestampPrefix, worker only
+    std::string m_TimestampPrefix;       // "YYYY-MM-DD HH:MM:SS.", worker only
+    std::thread::id m_FormattedThread;   // thread of m_FormattedThreadId, worker only
+    std::string m_FormattedThreadId;     // last thread id formatted, worker only
+
+    // The outputs and settings. Producers take it only to notify a worker sleeping on m_Cv, never to log.
     std::mutex m_Mutex;
     std::condition_variable m_Cv;
     std::thread m_WorkerThread;
-    bool m_WorkerStarted = false;
-    bool m_Exit = false;
+    std::atomic<bool> m_WorkerStarted{false};
+    std::atomic<bool> m_WorkerWaiting{false};
+    std::atomic<bool> m_Exit{false};
 };
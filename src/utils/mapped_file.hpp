@@ -0,0 +1,58 @@
+#ifndef MAPPED_FILE_HPP_
+#define MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The pages are loaded by the OS on first access, so data can be handed to the
+ * GPU straight from the page cache without being copied or parsed first.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Maps a file.
+     *
+     * @param path The file to map.
+     *
+     * @throw std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Gets the mapped bytes.
+     *
+     * @return The start of the file, nullptr if nothing is mapped.
+     */
+    const std::uint8_t* data() const { return m_data; }
+
+    /**
+     * @brief Gets the size of the mapping.
+     *
+     * @return The file size in bytes.
+     */
+    std::size_t size() const { return m_size; }
+
+private:
+    void close();
+
+    const std::uint8_t* m_data = nullptr; /**< Start of the mapping. */
+    std::size_t m_size = 0;               /**< Size of the mapping. */
+    void* m_mapping = nullptr;            /**< Platform mapping handle, Windows only. */
+};
+
+#endif
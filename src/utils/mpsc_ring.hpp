@@ -0,0 +1,137 @@
+#ifndef MPSC_RING_HPP_
+#define MPSC_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class MpscRing
+ * @brief Bounded lock-free queue of fixed-size slots for many producers and one consumer.
+ *
+ * Every slot carries a sequence number that says whose turn it is. A producer
+ * claims the next position with a compare-and-swap, fills the slot in place,
+ * then publishes it with a release store of the sequence; the consumer reads
+ * it after an acquire load and hands it back the same way. Nothing allocates
+ * after construction, and producers never wait for each other or for the
+ * consumer: tryPush() fails when the ring is full and leaves the choice to
+ * the caller.
+ *
+ * @tparam T The slot type, default constructible. Slots are reused, so T keeps
+ * whatever the consumer leaves in it.
+ */
+template <typename T>
+class MpscRing
+{
+public:
+    /**
+     * @brief Allocates the slots.
+     *
+     * @param capacity Number of slots, rounded up to a power of two (at least 2).
+     */
+    explicit MpscRing(std::size_t capacity)
+    {
+        m_capacity = 2;
+        while (m_capacity < capacity)
+            m_capacity <<= 1;
+        m_mask = m_capacity - 1;
+
+        m_slots = std::make_unique<Slot[]>(m_capacity);
+        for (std::size_t i = 0; i < m_capacity; ++i)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Gets the number of slots.
+     *
+     * @return The capacity, a power of two.
+     */
+    std::size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Claims a slot and fills it in place. Safe from any thread.
+     *
+     * @param fill Called as fill(T&) on the claimed slot before it is published; must not throw.
+     * @return False, without calling fill, if the ring is full.
+     */
+    template <typename Fill>
+    bool tryPush(Fill&& fill)
+    {
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &m_slots[position & m_mask];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                // The consumer has not released this slot since the last lap.
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(slot->value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest published slot. Only one thread may consume.
+     *
+     * @param consume Called as consume(T&) on the slot before it is released to producers.
+     * @return False, without calling consume, if no slot is published yet.
+     */
+    template <typename Consume>
+    bool tryPop(Consume&& consume)
+    {
+        Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+            return false;
+
+        consume(slot.value);
+        slot.sequence.store(m_dequeuePosition + m_capacity, std::memory_order_release);
+        ++m_dequeuePosition;
+        return true;
+    }
+
+    /**
+     * @brief Whether the next slot to consume is not published yet. Consumer thread only.
+     *
+     * @return True if tryPop() would fail.
+     */
+    bool empty() const
+    {
+        const Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        return slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1;
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<std::size_t> sequence{0}; /**< The position it is free for, that + 1 once published. */
+        T value{};                            /**< The payload, filled in place. */
+    };
+
+    std::unique_ptr<Slot[]> m_slots; /**< The ring, m_capacity slots. */
+    std::size_t m_capacity = 0;      /**< Number of slots, a power of two. */
+    std::size_t m_mask = 0;          /**< m_capacity - 1. */
+
+    alignas(64) std::atomic<std::size_t> m_enqueuePosition{0}; /**< Next position to claim. */
+    alignas(64) std::size_t m_dequeuePosition = 0;             /**< Next position to consume, consumer only. */
+};
+
+#endif
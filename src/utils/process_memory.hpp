@@ -0,0 +1,25 @@
+#ifndef PROCESS_MEMORY_HPP_
+#define PROCESS_MEMORY_HPP_
+
+#include <cstdint>
+
+/**
+ * @class ProcessMemory
+ * @brief Reads the memory use of the process from the OS.
+ *
+ * The peak resident set, or peak working set on Windows, covers everything
+ * the process touched: heap, stacks, mapped files and the driver's own
+ * allocations, which the engine's counters do not see.
+ */
+class ProcessMemory
+{
+public:
+    /**
+     * @brief Gets the largest amount of physical memory the process has used.
+     *
+     * @return The peak resident set in bytes, or 0 where it cannot be read.
+     */
+    static std::uint64_t getPeakResidentBytes();
+};
+
+#endif
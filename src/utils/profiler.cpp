@@ -0,0 +1,284 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+
+#include "log.hpp"
+
+namespace
+{
+
+thread_local Profiler::Track* t_track = nullptr;
+
+void writeEscaped(std::ofstream& out, const std::string& text)
+{
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) >= 0x20)
+            out << c;
+    }
+}
+
+void writeTimestamp(std::ofstream& out, std::int64_t nanoseconds)
+{
+    // Trace timestamps are in microseconds.
+    out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+}
+
+} // namespace
+
+struct Profiler::Track
+{
+    std::uint32_t id = 0;                                 /**< The index in m_tracks. */
+    std::string name;                                     /**< The thread or track name, guarded by m_mutex. */
+    bool steadyTime = false;                              /**< Whether timestamps are steady nanoseconds, not ticks. */
+    std::array<std::atomic<Event*>, MAX_CHUNKS> chunks{}; /**< The event chunks, allocated on demand. */
+    std::atomic<std::size_t> count{0};                    /**< The published event count. */
+    std::size_t captureStart = 0;                         /**< The count when the capture started. */
+    std::size_t captureEnd = 0;                           /**< The count when it stopped. */
+};
+
+Profiler::Profiler() : m_anchorTicks(now()), m_anchorTime(steadyNanoseconds())
+{
+}
+
+Profiler::~Profiler()
+{
+    for (const auto& track : m_tracks)
+    {
+        for (std::atomic<Event*>& chunk : track->chunks)
+            delete[] chunk.load();
+    }
+}
+
+Profiler::Track& Profiler::createTrack(const std::string& name, bool steadyTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto track = std::make_unique<Track>();
+    track->id = static_cast<std::uint32_t>(m_tracks.size());
+    track->name = name;
+    track->steadyTime = steadyTime;
+    m_tracks.push_back(std::move(track));
+    return *m_tracks.back();
+}
+
+Profiler::Track& Profiler::threadTrack()
+{
+    if (!t_track)
+        t_track = &createTrack("", false);
+    return *t_track;
+}
+
+Profiler::Track* Profiler::addTrack(const std::string& name)
+{
+    return &createTrack(name, true);
+}
+
+void Profiler::calibrate() const
+{
+#ifdef PROFILER_USE_TSC
+    const std::int64_t ticks = now() - m_anchorTicks;
+    const std::int64_t time = steadyNanoseconds() - m_anchorTime;
+    // Too short a time to measure the rate keeps the previous one.
+    if (ticks > 0 && time > 1000000)
+        m_nanosecondsPerTick = static_cast<double>(time) / static_cast<double>(ticks);
+#endif
+}
+
+void Profiler::start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& track : m_tracks)
+    {
+        track->captureStart = track->count.load(std::memory_order_acquire);
+        track->captureEnd = track->captureStart;
+    }
+    m_capturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capturing.store(false, std::memory_order_relaxed);
+    for (const auto& track : m_tracks)
+        track->captureEnd = track->count.load(std::memory_order_acquire);
+    calibrate();
+}
+
+void Profiler::append(Track& track, const Event& event)
+{
+    // Only the owner writes the count, so it can read its own value relaxed.
+    const std::size_t index = track.count.load(std::memory_order_relaxed);
+    const std::size_t chunkIndex = index / CHUNK_SIZE % MAX_CHUNKS;
+    Event* chunk = track.chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = new Event[CHUNK_SIZE];
+        track.chunks[chunkIndex].store(chunk, std::memory_order_relaxed);
+    }
+    chunk[index % CHUNK_SIZE] = event;
+    track.count.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::record(const char* name, std::int64_t start, std::int64_t end)
+{
+    append(threadTrack(), Event{name, start, end});
+}
+
+void Profiler::recordOnTrack(Track* track, const char* name, std::int64_t start, std::int64_t end)
+{
+    append(*track, Event{name, start, end});
+}
+
+void Profiler::markFrame()
+{
+    if (!isCapturing())
+        return;
+    record("Frame", now(), INSTANT);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    Track& track = threadTrack();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    track.name = name;
+}
+
+void Profiler::copyEvents(const Track& track, std::size_t begin, std::size_t end,
+                          std::vector<ThreadEvents>& out) const
+{
+    // Older events were overwritten by the ring.
+    begin = std::max(std::min(begin, end), end - std::min(end, CAPACITY));
+    if (begin == end)
+        return;
+
+    auto toNanoseconds = [this](std::int64_t ticks) {
+        const double elapsed = static_cast<double>(ticks - m_anchorTicks) * m_nanosecondsPerTick;
+        return m_anchorTime + static_cast<std::int64_t>(elapsed);
+    };
+
+    ThreadEvents thread{track.id, track.name, {}};
+    thread.events.reserve(end - begin);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Event event = track.chunks[i / CHUNK_SIZE % MAX_CHUNKS].load(std::memory_order_relaxed)[i % CHUNK_SIZE];
+        if (!track.steadyTime)
+        {
+            event.start = toNanoseconds(event.start);
+            if (event.end != INSTANT)
+                event.end = toNanoseconds(event.end);
+        }
+        thread.events.push_back(event);
+    }
+
+    // The owner may have lapped the ring while we copied. The slots it wrote since, and the one it may be
+    // writing now, hold torn events; only the CAPACITY - 1 events before the count read here are whole.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::size_t written = track.count.load(std::memory_order_relaxed);
+    const std::size_t firstWhole = written >= CAPACITY ? written - CAPACITY + 1 : 0;
+    if (firstWhole > begin)
+        thread.events.erase(thread.events.begin(),
+                            thread.events.begin() + static_cast<std::ptrdiff_t>(std::min(firstWhole, end) - begin));
+    if (!thread.events.empty())
+        out.push_back(std::move(thread));
+}
+
+std::vector<Profiler::ThreadEvents> Profiler::collect() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool capturing = isCapturing();
+    if (capturing)
+        calibrate();
+
+    std::vector<ThreadEvents> threads;
+    for (const auto& track : m_tracks)
+    {
+        const std::size_t end = capturing ? track->count.load(std::memory_order_acquire) : track->captureEnd;
+        copyEvents(*track, track->captureStart, end, threads);
+    }
+    return threads;
+}
+
+std::vector<Profiler::ThreadEvents> Profiler::collectNew(std::vector<std::size_t>& cursors) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    calibrate();
+
+    std::vector<ThreadEvents> threads;
+    cursors.resize(m_tracks.size(), 0);
+    for (const auto& track : m_tracks)
+    {
+        const std::size_t end = track->count.load(std::memory_order_acquire);
+        copyEvents(*track, cursors[track->id], end, threads);
+        cursors[track->id] = end;
+    }
+    return threads;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const
+{
+    const std::vector<ThreadEvents> threads = collect();
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        Logger::Log(LogLevel::Error, "Failed to open profiler trace " + path, "Engine");
+        return false;
+    }
+
+    std::size_t eventCount = 0;
+    bool first = true;
+    auto separator = [&]() {
+        if (!first)
+            out << ",\n";
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const ThreadEvents& thread : threads)
+    {
+        if (!thread.name.empty())
+        {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.id
+                << ",\"args\":{\"name\":\"";
+            writeEscaped(out, thread.name);
+            out << "\"}}";
+        }
+
+        for (const Event& event : thread.events)
+        {
+            separator();
+            out << "{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"pid\":1,\"tid\":" << thread.id << ",\"ts\":";
+            writeTimestamp(out, event.start);
+            if (event.end == INSTANT)
+            {
+                out << ",\"ph\":\"i\",\"s\":\"g\"}";
+            }
+            else
+            {
+                out << ",\"ph\":\"X\",\"dur\":";
+                writeTimestamp(out, event.end - event.start);
+                out << '}';
+            }
+        }
+        eventCount += thread.events.size();
+    }
+    out << "\n]}\n";
+
+    if (!out)
+    {
+        Logger::Log(LogLevel::Error, "Failed to write profiler trace " + path, "Engine");
+        return false;
+    }
+
+    Logger::Log(LogLevel::Info, "Profiler trace written to " + path + ": " + std::to_string(eventCount) + " events",
+                "Engine");
+    return true;
+}
@@ -0,0 +1,252 @@
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PROFILER_USE_TSC
+#endif
+
+/**
+ * @class Profiler
+ * @brief Records timed zones per thread and exports them as a Chrome trace.
+ *
+ * Each thread appends to its own buffer, so recording takes no lock: the
+ * owner writes an event, then publishes it with a release store of the
+ * count. Buffers are rings of fixed chunks, allocated on first use and
+ * never moved or freed, so the exporter can read while threads keep
+ * recording. A thread keeps its last CAPACITY events. Events timed on other
+ * clocks, such as GPU queries, go to named tracks added with addTrack().
+ *
+ * On x86-64, zones are timed with the time stamp counter, which costs a few
+ * nanoseconds where the OS clock costs tens. The counter is calibrated
+ * against the steady clock since the profiler was created.
+ *
+ * Instrument code with the PROFILE_* macros rather than calling the class
+ * directly: they compile to nothing unless LAMB_PROFILER is defined (the
+ * ENABLE_PROFILER CMake option). Zones only record between start() and stop().
+ * Open the output of writeChromeTrace() in about:tracing or ui.perfetto.dev.
+ */
+class Profiler
+{
+public:
+    /**
+     * @brief A timed zone, or an instant event when end is INSTANT.
+     *
+     * Recorded in now() ticks; collect() converts them to nanoseconds.
+     */
+    struct Event
+    {
+        const char* name;   /**< The zone name, a string with static storage duration. */
+        std::int64_t start; /**< Start timestamp. */
+        std::int64_t end;   /**< End timestamp. */
+    };
+
+    static constexpr std::int64_t INSTANT = -1; /**< The end of instant events. */
+
+    /**
+     * @brief The event buffer of a thread or of a track added with addTrack().
+     */
+    struct Track;
+
+    /**
+     * @brief A copy of the events one thread recorded during the capture.
+     */
+    struct ThreadEvents
+    {
+        std::uint32_t id;          /**< The thread or track index, in order of first use. */
+        std::string name;          /**< The name set with setThreadName() or addTrack(), may be empty. */
+        std::vector<Event> events; /**< The events, in completion order. */
+    };
+
+    static Profiler& getInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Starts a capture. Events recorded by a previous capture are left out of the next export.
+     */
+    void start();
+
+    /**
+     * @brief Stops the capture. Zones still open finish, but are not exported.
+     */
+    void stop();
+
+    /**
+     * @brief Whether a capture is running.
+     *
+     * @return True between start() and stop().
+     */
+    bool isCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records a finished zone on the calling thread.
+     *
+     * @param name The zone name, which must outlive the profiler.
+     * @param start The start timestamp from now().
+     * @param end The end timestamp from now().
+     */
+    void record(const char* name, std::int64_t start, std::int64_t end);
+
+    /**
+     * @brief Records a frame boundary, shown as a global instant event.
+     */
+    void markFrame();
+
+    /**
+     * @brief Names the calling thread in exported traces.
+     *
+     * @param name The thread name.
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief Adds a track for events that do not come from CPU zones, shown as its own thread.
+     *
+     * @param name The track name.
+     * @return The track, valid as long as the profiler.
+     */
+    Track* addTrack(const std::string& name);
+
+    /**
+     * @brief Records an event on a track. A track must only be recorded to by one thread at a time.
+     *
+     * @param track The track from addTrack().
+     * @param name The event name, which must outlive the profiler.
+     * @param start The start timestamp from steadyNanoseconds().
+     * @param end The end timestamp from steadyNanoseconds(), or INSTANT.
+     */
+    void recordOnTrack(Track* track, const char* name, std::int64_t start, std::int64_t end);
+
+    /**
+     * @brief Copies the events of the current or last capture.
+     *
+     * @return The events of every thread that recorded some, with timestamps in nanoseconds of the steady clock.
+     */
+    std::vector<ThreadEvents> collect() const;
+
+    /**
+     * @brief Copies the events recorded since the previous call with the same cursors, for live displays.
+     *
+     * @param cursors The read position of every track, updated. Start with an empty vector.
+     * @return The new events, with timestamps in nanoseconds of the steady clock.
+     */
+    std::vector<ThreadEvents> collectNew(std::vector<std::size_t>& cursors) const;
+
+    /**
+     * @brief Writes the current or last capture in the Chrome trace event format.
+     *
+     * @param path The JSON file to write.
+     * @return Whether the file was written.
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /**
+     * @brief Gets a timestamp for record().
+     *
+     * @return Ticks of the time stamp counter, or nanoseconds of the steady clock without one.
+     */
+    static std::int64_t now()
+    {
+#ifdef PROFILER_USE_TSC
+        return static_cast<std::int64_t>(__rdtsc());
+#else
+        return steadyNanoseconds();
+#endif
+    }
+
+    /**
+     * @brief Gets the time of the steady clock, which collect() reports in.
+     *
+     * @return Nanoseconds from the steady clock.
+     */
+    static std::int64_t steadyNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static constexpr std::size_t CHUNK_SIZE = 16384;                 /**< Events per buffer chunk. */
+    static constexpr std::size_t MAX_CHUNKS = 64;                    /**< Chunks per thread. */
+    static constexpr std::size_t CAPACITY = CHUNK_SIZE * MAX_CHUNKS; /**< Events per thread, about 1M. */
+
+private:
+    Profiler();
+    ~Profiler();
+
+    Track& threadTrack();
+    Track& createTrack(const std::string& name, bool steadyTime);
+    static void append(Track& track, const Event& event);
+    void calibrate() const;
+    void copyEvents(const Track& track, std::size_t begin, std::size_t end, std::vector<ThreadEvents>& out) const;
+
+    std::atomic<bool> m_capturing{false};         /**< Whether zones record. */
+    std::int64_t m_anchorTicks;                   /**< now() when the profiler was created. */
+    std::int64_t m_anchorTime;                    /**< The steady clock at the same time. */
+    mutable double m_nanosecondsPerTick = 1.0;    /**< The now() rate, guarded by m_mutex. */
+    mutable std::mutex m_mutex;                   /**< Guards the track list and capture bounds. */
+    std::vector<std::unique_ptr<Track>> m_tracks; /**< One per thread that recorded and per added track. */
+};
+
+/**
+ * @class ProfileZone
+ * @brief Times its own lifetime. Use PROFILE_ZONE or PROFILE_FUNCTION.
+ */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_name(name), m_start(Profiler::getInstance().isCapturing() ? Profiler::now() : -1)
+    {
+    }
+
+    ~ProfileZone()
+    {
+        if (m_start >= 0)
+            Profiler::getInstance().record(m_name, m_start, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;   /**< The zone name. */
+    std::int64_t m_start; /**< The start timestamp, -1 when not capturing. */
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef LAMB_PROFILER
+// Times the enclosing scope; name must be a string literal.
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_FRAME() Profiler::getInstance().markFrame()
+#define PROFILE_THREAD(name) Profiler::getInstance().setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of worker threads consuming a FIFO task queue.
+ *
+ * Tasks must not touch the OpenGL context: the context lives on the main thread,
+ * so workers only do CPU work (decoding, parsing) and hand results back.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Gets the engine-wide pool, sized to the hardware concurrency minus the main thread.
+     *
+     * @return The shared ThreadPool instance.
+     */
+    static ThreadPool& getInstance()
+    {
+        static ThreadPool instance;
+        return instance;
+    }
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threadCount Number of workers, 0 picks hardware_concurrency() - 1 (at least 1).
+     */
+    explicit ThreadPool(std::size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+        {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            threadCount = std::max(1u, hardware > 1 ? hardware - 1 : 1u);
+        }
+
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i)
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    /**
+     * @brief Drains the remaining tasks and joins the workers.
+     */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+        m_cv.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution on a worker thread.
+     *
+     * @param task Callable taking no argument.
+     * @return A future holding the task result (or the exception it threw).
+     */
+    template <typename F> auto submit(F&& task) -> std::future<std::invoke_result_t<F>>
+    {
+        using Result = std::invoke_result_t<F>;
+
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        m_cv.notify_one();
+
+        return future;
+    }
+
+    /**
+     * @brief Runs body(i) for every i in [0, count) on the workers and the calling thread.
+     *
+     * Indices are handed out one at a time, so uneven items balance across threads.
+     * The calling thread works too and only waits for items already started, which
+     * keeps nested calls from a worker thread deadlock free.
+     *
+     * @param count Number of items.
+     * @param body Callable taking the item index. Must be safe to call concurrently.
+     *
+     * @throw The first exception thrown by body, once every started item finished.
+     */
+    template <typename F> void parallelFor(std::size_t count, F&& body)
+    {
+        if (count == 0)
+            return;
+
+        struct Shared
+        {
+            std::atomic<std::size_t> next{0};
+            std::size_t finished = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+
+        auto shared = std::make_shared<Shared>();
+        auto* function = &body;
+        const std::size_t total = count;
+
+        // Helpers that start after every index was claimed return without touching body.
+        auto work = [shared, function, total]() {
+            std::size_t completed = 0;
+            std::exception_ptr error;
+            for (std::size_t i = shared->next++; i < total; i = shared->next++)
+            {
+                try
+                {
+                    (*function)(i);
+                }
+                catch (...)
+                {
+                    if (!error)
+                        error = std::current_exception();
+                }
+                completed++;
+            }
+
+            if (completed == 0)
+                return;
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (error && !shared->error)
+                shared->error = error;
+            shared->finished += completed;
+            if (shared->finished == total)
+                shared->done.notify_all();
+        };
+
+        const std::size_t helpers = std::min(count - 1, m_workers.size());
+        if (helpers > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (std::size_t i = 0; i < helpers; ++i)
+                    m_tasks.emplace_back(work);
+            }
+            m_cv.notify_all();
+        }
+
+        work();
+
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->done.wait(lock, [&] { return shared->finished == total; });
+        if (shared->error)
+            std::rethrow_exception(shared->error);
+    }
+
+    /**
+     * @brief Gets the number of worker threads.
+     *
+     * @return The worker count.
+     */
+    std::size_t size() const { return m_workers.size(); }
+
+private:
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&] { return m_exit || !m_tasks.empty(); });
+
+                if (m_exit && m_tasks.empty())
+                    break;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_exit = false;
+};
+
+#endif
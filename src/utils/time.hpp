@@ -15,23 +15,27 @@ public:
     Time(const Time&) = delete;
     Time& operator=(const Time&) = delete;
 
+    // Measures the time since the previous call with the performance counter. The first call measures 0.
     void computeDeltaTime()
     {
-        float currentFrame = SDL_GetTicks() / 1000.0f; // Convert ms to seconds
-        m_deltaTime = currentFrame - m_lastFrame;
-        m_lastFrame = currentFrame;
+        const Uint64 counter = SDL_GetPerformanceCounter();
+        if (m_lastCounter == 0)
+            m_lastCounter = counter;
+        m_frameTime = static_cast<double>(counter - m_lastCounter) / static_cast<double>(m_frequency);
+        m_lastCounter = counter;
+        m_deltaTime = static_cast<float>(m_frameTime);
     }
 
     float getDeltaTime() const { return m_deltaTime; }
+    double getFrameTime() const { return m_frameTime; }
 
 private:
     float m_deltaTime{};
-    float m_lastFrame{};
+    double m_frameTime{};
+    Uint64 m_lastCounter{};
+    Uint64 m_frequency{};
 
-    Time()
-    {
-        // m_lastFrame = SDL_GetTicks() / 1000.0f;
-    }
+    Time() : m_frequency(SDL_GetPerformanceFrequency()) {}
 
     ~Time() {}
 };
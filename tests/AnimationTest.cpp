@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "animation_clip.hpp"
+#include "compressed_clip.hpp"
+#include "skeleton.hpp"
+#include "skinning.hpp"
+
+namespace
+{
+
+void expectNear(const glm::vec3& actual, const glm::vec3& expected, float tolerance = 1e-4f)
+{
+    EXPECT_NEAR(actual.x, expected.x, tolerance);
+    EXPECT_NEAR(actual.y, expected.y, tolerance);
+    EXPECT_NEAR(actual.z, expected.z, tolerance);
+}
+
+JointPose translated(const glm::vec3& translation)
+{
+    JointPose pose;
+    pose.translation = translation;
+    return pose;
+}
+
+} // namespace
+
+TEST(AnimationTest, SamplesAndClampsClip)
+{
+    const float halfTurn = std::sqrt(0.5f);
+
+    AnimationChannel channel;
+    channel.joint = 0;
+    channel.translations = {{0.0f, glm::vec3(0.0f)}, {1.0f, glm::vec3(2.0f, 0.0f, 0.0f)}};
+    channel.rotations = {{0.0f, glm::quat(1.0f, 0.0f, 0.0f, 0.0f)}, {1.0f, glm::quat(0.0f, 0.0f, 0.0f, 1.0f)}};
+    AnimationClip clip("walk", 1.0f, {channel});
+
+    std::vector<JointPose> pose(2);
+    pose[1] = translated(glm::vec3(0.0f, 5.0f, 0.0f));
+
+    clip.sample(0.5f, pose);
+    expectNear(pose[0].translation, glm::vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_NEAR(pose[0].rotation.w, halfTurn, 1e-4f);
+    EXPECT_NEAR(pose[0].rotation.z, halfTurn, 1e-4f);
+    // Joints without a channel keep their pose.
+    expectNear(pose[1].translation, glm::vec3(0.0f, 5.0f, 0.0f));
+
+    clip.sample(3.0f, pose);
+    expectNear(pose[0].translation, glm::vec3(2.0f, 0.0f, 0.0f));
+    clip.sample(-1.0f, pose);
+    expectNear(pose[0].translation, glm::vec3(0.0f));
+}
+
+TEST(AnimationTest, ComputesPaletteThroughHierarchy)
+{
+    Skeleton skeleton;
+    const int root = skeleton.addJoint("root", -1, translated(glm::vec3(1.0f, 0.0f, 0.0f)));
+    const int child = skeleton.addJoint("child", root, translated(glm::vec3(0.0f, 2.0f, 0.0f)));
+    EXPECT_THROW(skeleton.addJoint("orphan", 5, JointPose()), std::invalid_argument);
+    EXPECT_EQ(skeleton.find("child"), child);
+    EXPECT_EQ(skeleton.find("missing"), -1);
+
+    std::vector<JointPose> pose;
+    skeleton.bindPose(pose);
+    pose[root].translation = glm::vec3(3.0f, 0.0f, 0.0f);
+
+    std::vector<glm::mat4> globals;
+    std::vector<glm::mat4> palette(skeleton.size());
+    skeleton.computePalette(pose, globals, palette.data());
+
+    expectNear(glm::vec3(palette[child] * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)), glm::vec3(3.0f, 2.0f, 0.0f));
+}
+
+TEST(AnimationTest, SimdSkinningMatchesScalar)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<glm::mat4> palette(8);
+    for (glm::mat4& matrix : palette)
+    {
+        JointPose pose;
+        pose.translation = glm::vec3(unit(random), unit(random), unit(random));
+        pose.rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+        pose.scale = glm::vec3(1.0f + 0.5f * unit(random));
+        matrix = pose.toMatrix();
+    }
+
+    std::vector<Vertex> source(257, Vertex{});
+    for (std::size_t i = 0; i < source.size(); ++i)
+    {
+        Vertex& vertex = source[i];
+        vertex.position = glm::vec3(unit(random), unit(random), unit(random));
+        vertex.normal = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+        // Every third vertex is unweighted and must be copied as is.
+        if (i % 3 == 0)
+            continue;
+        for (int k = 0; k < MAX_BONE_INFLUENCE; ++k)
+        {
+            vertex.m_BoneIDs[k] = static_cast<int>(random() % palette.size());
+            vertex.m_Weights[k] = 0.25f;
+        }
+    }
+
+    std::vector<Vertex> simd = source;
+    std::vector<Vertex> scalar = source;
+    skinVertices(source.data(), source.size(), palette.data(), simd.data());
+    skinVerticesScalar(source.data(), source.size(), palette.data(), scalar.data());
+
+    for (std::size_t i = 0; i < source.size(); ++i)
+    {
+        expectNear(simd[i].position, scalar[i].position);
+        expectNear(simd[i].normal, scalar[i].normal);
+    }
+    expectNear(simd[0].position, source[0].position, 0.0f);
+}
+
+TEST(AnimationTest, QuantizesRotationsInto48Bits)
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const glm::quat rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+        std::uint16_t packed[3];
+        quantizeRotation(rotation, packed);
+        EXPECT_EQ(packed[0] >> 15, 0) << "only 47 of the 48 bits are used";
+
+        const glm::quat restored = dequantizeRotation(packed);
+        const float dot = rotation.x * restored.x + rotation.y * restored.y + rotation.z * restored.z +
+                          rotation.w * restored.w;
+        EXPECT_GT(std::abs(dot), 0.99999f);
+    }
+}
+
+TEST(AnimationTest, CompressedClipStaysWithinTolerance)
+{
+    AnimationChannel moving;
+    moving.joint = 0;
+    AnimationChannel still;
+    still.joint = 1;
+    for (int k = 0; k <= 60; ++k)
+    {
+        const float time = k / 30.0f;
+        moving.translations.push_back({time, glm::vec3(std::sin(time), 0.5f * time, 0.0f)});
+        moving.rotations.push_back({time, glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f))});
+        still.translations.push_back({time, glm::vec3(0.0f, 1.0f, 0.0f)});
+        still.rotations.push_back({time, glm::quat(1.0f, 0.0f, 0.0f, 0.0f)});
+    }
+    const AnimationClip clip("swing", 2.0f, {moving, still});
+
+    CompressionSettings settings;
+    settings.translationTolerance = 0.001f;
+    settings.rotationTolerance = 0.002f;
+    const auto compressed = AnimationClip::compress(clip, settings);
+    ASSERT_TRUE(compressed->isCompressed());
+    EXPECT_EQ(compressed->getDuration(), clip.getDuration());
+    EXPECT_LT(compressed->memoryUsage() * 4, clip.memoryUsage());
+
+    std::vector<JointPose> expected(2);
+    std::vector<JointPose> actual(2);
+    for (float time = -0.1f; time <= 2.1f; time += 0.007f)
+    {
+        clip.sample(time, expected);
+        compressed->sample(time, actual);
+        for (int j = 0; j < 2; ++j)
+        {
+            EXPECT_LE(glm::length(actual[j].translation - expected[j].translation), settings.translationTolerance)
+                << "joint " << j << " at " << time;
+            const glm::quat& a = actual[j].rotation;
+            const glm::quat& b = expected[j].rotation;
+            const float dot = std::min(1.0f, std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w));
+            EXPECT_LE(2.0f * std::acos(dot), settings.rotationTolerance + 1e-3f) << "joint " << j << " at " << time;
+        }
+    }
+}
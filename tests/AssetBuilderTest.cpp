@@ -0,0 +1,148 @@
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "asset_builder.hpp"
+#include "cookers.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+const std::filesystem::path ROOT = std::filesystem::temp_directory_path() / "lamb_asset_builder_test";
+
+std::string pathOf(const std::string& name)
+{
+    return (ROOT / name).string();
+}
+
+void writeFile(const std::string& name, const std::string& text)
+{
+    std::filesystem::create_directories((ROOT / name).parent_path());
+    std::ofstream(ROOT / name, std::ios::trunc) << text;
+}
+
+std::string readFile(const std::string& name)
+{
+    std::ifstream file(ROOT / name);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+Builder::BuildStats build()
+{
+    Builder::AssetBuilder builder(pathOf("build.json"));
+    Builder::registerDefaultCookers(builder);
+    builder.addRule({"material", {pathOf("src/materials.mtl")}, pathOf("out/gold.mtl"), {{"name", "Gold"}}});
+    builder.addRule({"material", {pathOf("src/materials.mtl")}, pathOf("out/silver.mtl"), {{"name", "Silver"}}});
+    builder.addRule({"shader", {pathOf("src/lit.glsl")}, pathOf("out/lit.glsl"), {}});
+    builder.addRule({"pack",
+                     {pathOf("out/gold.mtl"), pathOf("out/silver.mtl"), pathOf("out/lit.glsl")},
+                     pathOf("base.pak"),
+                     {{"root", pathOf("out")}}});
+    return builder.build();
+}
+
+} // namespace
+
+TEST(AssetBuilderTest, CooksOnlyWhatChanged)
+{
+    std::filesystem::remove_all(ROOT);
+    writeFile("src/materials.mtl", "newmtl Gold\nKd 0.75 0.6 0.2 # diffuse\n\nnewmtl Silver\nKd 0.5 0.5 0.5\n");
+    writeFile("src/lit.glsl", "#version 460 core\n#include \"common/light.glsl\"\nvoid main() {}\n");
+    writeFile("src/common/light.glsl", "struct Light { vec3 color; };\n");
+
+    Builder::BuildStats stats = build();
+    ASSERT_TRUE(stats.errors.empty());
+    ASSERT_EQ(stats.cooked, 4u);
+    ASSERT_EQ(stats.waves, 2u);
+    ASSERT_EQ(readFile("out/gold.mtl"), "newmtl Gold\nKd 0.75 0.6 0.2\n");
+    ASSERT_NE(readFile("out/lit.glsl").find("struct Light"), std::string::npos);
+
+    stats = build();
+    ASSERT_EQ(stats.cooked, 0u);
+    ASSERT_EQ(stats.upToDate, 4u);
+
+    // An .mtl edit cooks its materials and the pack again, not the shader.
+    writeFile("src/materials.mtl", "newmtl Gold\nKd 0.75 0.6 0.2 # diffuse\n\nnewmtl Silver\nKd 0.55 0.55 0.55\n");
+    stats = build();
+    ASSERT_EQ(stats.cooked, 3u);
+    ASSERT_EQ(stats.upToDate, 1u);
+
+    // A comment edit gives the same cooked materials, so the pack is left alone.
+    writeFile("src/materials.mtl", "newmtl Gold\nKd 0.75 0.6 0.2 # gold\n\nnewmtl Silver\nKd 0.55 0.55 0.55\n");
+    stats = build();
+    ASSERT_EQ(stats.cooked, 2u);
+    ASSERT_EQ(stats.upToDate, 2u);
+
+    // Includes are tracked as inputs.
+    writeFile("src/common/light.glsl", "struct Light { vec3 color; float range; };\n");
+    stats = build();
+    ASSERT_EQ(stats.cooked, 2u);
+    ASSERT_EQ(stats.upToDate, 2u);
+
+    // So are the outputs: a deleted output is cooked again.
+    std::filesystem::remove(ROOT / "out/gold.mtl");
+    stats = build();
+    ASSERT_EQ(stats.cooked, 1u);
+    ASSERT_EQ(stats.upToDate, 3u);
+
+    std::filesystem::remove_all(ROOT);
+}
+
+TEST(AssetBuilderTest, ReportsFailuresAndCycles)
+{
+    std::filesystem::remove_all(ROOT);
+    writeFile("src/materials.mtl", "newmtl Gold\nKd 1 1 1\n");
+
+    {
+        Builder::AssetBuilder builder(pathOf("build.json"));
+        Builder::registerDefaultCookers(builder);
+        builder.addRule({"material", {pathOf("src/materials.mtl")}, pathOf("out/lead.mtl"), {{"name", "Lead"}}});
+        builder.addRule({"copy", {pathOf("out/lead.mtl")}, pathOf("out/copy.mtl"), {}});
+        const Builder::BuildStats stats = builder.build();
+        ASSERT_EQ(stats.cooked, 0u);
+        ASSERT_EQ(stats.failed, 2u);
+    }
+
+    {
+        Builder::AssetBuilder builder(pathOf("build.json"));
+        Builder::registerDefaultCookers(builder);
+        builder.addRule({"copy", {pathOf("a")}, pathOf("b"), {}});
+        builder.addRule({"copy", {pathOf("b")}, pathOf("a"), {}});
+        ASSERT_THROW(builder.build(), std::runtime_error);
+    }
+
+    std::filesystem::remove_all(ROOT);
+}
+
+TEST(AssetBuilderTest, CooksMoreTexturesThanWorkers)
+{
+    std::filesystem::remove_all(ROOT);
+
+    // One wave with more texture rules than workers: every worker and the caller cook at once, and the
+    // encoder splits each image across the same pool.
+    const std::size_t textures = ThreadPool::getInstance().size() + 2;
+    Builder::AssetBuilder builder(pathOf("build.json"));
+    Builder::registerDefaultCookers(builder);
+    for (std::size_t i = 0; i < textures; ++i)
+    {
+        const std::string name = "texture" + std::to_string(i);
+        std::string ppm = "P6\n32 32\n255\n";
+        for (int texel = 0; texel < 32 * 32; ++texel)
+            ppm += std::string{static_cast<char>(texel), static_cast<char>(i * 40), static_cast<char>(255 - texel)};
+        std::filesystem::create_directories(ROOT / "src");
+        std::ofstream(ROOT / "src" / (name + ".ppm"), std::ios::binary | std::ios::trunc) << ppm;
+        builder.addRule({"texture", {pathOf("src/" + name + ".ppm")}, pathOf("out/" + name + ".ktx2"), {}});
+    }
+
+    const Builder::BuildStats stats = builder.build();
+    ASSERT_TRUE(stats.errors.empty());
+    ASSERT_EQ(stats.cooked, textures);
+    ASSERT_EQ(stats.waves, 1u);
+
+    std::filesystem::remove_all(ROOT);
+}
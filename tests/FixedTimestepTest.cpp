@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "fixed_timestep.hpp"
+
+TEST(FixedTimestepTest, ConsumesWholeStepsAndKeepsRemainder)
+{
+    FixedTimestep timestep(100.0, 5);
+
+    timestep.advance(0.025);
+    int steps = 0;
+    while (timestep.step())
+        ++steps;
+    EXPECT_EQ(steps, 2);
+    EXPECT_NEAR(timestep.getAlpha(), 0.5f, 1e-4f);
+
+    // The remainder carries over to the next frame.
+    timestep.advance(0.006);
+    steps = 0;
+    while (timestep.step())
+        ++steps;
+    EXPECT_EQ(steps, 1);
+    EXPECT_NEAR(timestep.getAlpha(), 0.1f, 1e-4f);
+}
+
+TEST(FixedTimestepTest, DropsBacklogPastStepLimit)
+{
+    FixedTimestep timestep(100.0, 3);
+
+    timestep.advance(1.0025);
+    int steps = 0;
+    while (timestep.step())
+        ++steps;
+    EXPECT_EQ(steps, 3);
+    EXPECT_EQ(timestep.getStepCount(), 3);
+    EXPECT_NEAR(timestep.getDroppedTime(), 0.97, 1e-9);
+    EXPECT_NEAR(timestep.getAlpha(), 0.25f, 1e-4f);
+
+    // Nothing is left to catch up on.
+    timestep.advance(0.0);
+    EXPECT_FALSE(timestep.step());
+
+    EXPECT_THROW(FixedTimestep(0.0, 3), std::invalid_argument);
+    EXPECT_THROW(FixedTimestep(60.0, 0), std::invalid_argument);
+}
@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "frame_time_report.hpp"
+
+TEST(FrameTimeReportTest, SummarizesWithNearestRankPercentiles)
+{
+    FrameTimeReport report;
+    EXPECT_EQ(report.summarize().frames, 0u);
+
+    // 1 ms to 100 ms, in reverse so the summary cannot rely on the order.
+    for (int i = 100; i >= 1; --i)
+        report.add(i / 1000.0);
+
+    const FrameTimeReport::Summary summary = report.summarize();
+    EXPECT_EQ(summary.frames, 100u);
+    EXPECT_NEAR(summary.totalSeconds, 5.05, 1e-9);
+    EXPECT_NEAR(summary.framesPerSecond, 100.0 / 5.05, 1e-9);
+    EXPECT_NEAR(summary.average, 50.5, 1e-9);
+    EXPECT_NEAR(summary.minimum, 1.0, 1e-9);
+    EXPECT_NEAR(summary.maximum, 100.0, 1e-9);
+    EXPECT_NEAR(summary.p50, 50.0, 1e-9);
+    EXPECT_NEAR(summary.p95, 95.0, 1e-9);
+    EXPECT_NEAR(summary.p99, 99.0, 1e-9);
+}
+
+TEST(FrameTimeReportTest, WritesJson)
+{
+    FrameTimeReport report;
+    report.add(0.010);
+    report.add(0.020);
+    report.setCounter("drawCalls", 42.0);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_frame_time_report.json";
+    ASSERT_TRUE(report.write(path.string(), {{"scene", "test"}}));
+
+    nlohmann::json root;
+    {
+        std::ifstream file(path);
+        file >> root;
+    }
+    std::remove(path.string().c_str());
+
+    EXPECT_EQ(root["info"]["scene"], "test");
+    EXPECT_EQ(root["frames"], 2);
+    EXPECT_NEAR(root["milliseconds"]["p50"].get<double>(), 10.0, 1e-9);
+    EXPECT_NEAR(root["milliseconds"]["max"].get<double>(), 20.0, 1e-9);
+    EXPECT_EQ(root["counters"]["drawCalls"], 42.0);
+    ASSERT_EQ(root["frameTimes"].size(), 2u);
+    EXPECT_NEAR(root["frameTimes"][1].get<double>(), 20.0, 1e-9);
+}
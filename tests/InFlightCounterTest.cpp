@@ -0,0 +1,36 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "in_flight_counter.hpp"
+
+TEST(InFlightCounterTest, WaitReturnsOnceEveryJobIsDone)
+{
+    constexpr int JOBS = 8;
+    InFlightCounter jobs;
+    // Nothing added yet, so it does not block.
+    jobs.wait();
+
+    std::atomic<int> finished = 0;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < JOBS; ++i)
+    {
+        jobs.add();
+        workers.emplace_back([&jobs, &finished]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            finished++;
+            jobs.done();
+        });
+    }
+
+    // Everything a job did before done() is visible once wait() returns.
+    jobs.wait();
+    EXPECT_EQ(finished.load(), JOBS);
+    EXPECT_EQ(jobs.count(), 0u);
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
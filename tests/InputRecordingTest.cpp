@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "input_recording.hpp"
+
+namespace
+{
+
+const std::filesystem::path PATH = std::filesystem::temp_directory_path() / "lamb_input_recording_test.linp";
+
+} // namespace
+
+TEST(InputRecordingTest, RoundTrips)
+{
+    InputRecording recording;
+    InputRecording::Frame frame;
+    frame.frameTime = 1.0 / 60.0;
+    frame.mouseX = 3;
+    frame.mouseY = -70000;
+    frame.keys.set(SDL_SCANCODE_W);
+    recording.add(frame);
+    frame.mouseX = 0;
+    frame.mouseY = 0;
+    recording.add(frame);
+    frame.keys.set(SDL_SCANCODE_SPACE);
+    frame.frameTime = 0.5;
+    recording.add(frame);
+    recording.write(PATH.string());
+
+    // Only the first and last frames store the keyboard.
+    const auto keyBytes = (InputRecording::KEY_COUNT + 7) / 8;
+    const auto expected = sizeof(InputRecordingHeader) + 3 * sizeof(InputFrameRecord) + 2 * keyBytes;
+    EXPECT_EQ(std::filesystem::file_size(PATH), expected);
+
+    const InputRecording read = InputRecording::read(PATH.string());
+    std::remove(PATH.string().c_str());
+
+    ASSERT_EQ(read.size(), 3u);
+    EXPECT_DOUBLE_EQ(read.getFrame(0).frameTime, 1.0 / 60.0);
+    EXPECT_EQ(read.getFrame(0).mouseX, 3);
+    EXPECT_EQ(read.getFrame(0).mouseY, -32768);
+    EXPECT_TRUE(read.getFrame(1).keys.test(SDL_SCANCODE_W));
+    EXPECT_FALSE(read.getFrame(1).keys.test(SDL_SCANCODE_SPACE));
+    EXPECT_TRUE(read.getFrame(2).keys.test(SDL_SCANCODE_SPACE));
+    EXPECT_EQ(read.getFrame(2).keys.count(), 2u);
+    EXPECT_DOUBLE_EQ(read.getFrame(2).frameTime, 0.5);
+}
+
+TEST(InputRecordingTest, RejectsOtherFiles)
+{
+    std::ofstream(PATH, std::ios::binary | std::ios::trunc) << "not an input recording";
+    EXPECT_THROW(InputRecording::read(PATH.string()), std::runtime_error);
+    std::remove(PATH.string().c_str());
+
+    EXPECT_THROW(InputRecording::read(PATH.string()), std::runtime_error);
+}
+
+TEST(InputRecordingTest, RejectsFrameCountsTheFileCannotHold)
+{
+    InputRecording recording;
+    recording.add(InputRecording::Frame{});
+    recording.write(PATH.string());
+
+    // A corrupt count must fail before anything is reserved for it.
+    {
+        std::fstream file(PATH, std::ios::binary | std::ios::in | std::ios::out);
+        const std::uint32_t frameCount = 0xFFFFFFFFu;
+        file.seekp(offsetof(InputRecordingHeader, frameCount));
+        file.write(reinterpret_cast<const char*>(&frameCount), sizeof(frameCount));
+    }
+    EXPECT_THROW(InputRecording::read(PATH.string()), std::runtime_error);
+    std::remove(PATH.string().c_str());
+}
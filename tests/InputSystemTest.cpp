@@ -40,6 +40,29 @@ TEST_F(InputSystemTest, UpdateTest)
     event.type = SDL_QUIT;
     SDL_PushEvent(&event);
 
-    inputSystem->update(window);
+    inputSystem->update(window, 0.0);
     ASSERT_TRUE(inputSystem->shouldStop()); // Should stop after receiving SDL_QUIT event
 }
+
+TEST_F(InputSystemTest, ReplaysRecordedFrames)
+{
+    InputRecording recording;
+    InputRecording::Frame frame;
+    frame.frameTime = 0.025;
+    frame.keys.set(SDL_SCANCODE_W);
+    recording.add(frame);
+
+    inputSystem->startReplay(std::move(recording));
+    inputSystem->update(window, 0.5);
+    EXPECT_DOUBLE_EQ(inputSystem->getFrameTime(), 0.025);
+    EXPECT_EQ(inputSystem->getKeyboardState()[SDL_SCANCODE_W], 1);
+    EXPECT_EQ(inputSystem->getKeyboardState()[SDL_SCANCODE_S], 0);
+    EXPECT_FALSE(inputSystem->isReplayFinished());
+
+    inputSystem->update(window, 0.5);
+    EXPECT_TRUE(inputSystem->isReplayFinished());
+    inputSystem->stopReplay();
+
+    inputSystem->update(window, 0.5);
+    EXPECT_DOUBLE_EQ(inputSystem->getFrameTime(), 0.5);
+}
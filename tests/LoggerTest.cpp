@@ -0,0 +1,99 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "log.hpp"
+
+namespace
+{
+
+// Other tests may have logged before, so only the lines of the "Test" subsystem count.
+std::vector<std::string> readTestLines(const std::filesystem::path& path)
+{
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+    {
+        if (line.find("] [Test] [") != std::string::npos)
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(LoggerTest, WritesEveryMessageFromManyThreads)
+{
+#ifndef DEBUG
+    GTEST_SKIP() << "Logger::Log is compiled out without DEBUG";
+#endif
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_logger_test" / "Global.log";
+    std::filesystem::remove(path);
+
+    // Blocking producers outrun the ring many times over, yet nothing is lost.
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 5000;
+    Logger::Init(false, false);
+    Logger::SetOverflowPolicy(LogOverflowPolicy::Block);
+    Logger::RegisterSubsystemFile("Global", path.string(), false);
+
+    std::vector<std::thread> threads;
+    std::vector<std::string> threadIds(THREADS);
+    for (int thread = 0; thread < THREADS; ++thread)
+    {
+        threads.emplace_back([thread, &threadIds]() {
+            std::ostringstream id;
+            id << std::this_thread::get_id();
+            threadIds[thread] = id.str();
+            for (int i = 0; i < MESSAGES; ++i)
+                Logger::Log(LogLevel::Info, "message " + std::to_string(thread), "Test");
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Longer than a record, so it takes the heap path.
+    const std::string longMessage(1000, 'x');
+    Logger::Log(LogLevel::Error, longMessage, "Test");
+    Logger::Shutdown();
+    Logger::SetOverflowPolicy(LogOverflowPolicy::Count);
+
+    const std::vector<std::string> lines = readTestLines(path);
+    ASSERT_EQ(lines.size(), static_cast<std::size_t>(THREADS * MESSAGES + 1));
+    EXPECT_NE(lines.front().find("[INFO] message "), std::string::npos);
+    EXPECT_NE(lines.back().find("[ERROR] " + longMessage), std::string::npos);
+
+    // Interleaved producers each keep their own thread id.
+    for (std::size_t line = 0; line + 1 < lines.size(); ++line)
+    {
+        const int thread = lines[line].back() - '0';
+        ASSERT_TRUE(thread >= 0 && thread < THREADS) << lines[line];
+        EXPECT_NE(lines[line].find("[T:" + threadIds[thread] + "]"), std::string::npos) << lines[line];
+    }
+}
+
+TEST(LoggerTest, LongSubsystemNamesReachTheirFile)
+{
+#ifndef DEBUG
+    GTEST_SKIP() << "Logger::Log is compiled out without DEBUG";
+#endif
+    // Longer than a record holds inline, so the name takes the heap path.
+    const std::string subsystem = "AVeryLongSubsystemNameForStreaming";
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_logger_test" / "Long.log";
+    std::filesystem::remove(path);
+
+    Logger::Init(false, false);
+    Logger::RegisterSubsystemFile(subsystem, path.string(), false);
+    Logger::Log(LogLevel::Warning, "streamed", subsystem);
+    Logger::Shutdown();
+
+    std::ifstream in(path);
+    const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("[" + subsystem + "] [WARN] streamed"), std::string::npos);
+}
@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mesh_cache.hpp"
+
+namespace
+{
+
+IO::MeshCacheData makeData()
+{
+    IO::MeshCacheData data;
+    data.sourceHash = 0x1234;
+    data.importFlags = 8;
+    data.vertexStride = 12;
+
+    IO::MeshCacheSubmesh first;
+    first.vertexCount = 3;
+    first.indexCount = 3;
+    first.textureCount = 1;
+    first.boundsRadius = 2.0f;
+    IO::MeshCacheSubmesh second;
+    second.firstVertex = 3;
+    second.vertexCount = 1;
+    second.firstIndex = 3;
+    second.indexCount = 3;
+    second.firstTexture = 1;
+    data.submeshes = {first, second};
+
+    data.textureTypes = {1};
+    data.texturePaths = {"box.png"};
+    for (std::uint8_t i = 0; i < 4 * 12; ++i)
+        data.vertices.push_back(i);
+    data.indices = {0, 1, 2, 0, 0, 0};
+    return data;
+}
+
+} // namespace
+
+TEST(MeshCacheTest, RoundTripsInPlace)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_mesh_cache_test.lmesh";
+    IO::writeMeshCache(path.string(), makeData());
+
+    IO::MeshCacheFile file(path.string(), 0x1234, 8, 12);
+    ASSERT_EQ(file.header().submeshCount, 2u);
+    ASSERT_EQ(file.header().vertexOffset % 16, 0u);
+    ASSERT_EQ(file.header().indexOffset % 16, 0u);
+
+    const IO::MeshCacheSubmesh& second = file.submeshes()[1];
+    ASSERT_EQ(file.vertices(second)[0], 36);
+    ASSERT_EQ(file.indices(second)[2], 0u);
+    ASSERT_FLOAT_EQ(file.submeshes()[0].boundsRadius, 2.0f);
+    ASSERT_EQ(file.texturePath(0), "box.png");
+    ASSERT_EQ(file.textureType(0), 1u);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MeshCacheTest, RejectsStaleFiles)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_mesh_cache_stale.lmesh";
+    IO::writeMeshCache(path.string(), makeData());
+
+    ASSERT_THROW(IO::MeshCacheFile(path.string(), 0x9999, 8, 12), std::runtime_error);
+    ASSERT_THROW(IO::MeshCacheFile(path.string(), 0x1234, 9, 12), std::runtime_error);
+    ASSERT_THROW(IO::MeshCacheFile(path.string(), 0x1234, 8, 16), std::runtime_error);
+
+    std::filesystem::resize_file(path, 140);
+    ASSERT_THROW(IO::MeshCacheFile(path.string(), 0x1234, 8, 12), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
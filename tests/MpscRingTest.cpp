@@ -0,0 +1,78 @@
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mpsc_ring.hpp"
+
+TEST(MpscRingTest, RoundsCapacityAndRejectsWhenFull)
+{
+    MpscRing<int> ring(5);
+    ASSERT_EQ(ring.capacity(), 8u);
+    ASSERT_TRUE(ring.empty());
+
+    for (int i = 0; i < 8; ++i)
+        ASSERT_TRUE(ring.tryPush([i](int& slot) { slot = i; }));
+    EXPECT_FALSE(ring.tryPush([](int& slot) { slot = -1; }));
+
+    // Slots come back in order and free room for the next lap.
+    int value = -1;
+    ASSERT_TRUE(ring.tryPop([&value](int& slot) { value = slot; }));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.tryPush([](int& slot) { slot = 8; }));
+
+    for (int expected = 1; expected <= 8; ++expected)
+    {
+        ASSERT_TRUE(ring.tryPop([&value](int& slot) { value = slot; }));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.tryPop([](int&) {}));
+}
+
+TEST(MpscRingTest, KeepsEveryItemFromManyProducers)
+{
+    struct Item
+    {
+        int producer = 0;
+        int index = 0;
+    };
+
+    constexpr int PRODUCERS = 4;
+    constexpr int ITEMS = 20000;
+    MpscRing<Item> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCERS; ++producer)
+    {
+        producers.emplace_back([&ring, producer]() {
+            for (int i = 0; i < ITEMS; ++i)
+            {
+                while (!ring.tryPush([&](Item& item) { item = Item{producer, i}; }))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Each producer's items arrive in its own order, none lost or repeated.
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * ITEMS)
+    {
+        Item item;
+        if (!ring.tryPop([&item](Item& slot) { item = slot; }))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(item.index, next[item.producer]);
+        ++next[item.producer];
+        ++received;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glad/glad.h>
+#include <gtest/gtest.h>
+
+#include "null_gl.hpp"
+
+TEST(NullGlTest, LoadsGladAndAnswersLikeADriver)
+{
+    ASSERT_TRUE(gladLoadGLLoader((GLADloadproc)NullGl::getProcAddress));
+    EXPECT_TRUE(GLAD_GL_VERSION_3_3);
+    const std::uint64_t calls = NullGl::getCallCount();
+
+    GLuint buffers[2] = {0, 0};
+    glGenBuffers(2, buffers);
+    EXPECT_NE(buffers[0], 0u);
+    EXPECT_NE(buffers[0], buffers[1]);
+    EXPECT_TRUE(glIsBuffer(buffers[0]));
+
+    const GLuint program = glCreateProgram();
+    EXPECT_NE(program, 0u);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    EXPECT_EQ(linked, GL_TRUE);
+
+    glViewport(0, 0, 640, 480);
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    EXPECT_EQ(viewport[2], 640);
+    EXPECT_EQ(viewport[3], 480);
+
+    // Buffer mappings get writable memory.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffers[1]);
+    void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, 256, GL_MAP_WRITE_BIT);
+    ASSERT_NE(staging, nullptr);
+    std::memset(staging, 0xFF, 256);
+    EXPECT_TRUE(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+    // Calls without outputs are only counted.
+    glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, nullptr);
+    glDeleteBuffers(2, buffers);
+    EXPECT_EQ(NullGl::getCallCount() - calls, 11u);
+}
+
+TEST(NullGlTest, WritesEveryOutputAndLeavesUnknownFunctionsUnloaded)
+{
+    ASSERT_TRUE(gladLoadGLLoader((GLADloadproc)NullGl::getProcAddress));
+
+    // Reads back black, with rows padded to the pack alignment: 9 bytes, then 3 of padding.
+    std::vector<std::uint8_t> pixels(24, 0xAB);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, 3, 2, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    EXPECT_EQ(std::count(pixels.begin(), pixels.begin() + 21, 0), 21);
+    EXPECT_EQ(std::count(pixels.begin() + 21, pixels.end(), 0xAB), 3);
+
+    GLint64 timestamp = -1;
+    glGetInteger64v(GL_TIMESTAMP, &timestamp);
+    EXPECT_GE(timestamp, 0);
+
+    EXPECT_EQ(NullGl::getProcAddress("glNotAFunction"), nullptr);
+}
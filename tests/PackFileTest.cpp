@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pack_file.hpp"
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+std::vector<std::uint8_t> bytesOf(const std::string& text)
+{
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+} // namespace
+
+TEST(PackFileTest, DeduplicatesAndFindsNormalizedPaths)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_pack_test.pak";
+    const std::string shader = "#version 460 core\nvoid main() {}\n";
+    const IO::PackStats stats = IO::writePack(
+        path.string(),
+        {{"shaders/a.glsl", bytesOf(shader)}, {".\\shaders\\b.glsl", bytesOf(shader)}, {"res/c.txt", bytesOf("c")}},
+        false);
+    ASSERT_EQ(stats.entries, 3u);
+    ASSERT_EQ(stats.blobs, 2u);
+
+    IO::PackFile pack(path.string());
+    const IO::PackEntry* a = pack.find(IO::normalizePackPath(".\\shaders\\a.glsl"));
+    const IO::PackEntry* b = pack.find("shaders/b.glsl");
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_EQ(a->blob, b->blob);
+    ASSERT_EQ(pack.find("shaders/missing.glsl"), nullptr);
+
+    const std::span<const std::uint8_t> stored = pack.stored(*a);
+    ASSERT_EQ(std::string(stored.begin(), stored.end()), shader);
+    ASSERT_EQ(pack.blob(*a).offset % 16, 0u);
+
+    std::filesystem::remove(path);
+}
+
+TEST(PackFileTest, CompressesWithLZ4AndReadsThroughTheFileSystem)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_pack_lz4_test.pak";
+    const std::string repetitive(4096, 'x');
+    IO::writePack(path.string(),
+                  {{"lamb_pack_test/big.txt", bytesOf(repetitive)}, {"lamb_pack_test/tiny.txt", bytesOf("t")}}, true);
+
+    IO::VirtualFileSystem& vfs = IO::VirtualFileSystem::getInstance();
+    ASSERT_TRUE(vfs.mount(path.string()));
+
+    IO::FileData big = vfs.read("lamb_pack_test/big.txt");
+    ASSERT_FALSE(big.isMapped());
+    ASSERT_EQ(big.text(), repetitive);
+
+    // Too small to gain anything, so stored as is and served from the mapping.
+    IO::FileData tiny = vfs.read(".\\lamb_pack_test\\tiny.txt");
+    ASSERT_TRUE(tiny.isMapped());
+    ASSERT_EQ(tiny.text(), "t");
+
+    ASSERT_FALSE(vfs.exists("lamb_pack_test/missing.txt"));
+    ASSERT_THROW(vfs.read("lamb_pack_test/missing.txt"), std::runtime_error);
+
+    vfs.unmountAll();
+    ASSERT_EQ(tiny.text(), "t");
+    std::filesystem::remove(path);
+}
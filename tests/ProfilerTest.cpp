@@ -0,0 +1,191 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "profiler.hpp"
+
+namespace
+{
+
+std::size_t countEvents(const std::vector<Profiler::ThreadEvents>& threads, const std::string& name)
+{
+    std::size_t count = 0;
+    for (const Profiler::ThreadEvents& thread : threads)
+    {
+        for (const Profiler::Event& event : thread.events)
+            count += name == event.name;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(ProfilerTest, RecordsNestedZonesPerThreadOnlyWhileCapturing)
+{
+    Profiler& profiler = Profiler::getInstance();
+    {
+        ProfileZone ignored("Before");
+    }
+
+    profiler.start();
+    profiler.markFrame();
+    {
+        ProfileZone outer("Outer");
+        ProfileZone inner("Inner");
+    }
+    std::thread worker([]() {
+        Profiler::getInstance().setThreadName("Test worker");
+        for (int i = 0; i < 3; ++i)
+            ProfileZone zone("Worker zone");
+    });
+    worker.join();
+    profiler.stop();
+
+    {
+        ProfileZone ignored("After");
+    }
+
+    const std::vector<Profiler::ThreadEvents> threads = profiler.collect();
+    EXPECT_EQ(countEvents(threads, "Before"), 0u);
+    EXPECT_EQ(countEvents(threads, "After"), 0u);
+    EXPECT_EQ(countEvents(threads, "Outer"), 1u);
+    EXPECT_EQ(countEvents(threads, "Inner"), 1u);
+    EXPECT_EQ(countEvents(threads, "Worker zone"), 3u);
+    EXPECT_EQ(countEvents(threads, "Frame"), 1u);
+
+    const Profiler::Event* outer = nullptr;
+    const Profiler::Event* inner = nullptr;
+    for (const Profiler::ThreadEvents& thread : threads)
+    {
+        for (const Profiler::Event& event : thread.events)
+        {
+            if (std::string(event.name) == "Outer")
+                outer = &event;
+            else if (std::string(event.name) == "Inner")
+                inner = &event;
+            else if (std::string(event.name) == "Worker zone")
+            {
+                EXPECT_EQ(thread.name, "Test worker");
+            }
+        }
+    }
+    ASSERT_TRUE(outer && inner);
+    EXPECT_LE(outer->start, inner->start);
+    EXPECT_GE(outer->end, inner->end);
+}
+
+TEST(ProfilerTest, WritesChromeTrace)
+{
+    Profiler& profiler = Profiler::getInstance();
+    profiler.start();
+    profiler.setThreadName("Test main");
+    profiler.markFrame();
+    {
+        ProfileZone zone("Traced \"zone\"");
+    }
+    profiler.stop();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "lamb_profiler_test.json").string();
+    ASSERT_TRUE(profiler.writeChromeTrace(path));
+
+    std::ifstream in(path);
+    const nlohmann::json trace = nlohmann::json::parse(in);
+    in.close();
+    std::remove(path.c_str());
+
+    bool zone = false;
+    bool frame = false;
+    bool threadName = false;
+    for (const nlohmann::json& event : trace["traceEvents"])
+    {
+        const std::string phase = event["ph"];
+        if (phase == "X" && event["name"] == "Traced \"zone\"")
+            zone = event["dur"].get<double>() >= 0.0;
+        else if (phase == "i" && event["name"] == "Frame")
+            frame = true;
+        else if (phase == "M" && event["args"]["name"] == "Test main")
+            threadName = true;
+    }
+    EXPECT_TRUE(zone);
+    EXPECT_TRUE(frame);
+    EXPECT_TRUE(threadName);
+}
+
+TEST(ProfilerTest, KeepsTrackEventsInSteadyTime)
+{
+    Profiler& profiler = Profiler::getInstance();
+    Profiler::Track* track = profiler.addTrack("Test track");
+
+    profiler.start();
+    const std::int64_t now = Profiler::steadyNanoseconds();
+    profiler.recordOnTrack(track, "Track event", now, now + 2000000);
+    profiler.stop();
+
+    bool found = false;
+    for (const Profiler::ThreadEvents& thread : profiler.collect())
+    {
+        if (thread.name != "Test track")
+            continue;
+        ASSERT_EQ(thread.events.size(), 1u);
+        EXPECT_EQ(thread.events[0].start, now);
+        EXPECT_EQ(thread.events[0].end - thread.events[0].start, 2000000);
+        found = true;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(ProfilerTest, CollectsOnlyNewEventsPerCursor)
+{
+    Profiler& profiler = Profiler::getInstance();
+    std::vector<std::size_t> cursors;
+    profiler.collectNew(cursors);
+
+    profiler.start();
+    {
+        ProfileZone zone("First");
+    }
+    std::vector<Profiler::ThreadEvents> threads = profiler.collectNew(cursors);
+    EXPECT_EQ(countEvents(threads, "First"), 1u);
+
+    {
+        ProfileZone zone("Second");
+    }
+    threads = profiler.collectNew(cursors);
+    profiler.stop();
+    EXPECT_EQ(countEvents(threads, "First"), 0u);
+    EXPECT_EQ(countEvents(threads, "Second"), 1u);
+
+    EXPECT_TRUE(profiler.collectNew(cursors).empty());
+}
+
+TEST(ProfilerTest, DropsEventsTheRingMayHaveOverwritten)
+{
+    Profiler& profiler = Profiler::getInstance();
+    Profiler::Track* track = profiler.addTrack("Wrap test");
+    profiler.start();
+
+    // The oldest slot left is the next one the owner writes, so it cannot be trusted while it records.
+    const auto recorded = static_cast<std::int64_t>(Profiler::CAPACITY + 5);
+    for (std::int64_t i = 0; i < recorded; ++i)
+        profiler.recordOnTrack(track, "Wrapped", i, i + 1);
+    const std::vector<Profiler::ThreadEvents> threads = profiler.collect();
+    profiler.stop();
+
+    const Profiler::ThreadEvents* wrapped = nullptr;
+    for (const Profiler::ThreadEvents& thread : threads)
+    {
+        if (thread.name == "Wrap test")
+            wrapped = &thread;
+    }
+    ASSERT_NE(wrapped, nullptr);
+    ASSERT_EQ(wrapped->events.size(), Profiler::CAPACITY - 1);
+    EXPECT_EQ(wrapped->events.front().start, recorded - static_cast<std::int64_t>(Profiler::CAPACITY) + 1);
+    EXPECT_EQ(wrapped->events.back().start, recorded - 1);
+}
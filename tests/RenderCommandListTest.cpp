@@ -0,0 +1,23 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "render_command_list.hpp"
+
+TEST(RenderCommandListTest, ExecutesInRecordingOrderUntilReset)
+{
+    RenderCommandList commands;
+    std::vector<int> calls;
+    for (int i = 0; i < 3; ++i)
+        commands.call([&calls, i]() { calls.push_back(i); });
+    ASSERT_EQ(commands.size(), 3u);
+
+    commands.execute();
+    commands.execute();
+    EXPECT_EQ(calls, (std::vector<int>{0, 1, 2, 0, 1, 2}));
+
+    commands.reset();
+    EXPECT_EQ(commands.size(), 0u);
+    commands.execute();
+    EXPECT_EQ(calls.size(), 6u);
+}
@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pack_file.hpp"
+#include "shader_preprocessor.hpp"
+#include "virtual_file_system.hpp"
+
+namespace
+{
+
+const std::filesystem::path PACK = std::filesystem::temp_directory_path() / "lamb_shader_preprocessor_test.pak";
+
+std::vector<std::uint8_t> bytesOf(const std::string& text)
+{
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Serves the sources through the VirtualFileSystem, as the engine reads shaders.
+void mountSources(const std::vector<std::pair<std::string, std::string>>& files)
+{
+    std::vector<IO::PackInput> inputs;
+    for (const auto& [path, text] : files)
+        inputs.push_back(IO::PackInput{"lamb_preprocessor_test/" + path, bytesOf(text)});
+    IO::writePack(PACK.string(), inputs, false);
+    ASSERT_TRUE(IO::VirtualFileSystem::getInstance().mount(PACK.string()));
+
+    // Parsed files are cached by path, and other tests may have used the same ones.
+    ShaderPreprocessor::getInstance().clear();
+}
+
+void unmountSources()
+{
+    IO::VirtualFileSystem::getInstance().unmountAll();
+    ShaderPreprocessor::getInstance().clear();
+    std::filesystem::remove(PACK);
+}
+
+} // namespace
+
+TEST(ShaderPreprocessorTest, ExpandsIncludesAndKeepsLineNumbers)
+{
+    mountSources({{"lit.glsl", "#version 460 core\n#include \"common/light.glsl\"\nvoid main() {}\n"},
+                  {"common/light.glsl", "struct Light { vec3 color; };\n"}});
+
+    const std::string source = ShaderPreprocessor::getInstance().process(".\\lamb_preprocessor_test\\lit.glsl");
+    EXPECT_EQ(source, "#version 460 core\n"
+                      "#line 1\n"
+                      "struct Light { vec3 color; };\n"
+                      "#line 3\n"
+                      "void main() {}\n");
+
+    EXPECT_EQ(ShaderPreprocessor::getInstance().process("lamb_preprocessor_test/missing.glsl"), "");
+    unmountSources();
+}
+
+TEST(ShaderPreprocessorTest, InjectsDefinesAfterVersion)
+{
+    mountSources({{"lit.glsl", "#version 460 core\nvoid main() {}\n"}});
+
+    const ShaderDefines defines = {{"SKINNED", ""}, {"LIGHTS", "4"}};
+    const std::string source = ShaderPreprocessor::getInstance().process("lamb_preprocessor_test/lit.glsl", defines);
+    EXPECT_EQ(source, "#version 460 core\n"
+                      "#define SKINNED\n"
+                      "#define LIGHTS 4\n"
+                      "#line 2\n"
+                      "void main() {}\n");
+    unmountSources();
+}
+
+TEST(ShaderPreprocessorTest, IncludesSharedFilesOnceAndStopsCycles)
+{
+    // a and b both include common; loop includes itself through again.
+    mountSources({{"main.glsl", "#include \"a.glsl\"\n#include \"b.glsl\"\n#include \"loop.glsl\"\n"},
+                  {"a.glsl", "#include \"common.glsl\"\nA\n"},
+                  {"b.glsl", "#include \"common.glsl\"\nB\n"},
+                  {"common.glsl", "COMMON\n"},
+                  {"loop.glsl", "#include \"again.glsl\"\nLOOP\n"},
+                  {"again.glsl", "#include \"loop.glsl\"\nAGAIN\n"}});
+
+    const std::string source = ShaderPreprocessor::getInstance().process("lamb_preprocessor_test/main.glsl");
+    const auto occurrences = [&source](const std::string& text) {
+        std::size_t count = 0;
+        for (std::size_t at = source.find(text); at != std::string::npos; at = source.find(text, at + 1))
+            ++count;
+        return count;
+    };
+    EXPECT_EQ(occurrences("COMMON"), 1u);
+    EXPECT_EQ(occurrences("A\n"), 1u);
+    EXPECT_EQ(occurrences("B\n"), 1u);
+    EXPECT_EQ(occurrences("LOOP"), 1u);
+    EXPECT_EQ(occurrences("AGAIN"), 1u);
+    EXPECT_LT(source.find("COMMON"), source.find("A\n"));
+    unmountSources();
+}
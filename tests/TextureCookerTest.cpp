@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bc_encoder.hpp"
+#include "ktx2.hpp"
+#include "mip_chain.hpp"
+
+TEST(TextureCookerTest, SolidBlockEncodesToExactEndpoints)
+{
+    std::uint8_t block[64];
+    for (int i = 0; i < 16; ++i)
+    {
+        block[i * 4 + 0] = 255;
+        block[i * 4 + 1] = 0;
+        block[i * 4 + 2] = 0;
+        block[i * 4 + 3] = 255;
+    }
+
+    std::uint8_t bc1[8];
+    Cooker::encodeBlock(Cooker::BlockFormat::BC1, block, bc1);
+    ASSERT_EQ(bc1[0] | (bc1[1] << 8), 0xF800); // pure red in 565
+    ASSERT_EQ(bc1[4] | bc1[5] | bc1[6] | bc1[7], 0);
+
+    std::uint8_t bc7[16];
+    Cooker::encodeBlock(Cooker::BlockFormat::BC7, block, bc7);
+    ASSERT_EQ(bc7[0] & 0x7F, 0x40); // mode 6
+}
+
+TEST(TextureCookerTest, MipChainGoesDownToOnePixel)
+{
+    Cooker::Image base;
+    base.width = 16;
+    base.height = 4;
+    base.pixels.assign(16 * 4 * 4, 200);
+
+    for (Cooker::MipFilter filter : {Cooker::MipFilter::BOX, Cooker::MipFilter::KAISER})
+    {
+        std::vector<Cooker::Image> chain = Cooker::buildMipChain(base, filter);
+        ASSERT_EQ(chain.size(), 5);
+        ASSERT_EQ(chain.back().width, 1);
+        ASSERT_EQ(chain.back().height, 1);
+        for (const Cooker::Image& level : chain)
+        {
+            for (std::uint8_t value : level.pixels)
+                ASSERT_EQ(value, 200); // a flat image stays flat
+        }
+    }
+}
+
+TEST(TextureCookerTest, Ktx2RoundTrip)
+{
+    IO::Ktx2Image image;
+    image.format = IO::Ktx2Format::BC1_RGB_UNORM;
+    image.width = 8;
+    image.height = 8;
+    for (std::uint32_t level = 0; level < 4; ++level)
+    {
+        std::size_t size = IO::levelByteSize(image.format, image.width >> level, image.height >> level);
+        image.levels.push_back(IO::Ktx2Level{image.data.size(), size});
+        for (std::size_t i = 0; i < size; ++i)
+            image.data.push_back(static_cast<std::uint8_t>(level * 16 + i));
+    }
+
+    std::vector<std::uint8_t> file = IO::encodeKTX2(image);
+    IO::Ktx2Image parsed = IO::parseKTX2(file.data(), file.size());
+
+    ASSERT_EQ(parsed.format, image.format);
+    ASSERT_EQ(parsed.width, 8);
+    ASSERT_EQ(parsed.height, 8);
+    ASSERT_EQ(parsed.layers(), 1);
+    ASSERT_EQ(parsed.levels.size(), 4);
+    ASSERT_EQ(parsed.data, image.data);
+}
+
+TEST(TextureCookerTest, Ktx2PartialReads)
+{
+    IO::Ktx2Image image;
+    image.format = IO::Ktx2Format::BC7_UNORM;
+    image.width = 64;
+    image.height = 64;
+    for (std::uint32_t level = 0; level < 7; ++level)
+    {
+        std::size_t size = IO::levelByteSize(image.format, image.width >> level, image.height >> level);
+        image.levels.push_back(IO::Ktx2Level{image.data.size(), size});
+        for (std::size_t i = 0; i < size; ++i)
+            image.data.push_back(static_cast<std::uint8_t>(level * 16 + i));
+    }
+
+    const std::vector<std::uint8_t> file = IO::encodeKTX2(image);
+
+    IO::Ktx2Image tail = IO::parseKTX2Tail(file.data(), file.size(), 16);
+    ASSERT_EQ(tail.firstLevel, 2);
+    ASSERT_EQ(tail.levels.size(), 7);
+    ASSERT_EQ(tail.levels[0].size, image.levels[0].size);
+    ASSERT_EQ(tail.data.size(), image.data.size() - image.levels[2].offset);
+    ASSERT_TRUE(std::equal(tail.data.begin(), tail.data.end(), image.data.begin() + image.levels[2].offset));
+
+    std::vector<std::uint8_t> top = IO::parseKTX2Level(file.data(), file.size(), 0);
+    ASSERT_EQ(top.size(), image.levels[0].size);
+    ASSERT_TRUE(std::equal(top.begin(), top.end(), image.data.begin()));
+}
+
+TEST(TextureCookerTest, Ktx2RejectsCorruptLevelIndex)
+{
+    IO::Ktx2Image image;
+    image.format = IO::Ktx2Format::R8G8B8A8_UNORM;
+    image.width = 4;
+    image.height = 4;
+    for (std::uint32_t level = 0; level < 3; ++level)
+    {
+        std::size_t size = IO::levelByteSize(image.format, image.width >> level, image.height >> level);
+        image.levels.push_back(IO::Ktx2Level{image.data.size(), size});
+        image.data.resize(image.data.size() + size);
+    }
+    const std::vector<std::uint8_t> file = IO::encodeKTX2(image);
+
+    auto put64 = [](std::vector<std::uint8_t>& bytes, std::size_t offset, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i)
+            bytes[offset + i] = static_cast<std::uint8_t>(value >> (8 * i));
+    };
+    auto rejected = [](const std::vector<std::uint8_t>& bytes) {
+        EXPECT_THROW(IO::parseKTX2(bytes.data(), bytes.size()), std::runtime_error);
+        EXPECT_THROW(IO::parseKTX2Tail(bytes.data(), bytes.size(), 1), std::runtime_error);
+        EXPECT_THROW(IO::parseKTX2Level(bytes.data(), bytes.size(), 0), std::runtime_error);
+    };
+
+    // An offset that wraps around when the size is added to it.
+    std::vector<std::uint8_t> wrapping = file;
+    put64(wrapping, 80, ~std::uint64_t(0) - 8);
+    rejected(wrapping);
+
+    // A size that fits in the file but not the level's dimensions.
+    std::vector<std::uint8_t> resized = file;
+    put64(resized, 80 + 8, 4);
+    rejected(resized);
+
+    // More levels than a 4x4 mip chain has.
+    std::vector<std::uint8_t> deep = file;
+    deep[40] = 40;
+    rejected(deep);
+}
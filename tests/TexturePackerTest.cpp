@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "texture_packer.hpp"
+
+namespace
+{
+
+Cooker::Image solidImage(std::uint32_t width, std::uint32_t height, std::uint8_t value)
+{
+    Cooker::Image image;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(static_cast<std::size_t>(width) * height * 4, value);
+    for (std::size_t i = 3; i < image.pixels.size(); i += 4)
+        image.pixels[i] = 255;
+    return image;
+}
+
+} // namespace
+
+TEST(TexturePackerTest, ShelfPackerOpensShelvesAndPages)
+{
+    Packer::ShelfPacker packer(64);
+
+    Packer::ShelfPacker::Placement a = packer.insert(40, 32);
+    Packer::ShelfPacker::Placement b = packer.insert(40, 32);
+    Packer::ShelfPacker::Placement c = packer.insert(40, 32);
+
+    ASSERT_EQ(a.page, 0);
+    ASSERT_EQ(a.x, 0);
+    ASSERT_EQ(b.page, 0);
+    ASSERT_EQ(b.y, 32);
+    ASSERT_EQ(c.page, 1);
+    ASSERT_EQ(packer.pageCount(), 2);
+    ASSERT_THROW(packer.insert(65, 1), std::runtime_error);
+}
+
+TEST(TexturePackerTest, GroupsBySizeAndAtlasesSmallImages)
+{
+    Packer::PackOptions options;
+    options.atlasThreshold = 16;
+    options.atlasSize = 64;
+    options.format = Cooker::BlockFormat::BC1;
+
+    std::vector<Packer::PackInput> inputs = {
+        {"a.png", solidImage(32, 32, 10)},
+        {"b.png", solidImage(32, 32, 20)},
+        {"c.png", solidImage(16, 8, 200)},
+    };
+
+    Packer::PackResult result = Packer::pack(inputs, options);
+
+    ASSERT_EQ(result.groups.size(), 2);
+    ASSERT_EQ(result.entries[0].group, result.entries[1].group);
+    ASSERT_EQ(result.entries[0].layer, 0);
+    ASSERT_EQ(result.entries[1].layer, 1);
+    ASSERT_EQ(result.groups[result.entries[0].group].layers.size(), 2);
+
+    const Packer::PackedEntry& small = result.entries[2];
+    const Packer::PackedGroup& atlas = result.groups[small.group];
+    ASSERT_TRUE(atlas.atlas);
+    ASSERT_FLOAT_EQ(small.uvScale[0], 16.0f / 64.0f);
+    ASSERT_FLOAT_EQ(small.uvScale[1], 8.0f / 64.0f);
+
+    // The image and its padding hold the image texels, nothing leaks from the cleared page.
+    const std::uint32_t x = static_cast<std::uint32_t>(small.uvOffset[0] * 64.0f) - options.padding;
+    const std::uint32_t y = static_cast<std::uint32_t>(small.uvOffset[1] * 64.0f) - options.padding;
+    ASSERT_EQ(atlas.layers[small.layer].pixels[(static_cast<std::size_t>(y) * 64 + x) * 4], 200);
+
+    IO::Ktx2Image image = Packer::compressGroup(result.groups[result.entries[0].group], options);
+    ASSERT_EQ(image.layers(), 2);
+    ASSERT_EQ(image.levels[0].size, 2 * IO::levelByteSize(image.format, 32, 32));
+}
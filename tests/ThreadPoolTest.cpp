@@ -0,0 +1,62 @@
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "thread_pool.hpp"
+
+TEST(ThreadPoolTest, RunsEveryTask)
+{
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures.push_back(pool.submit([&counter]() { counter++; }));
+
+    for (auto& future : futures)
+        future.get();
+
+    ASSERT_EQ(counter.load(), 100);
+}
+
+TEST(ThreadPoolTest, ReturnsResultsAndExceptions)
+{
+    ThreadPool pool(2);
+
+    auto value = pool.submit([]() { return 42; });
+    ASSERT_EQ(value.get(), 42);
+
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("decode failed"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce)
+{
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(), [&visits](std::size_t i) { visits[i]++; });
+
+    for (const auto& visit : visits)
+        ASSERT_EQ(visit.load(), 1);
+}
+
+TEST(ThreadPoolTest, ParallelForNestsAndRethrows)
+{
+    ThreadPool pool(2);
+    std::atomic<int> counter{0};
+
+    // Every worker blocks in an inner loop: callers must finish their own items.
+    pool.parallelFor(4, [&](std::size_t) { pool.parallelFor(10, [&](std::size_t) { counter++; }); });
+    ASSERT_EQ(counter.load(), 40);
+
+    EXPECT_THROW(pool.parallelFor(8,
+                                  [](std::size_t i) {
+                                      if (i == 5)
+                                          throw std::runtime_error("bad mesh");
+                                  }),
+                 std::runtime_error);
+}
@@ -0,0 +1,378 @@
+#include "asset_builder.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+#include "pack_file.hpp"
+#include "thread_pool.hpp"
+
+using json = nlohmann::json;
+
+namespace Builder
+{
+
+namespace
+{
+
+constexpr std::uint32_t DATABASE_VERSION = 1;
+
+/**
+ * Files modified this recently are hashed on every query, see BuildDatabase.
+ */
+constexpr auto RACY_WINDOW = std::chrono::seconds(2);
+
+std::uint64_t hashString(const std::string& text, std::uint64_t seed)
+{
+    // The length goes first so consecutive strings cannot run into each other.
+    const std::uint64_t length = text.size();
+    return hashContent(text.data(), text.size(), hashContent(&length, sizeof(length), seed));
+}
+
+} // namespace
+
+std::uint64_t hashContent(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    std::uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void BuildDatabase::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return;
+
+    json root;
+    try
+    {
+        root = json::parse(file);
+    }
+    catch (const json::exception&)
+    {
+        return;
+    }
+    if (root.value("version", 0u) != DATABASE_VERSION)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, stamp] : root["files"].items())
+    {
+        m_files[name] =
+            FileStamp{stamp[0].get<std::uint64_t>(), stamp[1].get<std::int64_t>(), stamp[2].get<std::uint64_t>()};
+    }
+
+    for (const auto& [output, entry] : root["records"].items())
+    {
+        Record record;
+        record.key = entry["key"].get<std::uint64_t>();
+        record.outputHash = entry["output"].get<std::uint64_t>();
+        for (const auto& input : entry["inputs"])
+            record.inputs.emplace_back(input[0].get<std::string>(), input[1].get<std::uint64_t>());
+        m_records[output] = std::move(record);
+    }
+}
+
+void BuildDatabase::save(const std::string& path) const
+{
+    json root;
+    root["version"] = DATABASE_VERSION;
+    root["files"] = json::object();
+    root["records"] = json::object();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& [name, stamp] : m_files)
+            root["files"][name] = {stamp.size, stamp.mtime, stamp.hash};
+
+        for (const auto& [output, record] : m_records)
+        {
+            json inputs = json::array();
+            for (const auto& [input, hash] : record.inputs)
+                inputs.push_back({input, hash});
+            root["records"][output] = {{"key", record.key}, {"output", record.outputHash}, {"inputs", inputs}};
+        }
+    }
+
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path());
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file || !(file << root.dump(1)))
+            throw std::runtime_error("Cannot write " + temporary);
+    }
+    std::filesystem::rename(temporary, target);
+}
+
+std::uint64_t BuildDatabase::hashFile(const std::string& path)
+{
+    std::error_code error;
+    const std::uint64_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return 0;
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+    if (error)
+        return 0;
+    const std::int64_t mtime = time.time_since_epoch().count();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_files.find(path);
+        if (it != m_files.end() && it->second.size == size && it->second.mtime == mtime)
+            return it->second.hash;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return 0;
+
+    std::uint64_t hash = hashContent(nullptr, 0);
+    char buffer[64 * 1024];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+        hash = hashContent(buffer, static_cast<std::size_t>(file.gcount()), hash);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (std::filesystem::file_time_type::clock::now() - time > RACY_WINDOW)
+        m_files[path] = FileStamp{size, mtime, hash};
+    else
+        m_files.erase(path);
+    return hash;
+}
+
+std::optional<BuildDatabase::Record> BuildDatabase::record(const std::string& output) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_records.find(output);
+    if (it == m_records.end())
+        return std::nullopt;
+    return it->second;
+}
+
+void BuildDatabase::setRecord(const std::string& output, Record record)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_records[output] = std::move(record);
+}
+
+void BuildDatabase::forget(const std::string& output)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_records.erase(output);
+}
+
+AssetBuilder::AssetBuilder(std::string databasePath) : m_databasePath(std::move(databasePath))
+{
+    m_database.load(m_databasePath);
+}
+
+void AssetBuilder::registerCooker(const std::string& name, std::uint32_t version, CookFunction cook)
+{
+    m_cookers[name] = Cooker{version, std::move(cook)};
+}
+
+void AssetBuilder::addRule(BuildRule rule)
+{
+    for (std::string& input : rule.inputs)
+        input = IO::normalizePackPath(input);
+    rule.output = IO::normalizePackPath(rule.output);
+    m_rules.push_back(std::move(rule));
+}
+
+BuildStats AssetBuilder::build(bool force)
+{
+    std::vector<std::vector<std::size_t>> dependencies;
+    const std::vector<std::vector<std::size_t>> waves = schedule(dependencies);
+
+    enum class State : std::uint8_t
+    {
+        PENDING,
+        DONE,
+        FAILED
+    };
+    std::vector<State> states(m_rules.size(), State::PENDING);
+
+    BuildStats stats;
+    stats.waves = waves.size();
+    std::atomic<std::size_t> cooked = 0;
+    std::atomic<std::size_t> upToDate = 0;
+    std::mutex errorMutex;
+
+    for (const std::vector<std::size_t>& wave : waves)
+    {
+        ThreadPool::getInstance().parallelFor(wave.size(), [&](std::size_t i) {
+            const std::size_t index = wave[i];
+            const BuildRule& rule = m_rules[index];
+
+            // States of earlier waves are no longer written, so they are safe to read here.
+            for (std::size_t dependency : dependencies[index])
+            {
+                if (states[dependency] == State::FAILED)
+                {
+                    m_database.forget(rule.output);
+                    states[index] = State::FAILED;
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    stats.errors.push_back(rule.output + ": skipped, " + m_rules[dependency].output + " failed");
+                    return;
+                }
+            }
+
+            const std::uint64_t key = ruleKey(rule);
+            if (!force && isUpToDate(rule, key))
+            {
+                upToDate++;
+                states[index] = State::DONE;
+                return;
+            }
+
+            try
+            {
+                cook(rule, key);
+                cooked++;
+                states[index] = State::DONE;
+            }
+            catch (const std::exception& e)
+            {
+                m_database.forget(rule.output);
+                states[index] = State::FAILED;
+                std::lock_guard<std::mutex> lock(errorMutex);
+                stats.errors.push_back(rule.output + ": " + e.what());
+            }
+        });
+    }
+
+    stats.cooked = cooked;
+    stats.upToDate = upToDate;
+    stats.failed = stats.errors.size();
+    m_database.save(m_databasePath);
+    return stats;
+}
+
+std::vector<std::vector<std::size_t>> AssetBuilder::schedule(std::vector<std::vector<std::size_t>>& dependencies) const
+{
+    std::unordered_map<std::string, std::size_t> producers;
+    for (std::size_t i = 0; i < m_rules.size(); ++i)
+    {
+        if (!m_cookers.contains(m_rules[i].cooker))
+            throw std::runtime_error(m_rules[i].output + ": unknown cooker " + m_rules[i].cooker);
+        if (!producers.emplace(m_rules[i].output, i).second)
+            throw std::runtime_error(m_rules[i].output + " is written by two rules");
+    }
+
+    dependencies.assign(m_rules.size(), {});
+    std::vector<std::vector<std::size_t>> dependents(m_rules.size());
+    std::vector<std::size_t> remaining(m_rules.size(), 0);
+    for (std::size_t i = 0; i < m_rules.size(); ++i)
+    {
+        for (const std::string& input : m_rules[i].inputs)
+        {
+            auto it = producers.find(input);
+            if (it == producers.end())
+                continue;
+            dependencies[i].push_back(it->second);
+            dependents[it->second].push_back(i);
+            remaining[i]++;
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> waves;
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < m_rules.size(); ++i)
+    {
+        if (remaining[i] == 0)
+            ready.push_back(i);
+    }
+
+    std::size_t scheduled = 0;
+    while (!ready.empty())
+    {
+        std::vector<std::size_t> next;
+        for (std::size_t rule : ready)
+        {
+            for (std::size_t dependent : dependents[rule])
+            {
+                if (--remaining[dependent] == 0)
+                    next.push_back(dependent);
+            }
+        }
+        scheduled += ready.size();
+        waves.push_back(std::move(ready));
+        ready = std::move(next);
+    }
+
+    if (scheduled != m_rules.size())
+        throw std::runtime_error("The build rules form a dependency cycle");
+    return waves;
+}
+
+std::uint64_t AssetBuilder::ruleKey(const BuildRule& rule) const
+{
+    const std::uint32_t version = m_cookers.at(rule.cooker).version;
+    std::uint64_t key = hashString(rule.cooker, hashContent(nullptr, 0));
+    key = hashContent(&version, sizeof(version), key);
+    for (const std::string& input : rule.inputs)
+        key = hashString(input, key);
+    key = hashString(rule.output, key);
+    for (const auto& [name, value] : rule.options)
+        key = hashString(value, hashString(name, key));
+    return key;
+}
+
+bool AssetBuilder::isUpToDate(const BuildRule& rule, std::uint64_t key)
+{
+    const std::optional<BuildDatabase::Record> record = m_database.record(rule.output);
+    if (!record || record->key != key || m_database.hashFile(rule.output) != record->outputHash)
+        return false;
+
+    for (const auto& [input, hash] : record->inputs)
+    {
+        if (m_database.hashFile(input) != hash)
+            return false;
+    }
+    return true;
+}
+
+void AssetBuilder::cook(const BuildRule& rule, std::uint64_t key)
+{
+    // Inputs are hashed before cooking, so an edit made while the cooker runs is seen by the next build.
+    BuildDatabase::Record record;
+    record.key = key;
+    for (const std::string& input : rule.inputs)
+    {
+        const std::uint64_t hash = m_database.hashFile(input);
+        if (hash == 0)
+            throw std::runtime_error("Missing input " + input);
+        record.inputs.emplace_back(input, hash);
+    }
+
+    const std::filesystem::path output(rule.output);
+    if (output.has_parent_path())
+        std::filesystem::create_directories(output.parent_path());
+
+    for (const std::string& path : m_cookers.at(rule.cooker).cook(rule))
+    {
+        const std::string input = IO::normalizePackPath(path);
+        const std::uint64_t hash = m_database.hashFile(input);
+        if (hash == 0)
+            throw std::runtime_error("Missing input " + input);
+        record.inputs.emplace_back(input, hash);
+    }
+
+    record.outputHash = m_database.hashFile(rule.output);
+    if (record.outputHash == 0)
+        throw std::runtime_error("The cooker did not write the output");
+    m_database.setRecord(rule.output, std::move(record));
+}
+
+} // namespace Builder
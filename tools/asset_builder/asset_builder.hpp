@@ -0,0 +1,228 @@
+#ifndef ASSET_BUILDER_HPP_
+#define ASSET_BUILDER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Builder
+{
+/**
+ * @struct BuildRule
+ * @brief One cooking step: a cooker turning input files into one output file.
+ */
+struct BuildRule
+{
+    std::string cooker;                         /**< Name of the registered cooker. */
+    std::vector<std::string> inputs;            /**< Files the cooker reads, possibly outputs of other rules. */
+    std::string output;                         /**< File the cooker writes. */
+    std::map<std::string, std::string> options; /**< Cooker options, part of the rule key. */
+};
+
+/**
+ * @brief Cooks a rule.
+ *
+ * Writes rule.output and returns the files it read besides rule.inputs, such as
+ * shader includes, so edits to them are tracked too. These discovered inputs must
+ * be source files, not outputs of other rules.
+ *
+ * @throw std::exception If the rule cannot be cooked.
+ */
+using CookFunction = std::function<std::vector<std::string>(const BuildRule& rule)>;
+
+/**
+ * @struct BuildStats
+ * @brief What AssetBuilder::build() did.
+ */
+struct BuildStats
+{
+    std::size_t cooked = 0;          /**< Rules cooked because an input, an option or the output changed. */
+    std::size_t upToDate = 0;        /**< Rules skipped. */
+    std::size_t failed = 0;          /**< Rules whose cooker threw, or with a failed dependency. */
+    std::size_t waves = 0;           /**< Number of dependency levels, each cooked in parallel. */
+    std::vector<std::string> errors; /**< One message per failed rule. */
+};
+
+/**
+ * @brief Hashes bytes for the build database.
+ *
+ * @param data The bytes.
+ * @param size Number of bytes.
+ * @param seed Hash to continue from, to hash several buffers as one.
+ * @return The 64-bit FNV-1a hash.
+ */
+std::uint64_t hashContent(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ull);
+
+/**
+ * @class BuildDatabase
+ * @brief Content hashes of files and of what every output was last cooked from.
+ *
+ * File hashes are remembered with the file size and modification time, so an
+ * unchanged file is not read again. Files modified in the last two seconds are
+ * always hashed again, since a second edit could keep both. Safe to use from
+ * several threads at once.
+ */
+class BuildDatabase
+{
+public:
+    /**
+     * @struct Record
+     * @brief How an output was cooked.
+     */
+    struct Record
+    {
+        std::uint64_t key = 0;                                     /**< Hash of the cooker, options and paths. */
+        std::vector<std::pair<std::string, std::uint64_t>> inputs; /**< Every file read and its content hash. */
+        std::uint64_t outputHash = 0;                              /**< Content hash of the output. */
+    };
+
+    /**
+     * @brief Loads a database. A missing or unreadable file gives an empty database.
+     *
+     * @param path The database file.
+     */
+    void load(const std::string& path);
+
+    /**
+     * @brief Saves the database, replacing the file atomically.
+     *
+     * @param path The database file.
+     *
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Gets the content hash of a file.
+     *
+     * @param path The file.
+     * @return The hash, 0 if the file does not exist.
+     */
+    std::uint64_t hashFile(const std::string& path);
+
+    /**
+     * @brief Gets how an output was last cooked.
+     *
+     * @param output The output path.
+     * @return The record, empty if the output was never cooked or its cooking failed.
+     */
+    std::optional<Record> record(const std::string& output) const;
+
+    /**
+     * @brief Remembers how an output was cooked.
+     *
+     * @param output The output path.
+     * @param record The record.
+     */
+    void setRecord(const std::string& output, Record record);
+
+    /**
+     * @brief Forgets an output, so it is cooked again by the next build.
+     *
+     * @param output The output path.
+     */
+    void forget(const std::string& output);
+
+private:
+    /**
+     * @struct FileStamp
+     * @brief A remembered file hash and what the file looked like when it was hashed.
+     */
+    struct FileStamp
+    {
+        std::uint64_t size = 0; /**< File size. */
+        std::int64_t mtime = 0; /**< Modification time, in file clock ticks. */
+        std::uint64_t hash = 0; /**< Content hash. */
+    };
+
+    mutable std::mutex m_mutex;                         /**< Guards both maps. */
+    std::unordered_map<std::string, FileStamp> m_files; /**< Remembered file hashes. */
+    std::unordered_map<std::string, Record> m_records;  /**< Records, by output path. */
+};
+
+/**
+ * @class AssetBuilder
+ * @brief Incremental asset build over a dependency graph of rules.
+ *
+ * A rule depends on the rules writing its inputs. build() orders the rules in
+ * waves of independent rules and cooks each wave on the ThreadPool. A rule is
+ * cooked again only when its cooker version, options, paths, the content of any
+ * file it read, or its output changed since the last build. Since inputs are
+ * compared by content, a dependency cooked again to the same bytes does not
+ * cook its dependents again.
+ */
+class AssetBuilder
+{
+public:
+    /**
+     * @brief Creates a builder and loads its database.
+     *
+     * @param databasePath The build database file, written by build().
+     */
+    explicit AssetBuilder(std::string databasePath);
+
+    /**
+     * @brief Registers a cooker.
+     *
+     * @param name The name rules refer to.
+     * @param version Bump it whenever the cooker output changes, to cook its rules again.
+     * @param cook The cook function, called from worker threads.
+     */
+    void registerCooker(const std::string& name, std::uint32_t version, CookFunction cook);
+
+    /**
+     * @brief Adds a rule. Paths are normalized.
+     *
+     * @param rule The rule.
+     */
+    void addRule(BuildRule rule);
+
+    /**
+     * @brief Cooks every rule that is not up to date, then saves the database.
+     *
+     * @param force Cook every rule, whatever the database says.
+     * @return What was cooked.
+     *
+     * @throw std::runtime_error If a rule names an unknown cooker, two rules write
+     *        the same output, or the rules form a cycle.
+     */
+    BuildStats build(bool force = false);
+
+private:
+    /**
+     * @struct Cooker
+     * @brief A registered cooker.
+     */
+    struct Cooker
+    {
+        std::uint32_t version = 0; /**< Version, part of the rule key. */
+        CookFunction cook;         /**< The cook function. */
+    };
+
+    /**
+     * @brief Orders the rules in dependency levels.
+     *
+     * @param dependencies Filled with the rules each rule depends on.
+     * @return The rule indices of every level, dependencies first.
+     */
+    std::vector<std::vector<std::size_t>> schedule(std::vector<std::vector<std::size_t>>& dependencies) const;
+
+    std::uint64_t ruleKey(const BuildRule& rule) const;
+    bool isUpToDate(const BuildRule& rule, std::uint64_t key);
+    void cook(const BuildRule& rule, std::uint64_t key);
+
+    std::string m_databasePath;                        /**< Where the database is saved. */
+    BuildDatabase m_database;                          /**< Hashes and records. */
+    std::unordered_map<std::string, Cooker> m_cookers; /**< Cookers, by name. */
+    std::vector<BuildRule> m_rules;                    /**< Rules, in the order they were added. */
+};
+}; // namespace Builder
+
+#endif
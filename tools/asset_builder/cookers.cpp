@@ -0,0 +1,222 @@
+#include "cookers.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include "pack_file.hpp"
+#include "texture_cooker.hpp"
+
+namespace Builder
+{
+
+namespace
+{
+
+std::string readText(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open " + path);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeText(const std::string& path, const std::string& text)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(text.data(), static_cast<std::streamsize>(text.size())))
+        throw std::runtime_error("Cannot write " + path);
+}
+
+std::string option(const BuildRule& rule, const std::string& name, const std::string& fallback)
+{
+    auto it = rule.options.find(name);
+    return it == rule.options.end() ? fallback : it->second;
+}
+
+const std::string& singleInput(const BuildRule& rule)
+{
+    if (rule.inputs.size() != 1)
+        throw std::runtime_error("The " + rule.cooker + " cooker takes exactly one input");
+    return rule.inputs[0];
+}
+
+/**
+ * Extracts the file name of an `#include "file"` line, or returns an empty string.
+ */
+std::string includeTarget(const std::string& line)
+{
+    std::size_t pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line[pos] != '#')
+        return "";
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+        return "";
+
+    const std::size_t open = line.find('"', pos + 7);
+    const std::size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+    if (close == std::string::npos)
+        return "";
+    return line.substr(open + 1, close - open - 1);
+}
+
+void expand(const std::string& path, std::vector<std::string>& included, std::vector<std::string>& stack,
+            std::string& output)
+{
+    if (std::find(stack.begin(), stack.end(), path) != stack.end())
+        throw std::runtime_error("Shader include cycle through " + path);
+    if (std::find(included.begin(), included.end(), path) != included.end())
+        return;
+    if (!stack.empty())
+        included.push_back(path);
+
+    std::istringstream file(readText(path));
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+    stack.push_back(path);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        const std::string target = includeTarget(line);
+        if (target.empty())
+        {
+            output += line;
+            output += '\n';
+            continue;
+        }
+
+        output += "#line 1\n";
+        expand(IO::normalizePackPath((directory / IO::normalizePackPath(target)).string()), included, stack, output);
+        output += "#line " + std::to_string(lineNumber + 1) + "\n";
+    }
+    stack.pop_back();
+}
+
+std::vector<std::string> cookTexture(const BuildRule& rule)
+{
+    Cooker::TextureCookOptions options;
+    options.input = singleInput(rule);
+    options.output = rule.output;
+
+    const std::string format = option(rule, "format", "auto");
+    if (format == "bc1")
+        options.format = Cooker::BlockFormat::BC1;
+    else if (format == "bc3")
+        options.format = Cooker::BlockFormat::BC3;
+    else if (format == "bc5")
+        options.format = Cooker::BlockFormat::BC5;
+    else if (format == "bc7")
+        options.format = Cooker::BlockFormat::BC7;
+    else if (format != "auto")
+        throw std::runtime_error("Unknown format: " + format);
+
+    options.filter = option(rule, "filter", "box") == "kaiser" ? Cooker::MipFilter::KAISER : Cooker::MipFilter::BOX;
+    options.srgb = option(rule, "srgb", "false") == "true";
+    options.mipmaps = option(rule, "mipmaps", "true") == "true";
+
+    Cooker::cookTexture(options);
+    return {};
+}
+
+std::vector<std::string> cookShader(const BuildRule& rule)
+{
+    std::vector<std::string> included;
+    writeText(rule.output, expandShader(singleInput(rule), included));
+    return included;
+}
+
+std::vector<std::string> cookMaterial(const BuildRule& rule)
+{
+    const std::string name = option(rule, "name", "");
+    if (name.empty())
+        throw std::runtime_error("The material cooker needs a name option");
+    writeText(rule.output, extractMaterial(readText(singleInput(rule)), name));
+    return {};
+}
+
+std::vector<std::string> cookCopy(const BuildRule& rule)
+{
+    std::filesystem::copy_file(singleInput(rule), rule.output, std::filesystem::copy_options::overwrite_existing);
+    return {};
+}
+
+std::vector<std::string> cookPack(const BuildRule& rule)
+{
+    const std::filesystem::path root = std::filesystem::absolute(option(rule, "root", ".")).lexically_normal();
+
+    std::vector<IO::PackInput> inputs;
+    for (const std::string& input : rule.inputs)
+    {
+        const std::filesystem::path relative = std::filesystem::absolute(input).lexically_relative(root);
+        if (relative.empty() || *relative.begin() == "..")
+            throw std::runtime_error(input + " is outside of the root directory");
+
+        const std::string text = readText(input);
+        inputs.push_back(IO::PackInput{relative.generic_string(), std::vector<std::uint8_t>(text.begin(), text.end())});
+    }
+
+    IO::writePack(rule.output, inputs, option(rule, "lz4", "false") == "true");
+    return {};
+}
+
+} // namespace
+
+std::string expandShader(const std::string& path, std::vector<std::string>& included)
+{
+    std::vector<std::string> stack;
+    std::string source;
+    expand(IO::normalizePackPath(path), included, stack, source);
+    return source;
+}
+
+std::string extractMaterial(const std::string& library, const std::string& name)
+{
+    std::istringstream file(library);
+    std::string material;
+    std::string line;
+    bool inside = false;
+    while (std::getline(file, line))
+    {
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+
+        std::istringstream iss(line);
+        std::string identifier;
+        iss >> identifier;
+        if (identifier.empty())
+            continue;
+
+        if (identifier == "newmtl")
+        {
+            std::string materialName;
+            iss >> materialName;
+            if (inside)
+                break;
+            inside = materialName == name;
+        }
+        if (inside)
+            material += line.substr(line.find_first_not_of(" \t")) + "\n";
+    }
+
+    if (material.empty())
+        throw std::runtime_error("No material named " + name);
+    return material;
+}
+
+void registerDefaultCookers(AssetBuilder& builder)
+{
+    builder.registerCooker("texture", 1, cookTexture);
+    builder.registerCooker("shader", 1, cookShader);
+    builder.registerCooker("material", 1, cookMaterial);
+    builder.registerCooker("copy", 1, cookCopy);
+    builder.registerCooker("pack", 1, cookPack);
+}
+
+} // namespace Builder
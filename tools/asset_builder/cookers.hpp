@@ -0,0 +1,51 @@
+#ifndef COOKERS_HPP_
+#define COOKERS_HPP_
+
+#include <string>
+#include <vector>
+
+#include "asset_builder.hpp"
+
+namespace Builder
+{
+/**
+ * @brief Expands the `#include "file"` directives of a shader into one source.
+ *
+ * Same rules as the engine ShaderPreprocessor: includes are relative to the
+ * including file, each file is inserted once and `#line` directives keep
+ * compiler messages pointing at the right line.
+ *
+ * @param path The shader file.
+ * @param included Filled with the files included, directly or not.
+ * @return The expanded source.
+ *
+ * @throw std::runtime_error If a file cannot be read or the includes form a cycle.
+ */
+std::string expandShader(const std::string& path, std::vector<std::string>& included);
+
+/**
+ * @brief Extracts one material of a Material Template Library file, comments stripped.
+ *
+ * @param library The MTL source.
+ * @param name The `newmtl` name of the material.
+ * @return The material, as an MTL source holding it alone.
+ *
+ * @throw std::runtime_error If the library has no such material.
+ */
+std::string extractMaterial(const std::string& library, const std::string& name);
+
+/**
+ * @brief Registers the cookers of the engine asset types.
+ *
+ * - texture: image to KTX2, options format, filter, srgb and mipmaps as in LambTextureCooker.
+ * - shader: shader with its includes expanded, includes tracked as inputs.
+ * - material: one material of a .mtl library, option name.
+ * - copy: the input as is.
+ * - pack: every input in a pack file, options root and lz4 as in LambAssetPacker.
+ *
+ * @param builder The builder.
+ */
+void registerDefaultCookers(AssetBuilder& builder);
+}; // namespace Builder
+
+#endif
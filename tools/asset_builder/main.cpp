@@ -0,0 +1,101 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "asset_builder.hpp"
+#include "cookers.hpp"
+#include "stb_image.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+
+void printUsage()
+{
+    std::cout << "Usage: LambAssetBuilder <manifest.json> [options]\n"
+              << "  --database <file>  Build database (default: the manifest database entry, or .asset_build.json)\n"
+              << "  --force            Cook every rule, ignoring the database\n";
+}
+
+Builder::BuildRule parseRule(const json& entry)
+{
+    Builder::BuildRule rule;
+    rule.cooker = entry.at("cooker").get<std::string>();
+    rule.output = entry.at("output").get<std::string>();
+    if (entry.contains("input"))
+        rule.inputs.push_back(entry["input"].get<std::string>());
+    for (const auto& input : entry.value("inputs", json::array()))
+        rule.inputs.push_back(input.get<std::string>());
+    for (const auto& [name, value] : entry.value("options", json::object()).items())
+        rule.options[name] = value.is_string() ? value.get<std::string>() : value.dump();
+    return rule;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const std::string manifestPath = argv[1];
+    std::string database;
+    bool force = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--database" && i + 1 < argc)
+        {
+            database = argv[++i];
+        }
+        else if (arg == "--force")
+        {
+            force = true;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    try
+    {
+        std::ifstream file(manifestPath);
+        if (!file)
+            throw std::runtime_error("Cannot open " + manifestPath);
+        const json manifest = json::parse(file);
+        if (database.empty())
+            database = manifest.value("database", ".asset_build.json");
+
+        Builder::AssetBuilder builder(database);
+        Builder::registerDefaultCookers(builder);
+        for (const auto& entry : manifest.at("rules"))
+            builder.addRule(parseRule(entry));
+
+        const auto start = std::chrono::steady_clock::now();
+        const Builder::BuildStats stats = builder.build(force);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const std::string& error : stats.errors)
+            std::cerr << error << std::endl;
+        std::cout << stats.cooked << " cooked, " << stats.upToDate << " up to date, " << stats.failed << " failed in "
+                  << stats.waves << " waves (" << seconds << " s)" << std::endl;
+        return stats.failed == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Build failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
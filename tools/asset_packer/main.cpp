@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pack_file.hpp"
+
+namespace
+{
+
+void printUsage()
+{
+    std::cout << "Usage: LambAssetPacker <output.pak> <inputs...> [options]\n"
+              << "  Inputs are files or directories, packed recursively.\n"
+              << "  --root <dir>  Entry paths are relative to this directory (default: current directory)\n"
+              << "  --lz4         Store entries as LZ4 when it saves at least 1/8 of their size\n";
+}
+
+std::vector<std::uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open " + path.string());
+    return std::vector<std::uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void addInput(const std::filesystem::path& file, const std::filesystem::path& root, std::vector<IO::PackInput>& inputs)
+{
+    const std::filesystem::path relative = std::filesystem::absolute(file).lexically_relative(root);
+    if (relative.empty() || *relative.begin() == "..")
+        throw std::runtime_error(file.string() + " is outside of the root directory");
+    inputs.push_back(IO::PackInput{relative.generic_string(), readFile(file)});
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const std::string output = argv[1];
+    std::filesystem::path root = std::filesystem::current_path();
+    bool compress = false;
+    std::vector<std::string> sources;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc)
+        {
+            root = argv[++i];
+        }
+        else if (arg == "--lz4")
+        {
+            compress = true;
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            sources.push_back(arg);
+        }
+    }
+
+    try
+    {
+        root = std::filesystem::absolute(root).lexically_normal();
+
+        std::vector<IO::PackInput> inputs;
+        for (const std::string& source : sources)
+        {
+            if (std::filesystem::is_directory(source))
+            {
+                for (const auto& item : std::filesystem::recursive_directory_iterator(source))
+                {
+                    if (item.is_regular_file())
+                        addInput(item.path(), root, inputs);
+                }
+            }
+            else
+            {
+                addInput(source, root, inputs);
+            }
+        }
+
+        const IO::PackStats stats = IO::writePack(output, inputs, compress);
+        std::cout << output << ": " << stats.entries << " files, " << stats.blobs << " distinct ("
+                  << stats.compressed << " LZ4), " << stats.inputBytes << " bytes in, " << stats.storedBytes
+                  << " bytes stored" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Packing failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
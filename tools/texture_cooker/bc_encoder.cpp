@@ -0,0 +1,356 @@
+#include "bc_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "thread_pool.hpp"
+
+namespace Cooker
+{
+
+namespace
+{
+
+/**
+ * Principal axis of the block colors, by power iteration on the covariance matrix.
+ * Endpoints are the extreme projections of the pixels onto that axis.
+ */
+template <int N> void fitEndpoints(const std::uint8_t rgba[64], float lo[N], float hi[N])
+{
+    float mean[N] = {};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < N; ++c)
+            mean[c] += rgba[i * 4 + c];
+    for (int c = 0; c < N; ++c)
+        mean[c] /= 16.0f;
+
+    float cov[N][N] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        float d[N];
+        for (int c = 0; c < N; ++c)
+            d[c] = rgba[i * 4 + c] - mean[c];
+        for (int a = 0; a < N; ++a)
+            for (int b = 0; b < N; ++b)
+                cov[a][b] += d[a] * d[b];
+    }
+
+    float axis[N];
+    for (int c = 0; c < N; ++c)
+        axis[c] = 1.0f;
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[N] = {};
+        for (int a = 0; a < N; ++a)
+            for (int b = 0; b < N; ++b)
+                next[a] += cov[a][b] * axis[b];
+
+        float length = 0.0f;
+        for (int c = 0; c < N; ++c)
+            length += next[c] * next[c];
+        if (length < 1e-12f)
+            break;
+
+        length = std::sqrt(length);
+        for (int c = 0; c < N; ++c)
+            axis[c] = next[c] / length;
+    }
+
+    float tMin = 0.0f, tMax = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+        float t = 0.0f;
+        for (int c = 0; c < N; ++c)
+            t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    for (int c = 0; c < N; ++c)
+    {
+        lo[c] = std::clamp(mean[c] + tMin * axis[c], 0.0f, 255.0f);
+        hi[c] = std::clamp(mean[c] + tMax * axis[c], 0.0f, 255.0f);
+    }
+}
+
+std::uint16_t to565(const float color[3])
+{
+    auto r = static_cast<std::uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+    auto g = static_cast<std::uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+    auto b = static_cast<std::uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void from565(std::uint16_t packed, int color[3])
+{
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+void encodeColorBlock(const std::uint8_t rgba[64], std::uint8_t* out)
+{
+    float lo[3], hi[3];
+    fitEndpoints<3>(rgba, lo, hi);
+
+    std::uint16_t c0 = to565(hi);
+    std::uint16_t c1 = to565(lo);
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    std::uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        int palette[4][3];
+        from565(c0, palette[0]);
+        from565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0, bestError = INT32_MAX;
+            for (int p = 0; p < 4; ++p)
+            {
+                int error = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    int d = rgba[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= static_cast<std::uint32_t>(best) << (2 * i);
+        }
+    }
+
+    out[0] = static_cast<std::uint8_t>(c0);
+    out[1] = static_cast<std::uint8_t>(c0 >> 8);
+    out[2] = static_cast<std::uint8_t>(c1);
+    out[3] = static_cast<std::uint8_t>(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        out[4 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+}
+
+void encodeChannelBlock(const std::uint8_t rgba[64], int channel, std::uint8_t* out)
+{
+    int lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        lo = std::min<int>(lo, rgba[i * 4 + channel]);
+        hi = std::max<int>(hi, rgba[i * 4 + channel]);
+    }
+
+    std::memset(out, 0, 8);
+    out[0] = static_cast<std::uint8_t>(hi);
+    out[1] = static_cast<std::uint8_t>(lo);
+    if (hi == lo)
+        return;
+
+    // hi > lo selects the 8 value mode: codes 2..7 interpolate from hi to lo.
+    int palette[8] = {hi, lo};
+    for (int code = 2; code < 8; ++code)
+        palette[code] = ((8 - code) * hi + (code - 1) * lo) / 7;
+
+    std::uint64_t indices = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int value = rgba[i * 4 + channel];
+        int best = 0, bestError = INT32_MAX;
+        for (int code = 0; code < 8; ++code)
+        {
+            int error = std::abs(value - palette[code]);
+            if (error < bestError)
+            {
+                bestError = error;
+                best = code;
+            }
+        }
+        indices |= static_cast<std::uint64_t>(best) << (3 * i);
+    }
+
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+}
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::uint8_t* out) : m_out(out) {}
+
+    void write(std::uint32_t value, int bits)
+    {
+        for (int i = 0; i < bits; ++i, ++m_position)
+        {
+            if ((value >> i) & 1u)
+                m_out[m_position >> 3] |= static_cast<std::uint8_t>(1u << (m_position & 7));
+        }
+    }
+
+private:
+    std::uint8_t* m_out;
+    int m_position = 0;
+};
+
+/**
+ * Quantizes a BC7 mode 6 endpoint (7 bits per channel plus a shared p-bit),
+ * keeping the p-bit that reconstructs the endpoint with the smallest error.
+ */
+void quantizeMode6Endpoint(const float endpoint[4], int quantized[4], int& pBit)
+{
+    int bestError = INT32_MAX;
+    for (int p = 0; p < 2; ++p)
+    {
+        int candidate[4];
+        int error = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+            candidate[c] = std::clamp(static_cast<int>(std::lround((endpoint[c] - p) / 2.0f)), 0, 127);
+            int d = static_cast<int>(std::lround(endpoint[c])) - ((candidate[c] << 1) | p);
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            pBit = p;
+            std::copy(candidate, candidate + 4, quantized);
+        }
+    }
+}
+
+void encodeBC7Mode6(const std::uint8_t rgba[64], std::uint8_t* out)
+{
+    static constexpr int WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    float lo[4], hi[4];
+    fitEndpoints<4>(rgba, lo, hi);
+
+    int q0[4], q1[4], p0 = 0, p1 = 0;
+    quantizeMode6Endpoint(lo, q0, p0);
+    quantizeMode6Endpoint(hi, q1, p1);
+
+    int e0[4], e1[4];
+    for (int c = 0; c < 4; ++c)
+    {
+        e0[c] = (q0[c] << 1) | p0;
+        e1[c] = (q1[c] << 1) | p1;
+    }
+
+    int palette[16][4];
+    for (int w = 0; w < 16; ++w)
+        for (int c = 0; c < 4; ++c)
+            palette[w][c] = ((64 - WEIGHTS[w]) * e0[c] + WEIGHTS[w] * e1[c] + 32) >> 6;
+
+    int indices[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        int best = 0, bestError = INT32_MAX;
+        for (int w = 0; w < 16; ++w)
+        {
+            int error = 0;
+            for (int c = 0; c < 4; ++c)
+            {
+                int d = rgba[i * 4 + c] - palette[w][c];
+                error += d * d;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                best = w;
+            }
+        }
+        indices[i] = best;
+    }
+
+    // The anchor index is stored with 3 bits, its high bit must be zero.
+    if (indices[0] & 8)
+    {
+        std::swap(q0, q1);
+        std::swap(p0, p1);
+        for (int& index : indices)
+            index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer(out);
+    writer.write(1u << 6, 7);
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.write(q0[c], 7);
+        writer.write(q1[c], 7);
+    }
+    writer.write(p0, 1);
+    writer.write(p1, 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < 16; ++i)
+        writer.write(indices[i], 4);
+}
+
+} // namespace
+
+void encodeBlock(BlockFormat format, const std::uint8_t rgba[64], std::uint8_t* out)
+{
+    switch (format)
+    {
+        case BlockFormat::BC1:
+            encodeColorBlock(rgba, out);
+            break;
+        case BlockFormat::BC3:
+            encodeChannelBlock(rgba, 3, out);
+            encodeColorBlock(rgba, out + 8);
+            break;
+        case BlockFormat::BC5:
+            encodeChannelBlock(rgba, 0, out);
+            encodeChannelBlock(rgba, 1, out + 8);
+            break;
+        case BlockFormat::BC7:
+            encodeBC7Mode6(rgba, out);
+            break;
+    }
+}
+
+std::vector<std::uint8_t> encodeImage(BlockFormat format, const std::uint8_t* rgba, std::uint32_t width,
+                                      std::uint32_t height)
+{
+    const std::uint32_t blocksX = std::max<std::uint32_t>(1, (width + 3) / 4);
+    const std::uint32_t blocksY = std::max<std::uint32_t>(1, (height + 3) / 4);
+    const std::size_t bytesPerBlock = blockBytes(format);
+
+    std::vector<std::uint8_t> encoded(static_cast<std::size_t>(blocksX) * blocksY * bytesPerBlock);
+
+    auto encodeRow = [&](std::uint32_t by) {
+        std::uint8_t block[64];
+        for (std::uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            for (std::uint32_t y = 0; y < 4; ++y)
+            {
+                std::uint32_t sy = std::min(by * 4 + y, height - 1);
+                for (std::uint32_t x = 0; x < 4; ++x)
+                {
+                    std::uint32_t sx = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<std::size_t>(sy) * width + sx) * 4, 4);
+                }
+            }
+            encodeBlock(format, block, encoded.data() + (static_cast<std::size_t>(by) * blocksX + bx) * bytesPerBlock);
+        }
+    };
+
+    // The caller encodes rows too, so cooking from inside a pool task cannot starve on its own rows.
+    ThreadPool::getInstance().parallelFor(blocksY, [&](std::size_t by) { encodeRow(static_cast<std::uint32_t>(by)); });
+
+    return encoded;
+}
+
+} // namespace Cooker
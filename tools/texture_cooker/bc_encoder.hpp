@@ -0,0 +1,56 @@
+#ifndef BC_ENCODER_HPP_
+#define BC_ENCODER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace Cooker
+{
+/**
+ * @enum BlockFormat
+ * @brief Block compression formats produced by the texture cooker.
+ */
+enum class BlockFormat
+{
+    BC1, /**< Opaque RGB, 4 bits per pixel. */
+    BC3, /**< RGB plus interpolated alpha, 8 bits per pixel. */
+    BC5, /**< Two independent channels (red, green), 8 bits per pixel, for normal maps. */
+    BC7  /**< High quality RGBA, 8 bits per pixel (mode 6 only). */
+};
+
+/**
+ * @brief Gets the size of one encoded 4x4 block.
+ *
+ * @param format The block format.
+ * @return 8 for BC1, 16 otherwise.
+ */
+inline std::size_t blockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+/**
+ * @brief Encodes one 4x4 block of RGBA8 pixels.
+ *
+ * @param format The block format to produce.
+ * @param rgba 16 pixels, row major, 4 bytes each.
+ * @param out Destination, blockBytes(format) bytes.
+ */
+void encodeBlock(BlockFormat format, const std::uint8_t rgba[64], std::uint8_t* out);
+
+/**
+ * @brief Encodes a whole RGBA8 image, replicating edge pixels to fill partial blocks.
+ *
+ * Block rows are encoded in parallel on the ThreadPool.
+ *
+ * @param format The block format to produce.
+ * @param rgba The pixels, width * height * 4 bytes.
+ * @param width Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @return The encoded blocks, row major.
+ */
+std::vector<std::uint8_t> encodeImage(BlockFormat format, const std::uint8_t* rgba, std::uint32_t width,
+                                      std::uint32_t height);
+}; // namespace Cooker
+
+#endif
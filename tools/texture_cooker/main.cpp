@@ -0,0 +1,98 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "texture_cooker.hpp"
+
+namespace
+{
+
+void printUsage()
+{
+    std::cout << "Usage: LambTextureCooker <input> <output.ktx2> [options]\n"
+              << "  --format bc1|bc3|bc5|bc7  Block format (default: bc1 if opaque, bc3 otherwise)\n"
+              << "  --filter box|kaiser       Mip filter (default: box)\n"
+              << "  --srgb                    Tag the texture as sRGB encoded\n"
+              << "  --no-mips                 Only store level 0\n";
+}
+
+bool parseFormat(const std::string& value, Cooker::BlockFormat& format)
+{
+    if (value == "bc1")
+        format = Cooker::BlockFormat::BC1;
+    else if (value == "bc3")
+        format = Cooker::BlockFormat::BC3;
+    else if (value == "bc5")
+        format = Cooker::BlockFormat::BC5;
+    else if (value == "bc7")
+        format = Cooker::BlockFormat::BC7;
+    else
+        return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    Cooker::TextureCookOptions options;
+    options.input = argv[1];
+    options.output = argv[2];
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+        {
+            Cooker::BlockFormat format;
+            if (!parseFormat(argv[++i], format))
+            {
+                std::cerr << "Unknown format: " << argv[i] << std::endl;
+                return 1;
+            }
+            options.format = format;
+        }
+        else if (arg == "--filter" && i + 1 < argc)
+        {
+            std::string filter = argv[++i];
+            options.filter = filter == "kaiser" ? Cooker::MipFilter::KAISER : Cooker::MipFilter::BOX;
+        }
+        else if (arg == "--srgb")
+        {
+            options.srgb = true;
+        }
+        else if (arg == "--no-mips")
+        {
+            options.mipmaps = false;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    try
+    {
+        Cooker::TextureCookResult result = Cooker::cookTexture(options);
+        std::cout << options.input << " -> " << options.output << ": " << result.width << "x" << result.height << ", "
+                  << result.levels << " levels, " << result.uncompressedBytes << " -> " << result.cookedBytes
+                  << " bytes (" << static_cast<double>(result.uncompressedBytes) / result.cookedBytes << ":1)"
+                  << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Cooking failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "mip_chain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LAMB_COOKER_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace Cooker
+{
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+constexpr int KAISER_TAPS = 8;
+constexpr double KAISER_ALPHA = 4.0;
+
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Weights of the 8 source pixels feeding one output pixel when halving:
+ * sinc low-pass at the new Nyquist frequency, windowed by a Kaiser window.
+ */
+std::array<float, KAISER_TAPS> kaiserWeights()
+{
+    std::array<float, KAISER_TAPS> weights{};
+    const double radius = KAISER_TAPS / 2.0;
+    double total = 0.0;
+
+    for (int tap = 0; tap < KAISER_TAPS; ++tap)
+    {
+        double d = tap - radius + 0.5; // distance from the output pixel center, in source pixels
+        double x = d / 2.0;
+        double sinc = x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+        double t = d / radius;
+        double window = besselI0(KAISER_ALPHA * std::sqrt(std::max(0.0, 1.0 - t * t))) / besselI0(KAISER_ALPHA);
+        weights[tap] = static_cast<float>(sinc * window);
+        total += weights[tap];
+    }
+
+    for (float& weight : weights)
+        weight = static_cast<float>(weight / total);
+
+    return weights;
+}
+
+void boxScalar(const Image& source, Image& target, std::uint32_t firstX, std::uint32_t y)
+{
+    const std::uint32_t y0 = std::min(2 * y, source.height - 1);
+    const std::uint32_t y1 = std::min(2 * y + 1, source.height - 1);
+
+    for (std::uint32_t x = firstX; x < target.width; ++x)
+    {
+        const std::uint32_t x0 = std::min(2 * x, source.width - 1);
+        const std::uint32_t x1 = std::min(2 * x + 1, source.width - 1);
+
+        const std::uint8_t* a = &source.pixels[(static_cast<std::size_t>(y0) * source.width + x0) * 4];
+        const std::uint8_t* b = &source.pixels[(static_cast<std::size_t>(y0) * source.width + x1) * 4];
+        const std::uint8_t* c = &source.pixels[(static_cast<std::size_t>(y1) * source.width + x0) * 4];
+        const std::uint8_t* d = &source.pixels[(static_cast<std::size_t>(y1) * source.width + x1) * 4];
+        std::uint8_t* out = &target.pixels[(static_cast<std::size_t>(y) * target.width + x) * 4];
+
+        for (int channel = 0; channel < 4; ++channel)
+            out[channel] = static_cast<std::uint8_t>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+    }
+}
+
+void boxFilter(const Image& source, Image& target)
+{
+    for (std::uint32_t y = 0; y < target.height; ++y)
+    {
+        std::uint32_t x = 0;
+
+#ifdef LAMB_COOKER_SSE2
+        if (source.width % 2 == 0 && source.height % 2 == 0)
+        {
+            const std::uint8_t* rowA = &source.pixels[static_cast<std::size_t>(2 * y) * source.width * 4];
+            const std::uint8_t* rowB = rowA + static_cast<std::size_t>(source.width) * 4;
+            std::uint8_t* out = &target.pixels[static_cast<std::size_t>(y) * target.width * 4];
+
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rounding = _mm_set1_epi16(2);
+
+            // 4 source pixels per row in, 2 destination pixels out.
+            for (; x + 2 <= target.width; x += 2)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowA + x * 8));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowB + x * 8));
+
+                __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+                sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, sum));
+            }
+        }
+#endif
+
+        boxScalar(source, target, x, y);
+    }
+}
+
+#ifdef LAMB_COOKER_SSE2
+using Pixel = __m128;
+
+inline Pixel loadPixel(const std::uint8_t* rgba)
+{
+    std::int32_t packed;
+    std::memcpy(&packed, rgba, 4);
+    __m128i bytes = _mm_cvtsi32_si128(packed);
+    __m128i zero = _mm_setzero_si128();
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+
+inline Pixel loadPixel(const float* rgba)
+{
+    return _mm_loadu_ps(rgba);
+}
+
+inline Pixel zeroPixel()
+{
+    return _mm_setzero_ps();
+}
+
+inline Pixel madd(Pixel accumulator, Pixel value, float weight)
+{
+    return _mm_add_ps(accumulator, _mm_mul_ps(value, _mm_set1_ps(weight)));
+}
+
+inline void storePixel(float* out, Pixel value)
+{
+    _mm_storeu_ps(out, value);
+}
+
+inline void storePixel(std::uint8_t* out, Pixel value)
+{
+    __m128i rounded = _mm_cvtps_epi32(value); // round to nearest
+    __m128i packed = _mm_packs_epi32(rounded, rounded);
+    packed = _mm_packus_epi16(packed, packed); // saturates to [0, 255]
+    std::int32_t bytes = _mm_cvtsi128_si32(packed);
+    std::memcpy(out, &bytes, 4);
+}
+#else
+using Pixel = std::array<float, 4>;
+
+template <typename T> inline Pixel loadPixel(const T* rgba)
+{
+    return {static_cast<float>(rgba[0]), static_cast<float>(rgba[1]), static_cast<float>(rgba[2]),
+            static_cast<float>(rgba[3])};
+}
+
+inline Pixel zeroPixel()
+{
+    return {0.0f, 0.0f, 0.0f, 0.0f};
+}
+
+inline Pixel madd(Pixel accumulator, Pixel value, float weight)
+{
+    for (int channel = 0; channel < 4; ++channel)
+        accumulator[channel] += value[channel] * weight;
+    return accumulator;
+}
+
+inline void storePixel(float* out, Pixel value)
+{
+    std::memcpy(out, value.data(), sizeof(float) * 4);
+}
+
+inline void storePixel(std::uint8_t* out, Pixel value)
+{
+    for (int channel = 0; channel < 4; ++channel)
+        out[channel] = static_cast<std::uint8_t>(std::clamp(std::lround(value[channel]), 0l, 255l));
+}
+#endif
+
+void kaiserFilter(const Image& source, Image& target)
+{
+    static const std::array<float, KAISER_TAPS> weights = kaiserWeights();
+    const int firstTap = -(KAISER_TAPS / 2 - 1);
+
+    // Horizontal pass into a float buffer, width halved, height kept.
+    std::vector<float> horizontal(static_cast<std::size_t>(target.width) * source.height * 4);
+    for (std::uint32_t y = 0; y < source.height; ++y)
+    {
+        const std::uint8_t* row = &source.pixels[static_cast<std::size_t>(y) * source.width * 4];
+        for (std::uint32_t x = 0; x < target.width; ++x)
+        {
+            Pixel sum = zeroPixel();
+            for (int tap = 0; tap < KAISER_TAPS; ++tap)
+            {
+                int sx = std::clamp(static_cast<int>(2 * x) + firstTap + tap, 0, static_cast<int>(source.width) - 1);
+                sum = madd(sum, loadPixel(row + sx * 4), weights[tap]);
+            }
+            storePixel(&horizontal[(static_cast<std::size_t>(y) * target.width + x) * 4], sum);
+        }
+    }
+
+    // Vertical pass.
+    for (std::uint32_t y = 0; y < target.height; ++y)
+    {
+        for (std::uint32_t x = 0; x < target.width; ++x)
+        {
+            Pixel sum = zeroPixel();
+            for (int tap = 0; tap < KAISER_TAPS; ++tap)
+            {
+                int sy = std::clamp(static_cast<int>(2 * y) + firstTap + tap, 0, static_cast<int>(source.height) - 1);
+                sum = madd(sum, loadPixel(&horizontal[(static_cast<std::size_t>(sy) * target.width + x) * 4]),
+                           weights[tap]);
+            }
+            storePixel(&target.pixels[(static_cast<std::size_t>(y) * target.width + x) * 4], sum);
+        }
+    }
+}
+
+} // namespace
+
+Image downsample(const Image& source, MipFilter filter)
+{
+    Image target;
+    target.width = std::max<std::uint32_t>(1, source.width / 2);
+    target.height = std::max<std::uint32_t>(1, source.height / 2);
+    target.pixels.resize(static_cast<std::size_t>(target.width) * target.height * 4);
+
+    if (filter == MipFilter::KAISER)
+        kaiserFilter(source, target);
+    else
+        boxFilter(source, target);
+
+    return target;
+}
+
+std::vector<Image> buildMipChain(const Image& base, MipFilter filter)
+{
+    std::vector<Image> chain;
+    chain.push_back(base);
+
+    while (chain.back().width > 1 || chain.back().height > 1)
+        chain.push_back(downsample(chain.back(), filter));
+
+    return chain;
+}
+
+} // namespace Cooker
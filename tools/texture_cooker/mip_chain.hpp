@@ -0,0 +1,52 @@
+#ifndef MIP_CHAIN_HPP_
+#define MIP_CHAIN_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace Cooker
+{
+/**
+ * @enum MipFilter
+ * @brief Downsampling filter used to build mip chains.
+ */
+enum class MipFilter
+{
+    BOX,   /**< 2x2 average, fast, slightly soft. */
+    KAISER /**< Kaiser windowed sinc, sharper, keeps fine detail in lower mips. */
+};
+
+/**
+ * @struct Image
+ * @brief An RGBA8 image, 4 bytes per pixel, row major.
+ */
+struct Image
+{
+    std::uint32_t width = 0;          /**< Width in pixels. */
+    std::uint32_t height = 0;         /**< Height in pixels. */
+    std::vector<std::uint8_t> pixels; /**< width * height * 4 bytes. */
+};
+
+/**
+ * @brief Halves an image in each dimension (never below 1 pixel).
+ *
+ * The box filter runs 4 pixels at a time with SSE2 when both dimensions are even.
+ * The Kaiser filter keeps each pixel in a 4-wide float vector, RGBA in one register.
+ *
+ * @param source The image to downsample.
+ * @param filter The filter to apply.
+ * @return The next mip level.
+ */
+Image downsample(const Image& source, MipFilter filter);
+
+/**
+ * @brief Builds the full mip chain of an image, down to 1x1.
+ *
+ * @param base Level 0.
+ * @param filter The filter to apply between levels.
+ * @return Every level, base included, largest first.
+ */
+std::vector<Image> buildMipChain(const Image& base, MipFilter filter);
+}; // namespace Cooker
+
+#endif
@@ -0,0 +1,100 @@
+#include "texture_cooker.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <stb_image.h>
+
+namespace Cooker
+{
+
+Image loadImage(const std::string& path)
+{
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!pixels)
+        throw std::runtime_error("Failed to decode image: " + path);
+
+    Image image;
+    image.width = static_cast<std::uint32_t>(width);
+    image.height = static_cast<std::uint32_t>(height);
+    image.pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    return image;
+}
+
+BlockFormat chooseFormat(const Image& image)
+{
+    for (std::size_t i = 3; i < image.pixels.size(); i += 4)
+    {
+        if (image.pixels[i] != 255)
+            return BlockFormat::BC3;
+    }
+    return BlockFormat::BC1;
+}
+
+IO::Ktx2Format ktx2Format(BlockFormat format, bool srgb)
+{
+    switch (format)
+    {
+        case BlockFormat::BC1:
+            return srgb ? IO::Ktx2Format::BC1_RGB_SRGB : IO::Ktx2Format::BC1_RGB_UNORM;
+        case BlockFormat::BC3:
+            return srgb ? IO::Ktx2Format::BC3_SRGB : IO::Ktx2Format::BC3_UNORM;
+        case BlockFormat::BC5:
+            return IO::Ktx2Format::BC5_UNORM;
+        case BlockFormat::BC7:
+            return srgb ? IO::Ktx2Format::BC7_SRGB : IO::Ktx2Format::BC7_UNORM;
+    }
+    return IO::Ktx2Format::UNDEFINED;
+}
+
+IO::Ktx2Image compressImage(const Image& base, const TextureCookOptions& options)
+{
+    const BlockFormat format = options.format.value_or(chooseFormat(base));
+
+    std::vector<Image> chain;
+    if (options.mipmaps)
+        chain = buildMipChain(base, options.filter);
+    else
+        chain.push_back(base);
+
+    IO::Ktx2Image image;
+    image.format = ktx2Format(format, options.srgb);
+    image.width = base.width;
+    image.height = base.height;
+
+    for (const Image& level : chain)
+    {
+        std::vector<std::uint8_t> blocks = encodeImage(format, level.pixels.data(), level.width, level.height);
+        image.levels.push_back(IO::Ktx2Level{image.data.size(), blocks.size()});
+        image.data.insert(image.data.end(), blocks.begin(), blocks.end());
+    }
+
+    return image;
+}
+
+TextureCookResult cookTexture(const TextureCookOptions& options)
+{
+    Image base = loadImage(options.input);
+    IO::Ktx2Image image = compressImage(base, options);
+    IO::writeKTX2(options.output, image);
+
+    TextureCookResult result;
+    result.width = image.width;
+    result.height = image.height;
+    result.levels = static_cast<std::uint32_t>(image.levels.size());
+    result.format = options.format.value_or(chooseFormat(base));
+    result.cookedBytes = image.data.size();
+    for (std::uint32_t level = 0; level < result.levels; ++level)
+    {
+        std::size_t width = std::max<std::uint32_t>(1, image.width >> level);
+        std::size_t height = std::max<std::uint32_t>(1, image.height >> level);
+        result.uncompressedBytes += width * height * 4;
+    }
+
+    return result;
+}
+
+} // namespace Cooker
@@ -0,0 +1,90 @@
+#ifndef TEXTURE_COOKER_HPP_
+#define TEXTURE_COOKER_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include <ktx2.hpp>
+
+#include "bc_encoder.hpp"
+#include "mip_chain.hpp"
+
+namespace Cooker
+{
+/**
+ * @struct TextureCookOptions
+ * @brief Parameters of one texture cooking job.
+ */
+struct TextureCookOptions
+{
+    std::string input;                 /**< Source image (any format stb_image reads). */
+    std::string output;                /**< Destination KTX2 file. */
+    std::optional<BlockFormat> format; /**< Block format, picked from the image content when empty. */
+    MipFilter filter = MipFilter::BOX; /**< Filter used to build the mip chain. */
+    bool srgb = false;                 /**< Tag the output as sRGB encoded. */
+    bool mipmaps = true;               /**< Store the full mip chain, level 0 only otherwise. */
+};
+
+/**
+ * @struct TextureCookResult
+ * @brief Summary of a cooked texture.
+ */
+struct TextureCookResult
+{
+    std::uint32_t width = 0;               /**< Width of level 0. */
+    std::uint32_t height = 0;              /**< Height of level 0. */
+    std::uint32_t levels = 0;              /**< Number of mip levels written. */
+    BlockFormat format = BlockFormat::BC1; /**< Format written. */
+    std::size_t uncompressedBytes = 0;     /**< RGBA8 size of the same mip chain. */
+    std::size_t cookedBytes = 0;           /**< Size of the level payloads in the KTX2 file. */
+};
+
+/**
+ * @brief Loads an image as RGBA8.
+ *
+ * @param path The file path to the image.
+ * @return The decoded image.
+ *
+ * @throw std::runtime_error If the image cannot be decoded.
+ */
+Image loadImage(const std::string& path);
+
+/**
+ * @brief Picks BC1 for opaque images and BC3 when any pixel is translucent.
+ *
+ * @param image The image to inspect.
+ * @return The suggested block format.
+ */
+BlockFormat chooseFormat(const Image& image);
+
+/**
+ * @brief Gets the KTX2 format matching a block format.
+ *
+ * @param format The block format.
+ * @param srgb Whether the data is sRGB encoded (ignored for BC5).
+ * @return The KTX2 format.
+ */
+IO::Ktx2Format ktx2Format(BlockFormat format, bool srgb);
+
+/**
+ * @brief Builds the mip chain of an image and block compresses every level.
+ *
+ * @param base Level 0.
+ * @param options Format, filter, sRGB and mipmap settings (paths are ignored).
+ * @return The compressed image, ready to be written.
+ */
+IO::Ktx2Image compressImage(const Image& base, const TextureCookOptions& options);
+
+/**
+ * @brief Cooks one texture: decode, build mips, block compress, write KTX2.
+ *
+ * @param options The cooking parameters.
+ * @return A summary of the written texture.
+ *
+ * @throw std::runtime_error If the input cannot be read or the output cannot be written.
+ */
+TextureCookResult cookTexture(const TextureCookOptions& options);
+}; // namespace Cooker
+
+#endif
@@ -0,0 +1,161 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "texture_cooker.hpp"
+#include "texture_packer.hpp"
+
+using json = nlohmann::json;
+
+namespace
+{
+
+void printUsage()
+{
+    std::cout << "Usage: LambTexturePacker <output-dir> <inputs...> [options]\n"
+              << "  --name <prefix>           Prefix of the generated files (default: textures)\n"
+              << "  --format bc1|bc3|bc5|bc7  Block format (default: bc1 if opaque, bc3 otherwise)\n"
+              << "  --filter box|kaiser       Mip filter (default: box)\n"
+              << "  --srgb                    Tag the textures as sRGB encoded\n"
+              << "  --atlas-threshold <n>     Images up to n x n texels go into atlases (default: 256)\n"
+              << "  --atlas-size <n>          Side of an atlas page (default: 2048)\n";
+}
+
+bool parseFormat(const std::string& value, Cooker::BlockFormat& format)
+{
+    if (value == "bc1")
+        format = Cooker::BlockFormat::BC1;
+    else if (value == "bc3")
+        format = Cooker::BlockFormat::BC3;
+    else if (value == "bc5")
+        format = Cooker::BlockFormat::BC5;
+    else if (value == "bc7")
+        format = Cooker::BlockFormat::BC7;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * Writes the manifest the engine's TextureAtlas reads: the containers, then for
+ * every source path the container, layer and UV transform to use instead.
+ */
+void writeManifest(const std::filesystem::path& path, const Packer::PackResult& result)
+{
+    json manifest;
+    manifest["containers"] = json::array();
+    for (const Packer::PackedGroup& group : result.groups)
+        manifest["containers"].push_back(group.container);
+
+    manifest["entries"] = json::object();
+    for (const Packer::PackedEntry& entry : result.entries)
+    {
+        manifest["entries"][entry.source] = {
+            {"container", entry.group},
+            {"layer", entry.layer},
+            {"uvOffset", {entry.uvOffset[0], entry.uvOffset[1]}},
+            {"uvScale", {entry.uvScale[0], entry.uvScale[1]}},
+        };
+    }
+
+    std::ofstream file(path);
+    if (!file)
+        throw std::runtime_error("Cannot write manifest: " + path.string());
+    file << manifest.dump(4) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const std::filesystem::path outputDirectory = argv[1];
+    Packer::PackOptions options;
+    std::vector<std::string> sources;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc)
+        {
+            options.name = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            Cooker::BlockFormat format;
+            if (!parseFormat(argv[++i], format))
+            {
+                std::cerr << "Unknown format: " << argv[i] << std::endl;
+                return 1;
+            }
+            options.format = format;
+        }
+        else if (arg == "--filter" && i + 1 < argc)
+        {
+            std::string filter = argv[++i];
+            options.filter = filter == "kaiser" ? Cooker::MipFilter::KAISER : Cooker::MipFilter::BOX;
+        }
+        else if (arg == "--srgb")
+        {
+            options.srgb = true;
+        }
+        else if (arg == "--atlas-threshold" && i + 1 < argc)
+        {
+            options.atlasThreshold = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--atlas-size" && i + 1 < argc)
+        {
+            options.atlasSize = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            sources.push_back(arg);
+        }
+    }
+
+    try
+    {
+        std::vector<Packer::PackInput> inputs;
+        for (const std::string& source : sources)
+            inputs.push_back(Packer::PackInput{std::filesystem::path(source).generic_string(),
+                                               Cooker::loadImage(source)});
+
+        Packer::PackResult result = Packer::pack(inputs, options);
+
+        std::filesystem::create_directories(outputDirectory);
+        for (const Packer::PackedGroup& group : result.groups)
+        {
+            IO::Ktx2Image image = Packer::compressGroup(group, options);
+            IO::writeKTX2((outputDirectory / group.container).string(), image);
+            std::cout << group.container << ": " << group.layers.size() << (group.atlas ? " atlas pages" : " layers")
+                      << " of " << group.width << "x" << group.height << ", " << image.data.size() << " bytes"
+                      << std::endl;
+        }
+
+        writeManifest(outputDirectory / (options.name + ".atlas.json"), result);
+        std::cout << sources.size() << " textures packed into " << result.groups.size() << " arrays" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Packing failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "texture_packer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "texture_cooker.hpp"
+
+namespace Packer
+{
+
+namespace
+{
+
+const char* formatName(Cooker::BlockFormat format)
+{
+    switch (format)
+    {
+        case Cooker::BlockFormat::BC1:
+            return "bc1";
+        case Cooker::BlockFormat::BC3:
+            return "bc3";
+        case Cooker::BlockFormat::BC5:
+            return "bc5";
+        default:
+            return "bc7";
+    }
+}
+
+std::uint32_t alignToBlock(std::uint32_t value)
+{
+    return (value + 3) / 4 * 4;
+}
+
+/**
+ * Copies an image into an atlas page, then repeats its border texels outward
+ * over `padding` texels so bilinear taps and small mips see the image's own edge.
+ */
+void blit(const Cooker::Image& source, Cooker::Image& page, std::uint32_t x, std::uint32_t y, std::uint32_t padding)
+{
+    const int left = static_cast<int>(x);
+    const int top = static_cast<int>(y);
+    const int pad = static_cast<int>(padding);
+
+    for (int py = top - pad; py < top + static_cast<int>(source.height) + pad; ++py)
+    {
+        if (py < 0 || py >= static_cast<int>(page.height))
+            continue;
+        const int sy = std::clamp(py - top, 0, static_cast<int>(source.height) - 1);
+
+        for (int px = left - pad; px < left + static_cast<int>(source.width) + pad; ++px)
+        {
+            if (px < 0 || px >= static_cast<int>(page.width))
+                continue;
+            const int sx = std::clamp(px - left, 0, static_cast<int>(source.width) - 1);
+
+            std::memcpy(&page.pixels[(static_cast<std::size_t>(py) * page.width + px) * 4],
+                        &source.pixels[(static_cast<std::size_t>(sy) * source.width + sx) * 4], 4);
+        }
+    }
+}
+
+} // namespace
+
+ShelfPacker::Placement ShelfPacker::insert(std::uint32_t width, std::uint32_t height)
+{
+    if (width > m_pageSize || height > m_pageSize)
+        throw std::runtime_error("Rectangle does not fit in an atlas page");
+
+    // New shelf when the row is full, new page when the shelf does not fit.
+    if (m_cursorX + width > m_pageSize)
+    {
+        m_shelfY += m_shelfHeight;
+        m_shelfHeight = 0;
+        m_cursorX = 0;
+    }
+    if (m_shelfY + height > m_pageSize)
+    {
+        m_page++;
+        m_shelfY = 0;
+        m_shelfHeight = 0;
+        m_cursorX = 0;
+    }
+
+    Placement placement{m_page, m_cursorX, m_shelfY};
+    m_cursorX += width;
+    m_shelfHeight = std::max(m_shelfHeight, height);
+    m_used = true;
+    return placement;
+}
+
+PackResult pack(const std::vector<PackInput>& inputs, const PackOptions& options)
+{
+    if (options.atlasThreshold + 2 * options.padding > options.atlasSize)
+        throw std::runtime_error("Atlas pages are too small for the atlas threshold and padding");
+
+    PackResult result;
+    result.entries.resize(inputs.size());
+
+    std::map<std::tuple<Cooker::BlockFormat, std::uint32_t, std::uint32_t>, std::size_t> arrays;
+    std::map<Cooker::BlockFormat, std::vector<std::size_t>> atlasInputs;
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        const Cooker::Image& image = inputs[i].image;
+        const Cooker::BlockFormat format = options.format.value_or(Cooker::chooseFormat(image));
+        result.entries[i].source = inputs[i].source;
+
+        if (image.width <= options.atlasThreshold && image.height <= options.atlasThreshold)
+        {
+            atlasInputs[format].push_back(i);
+            continue;
+        }
+
+        auto key = std::make_tuple(format, image.width, image.height);
+        auto it = arrays.find(key);
+        if (it == arrays.end())
+        {
+            PackedGroup group;
+            group.format = format;
+            group.width = image.width;
+            group.height = image.height;
+            group.container = options.name + "_" + formatName(format) + "_" + std::to_string(image.width) + "x" +
+                              std::to_string(image.height) + ".ktx2";
+            it = arrays.emplace(key, result.groups.size()).first;
+            result.groups.push_back(std::move(group));
+        }
+
+        PackedGroup& group = result.groups[it->second];
+        result.entries[i].group = it->second;
+        result.entries[i].layer = static_cast<std::uint32_t>(group.layers.size());
+        group.layers.push_back(image);
+    }
+
+    for (auto& [format, indices] : atlasInputs)
+    {
+        // Tallest first keeps shelves tight.
+        std::stable_sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
+            return inputs[a].image.height > inputs[b].image.height;
+        });
+
+        PackedGroup group;
+        group.format = format;
+        group.atlas = true;
+        group.width = options.atlasSize;
+        group.height = options.atlasSize;
+        group.container = options.name + "_" + formatName(format) + "_atlas.ktx2";
+
+        const std::size_t groupIndex = result.groups.size();
+        const float size = static_cast<float>(options.atlasSize);
+        ShelfPacker packer(options.atlasSize);
+
+        for (std::size_t index : indices)
+        {
+            const Cooker::Image& image = inputs[index].image;
+            // Cells cover whole 4x4 blocks so no compressed block mixes two entries.
+            ShelfPacker::Placement placement = packer.insert(alignToBlock(image.width + 2 * options.padding),
+                                                             alignToBlock(image.height + 2 * options.padding));
+
+            while (group.layers.size() <= placement.page)
+            {
+                Cooker::Image page;
+                page.width = options.atlasSize;
+                page.height = options.atlasSize;
+                page.pixels.assign(static_cast<std::size_t>(page.width) * page.height * 4, 0);
+                group.layers.push_back(std::move(page));
+            }
+
+            const std::uint32_t x = placement.x + options.padding;
+            const std::uint32_t y = placement.y + options.padding;
+            blit(image, group.layers[placement.page], x, y, options.padding);
+
+            PackedEntry& entry = result.entries[index];
+            entry.group = groupIndex;
+            entry.layer = placement.page;
+            entry.uvOffset[0] = x / size;
+            entry.uvOffset[1] = y / size;
+            entry.uvScale[0] = image.width / size;
+            entry.uvScale[1] = image.height / size;
+        }
+
+        result.groups.push_back(std::move(group));
+    }
+
+    return result;
+}
+
+IO::Ktx2Image compressGroup(const PackedGroup& group, const PackOptions& options)
+{
+    Cooker::TextureCookOptions cookOptions;
+    cookOptions.format = group.format;
+    cookOptions.filter = options.filter;
+    cookOptions.srgb = options.srgb;
+
+    std::vector<IO::Ktx2Image> layers;
+    for (const Cooker::Image& layer : group.layers)
+        layers.push_back(Cooker::compressImage(layer, cookOptions));
+
+    IO::Ktx2Image image;
+    image.format = layers.front().format;
+    image.width = group.width;
+    image.height = group.height;
+    image.layerCount = static_cast<std::uint32_t>(layers.size());
+
+    // KTX2 stores every layer of a level together, level after level.
+    for (std::size_t level = 0; level < layers.front().levels.size(); ++level)
+    {
+        IO::Ktx2Level packed{image.data.size(), 0};
+        for (const IO::Ktx2Image& layer : layers)
+        {
+            const IO::Ktx2Level& source = layer.levels[level];
+            image.data.insert(image.data.end(), layer.data.begin() + source.offset,
+                              layer.data.begin() + source.offset + source.size);
+            packed.size += source.size;
+        }
+        image.levels.push_back(packed);
+    }
+
+    return image;
+}
+
+} // namespace Packer
@@ -0,0 +1,161 @@
+#ifndef TEXTURE_PACKER_HPP_
+#define TEXTURE_PACKER_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ktx2.hpp>
+
+#include "bc_encoder.hpp"
+#include "mip_chain.hpp"
+
+namespace Packer
+{
+/**
+ * @struct PackOptions
+ * @brief Parameters of one packing job.
+ */
+struct PackOptions
+{
+    std::string name = "textures";                     /**< Prefix of the generated container files. */
+    std::uint32_t atlasThreshold = 256;                /**< Images no larger than this go into atlases. */
+    std::uint32_t atlasSize = 2048;                    /**< Side of an atlas page. */
+    std::uint32_t padding = 4;                         /**< Texels of edge extension around atlas entries. */
+    std::optional<Cooker::BlockFormat> format;         /**< Block format, picked per image when empty. */
+    Cooker::MipFilter filter = Cooker::MipFilter::BOX; /**< Filter used to build the mip chains. */
+    bool srgb = false;                                 /**< Tag the output as sRGB encoded. */
+};
+
+/**
+ * @struct PackInput
+ * @brief A source image to pack.
+ */
+struct PackInput
+{
+    std::string source;  /**< The source path, as materials reference it. */
+    Cooker::Image image; /**< The decoded RGBA8 pixels. */
+};
+
+/**
+ * @struct PackedEntry
+ * @brief Where a source image ended up.
+ *
+ * Texture coordinates of the source map to the container as uv * uvScale + uvOffset
+ * in layer `layer`.
+ */
+struct PackedEntry
+{
+    std::string source;         /**< The source path. */
+    std::size_t group = 0;      /**< Index of the group in PackResult::groups. */
+    std::uint32_t layer = 0;    /**< Array layer holding the image. */
+    float uvOffset[2] = {0, 0}; /**< Offset of the image in the layer, in normalized coordinates. */
+    float uvScale[2] = {1, 1};  /**< Size of the image in the layer, in normalized coordinates. */
+};
+
+/**
+ * @struct PackedGroup
+ * @brief One texture array: same format, same size layers.
+ */
+struct PackedGroup
+{
+    std::string container;                                 /**< File name of the KTX2 container. */
+    Cooker::BlockFormat format = Cooker::BlockFormat::BC1; /**< Block format of every layer. */
+    bool atlas = false;                                    /**< Whether the layers are atlas pages. */
+    std::uint32_t width = 0;                               /**< Width of every layer. */
+    std::uint32_t height = 0;                              /**< Height of every layer. */
+    std::vector<Cooker::Image> layers;                     /**< The layer images, before compression. */
+};
+
+/**
+ * @struct PackResult
+ * @brief Output of pack(): the arrays to write and the placement of every source.
+ */
+struct PackResult
+{
+    std::vector<PackedGroup> groups;  /**< The texture arrays. */
+    std::vector<PackedEntry> entries; /**< One entry per input, in input order. */
+};
+
+/**
+ * @class ShelfPacker
+ * @brief Places rectangles on fixed size pages, row by row.
+ *
+ * Rectangles should be inserted tallest first for tight shelves.
+ */
+class ShelfPacker
+{
+public:
+    /**
+     * @struct Placement
+     * @brief Position of a packed rectangle.
+     */
+    struct Placement
+    {
+        std::uint32_t page = 0; /**< The page index. */
+        std::uint32_t x = 0;    /**< Left edge in texels. */
+        std::uint32_t y = 0;    /**< Top edge in texels. */
+    };
+
+    /**
+     * @brief Constructs a packer.
+     *
+     * @param pageSize Side of every page in texels.
+     */
+    explicit ShelfPacker(std::uint32_t pageSize) : m_pageSize(pageSize) {}
+
+    /**
+     * @brief Places a rectangle, opening a new shelf or page when needed.
+     *
+     * @param width Width in texels, at most the page size.
+     * @param height Height in texels, at most the page size.
+     * @return Where the rectangle goes.
+     *
+     * @throw std::runtime_error If the rectangle is larger than a page.
+     */
+    Placement insert(std::uint32_t width, std::uint32_t height);
+
+    /**
+     * @brief Gets the number of pages opened so far.
+     *
+     * @return The page count.
+     */
+    std::uint32_t pageCount() const { return m_page + (m_used ? 1 : 0); }
+
+private:
+    std::uint32_t m_pageSize;        /**< Side of every page. */
+    std::uint32_t m_page = 0;        /**< Current page. */
+    std::uint32_t m_shelfY = 0;      /**< Top of the current shelf. */
+    std::uint32_t m_shelfHeight = 0; /**< Height of the current shelf. */
+    std::uint32_t m_cursorX = 0;     /**< Next free column on the current shelf. */
+    bool m_used = false;             /**< Whether the current page holds anything. */
+};
+
+/**
+ * @brief Groups images into texture arrays and atlas pages.
+ *
+ * Images larger than the atlas threshold are grouped by format and size, one
+ * layer each. Smaller images are shelf packed into atlas pages, with their
+ * border texels repeated into the padding so filtering does not bleed
+ * between neighbours; the pages of one format form one array.
+ *
+ * @param inputs The images to pack.
+ * @param options The packing parameters.
+ * @return The groups and entries.
+ *
+ * @throw std::runtime_error If options are inconsistent.
+ */
+PackResult pack(const std::vector<PackInput>& inputs, const PackOptions& options);
+
+/**
+ * @brief Builds the mip chain of every layer and compresses them into one layered KTX2 image.
+ *
+ * @param group The group to compress.
+ * @param options Filter and sRGB settings.
+ * @return The layered image, ready to be written.
+ */
+IO::Ktx2Image compressGroup(const PackedGroup& group, const PackOptions& options);
+}; // namespace Packer
+
+#endif